@@ -0,0 +1,372 @@
+#include "user.pb.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Channel.h"
+#include "AzRPC_Controller.h"
+#include "AzRPC_Provider.h"
+#include "AzRPC_Registry.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+
+/**
+    AzRPC压测工具
+    闭环模式(closed): N个调用方各自串行地发请求, 收到响应后立刻发下一个, 衡量给定并发下的吞吐和延迟
+    开环模式(open):   按固定速率安排请求的发出时间, 与响应快慢无关
+                      延迟从"计划发出时间"开始计算(coordinated omission修正), 服务端变慢时排队的时间也会被计入
+*/
+
+typedef std::chrono::steady_clock Clock;
+
+// 压测参数
+struct BenchOptions {
+    std::string config;                     // 框架配置文件(-i)
+    std::string mode = "closed";            // closed | open
+    int concurrency = 8;                    // 闭环模式的调用方数量, 开环模式的发送线程数量
+    double rate = 1000;                     // 开环模式的目标速率(请求/秒)
+    double duration = 10;                   // 每轮压测的统计时长(秒)
+    double warmup = 2;                      // 每轮压测开始前的预热时长(秒), 不计入统计
+    std::vector<size_t> payloads{64};       // 请求负载大小(字节), 每个大小跑一轮
+    std::string service = "UserServiceRpc";
+    std::string method = "Login";
+    std::string format = "text";            // text | json | both
+    bool inproc = false;                    // 在本进程内启动服务端
+};
+
+// 单个线程的统计数据, 线程结束后再合并, 压测过程中没有共享写
+struct ThreadStats {
+    uint64_t ok = 0;
+    uint64_t failed = 0;
+    std::vector<int64_t> latency_ns;        // 从计划发出到收到响应(闭环模式下等于service_ns)
+    std::vector<int64_t> service_ns;        // 从实际发出到收到响应
+    Clock::time_point last_finished;        // 计入统计的调用中最后完成的时间
+};
+
+// 一轮压测的结果
+struct RunResult {
+    size_t payload = 0;
+    uint64_t ok = 0;
+    uint64_t failed = 0;
+    double elapsed = 0;
+    std::vector<int64_t> latency_ns;
+    std::vector<int64_t> service_ns;
+};
+
+static void usage(const char* prog) {
+    std::cout << "格式: " << prog << " -i <配置文件路径> [选项]\n"
+              << "  --mode closed|open      闭环或开环模式, 默认closed\n"
+              << "  --concurrency N         并发调用方数量, 默认8\n"
+              << "  --rate R                开环模式的目标速率(请求/秒), 默认1000\n"
+              << "  --duration S            统计时长(秒), 默认10\n"
+              << "  --warmup S              预热时长(秒), 默认2\n"
+              << "  --payload 64,1024,...   请求负载大小(字节), 逗号分隔, 每个大小跑一轮\n"
+              << "  --service NAME          服务名, 默认UserServiceRpc\n"
+              << "  --method NAME           方法名, 默认Login\n"
+              << "  --format text|json|both 输出格式, 默认text\n"
+              << "  --inproc                在本进程内启动服务端, 配合registry=memory可以脱离ZooKeeper运行" << std::endl;
+}
+
+static bool parse_options(int argc, char* argv[], BenchOptions* options) {
+    static const struct option long_options[] = {
+        {"mode", required_argument, nullptr, 'M'},
+        {"concurrency", required_argument, nullptr, 'c'},
+        {"rate", required_argument, nullptr, 'r'},
+        {"duration", required_argument, nullptr, 'd'},
+        {"warmup", required_argument, nullptr, 'w'},
+        {"payload", required_argument, nullptr, 'p'},
+        {"service", required_argument, nullptr, 's'},
+        {"method", required_argument, nullptr, 'm'},
+        {"format", required_argument, nullptr, 'f'},
+        {"inproc", no_argument, nullptr, 'P'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    int o;
+    while (-1 != (o = getopt_long(argc, argv, "i:c:r:d:w:p:s:m:f:", long_options, nullptr))) {
+        switch (o) {
+            case 'i': options->config = optarg; break;
+            case 'M': options->mode = optarg; break;
+            case 'c': options->concurrency = atoi(optarg); break;
+            case 'r': options->rate = atof(optarg); break;
+            case 'd': options->duration = atof(optarg); break;
+            case 'w': options->warmup = atof(optarg); break;
+            case 's': options->service = optarg; break;
+            case 'm': options->method = optarg; break;
+            case 'f': options->format = optarg; break;
+            case 'P': options->inproc = true; break;
+            case 'p': {
+                options->payloads.clear();
+                std::stringstream ss(optarg);
+                std::string item;
+                while (std::getline(ss, item, ',')) {
+                    options->payloads.push_back(strtoul(item.c_str(), nullptr, 10));
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    if (options->config.empty() || options->concurrency <= 0 || options->payloads.empty()) {
+        return false;
+    }
+    if (options->mode != "closed" && options->mode != "open") {
+        return false;
+    }
+    return !(options->mode == "open" && options->rate <= 0);
+}
+
+// --inproc时在本进程内发布的服务, 不做任何业务处理, 只衡量框架本身的开销
+class BenchUserService: public AzUser::UserServiceRpc {
+public:
+    void Login(::google::protobuf::RpcController* controller, const ::AzUser::LoginRequest* request, ::AzUser::LoginResponse* response, ::google::protobuf::Closure* done) override {
+        response->mutable_result()->set_errcode(0);
+        response->set_success(true);
+        done->Run();
+    }
+
+    void Register(::google::protobuf::RpcController* controller, const ::AzUser::RegisterRequest* request, ::AzUser::RegisterResponse* response, ::google::protobuf::Closure* done) override {
+        response->mutable_result()->set_errcode(0);
+        response->set_success(true);
+        done->Run();
+    }
+};
+
+// 在后台线程启动服务端, 等到方法出现在注册中心后返回
+static bool start_inproc_server(const BenchOptions& options, std::thread* server, std::atomic<AzRPC_Provider*>* provider) {
+    *server = std::thread([provider]() {
+        // EventLoop必须在运行它的线程中创建
+        AzRPC_Provider local;
+        local.NotifyService(new BenchUserService());
+        provider->store(&local);
+        local.Run();
+        provider->store(nullptr);
+    });
+
+    std::unique_ptr<AzRPC_Registry> registry = AzRPC_Registry::NewFromConfig();
+    if (!registry->Start()) {
+        return false;
+    }
+    std::string method_path = "/" + options.service + "/" + options.method;
+    for (int i = 0; i < 1000; ++i) {
+        if (!registry->GetData(method_path).empty()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+// 把负载写入请求中的第一个string/bytes字段, 使任意方法都可以调整请求大小
+static void fill_payload(google::protobuf::Message* request, size_t payload) {
+    const google::protobuf::Descriptor* descriptor = request->GetDescriptor();
+    const google::protobuf::Reflection* reflection = request->GetReflection();
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+        const google::protobuf::FieldDescriptor* field = descriptor->field(i);
+        if (!field->is_repeated() && field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING) {
+            reflection->SetString(request, field, std::string(payload, 'x'));
+            return;
+        }
+    }
+}
+
+// 单个调用方: 每个线程独占一个channel, 连接在整轮压测中复用
+static void caller(const BenchOptions& options, const google::protobuf::MethodDescriptor* method, size_t payload,
+                   Clock::time_point start, Clock::time_point measure_start, Clock::time_point end,
+                   std::atomic<uint64_t>* ticket, ThreadStats* stats) {
+    AzUser::UserServiceRpc_Stub stub(new AzRPC_Channel(false), google::protobuf::Service::STUB_OWNS_CHANNEL);
+    std::unique_ptr<google::protobuf::Message> request(stub.GetRequestPrototype(method).New());
+    std::unique_ptr<google::protobuf::Message> response(stub.GetResponsePrototype(method).New());
+    fill_payload(request.get(), payload);
+
+    const bool open_loop = options.mode == "open";
+    const std::chrono::nanoseconds interval(open_loop ? static_cast<int64_t>(1e9 / options.rate) : 0);
+    AzRPC_Controller controller;
+
+    while (true) {
+        Clock::time_point intended;
+        if (open_loop) {
+            // 领取下一个请求的计划发出时间, 发送线程忙不过来时请求会晚于计划发出, 这段时间计入延迟
+            intended = start + interval * ticket->fetch_add(1, std::memory_order_relaxed);
+            if (intended >= end) {
+                break;
+            }
+            std::this_thread::sleep_until(intended);
+        }
+        else {
+            intended = Clock::now();
+            if (intended >= end) {
+                break;
+            }
+        }
+
+        Clock::time_point issued = Clock::now();
+        controller.Reset();
+        response->Clear();
+        stub.CallMethod(method, &controller, request.get(), response.get(), nullptr);
+        Clock::time_point finished = Clock::now();
+
+        if (intended < measure_start) {
+            continue;   // 预热阶段
+        }
+        if (controller.Failed()) {
+            ++stats->failed;
+            continue;
+        }
+        ++stats->ok;
+        stats->last_finished = std::max(stats->last_finished, finished);
+        stats->latency_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(finished - intended).count());
+        stats->service_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(finished - issued).count());
+    }
+}
+
+static RunResult run_once(const BenchOptions& options, const google::protobuf::MethodDescriptor* method, size_t payload) {
+    std::vector<ThreadStats> stats(options.concurrency);
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> ticket(0);
+
+    // 预留线程启动时间, 所有调用方从同一时刻开始
+    Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+    Clock::time_point measure_start = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.warmup));
+    Clock::time_point end = measure_start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+
+    for (int i = 0; i < options.concurrency; ++i) {
+        threads.emplace_back([&options, method, payload, start, measure_start, end, &ticket, &stats, i]() {
+            std::this_thread::sleep_until(start);
+            caller(options, method, payload, start, measure_start, end, &ticket, &stats[i]);
+        });
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    RunResult result;
+    result.payload = payload;
+    // 吞吐按实际的统计窗口计算: 从统计开始到最后一个计入统计的调用完成, 包括计划时间之后才完成的调用
+    Clock::time_point last_finished = measure_start;
+    for (auto& s: stats) {
+        last_finished = std::max(last_finished, s.last_finished);
+        result.ok += s.ok;
+        result.failed += s.failed;
+        result.latency_ns.insert(result.latency_ns.end(), s.latency_ns.begin(), s.latency_ns.end());
+        result.service_ns.insert(result.service_ns.end(), s.service_ns.begin(), s.service_ns.end());
+    }
+    result.elapsed = std::chrono::duration<double>(last_finished - measure_start).count();
+    std::sort(result.latency_ns.begin(), result.latency_ns.end());
+    std::sort(result.service_ns.begin(), result.service_ns.end());
+    return result;
+}
+
+// 已排序样本的分位数(微秒)
+static double percentile_us(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>(p * sorted.size());
+    if (rank >= sorted.size()) {
+        rank = sorted.size() - 1;
+    }
+    return sorted[rank] / 1000.0;
+}
+
+static const double kPercentiles[] = {0.5, 0.9, 0.99, 0.999};
+static const char* const kPercentileNames[] = {"p50", "p90", "p99", "p99.9"};
+
+static void print_text(const BenchOptions& options, const RunResult& r) {
+    printf("mode=%s method=%s.%s payload=%zuB concurrency=%d", options.mode.c_str(), options.service.c_str(), options.method.c_str(), r.payload, options.concurrency);
+    if (options.mode == "open") {
+        printf(" rate=%.0f/s", options.rate);
+    }
+    printf("\n  requests   ok=%llu failed=%llu\n", (unsigned long long)r.ok, (unsigned long long)r.failed);
+    printf("  throughput %.1f req/s\n", r.elapsed > 0 ? r.ok / r.elapsed : 0.0);
+    printf("  latency(us)");
+    for (int i = 0; i < 4; ++i) {
+        printf(" %s=%.1f", kPercentileNames[i], percentile_us(r.latency_ns, kPercentiles[i]));
+    }
+    printf(" max=%.1f\n", r.latency_ns.empty() ? 0.0 : r.latency_ns.back() / 1000.0);
+    if (options.mode == "open") {
+        // 未修正的延迟, 与上面对比可以看出排队的影响
+        printf("  service(us)");
+        for (int i = 0; i < 4; ++i) {
+            printf(" %s=%.1f", kPercentileNames[i], percentile_us(r.service_ns, kPercentiles[i]));
+        }
+        printf("\n");
+    }
+}
+
+static void print_json(const BenchOptions& options, const std::vector<RunResult>& results) {
+    printf("{\"mode\":\"%s\",\"service\":\"%s\",\"method\":\"%s\",\"concurrency\":%d,\"rate\":%.1f,\"duration_s\":%.3f,\"warmup_s\":%.3f,\"results\":[",
+           options.mode.c_str(), options.service.c_str(), options.method.c_str(), options.concurrency,
+           options.mode == "open" ? options.rate : 0.0, options.duration, options.warmup);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult& r = results[i];
+        printf("%s{\"payload\":%zu,\"ok\":%llu,\"failed\":%llu,\"throughput\":%.3f,\"latency_us\":{",
+               i == 0 ? "" : ",", r.payload, (unsigned long long)r.ok, (unsigned long long)r.failed, r.elapsed > 0 ? r.ok / r.elapsed : 0.0);
+        for (int k = 0; k < 4; ++k) {
+            printf("\"%s\":%.3f,", kPercentileNames[k], percentile_us(r.latency_ns, kPercentiles[k]));
+        }
+        printf("\"max\":%.3f},\"service_us\":{", r.latency_ns.empty() ? 0.0 : r.latency_ns.back() / 1000.0);
+        for (int k = 0; k < 4; ++k) {
+            printf("%s\"%s\":%.3f", k == 0 ? "" : ",", kPercentileNames[k], percentile_us(r.service_ns, kPercentiles[k]));
+        }
+        printf("}}");
+    }
+    printf("]}\n");
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // 框架只认识-i参数, 把配置文件单独交给它
+    optind = 1;
+    const char* init_argv[] = {argv[0], "-i", options.config.c_str(), nullptr};
+    AzRPC_Application::Init(3, init_argv);
+
+    const google::protobuf::ServiceDescriptor* sd = AzUser::UserServiceRpc::descriptor();
+    const google::protobuf::MethodDescriptor* method = sd->FindMethodByName(options.method);
+    if (options.service != sd->name() || method == nullptr) {
+        std::cout << options.service << "." << options.method << " does not exist!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::thread server;
+    std::atomic<AzRPC_Provider*> provider(nullptr);
+    if (options.inproc && !start_inproc_server(options, &server, &provider)) {
+        std::cout << "start in-process server error" << std::endl;
+        server.detach();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<RunResult> results;
+    for (size_t payload: options.payloads) {
+        results.push_back(run_once(options, method, payload));
+        if (options.format != "json") {
+            print_text(options, results.back());
+        }
+    }
+    if (options.format != "text") {
+        print_json(options, results);
+    }
+
+    if (server.joinable()) {
+        // 服务端启动失败时Run已经返回, provider为空
+        AzRPC_Provider* running = provider.load();
+        if (running != nullptr) {
+            running->Stop();
+        }
+        server.join();
+    }
+    return 0;
+}
@@ -0,0 +1,391 @@
+#include "user.pb.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Compress.h"
+#include "AzRPC_Cork.h"
+#include "AzRPC_Crc32c.h"
+#include "AzRPC_Provider.h"
+#include <muduo/net/Buffer.h>
+#include <muduo/net/EventLoopThread.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+    AzRPC热路径的微基准, 全部在进程内运行, 只有响应用例经过本进程内的socketpair
+    覆盖: 请求帧编解码(RpcHeader + varint, 以及带CRC32C校验的版本)、按MSS分片到达时的帧重组、service_map/method_map查找、
+          请求对象New()与复用对比、响应的序列化、压缩、校验、附件和写合并直到写入socket
+    端到端压测的数字变化时, 用它定位是哪个阶段退化了
+*/
+
+typedef std::chrono::steady_clock Clock;
+
+struct MicroOptions {
+    double min_time = 0.5;                              // 每个用例至少运行的时间(秒)
+    std::vector<size_t> payloads{0, 64, 1024, 16384, 262144};
+    std::string filter;                                 // 只运行名字中包含该字符串的用例
+    std::string format = "text";                        // text | json | both
+};
+
+struct MicroResult {
+    std::string name;
+    size_t payload;
+    uint64_t iterations;
+    double ns_per_op;
+    double mb_per_s;
+};
+
+// 阻止编译器把基准中的计算当作无用代码删掉
+template <typename T>
+static inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// 发布给provider的示例服务, 只用于方法查找, 不会被调用
+class BenchUserService: public AzUser::UserServiceRpc {
+};
+
+static MicroOptions g_options;
+static std::vector<MicroResult> g_results;
+
+// 运行一个用例: 先试探出能跑满min_time的迭代次数, 再以该次数计时
+// items为每次调用body处理的操作数, bytes为每个操作处理的字节数
+static void run_bench(const std::string& name, size_t payload, uint64_t items, size_t bytes, const std::function<void()>& body) {
+    if (!g_options.filter.empty() && name.find(g_options.filter) == std::string::npos) {
+        return;
+    }
+
+    uint64_t iterations = 1;
+    double elapsed = 0;
+    while (true) {
+        Clock::time_point start = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed >= g_options.min_time || iterations >= (1ULL << 40)) {
+            break;
+        }
+        double scale = elapsed > 0 ? g_options.min_time * 1.2 / elapsed : 100;
+        iterations = static_cast<uint64_t>(iterations * (scale > 100 ? 100 : scale)) + 1;
+    }
+
+    MicroResult result;
+    result.name = name;
+    result.payload = payload;
+    result.iterations = iterations * items;
+    result.ns_per_op = elapsed * 1e9 / result.iterations;
+    result.mb_per_s = bytes > 0 ? bytes * result.iterations / elapsed / (1024 * 1024) : 0;
+    g_results.push_back(result);
+
+    if (g_options.format != "json") {
+        printf("%-28s payload=%-8zu %12.1f ns/op %10.1f MB/s  (%llu ops)\n", name.c_str(), payload, result.ns_per_op, result.mb_per_s, (unsigned long long)result.iterations);
+    }
+}
+
+// 构造一个带负载的Login请求帧
+static std::string make_request_frame(size_t payload, std::string* args) {
+    AzUser::LoginRequest request;
+    request.set_name(std::string(payload, 'x'));
+    request.set_pwd("0618");
+    request.SerializeToString(args);
+
+    AzRPC::RpcHeader header;
+    header.set_service_name("UserServiceRpc");
+    header.set_method_name("Login");
+    std::string frame;
+    AzRPC_Codec::EncodeRequest(&header, *args, &frame);
+    return frame;
+}
+
+static void bench_codec(size_t payload) {
+    std::string args;
+    std::string frame = make_request_frame(payload, &args);
+
+    AzRPC::RpcHeader header;
+    header.set_service_name("UserServiceRpc");
+    header.set_method_name("Login");
+    std::string out;
+    run_bench("codec/encode_request", payload, 1, frame.size(), [&]() {
+        out.clear();
+        AzRPC_Codec::EncodeRequest(&header, args, &out);
+        do_not_optimize(out);
+    });
+
+    AzRPC::RpcHeader decoded;
+    run_bench("codec/decode_request", payload, 1, frame.size(), [&]() {
+        size_t offset = 0;
+        int n = AzRPC_Codec::DecodeRequest(frame.data(), frame.size(), &decoded, &offset);
+        do_not_optimize(n);
+    });
+
+    // 带校验和的帧, 与上面的差值即为CRC32C的开销
+    header.set_checksum(true);
+    std::string checked_frame;
+    AzRPC_Codec::EncodeRequest(&header, args, &checked_frame);
+    run_bench("codec/encode_request_crc", payload, 1, checked_frame.size(), [&]() {
+        out.clear();
+        AzRPC_Codec::EncodeRequest(&header, args, &out);
+        do_not_optimize(out);
+    });
+    run_bench("codec/decode_request_crc", payload, 1, checked_frame.size(), [&]() {
+        size_t offset = 0;
+        int n = AzRPC_Codec::DecodeRequest(checked_frame.data(), checked_frame.size(), &decoded, &offset);
+        do_not_optimize(n);
+    });
+    run_bench(std::string("crc32c/") + AzRPC_Crc32c::Implementation(), payload, 1, frame.size(), [&]() {
+        uint32_t crc = AzRPC_Crc32c::Value(frame.data(), frame.size());
+        do_not_optimize(crc);
+    });
+}
+
+// 与AzRPC_Provider::OnMessage相同的重组逻辑: 数据按MSS大小分片写入muduo::Buffer, 每次可读后取出所有完整的帧
+static void bench_reassembly(size_t payload) {
+    std::string args;
+    std::string frame = make_request_frame(payload, &args);
+    const size_t kMss = 1460;
+    const uint64_t frames = frame.size() >= 64 * 1024 ? 4 : (64 * 1024) / frame.size() + 1;
+
+    std::string stream;
+    for (uint64_t i = 0; i < frames; ++i) {
+        stream += frame;
+    }
+
+    muduo::net::Buffer buffer;
+    AzRPC::RpcHeader header;
+    run_bench("reassembly/mss1460", payload, frames, frame.size(), [&]() {
+        uint64_t extracted = 0;
+        for (size_t offset = 0; offset < stream.size(); offset += kMss) {
+            size_t chunk = stream.size() - offset < kMss ? stream.size() - offset : kMss;
+            buffer.append(stream.data() + offset, chunk);
+            while (buffer.readableBytes() > 0) {
+                size_t args_offset = 0;
+                int frame_size = AzRPC_Codec::DecodeRequest(buffer.peek(), buffer.readableBytes(), &header, &args_offset);
+                if (frame_size <= 0) {
+                    break;
+                }
+                buffer.retrieve(frame_size);
+                ++extracted;
+            }
+        }
+        do_not_optimize(extracted);
+    });
+}
+
+static void bench_dispatch(AzRPC_Provider* provider) {
+    const std::string service_name = "UserServiceRpc";
+    const std::string method_name = "Register";
+    run_bench("dispatch/lookup", 0, 1, 0, [&]() {
+        google::protobuf::Service* service = nullptr;
+        const google::protobuf::MethodDescriptor* method = nullptr;
+        AzRPC::ErrorCode rt = provider->FindMethod(service_name, method_name, &service, &method);
+        do_not_optimize(rt);
+        do_not_optimize(method);
+    });
+}
+
+static void bench_message(AzRPC_Provider* provider, size_t payload) {
+    std::string args;
+    make_request_frame(payload, &args);
+
+    google::protobuf::Service* service = nullptr;
+    const google::protobuf::MethodDescriptor* method = nullptr;
+    provider->FindMethod("UserServiceRpc", "Login", &service, &method);
+
+    // 当前的做法: 每个请求New()出request/response, 用完释放
+    run_bench("message/new_parse", payload, 1, args.size(), [&]() {
+        google::protobuf::Message* request = service->GetRequestPrototype(method).New();
+        google::protobuf::Message* response = service->GetResponsePrototype(method).New();
+        request->ParseFromArray(args.data(), args.size());
+        do_not_optimize(request);
+        delete request;
+        delete response;
+    });
+
+    // 对照组: 复用同一对象, Clear()后再解析, 保留已分配的字符串容量
+    std::unique_ptr<google::protobuf::Message> request(service->GetRequestPrototype(method).New());
+    std::unique_ptr<google::protobuf::Message> response(service->GetResponsePrototype(method).New());
+    run_bench("message/pooled_parse", payload, 1, args.size(), [&]() {
+        request->Clear();
+        response->Clear();
+        request->ParseFromArray(args.data(), args.size());
+        do_not_optimize(request);
+    });
+}
+
+// 接收响应的连接: 在独立的IO线程中用socketpair的一端建立muduo::net::TcpConnection, 与服务端的Unix域连接相同
+// 另一端由drain线程读取并丢弃, 发送缓冲区不会一直堆积
+class ResponseSink {
+public:
+    ResponseSink() {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            perror("socketpair");
+            exit(EXIT_FAILURE);
+        }
+        fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+        m_peer = fds[1];
+        m_drain = std::thread([this] {
+            char buf[64 * 1024];
+            while (read(m_peer, buf, sizeof(buf)) > 0) {
+            }
+        });
+        m_loop = m_thread.startLoop();
+        m_connection = std::make_shared<muduo::net::TcpConnection>(m_loop, "microbench", fds[0], muduo::net::InetAddress(0), muduo::net::InetAddress(0));
+        m_connection->setConnectionCallback([](const muduo::net::TcpConnectionPtr&) {});
+        m_connection->setMessageCallback([](const muduo::net::TcpConnectionPtr&, muduo::net::Buffer* buffer, muduo::Timestamp) { buffer->retrieveAll(); });
+        m_connection->setCloseCallback([](const muduo::net::TcpConnectionPtr&) {});
+        RunAndWait([this] { m_connection->connectEstablished(); });
+    }
+
+    ~ResponseSink() {
+        RunAndWait([this] { m_connection->connectDestroyed(); });
+        // 释放连接时关闭socket, drain线程读到EOF后退出
+        m_connection.reset();
+        m_drain.join();
+        close(m_peer);
+    }
+
+    // 在IO线程中执行send, 等到本轮暂存的响应都写出后返回
+    void RunAndWait(const std::function<void()>& send) {
+        std::promise<void> done;
+        m_loop->runInLoop([&send, &done, this] {
+            send();
+            // 排在AzRPC_Cork::Flush之后执行
+            m_loop->queueInLoop([&done] { done.set_value(); });
+        });
+        done.get_future().wait();
+    }
+
+    const muduo::net::TcpConnectionPtr& Connection() const { return m_connection; }
+
+private:
+    muduo::net::EventLoopThread m_thread;
+    muduo::net::EventLoop* m_loop;
+    muduo::net::TcpConnectionPtr m_connection;
+    int m_peer;
+    std::thread m_drain;
+};
+
+// 与SendRpcResponse相同的路径: 序列化响应, 用AzRPC_Codec压缩并编码响应帧(按需带校验和与附件), 交给AzRPC_Cork暂存, 本轮末尾写入socket
+// 每轮在IO线程中发出kResponsesPerRound个响应, 与流水线请求在一次可读事件中得到处理相同, 写合并的收益计入结果
+static void bench_response(ResponseSink* sink, size_t payload) {
+    const uint64_t kResponsesPerRound = 64;
+    AzUser::LoginResponse response;
+    response.mutable_result()->set_errcode(0);
+    response.mutable_result()->set_errmsg(std::string(payload, 'x'));
+    response.set_success(true);
+    AzUser::LoginResponse small_response;
+    small_response.set_success(true);
+    AzRPC_Attachment attachment;
+    attachment.Append(std::string(payload, 'x'));
+
+    struct Variant {
+        std::string name;
+        bool checksum;
+        AzRPC::CompressType compress;
+        bool with_attachment;       // 负载作为响应附件, 不经过protobuf
+    };
+    std::vector<Variant> variants = {
+        {"response/send", false, AzRPC::COMPRESS_NONE, false},
+        {"response/send_crc", true, AzRPC::COMPRESS_NONE, false},
+        {"response/send_attachment", false, AzRPC::COMPRESS_NONE, true},
+        {"response/send_attachment_crc", true, AzRPC::COMPRESS_NONE, true},
+    };
+    for (AzRPC::CompressType type: {AzRPC::COMPRESS_LZ4, AzRPC::COMPRESS_ZSTD, AzRPC::COMPRESS_SNAPPY}) {
+        if (AzRPC_Compress::Supported(type)) {
+            variants.push_back(Variant{std::string("response/send_") + AzRPC_Compress::Name(type), false, type, false});
+        }
+    }
+
+    const AzRPC_Attachment empty;
+    for (const Variant& variant: variants) {
+        const google::protobuf::Message& message = variant.with_attachment ? static_cast<const google::protobuf::Message&>(small_response) : response;
+        const AzRPC_Attachment& response_attachment = variant.with_attachment ? attachment : empty;
+        size_t bytes = message.ByteSizeLong() + response_attachment.size();
+        run_bench(variant.name, payload, kResponsesPerRound, bytes, [&]() {
+            sink->RunAndWait([&]() {
+                for (uint64_t i = 0; i < kResponsesPerRound; ++i) {
+                    std::string response_str;
+                    std::string send_str;
+                    std::string trailer;
+                    AzRPC::RpcResponseHeader response_header;
+                    response_header.set_call_id(i);
+                    response_header.set_checksum(variant.checksum);
+                    message.SerializeToString(&response_str);
+                    AzRPC_Codec::EncodeResponse(&response_header, response_str, variant.compress, response_attachment, &send_str, &trailer);
+                    AzRPC_Cork::Send(sink->Connection(), send_str, response_attachment, trailer);
+                }
+            });
+        });
+    }
+}
+
+static void print_json() {
+    printf("{\"min_time_s\":%.3f,\"results\":[", g_options.min_time);
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const MicroResult& r = g_results[i];
+        printf("%s{\"name\":\"%s\",\"payload\":%zu,\"ops\":%llu,\"ns_per_op\":%.3f,\"mb_per_s\":%.3f}",
+               i == 0 ? "" : ",", r.name.c_str(), r.payload, (unsigned long long)r.iterations, r.ns_per_op, r.mb_per_s);
+    }
+    printf("]}\n");
+}
+
+int main(int argc, char* argv[]) {
+    static const struct option long_options[] = {
+        {"min-time", required_argument, nullptr, 't'},
+        {"payload", required_argument, nullptr, 'p'},
+        {"filter", required_argument, nullptr, 'F'},
+        {"format", required_argument, nullptr, 'f'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int o;
+    while (-1 != (o = getopt_long(argc, argv, "t:p:F:f:", long_options, nullptr))) {
+        switch (o) {
+            case 't': g_options.min_time = atof(optarg); break;
+            case 'F': g_options.filter = optarg; break;
+            case 'f': g_options.format = optarg; break;
+            case 'p': {
+                g_options.payloads.clear();
+                std::stringstream ss(optarg);
+                std::string item;
+                while (std::getline(ss, item, ',')) {
+                    g_options.payloads.push_back(strtoul(item.c_str(), nullptr, 10));
+                }
+                break;
+            }
+            default:
+                std::cout << "格式: " << argv[0] << " [--min-time S] [--payload 0,64,...] [--filter NAME] [--format text|json|both]" << std::endl;
+                return EXIT_FAILURE;
+        }
+    }
+
+    // 只注册服务, 不启动网络
+    AzRPC_Provider provider;
+    provider.NotifyService(new BenchUserService());
+
+    bench_dispatch(&provider);
+    ResponseSink sink;
+    for (size_t payload: g_options.payloads) {
+        bench_codec(payload);
+        bench_reassembly(payload);
+        bench_message(&provider, payload);
+        bench_response(&sink, payload);
+    }
+
+    if (g_options.format != "text") {
+        print_json();
+    }
+    return 0;
+}
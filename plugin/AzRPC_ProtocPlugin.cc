@@ -0,0 +1,442 @@
+// protoc-gen-azrpc: 为proto中的service生成AzRPC专用的服务基类和stub
+//
+//     protoc --plugin=protoc-gen-azrpc=bin/protoc-gen-azrpc --cpp_out=. --azrpc_out=. user.proto
+//
+// 每个xxx.proto生成xxx.azrpc.h和xxx.azrpc.cc, 每个service生成:
+// - <服务名>_AzService: 服务端基类, 实现AzRPC_Dispatcher, 按方法编号直接使用具体的消息类型分发, 不需要cc_generic_services
+// - <服务名>_AzStub: 调用方stub, 每个方法有同步(与protobuf的stub相同的形式)和返回AzRPC_Future的<方法名>Async两种调用方式
+// - <服务名>_AzCoStub: 以C++20编译时生成, co_await stub.<方法名>(request, &controller)得到响应
+// proto中声明为stream的方法在服务端为<方法名>(AzRPC_ServerStream*), 在stub中打开AzRPC_ClientStream
+#include <google/protobuf/compiler/code_generator.h>
+#include <google/protobuf/compiler/plugin.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <cctype>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef std::map<std::string, std::string> Vars;
+
+// 把text中的$name$替换为vars中的值
+std::string Substitute(const std::string& text, const Vars& vars) {
+    std::string out;
+    size_t pos = 0;
+    while (true) {
+        size_t begin = text.find('$', pos);
+        if (begin == std::string::npos) {
+            break;
+        }
+        size_t end = text.find('$', begin + 1);
+        if (end == std::string::npos) {
+            break;
+        }
+        out.append(text, pos, begin - pos);
+        auto it = vars.find(text.substr(begin + 1, end - begin - 1));
+        if (it != vars.end()) {
+            out.append(it->second);
+        }
+        pos = end + 1;
+    }
+    out.append(text, pos, std::string::npos);
+    return out;
+}
+
+std::string StripProto(const std::string& filename) {
+    const std::string suffix = ".proto";
+    if (filename.size() >= suffix.size() && filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        return filename.substr(0, filename.size() - suffix.size());
+    }
+    return filename;
+}
+
+std::vector<std::string> SplitPackage(const std::string& package) {
+    std::vector<std::string> parts;
+    size_t pos = 0;
+    while (!package.empty()) {
+        size_t dot = package.find('.', pos);
+        parts.push_back(package.substr(pos, dot == std::string::npos ? std::string::npos : dot - pos));
+        if (dot == std::string::npos) {
+            break;
+        }
+        pos = dot + 1;
+    }
+    return parts;
+}
+
+// 消息的C++类型全名, 嵌套消息与protobuf一致以下划线连接: pkg.Outer.Inner -> ::pkg::Outer_Inner
+std::string ClassName(const google::protobuf::Descriptor* descriptor) {
+    std::string name = descriptor->name();
+    for (const google::protobuf::Descriptor* outer = descriptor->containing_type(); outer != nullptr; outer = outer->containing_type()) {
+        name = outer->name() + "_" + name;
+    }
+    std::string prefix = "::";
+    for (const std::string& part: SplitPackage(descriptor->file()->package())) {
+        prefix += part + "::";
+    }
+    return prefix + name;
+}
+
+bool IsStream(const google::protobuf::MethodDescriptor* method) {
+    return method->client_streaming() || method->server_streaming();
+}
+
+Vars MethodVars(const google::protobuf::MethodDescriptor* method) {
+    Vars vars;
+    vars["service"] = method->service()->name();
+    vars["method"] = method->name();
+    vars["index"] = std::to_string(method->index());
+    vars["request"] = ClassName(method->input_type());
+    vars["response"] = ClassName(method->output_type());
+    return vars;
+}
+
+void GenerateServiceHeader(const google::protobuf::ServiceDescriptor* service, std::string* out) {
+    Vars vars;
+    vars["service"] = service->name();
+
+    out->append(Substitute(
+        "// 服务端基类: 继承并重写业务方法, 用AzRPC_Provider::NotifyService发布\n"
+        "class $service$_AzService: public AzRPC_Dispatcher {\n"
+        "public:\n"
+        "    // 方法编号, 与proto中的声明顺序一致\n"
+        "    enum MethodId {\n", vars));
+    for (int i = 0; i < service->method_count(); ++i) {
+        out->append(Substitute("        k$method$ = $index$,\n", MethodVars(service->method(i))));
+    }
+    out->append(
+        "    };\n"
+        "\n"
+        "    static const ::google::protobuf::ServiceDescriptor* descriptor();\n"
+        "\n");
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (IsStream(method)) {
+            out->append(Substitute(
+                "    // 流式方法, 读取$request$, 写入$response$\n"
+                "    virtual void $method$(AzRPC_ServerStream* stream);\n", MethodVars(method)));
+        }
+        else {
+            out->append(Substitute(
+                "    virtual void $method$(::google::protobuf::RpcController* controller, const $request$* request, $response$* response, ::google::protobuf::Closure* done);\n",
+                MethodVars(method)));
+        }
+    }
+    out->append(
+        "\n"
+        "    const ::google::protobuf::ServiceDescriptor* GetDescriptor() override;\n"
+        "    const ::google::protobuf::Message& GetRequestPrototype(const ::google::protobuf::MethodDescriptor* method) const override;\n"
+        "    const ::google::protobuf::Message& GetResponsePrototype(const ::google::protobuf::MethodDescriptor* method) const override;\n"
+        "    ::google::protobuf::Message* NewRequest(int method_index) const override;\n"
+        "    ::google::protobuf::Message* NewResponse(int method_index) const override;\n"
+        "    void Dispatch(int method_index, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request,\n"
+        "                  ::google::protobuf::Message* response, ::google::protobuf::Closure* done) override;\n"
+        "    void DispatchStream(int method_index, AzRPC_ServerStream* stream) override;\n"
+        "};\n"
+        "\n");
+
+    out->append(Substitute(
+        "// 调用方stub\n"
+        "class $service$_AzStub {\n"
+        "public:\n"
+        "    explicit $service$_AzStub(::google::protobuf::RpcChannel* channel): m_channel(channel) {}\n"
+        "    ::google::protobuf::RpcChannel* channel() const { return m_channel; }\n"
+        "\n", vars));
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (IsStream(method)) {
+            out->append(Substitute(
+                "    // 打开流式调用, 写入$request$, 读取$response$; channel必须是AzRPC_Channel\n"
+                "    std::unique_ptr<AzRPC_ClientStream> $method$(AzRPC_Controller* controller);\n", MethodVars(method)));
+        }
+        else {
+            out->append(Substitute(
+                "    // done为nullptr时同步调用\n"
+                "    void $method$(::google::protobuf::RpcController* controller, const $request$* request, $response$* response, ::google::protobuf::Closure* done);\n"
+                "    // 异步调用, 见AzRPC_Channel::CallAsync\n"
+                "    AzRPC_Future<$response$> $method$Async(const $request$& request, AzRPC_Controller* controller = nullptr);\n",
+                MethodVars(method)));
+        }
+    }
+    out->append(
+        "\n"
+        "private:\n"
+        "    ::google::protobuf::RpcChannel* m_channel;\n"
+        "};\n"
+        "\n");
+
+    out->append(Substitute(
+        "#if defined(__cpp_impl_coroutine)\n"
+        "// 协程stub, 见AzRPC_Coro.h\n"
+        "class $service$_AzCoStub {\n"
+        "public:\n"
+        "    explicit $service$_AzCoStub(::google::protobuf::RpcChannel* channel): m_channel(channel) {}\n"
+        "\n", vars));
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (!IsStream(method)) {
+            out->append(Substitute(
+                "    auto $method$(const $request$& request, AzRPC_Controller* controller) {\n"
+                "        return AzRPC_Call(m_channel, &$service$_AzStub::$method$, request, controller);\n"
+                "    }\n", MethodVars(method)));
+        }
+    }
+    out->append(
+        "\n"
+        "private:\n"
+        "    ::google::protobuf::RpcChannel* m_channel;\n"
+        "};\n"
+        "#endif\n"
+        "\n");
+}
+
+void GenerateServiceSource(const google::protobuf::ServiceDescriptor* service, std::string* out) {
+    Vars vars;
+    vars["service"] = service->name();
+    vars["full_name"] = service->full_name();
+
+    out->append(Substitute(
+        "const ::google::protobuf::ServiceDescriptor* $service$_AzService::descriptor() {\n"
+        "    static const ::google::protobuf::ServiceDescriptor* descriptor = ::google::protobuf::DescriptorPool::generated_pool()->FindServiceByName(\"$full_name$\");\n"
+        "    return descriptor;\n"
+        "}\n"
+        "\n", vars));
+
+    // 默认实现
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (IsStream(method)) {
+            out->append(Substitute(
+                "void $service$_AzService::$method$(AzRPC_ServerStream* stream) {\n"
+                "    stream->Finish(\"Method $method$() not implemented.\");\n"
+                "}\n"
+                "\n", MethodVars(method)));
+        }
+        else {
+            out->append(Substitute(
+                "void $service$_AzService::$method$(::google::protobuf::RpcController* controller, const $request$*, $response$*, ::google::protobuf::Closure* done) {\n"
+                "    controller->SetFailed(\"Method $method$() not implemented.\");\n"
+                "    done->Run();\n"
+                "}\n"
+                "\n", MethodVars(method)));
+        }
+    }
+
+    out->append(Substitute(
+        "const ::google::protobuf::ServiceDescriptor* $service$_AzService::GetDescriptor() {\n"
+        "    return descriptor();\n"
+        "}\n"
+        "\n", vars));
+
+    // 按方法编号选择具体类型
+    struct Switch {
+        const char* signature;
+        const char* body;
+        const char* fallback;
+    };
+    const Switch switches[] = {
+        {"const ::google::protobuf::Message& $service$_AzService::GetRequestPrototype(const ::google::protobuf::MethodDescriptor* method) const {\n"
+         "    switch (method->index()) {\n",
+         "    case k$method$:\n"
+         "        return $request$::default_instance();\n",
+         "    default:\n"
+         "        return *::google::protobuf::MessageFactory::generated_factory()->GetPrototype(method->input_type());\n"},
+        {"const ::google::protobuf::Message& $service$_AzService::GetResponsePrototype(const ::google::protobuf::MethodDescriptor* method) const {\n"
+         "    switch (method->index()) {\n",
+         "    case k$method$:\n"
+         "        return $response$::default_instance();\n",
+         "    default:\n"
+         "        return *::google::protobuf::MessageFactory::generated_factory()->GetPrototype(method->output_type());\n"},
+        {"::google::protobuf::Message* $service$_AzService::NewRequest(int method_index) const {\n"
+         "    switch (method_index) {\n",
+         "    case k$method$:\n"
+         "        return new $request$();\n",
+         "    default:\n"
+         "        return nullptr;\n"},
+        {"::google::protobuf::Message* $service$_AzService::NewResponse(int method_index) const {\n"
+         "    switch (method_index) {\n",
+         "    case k$method$:\n"
+         "        return new $response$();\n",
+         "    default:\n"
+         "        return nullptr;\n"},
+    };
+    for (const Switch& item: switches) {
+        out->append(Substitute(item.signature, vars));
+        for (int i = 0; i < service->method_count(); ++i) {
+            out->append(Substitute(item.body, MethodVars(service->method(i))));
+        }
+        out->append(item.fallback);
+        out->append(
+            "    }\n"
+            "}\n"
+            "\n");
+    }
+
+    out->append(Substitute(
+        "void $service$_AzService::Dispatch(int method_index, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request,\n"
+        "                                   ::google::protobuf::Message* response, ::google::protobuf::Closure* done) {\n"
+        "    switch (method_index) {\n", vars));
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (!IsStream(method)) {
+            out->append(Substitute(
+                "    case k$method$:\n"
+                "        $method$(controller, static_cast<const $request$*>(request), static_cast<$response$*>(response), done);\n"
+                "        break;\n", MethodVars(method)));
+        }
+    }
+    out->append(
+        "    default:\n"
+        "        controller->SetFailed(\"stream method must be called through a stream\");\n"
+        "        done->Run();\n"
+        "        break;\n"
+        "    }\n"
+        "}\n"
+        "\n");
+
+    out->append(Substitute(
+        "void $service$_AzService::DispatchStream(int method_index, AzRPC_ServerStream* stream) {\n"
+        "    switch (method_index) {\n", vars));
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (IsStream(method)) {
+            out->append(Substitute(
+                "    case k$method$:\n"
+                "        $method$(stream);\n"
+                "        break;\n", MethodVars(method)));
+        }
+    }
+    out->append(
+        "    default:\n"
+        "        stream->Finish(\"not a stream method\");\n"
+        "        break;\n"
+        "    }\n"
+        "}\n"
+        "\n");
+
+    // stub
+    for (int i = 0; i < service->method_count(); ++i) {
+        const google::protobuf::MethodDescriptor* method = service->method(i);
+        if (IsStream(method)) {
+            out->append(Substitute(
+                "std::unique_ptr<AzRPC_ClientStream> $service$_AzStub::$method$(AzRPC_Controller* controller) {\n"
+                "    AzRPC_Channel* channel = dynamic_cast<AzRPC_Channel*>(m_channel);\n"
+                "    if (channel == nullptr) {\n"
+                "        controller->SetFailed(\"stream call requires AzRPC_Channel\");\n"
+                "        return nullptr;\n"
+                "    }\n"
+                "    return channel->OpenStream($service$_AzService::descriptor()->method($service$_AzService::k$method$), controller);\n"
+                "}\n"
+                "\n", MethodVars(method)));
+        }
+        else {
+            out->append(Substitute(
+                "void $service$_AzStub::$method$(::google::protobuf::RpcController* controller, const $request$* request, $response$* response, ::google::protobuf::Closure* done) {\n"
+                "    m_channel->CallMethod($service$_AzService::descriptor()->method($service$_AzService::k$method$), controller, request, response, done);\n"
+                "}\n"
+                "\n"
+                "AzRPC_Future<$response$> $service$_AzStub::$method$Async(const $request$& request, AzRPC_Controller* controller) {\n"
+                "    return AzRPC_CallAsync(m_channel, &$service$_AzStub::$method$, request, controller);\n"
+                "}\n"
+                "\n", MethodVars(method)));
+        }
+    }
+}
+
+std::string OpenNamespaces(const google::protobuf::FileDescriptor* file) {
+    std::string out;
+    for (const std::string& part: SplitPackage(file->package())) {
+        out += "namespace " + part + " {\n";
+    }
+    return out;
+}
+
+std::string CloseNamespaces(const google::protobuf::FileDescriptor* file) {
+    std::vector<std::string> parts = SplitPackage(file->package());
+    std::string out;
+    for (auto it = parts.rbegin(); it != parts.rend(); ++it) {
+        out += "}  // namespace " + *it + "\n";
+    }
+    return out;
+}
+
+std::string HeaderGuard(const std::string& basename) {
+    std::string guard = "_AzRPC_GENERATED_";
+    for (char c: basename) {
+        guard += isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    return guard + "_AZRPC_H_";
+}
+
+class AzRPC_Generator: public google::protobuf::compiler::CodeGenerator {
+public:
+    bool Generate(const google::protobuf::FileDescriptor* file, const std::string& parameter,
+                  google::protobuf::compiler::GeneratorContext* context, std::string* error) const override {
+        if (file->service_count() == 0) {
+            return true;
+        }
+        std::string basename = StripProto(file->name());
+        Vars vars;
+        vars["proto"] = file->name();
+        vars["basename"] = basename;
+        vars["guard"] = HeaderGuard(basename);
+
+        std::string header = Substitute(
+            "// 由protoc-gen-azrpc根据$proto$生成, 不要手动修改\n"
+            "#ifndef $guard$\n"
+            "#define $guard$\n"
+            "\n"
+            "#include \"$basename$.pb.h\"\n"
+            "#include \"AzRPC_Dispatcher.h\"\n"
+            "#include \"AzRPC_Controller.h\"\n"
+            "#include \"AzRPC_Channel.h\"\n"
+            "#include \"AzRPC_Future.h\"\n"
+            "#include \"AzRPC_Stream.h\"\n"
+            "#include <memory>\n"
+            "#if defined(__cpp_impl_coroutine)\n"
+            "#include \"AzRPC_Coro.h\"\n"
+            "#endif\n"
+            "\n", vars);
+        header += OpenNamespaces(file) + "\n";
+        for (int i = 0; i < file->service_count(); ++i) {
+            GenerateServiceHeader(file->service(i), &header);
+        }
+        header += CloseNamespaces(file) + "\n#endif\n";
+
+        std::string source = Substitute(
+            "// 由protoc-gen-azrpc根据$proto$生成, 不要手动修改\n"
+            "#include \"$basename$.azrpc.h\"\n"
+            "#include <google/protobuf/message.h>\n"
+            "\n", vars);
+        source += OpenNamespaces(file) + "\n";
+        for (int i = 0; i < file->service_count(); ++i) {
+            GenerateServiceSource(file->service(i), &source);
+        }
+        source += CloseNamespaces(file);
+
+        return Write(context, basename + ".azrpc.h", header) && Write(context, basename + ".azrpc.cc", source);
+    }
+
+    uint64_t GetSupportedFeatures() const override {
+        return FEATURE_PROTO3_OPTIONAL;
+    }
+
+private:
+    static bool Write(google::protobuf::compiler::GeneratorContext* context, const std::string& filename, const std::string& content) {
+        std::unique_ptr<google::protobuf::io::ZeroCopyOutputStream> output(context->Open(filename));
+        google::protobuf::io::CodedOutputStream coded(output.get());
+        coded.WriteRaw(content.data(), static_cast<int>(content.size()));
+        return !coded.HadError();
+    }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    AzRPC_Generator generator;
+    return google::protobuf::compiler::PluginMain(argc, argv, &generator);
+}
@@ -0,0 +1,63 @@
+#include "AzRPC_Attachment.h"
+#include "AzRPC_Crc32c.h"
+
+void AzRPC_Attachment::Append(const char* data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    Append(std::string(data, len));
+}
+
+void AzRPC_Attachment::Append(std::string&& data) {
+    if (data.empty()) {
+        return;
+    }
+    std::shared_ptr<std::string> owner = std::make_shared<std::string>(std::move(data));
+    AppendRef(owner->data(), owner->size(), owner);
+}
+
+void AzRPC_Attachment::AppendRef(const char* data, size_t len, std::shared_ptr<const void> owner) {
+    if (len == 0) {
+        return;
+    }
+    m_blocks.push_back(Block{data, len, std::move(owner)});
+    m_size += len;
+}
+
+// 共享other的块, 不拷贝数据
+void AzRPC_Attachment::Append(const AzRPC_Attachment& other) {
+    for (const Block& block: other.m_blocks) {
+        AppendRef(block.data, block.size, block.owner);
+    }
+}
+
+void AzRPC_Attachment::Clear() {
+    m_blocks.clear();
+    m_size = 0;
+}
+
+void AzRPC_Attachment::AppendIovec(std::vector<struct iovec>* iov) const {
+    for (const Block& block: m_blocks) {
+        iov->push_back(iovec{const_cast<char*>(block.data), block.size});
+    }
+}
+
+void AzRPC_Attachment::AppendTo(std::string* out) const {
+    out->reserve(out->size() + m_size);
+    for (const Block& block: m_blocks) {
+        out->append(block.data, block.size);
+    }
+}
+
+std::string AzRPC_Attachment::ToString() const {
+    std::string out;
+    AppendTo(&out);
+    return out;
+}
+
+uint32_t AzRPC_Attachment::ExtendCrc32c(uint32_t crc) const {
+    for (const Block& block: m_blocks) {
+        crc = AzRPC_Crc32c::Extend(crc, block.data, block.size);
+    }
+    return crc;
+}
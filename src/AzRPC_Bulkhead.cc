@@ -0,0 +1,48 @@
+#include "AzRPC_Bulkhead.h"
+#include "AzRPC_Metrics.h"
+
+AzRPC_Bulkhead::AzRPC_Bulkhead(const std::string& name, size_t max_concurrency, size_t max_queue, std::function<void(Task)> resume)
+    : m_max_concurrency(max_concurrency),
+      m_max_queue(max_queue),
+      m_inflight(0),
+      m_resume(std::move(resume)),
+      m_queued(AzRPC_Metrics::Counter(name + "_queued")),
+      m_rejected(AzRPC_Metrics::Counter(name + "_rejected")) {}
+
+bool AzRPC_Bulkhead::TryAcquire() {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_inflight >= m_max_concurrency) {
+        return false;
+    }
+    ++m_inflight;
+    return true;
+}
+
+AzRPC_Bulkhead::Result AzRPC_Bulkhead::Wait(Task task) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_inflight < m_max_concurrency) {
+        ++m_inflight;
+        return kAcquired;
+    }
+    if (m_waiting.size() >= m_max_queue) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return kRejected;
+    }
+    m_waiting.push_back(std::move(task));
+    m_queued.fetch_add(1, std::memory_order_relaxed);
+    return kQueued;
+}
+
+void AzRPC_Bulkhead::Release() {
+    Task next;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_waiting.empty()) {
+            --m_inflight;
+            return;
+        }
+        next = std::move(m_waiting.front());
+        m_waiting.pop_front();
+    }
+    m_resume(std::move(next));
+}
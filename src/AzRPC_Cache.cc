@@ -0,0 +1,110 @@
+#include "AzRPC_Cache.h"
+#include "AzRPC_Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+namespace {
+
+// 每项除了键和值之外的固定开销(链表节点、哈希表节点、Value对象)
+const size_t kEntryOverhead = 128;
+
+}  // namespace
+
+AzRPC_Cache::AzRPC_Cache(const std::string& name, size_t max_bytes, size_t shard_count)
+    : m_hit(AzRPC_Metrics::Counter(name + "_hit")),
+      m_miss(AzRPC_Metrics::Counter(name + "_miss")),
+      m_evict(AzRPC_Metrics::Counter(name + "_evict")) {
+    shard_count = std::max<size_t>(1, shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        m_shards.emplace_back(new Shard());
+    }
+    m_shard_capacity = max_bytes / shard_count;
+}
+
+AzRPC_Cache::ValuePtr AzRPC_Cache::Get(const std::string& key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        m_miss.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    if (it->second->expire_us <= NowMicros()) {
+        Remove(shard, it->second);
+        m_miss.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    // 移到表头
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    m_hit.fetch_add(1, std::memory_order_relaxed);
+    return it->second->value;
+}
+
+void AzRPC_Cache::Put(const std::string& key, ValuePtr value, int64_t ttl_ms) {
+    size_t charge = key.size() + value->data.size() + value->attachment.size() + kEntryOverhead;
+    if (ttl_ms <= 0 || charge > m_shard_capacity) {
+        return;
+    }
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        Remove(shard, it->second);
+    }
+    shard.lru.push_front(Entry{key, std::move(value), NowMicros() + ttl_ms * 1000, charge});
+    shard.index[key] = shard.lru.begin();
+    shard.bytes += charge;
+    while (shard.bytes > m_shard_capacity) {
+        Remove(shard, std::prev(shard.lru.end()));
+        m_evict.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AzRPC_Cache::Erase(const std::string& key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        Remove(shard, it->second);
+    }
+}
+
+size_t AzRPC_Cache::ErasePrefix(const std::string& prefix) {
+    size_t erased = 0;
+    for (auto& shard: m_shards) {
+        std::lock_guard<std::mutex> lock(shard->mtx);
+        for (auto it = shard->lru.begin(); it != shard->lru.end();) {
+            auto next = std::next(it);
+            if (it->key.compare(0, prefix.size(), prefix) == 0) {
+                Remove(*shard, it);
+                ++erased;
+            }
+            it = next;
+        }
+    }
+    return erased;
+}
+
+size_t AzRPC_Cache::Bytes() const {
+    size_t bytes = 0;
+    for (auto& shard: m_shards) {
+        std::lock_guard<std::mutex> lock(shard->mtx);
+        bytes += shard->bytes;
+    }
+    return bytes;
+}
+
+AzRPC_Cache::Shard& AzRPC_Cache::ShardFor(const std::string& key) {
+    return *m_shards[std::hash<std::string>()(key) % m_shards.size()];
+}
+
+void AzRPC_Cache::Remove(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->charge;
+    shard.index.erase(it->key);
+    shard.lru.erase(it);
+}
+
+int64_t AzRPC_Cache::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -1,122 +1,887 @@
 #include "AzRPC_Channel.h"
 #include "AzRPC_Header.pb.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Compress.h"
+#include "AzRPC_SingleFlight.h"
+#include "AzRPC_Cache.h"
 #include "ZooKeeperUtil.h"
 #include "AzRPC_Application.h"
 #include "AzRPC_Controller.h"
+#include "AzRPC_Trace.h"
+#include "AzRPC_Scheduler.h"
+#include <algorithm>
+#include <functional>
+#include <future>
 #include <memory>
+#include <climits>
+#include <cstring>
 #include <error.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include "AzRPC_Logger.h"
 
 std::mutex global_data_mtx;     // 全局互斥锁, 用于保护共享数据的线程安全
 
 // RPC调用的核心方法, 将客户端的请求序列化并发送到服务端, 同时接收服务端的响应
+// done为nullptr时同步调用, 返回时调用已经完成; 否则在调用完成后执行done
+// 配置了客户端IO引擎(client_io_engine)时由AzRPC_ClientLoop收发, 异步调用立即返回, done在IO线程中执行
 void AzRPC_Channel::CallMethod(const ::google::protobuf::MethodDescriptor *method, ::google::protobuf::RpcController *controller, const ::google::protobuf::Message *request,::google::protobuf::Message *response, ::google::protobuf::Closure *done) {
-    if (m_clientfd != -1) {
-        // 客户端socket未初始化, 获取服务对象名和方法名
-        const google::protobuf::ServiceDescriptor* sd = method->service();
-        service_name = sd->name();
-        method_name = method->name();
-
-        // 客户端需要查询ZooKee, 找到提供服务的服务器地址
-        ZkClient zkClient;
-        zkClient.Start();
-        // 查询服务器地址
-        std::string host_data = QueryServiceHost(&zkClient, service_name, method_name, m_idx);
-        m_ip = host_data.substr(0, m_idx);  // 从查询结果中获取ip地址
-        std::cout << "ip: " << m_ip << std::endl;
-        m_port = atoi(host_data.substr(m_idx + 1, host_data.size() - m_idx).c_str());
-        std::cout << "port: " << m_port << std::endl;
-
-        // 尝试连接服务器
-        auto rt = newConnect(m_ip.c_str(), m_port);
-        if (!rt) {
-            LOG(ERROR) << "connect server error";
+    // 同一个channel可以调用服务中的不同方法, 也可以被多个线程同时调用, 方法随调用逐层传递, 不保存在channel上
+    // 开启了响应缓存的方法, 命中时直接返回缓存的响应
+    int64_t cache_ttl_ms = CacheTtlMs(method->service()->name(), method->name());
+    if (cache_ttl_ms > 0 && CallCached(cache_ttl_ms, method, controller, request, response, done)) {
+        return;
+    }
+    CallUncached(method, controller, request, response, done);
+}
+
+// 开启了请求合并的方法, 相同的调用正在进行时等待它的结果
+void AzRPC_Channel::CallUncached(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done) {
+    if (AzRPC_SingleFlight::Enabled(method->service()->name(), method->name()) && CallCoalesced(method, controller, request, response, done)) {
+        return;
+    }
+    Dispatch(method, controller, request, response, done);
+}
+
+// 按客户端IO引擎的配置发出调用
+void AzRPC_Channel::Dispatch(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done) {
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (loop != nullptr) {
+        CallInLoop(loop, method, controller, request, response, done);
+        return;
+    }
+    CallBlocking(method, controller, request, response);
+    if (done != nullptr) {
+        done->Run();
+    }
+}
+
+namespace {
+
+// 执行一次后删除自己的Closure, 用于在done之前插入额外的处理
+class FunctionClosure: public google::protobuf::Closure {
+public:
+    explicit FunctionClosure(std::function<void()> function): m_function(std::move(function)) {}
+    void Run() override {
+        m_function();
+        delete this;
+    }
+
+private:
+    std::function<void()> m_function;
+};
+
+// 进程内所有channel共享的响应缓存, 容量rpc_cache_bytes(默认64MB), 分片数rpc_cache_shards(默认16)
+AzRPC_Cache& ResponseCache() {
+    static AzRPC_Cache* cache = [] {
+        AzRPC_Config& config = AzRPC_Application::GetConfig();
+        std::string bytes = config.Load("rpc_cache_bytes");
+        std::string shards = config.Load("rpc_cache_shards");
+        return new AzRPC_Cache("client_cache", bytes.empty() ? (64 << 20) : strtoul(bytes.c_str(), nullptr, 10), shards.empty() ? 16 : strtoul(shards.c_str(), nullptr, 10));
+    }();
+    return *cache;
+}
+
+}  // namespace
+
+// 方法的缓存有效期, 依次查找rpc_cache_ttl_ms.<服务名>.<方法名>、rpc_cache_ttl_ms.<服务名>、rpc_cache_ttl_ms, 0表示不缓存
+int64_t AzRPC_Channel::CacheTtlMs(const std::string& service_name, const std::string& method_name) {
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpc_cache_ttl_ms");
+    if (!configured) {
+        return 0;
+    }
+    return atoll(AzRPC_Application::GetConfig().LoadForMethod("rpc_cache_ttl_ms", service_name, method_name).c_str());
+}
+
+// 方法的优先级类别, 依次查找rpc_priority.<服务名>.<方法名>、rpc_priority.<服务名>、rpc_priority, 默认normal
+AzRPC::Priority AzRPC_Channel::PriorityForMethod(const std::string& service_name, const std::string& method_name) {
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpc_priority");
+    AzRPC::Priority priority = AzRPC::PRIORITY_NORMAL;
+    if (configured) {
+        AzRPC_Scheduler::ParsePriority(AzRPC_Application::GetConfig().LoadForMethod("rpc_priority", service_name, method_name), &priority);
+    }
+    return priority;
+}
+
+// 响应缓存: 键为方法和序列化后的请求参数, 命中时把缓存的响应解析到response, 不发出调用
+// 未命中时正常调用, 成功后把响应放入缓存; 不适用时返回false
+bool AzRPC_Channel::CallCached(int64_t ttl_ms, const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done) {
+    // 带请求附件的调用不缓存, 键里没有附件的内容
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    if (az_controller != nullptr && !az_controller->RequestAttachment().empty()) {
+        return false;
+    }
+    std::string key;
+    if (!AzRPC_SingleFlight::MakeKey(method->service()->name(), method->name(), *request, &key)) {
+        return false;
+    }
+
+    AzRPC_Cache::ValuePtr value = ResponseCache().Get(key);
+    if (value) {
+        if (!response->ParseFromString(value->data)) {
+            controller->SetFailed("parse cached response error");
+        }
+        else if (az_controller != nullptr) {
+            az_controller->ResponseAttachment().Clear();
+            az_controller->ResponseAttachment().Append(value->attachment);
+        }
+        if (done != nullptr) {
+            done->Run();
+        }
+        return true;
+    }
+
+    // 只缓存成功的响应
+    auto store = [key, ttl_ms, controller, response, az_controller] {
+        if (controller->Failed()) {
             return;
         }
+        std::shared_ptr<AzRPC_Cache::Value> entry = std::make_shared<AzRPC_Cache::Value>();
+        if (!response->SerializeToString(&entry->data)) {
+            return;
+        }
+        if (az_controller != nullptr) {
+            entry->attachment.Append(az_controller->ResponseAttachment());
+        }
+        ResponseCache().Put(key, entry, ttl_ms);
+    };
+    if (done == nullptr) {
+        CallUncached(method, controller, request, response, nullptr);
+        store();
+        return true;
+    }
+    CallUncached(method, controller, request, response, new FunctionClosure([store, done] {
+        store();
+        done->Run();
+    }));
+    return true;
+}
+
+// 请求合并: 第一个调用正常发出, 结束后把结果交给期间加入的相同调用; 不适用时返回false, 由调用方正常发出
+// 等待者的done在发出调用的那一次完成的线程中执行
+bool AzRPC_Channel::CallCoalesced(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done) {
+    // 带附件的请求不参与合并; IO线程中的同步调用由CallInLoop报错
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    if (az_controller != nullptr && !az_controller->RequestAttachment().empty()) {
+        return false;
+    }
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (done == nullptr && loop != nullptr && loop->InLoopThread()) {
+        return false;
+    }
+    std::string key;
+    if (!AzRPC_SingleFlight::MakeKey(method->service()->name(), method->name(), *request, &key)) {
+        return false;
+    }
+
+    AzRPC_SingleFlight& flight = AzRPC_SingleFlight::Instance();
+    if (done == nullptr) {
+        std::promise<void> finished;
+        std::future<void> future = finished.get_future();
+        if (!flight.Join(key, [controller, response, &finished](const AzRPC_SingleFlight::Result& result) {
+                AzRPC_SingleFlight::Apply(result, controller, response);
+                finished.set_value();
+            })) {
+            future.wait();
+            return true;
+        }
+        Dispatch(method, controller, request, response, nullptr);
+        flight.Finish(key, controller, response);
+        return true;
+    }
+
+    if (!flight.Join(key, [controller, response, done](const AzRPC_SingleFlight::Result& result) {
+            AzRPC_SingleFlight::Apply(result, controller, response);
+            done->Run();
+        })) {
+        return true;
+    }
+    Dispatch(method, controller, request, response, new FunctionClosure([key, controller, response, done] {
+        AzRPC_SingleFlight::Instance().Finish(key, controller, response);
+        done->Run();
+    }));
+    return true;
+}
+
+// 查询服务地址并新建一条连接交给流, channel原有的连接保持不变
+std::unique_ptr<AzRPC_ClientStream> AzRPC_Channel::OpenStream(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller) {
+    // Connect把新连接写入m_clientfd, 在锁内暂时换出原有的连接, 其他线程的调用不会看到流的连接
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_conn_mtx);
+        int saved_fd = m_clientfd;
+        m_clientfd = -1;
+        bool connected = Connect(method, controller, false);
+        fd = m_clientfd;
+        m_clientfd = saved_fd;
+        if (!connected) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<AzRPC_ClientStream> stream(new AzRPC_ClientStream(fd, AzRPC_ClientLoop::NextCallId(), ChecksumEnabled()));
+    if (!stream->Open(method->service()->name(), method->name())) {
+        controller->SetFailed(stream->ErrorText());
+        return nullptr;
+    }
+    return stream;
+}
+
+// 阻塞模式: 在调用线程中发送请求并等待响应
+void AzRPC_Channel::CallBlocking(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response) {
+    // 连接上同时只能有一个请求在等待响应, 其他线程的阻塞调用等这一次收发完成
+    std::lock_guard<std::mutex> lock(m_conn_mtx);
+    // 客户端socket未初始化(或上次调用出错后已关闭), 需要重新连接
+    if (m_clientfd == -1 && !Connect(method, controller, true)) {
+        return;
+    }
+
+    CallState state;
+    std::string send_rpc_str;
+    std::string trailer;
+    if (!BuildRequest(method, request, controller, 0, ChecksumEnabled(), &state, &send_rpc_str, &trailer)) {
+        return;
+    }
+
+    // 发送RPC请求到服务器, 请求附件直接从调用方的内存发送
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    AzRPC::RpcResponseHeader response_header;
+    size_t body_offset = 0;
+    if (!Exchange(send_rpc_str, az_controller != nullptr ? &az_controller->RequestAttachment() : nullptr, trailer, &response_header, &body_offset, controller)) {
+        return;
+    }
+    // 有响应附件时把接收缓冲区交给附件持有, 附件直接引用其中的数据; 下次调用重新分配缓冲区
+    std::shared_ptr<const void> owner;
+    const char* body = m_recv_buf.data() + body_offset;
+    if (response_header.attachment_size() > 0) {
+        std::shared_ptr<std::string> frame = std::make_shared<std::string>();
+        frame->swap(m_recv_buf);
+        body = frame->data() + body_offset;
+        owner = frame;
+    }
+    FinishCall(state, response_header, body, owner, controller, response);
+}
+
+// 阻塞模式下发送一个请求帧, 并接收服务器响应, 直到收到一个完整的响应帧, 帧的内容保存在m_recv_buf中
+// 失败时关闭连接(下次调用时重新连接)并设置controller; 在m_conn_mtx内调用
+bool AzRPC_Channel::Exchange(const std::string& frame, const AzRPC_Attachment* attachment, const std::string& trailer, AzRPC::RpcResponseHeader* response_header, size_t* body_offset, ::google::protobuf::RpcController* controller) {
+    std::string err;
+    if (!SendFrame(frame, attachment, trailer, &err)) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "send error: %s", err.c_str());
+        closeConnection();
+        controller->SetFailed(err);
+        return false;
+    }
+    if (!RecvFrame(response_header, body_offset, &err)) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "recv error: %s", err.c_str());
+        closeConnection();
+        controller->SetFailed(err);
+        return false;
+    }
+    return true;
+}
+
+// 事件循环模式: 连接交给AzRPC_ClientLoop, 请求帧带上call_id, 响应在IO线程中按call_id匹配
+void AzRPC_Channel::CallInLoop(AzRPC_ClientLoop* loop, const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done) {
+    if (done == nullptr && loop->InLoopThread()) {
+        // 在响应回调中同步调用会阻塞IO线程, 永远等不到响应
+        controller->SetFailed("synchronous call in client io thread");
+        return;
+    }
+
+    uint64_t conn_id = 0;
+    if (!ConnectLoop(loop, method, controller, &conn_id)) {
+        if (done != nullptr) {
+            done->Run();
+        }
+        return;
+    }
+
+    uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+    std::shared_ptr<CallState> state = std::make_shared<CallState>();
+    // 请求附件拷贝进请求帧: 帧交给IO线程异步发送, 调用方的附件内存在返回后不再保证有效
+    std::string frame;
+    if (!BuildRequest(method, request, controller, call_id, ChecksumEnabled(), state.get(), &frame, nullptr)) {
+        if (done != nullptr) {
+            done->Run();
+        }
+        return;
+    }
+
+    if (done != nullptr) {
+        loop->Call(conn_id, call_id, std::move(frame), [state, controller, response, done](const AzRPC::RpcResponseHeader& header, const char* body, const std::string& error) {
+            if (!error.empty()) {
+                controller->SetFailed(error);
+            }
+            else {
+                FinishCall(*state, header, body, nullptr, controller, response);
+            }
+            done->Run();
+        });
+        return;
+    }
+
+    // 同步调用, 等待IO线程完成
+    std::promise<void> finished;
+    std::future<void> future = finished.get_future();
+    loop->Call(conn_id, call_id, std::move(frame), [state, controller, response, &finished](const AzRPC::RpcResponseHeader& header, const char* body, const std::string& error) {
+        if (!error.empty()) {
+            controller->SetFailed(error);
+        }
         else {
-            // 连接成功, 记录日志
-            LOG(INFO) << "connect server success";
+            FinishCall(*state, header, body, nullptr, controller, response);
+        }
+        finished.set_value();
+    });
+    future.wait();
+}
+
+// 使用客户端IO引擎时确保channel有可用的连接, 上一次的连接已经断开时重新连接; 成功时conn_id为本次调用使用的连接
+// 多个线程同时发起第一次调用时只有一个建立连接, 其他的等它完成后使用同一条连接
+bool AzRPC_Channel::ConnectLoop(AzRPC_ClientLoop* loop, const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, uint64_t* conn_id) {
+    std::lock_guard<std::mutex> lock(m_conn_mtx);
+    if (m_conn_id != 0 && loop->Broken(m_conn_id)) {
+        loop->Detach(m_conn_id);
+        m_conn_id = 0;
+    }
+    if (m_conn_id == 0) {
+        if (!Connect(method, controller, false)) {
+            return false;
         }
+        m_conn_id = loop->Attach(m_clientfd);
+        m_clientfd = -1;
     }
+    *conn_id = m_conn_id;
+    return true;
+}
 
-    // 将请求参数序列化为字符串, 计算其长度
-    uint32_t args_size{};
-    std::string args_str;
-    // 序列化请求参数
-    if (request->SerializeToString(&args_str)) {
-        args_size = args_str.size();    // 获取序列化后的长度
+// 批量调用: 每个调用编码为一个子请求帧(call_id为它在calls中的下标, 不带校验和), 拼接后作为一个请求帧的请求参数发出
+// 子请求各自按方法压缩请求参数和携带追踪上下文, 请求附件拷贝进子请求帧; 外层帧按rpc_checksum带校验和
+void AzRPC_Channel::BatchCall(const std::vector<BatchItem>& calls, ::google::protobuf::Closure* done) {
+    std::shared_ptr<BatchState> batch = std::make_shared<BatchState>();
+    batch->calls = calls;
+    batch->states.resize(calls.size());
+    batch->sent.resize(calls.size(), false);
+    std::string body;
+    uint32_t count = 0;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (BuildRequest(calls[i].method, calls[i].request, calls[i].controller, i, false, &batch->states[i], &body, nullptr)) {
+            batch->sent[i] = true;
+            ++count;
+        }
+    }
+    if (count == 0) {
+        if (done != nullptr) {
+            done->Run();
+        }
+        return;
+    }
+
+    // 按第一个调用查找服务端
+    const ::google::protobuf::MethodDescriptor* method = calls[0].method;
+    AzRPC::RpcHeader header;
+    header.set_service_name(method->service()->name());
+    header.set_method_name(method->name());
+    header.set_checksum(ChecksumEnabled());
+    header.set_batch_count(count);
+    // 连接和收发的错误记在transport中, 再交给每个调用
+    AzRPC_Controller transport;
+
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (loop != nullptr) {
+        if (done == nullptr && loop->InLoopThread()) {
+            FailBatch(*batch, "synchronous call in client io thread");
+            return;
+        }
+        uint64_t conn_id = 0;
+        if (!ConnectLoop(loop, method, &transport, &conn_id)) {
+            FailBatch(*batch, transport.ErrorText());
+            if (done != nullptr) {
+                done->Run();
+            }
+            return;
+        }
+        uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+        header.set_call_id(call_id);
+        std::string frame;
+        if (!AzRPC_Codec::EncodeRequest(&header, body, &frame)) {
+            FailBatch(*batch, "serialize rpc header error!");
+            if (done != nullptr) {
+                done->Run();
+            }
+            return;
+        }
+        if (done != nullptr) {
+            loop->Call(conn_id, call_id, std::move(frame), [batch, done](const AzRPC::RpcResponseHeader& response_header, const char* response_body, const std::string& error) {
+                if (!error.empty()) {
+                    FailBatch(*batch, error);
+                }
+                else {
+                    FinishBatch(*batch, response_header, response_body);
+                }
+                done->Run();
+            });
+            return;
+        }
+        // 同步调用, 等待IO线程完成
+        std::promise<void> finished;
+        std::future<void> future = finished.get_future();
+        loop->Call(conn_id, call_id, std::move(frame), [batch, &finished](const AzRPC::RpcResponseHeader& response_header, const char* response_body, const std::string& error) {
+            if (!error.empty()) {
+                FailBatch(*batch, error);
+            }
+            else {
+                FinishBatch(*batch, response_header, response_body);
+            }
+            finished.set_value();
+        });
+        future.wait();
+        return;
+    }
+
+    // 阻塞模式, 与CallBlocking一样整个收发在锁内
+    std::string frame;
+    AzRPC::RpcResponseHeader response_header;
+    size_t body_offset = 0;
+    std::unique_lock<std::mutex> lock(m_conn_mtx);
+    if (m_clientfd == -1 && !Connect(method, &transport, true)) {
+        FailBatch(*batch, transport.ErrorText());
+    }
+    else if (!AzRPC_Codec::EncodeRequest(&header, body, &frame)) {
+        FailBatch(*batch, "serialize rpc header error!");
+    }
+    else if (!Exchange(frame, nullptr, std::string(), &response_header, &body_offset, &transport)) {
+        FailBatch(*batch, transport.ErrorText());
+    }
+    else {
+        FinishBatch(*batch, response_header, m_recv_buf.data() + body_offset);
+    }
+    lock.unlock();
+    if (done != nullptr) {
+        done->Run();
+    }
+}
+
+// 把批量响应中的子响应按call_id交给各个调用, 整个批失败或者没有收到子响应的调用以错误结束
+void AzRPC_Channel::FinishBatch(const BatchState& batch, const AzRPC::RpcResponseHeader& response_header, const char* body) {
+    if (response_header.error_code() != AzRPC::OK) {
+        FailBatch(batch, response_header.error_text());
+        return;
+    }
+    size_t body_size = response_header.body_size();
+    std::string raw_body;
+    if (response_header.compress_type() != AzRPC::COMPRESS_NONE) {
+        if (!AzRPC_Compress::Decompress(response_header.compress_type(), body, body_size, response_header.body_raw_size(), &raw_body)) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "decompress batch response error, compress type %s", AzRPC_Compress::Name(response_header.compress_type()));
+            FailBatch(batch, std::string("decompress response error: ") + AzRPC_Compress::Name(response_header.compress_type()));
+            return;
+        }
+        body = raw_body.data();
+        body_size = raw_body.size();
+    }
+
+    std::vector<bool> answered(batch.calls.size(), false);
+    size_t offset = 0;
+    while (offset < body_size) {
+        AzRPC::RpcResponseHeader sub_header;
+        size_t sub_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeResponse(body + offset, body_size - offset, &sub_header, &sub_offset);
+        if (frame_size <= 0) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "parse batch response error");
+            break;
+        }
+        uint64_t index = sub_header.call_id();
+        if (index < batch.calls.size() && batch.sent[index] && !answered[index]) {
+            answered[index] = true;
+            const BatchItem& call = batch.calls[index];
+            FinishCall(batch.states[index], sub_header, body + offset + sub_offset, nullptr, call.controller, call.response);
+        }
+        offset += frame_size;
+    }
+    for (size_t i = 0; i < batch.calls.size(); ++i) {
+        if (batch.sent[i] && !answered[i]) {
+            batch.calls[i].controller->SetFailed("batch response missing");
+        }
+    }
+}
+
+void AzRPC_Channel::FailBatch(const BatchState& batch, const std::string& error) {
+    for (size_t i = 0; i < batch.calls.size(); ++i) {
+        if (batch.sent[i]) {
+            batch.calls[i].controller->SetFailed(error);
+        }
+    }
+}
+
+// 查询服务地址并建立连接, 成功后m_clientfd为已连接的socket; 在m_conn_mtx内调用
+bool AzRPC_Channel::Connect(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, bool allow_shm) {
+    // 查询注册中心, 找到提供服务的服务器地址
+    std::unique_ptr<AzRPC_Registry> registry = AzRPC_Registry::NewFromConfig();
+    if (!registry->Start()) {
+        controller->SetFailed("registry start error");
+        return false;
+    }
+    // 查询服务器地址
+    std::string host_data = QueryServiceHost(registry.get(), method->service()->name(), method->name(), m_idx);
+    m_ip = host_data.substr(0, m_idx);  // 从查询结果中获取ip地址
+    AZRPC_LOG_DEBUG("ip: %s", m_ip.c_str());
+    m_port = atoi(host_data.substr(m_idx + 1, host_data.size() - m_idx).c_str());
+    AZRPC_LOG_DEBUG("port: %d", m_port);
+
+    // 服务端与本进程在同一台主机上并且发布了Unix域套接字时优先使用它, 失败再回退到TCP
+    bool rt = false;
+    m_unix_path = ParseHostAttr(host_data, "unix");
+    if (!m_unix_path.empty() && PreferUnix() && IsLocalHost(m_ip, ParseHostAttr(host_data, "host"))) {
+        rt = newConnectUnix(m_unix_path.c_str());
+        AZRPC_LOG_DEBUG("connect unix %s %s", m_unix_path.c_str(), rt ? "success" : "failed, fallback to tcp");
+    }
+    bool local = rt;
+    if (!rt) {
+        rt = newConnect(m_ip.c_str(), m_port);
+        local = rt && IsLocalHost(m_ip, ParseHostAttr(host_data, "host"));
+    }
+    if (!rt) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "connect server error");
+        controller->SetFailed("connect server error");
+        return false;
     }
     else {
+        // 连接成功, 记录日志
+        AZRPC_LOG_DEBUG("connect server success");
+    }
+
+    // 同主机时尝试协商共享内存传输, 不成功就继续使用刚建立的连接
+    if (allow_shm && local && AzRPC_Application::GetConfig().Load("rpc_shm") == "true") {
+        NegotiateShm();
+    }
+    return true;
+}
+
+// 序列化请求参数并编码请求帧(追加到frame), 同时确定本次调用的追踪上下文; checksum为false时不带校验和
+// 控制器带有请求附件时, trailer为nullptr则把附件拷贝进frame, 否则附件由调用方另行发送, 校验和写入trailer
+bool AzRPC_Channel::BuildRequest(const ::google::protobuf::MethodDescriptor* method, const ::google::protobuf::Message* request, ::google::protobuf::RpcController* controller, uint64_t call_id, bool checksum, CallState* state, std::string* frame, std::string* trailer) {
+    // 序列化请求参数
+    std::string args_str;
+    if (!request->SerializeToString(&args_str)) {
         // 序列化失败, 设置错误信息
         controller->SetFailed("serialize request fail");
-        return;
+        return false;
     }
 
     // 定义RPC请求的头部信息
+    const std::string& service_name = method->service()->name();
+    const std::string& method_name = method->name();
     AzRPC::RpcHeader azrpcHeader;
     azrpcHeader.set_service_name(service_name);
     azrpcHeader.set_method_name(method_name);
-    azrpcHeader.set_args_size(args_size);
+    azrpcHeader.set_call_id(call_id);
+    azrpcHeader.set_checksum(checksum);
+    state->service_name = service_name;
+    state->method_name = method_name;
+
+    // 压缩请求参数: 控制器上指定的算法优先, 否则按方法配置; 太小或压缩后没有变小时原样发送
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    AzRPC::CompressType compress_type;
+    if (az_controller == nullptr || !az_controller->GetCompressType(&compress_type)) {
+        compress_type = AzRPC_Compress::ForMethod(service_name, method_name);
+    }
+    if (compress_type != AzRPC::COMPRESS_NONE) {
+        std::string compressed;
+        if (AzRPC_Compress::Compress(compress_type, args_str, &compressed) != AzRPC::COMPRESS_NONE) {
+            azrpcHeader.set_compress_type(compress_type);
+            azrpcHeader.set_args_raw_size(static_cast<uint32_t>(args_str.size()));
+            args_str.swap(compressed);
+        }
+        // 请求参数太小没有压缩时也告诉服务端, 响应可能足够大; 本进程不支持的算法不能用于响应
+        if (AzRPC_Compress::Supported(compress_type)) {
+            azrpcHeader.set_response_compress(compress_type);
+        }
+    }
+
+    // 优先级和租户: 控制器上指定的优先, 否则使用配置的rpc_priority和rpc_tenant; 默认值不占用header的空间
+    static const std::string config_tenant = AzRPC_Application::GetConfig().Load("rpc_tenant");
+    AzRPC::Priority priority;
+    if (az_controller == nullptr || !az_controller->GetPriority(&priority)) {
+        priority = PriorityForMethod(service_name, method_name);
+    }
+    azrpcHeader.set_priority(priority);
+    azrpcHeader.set_tenant(az_controller != nullptr && !az_controller->Tenant().empty() ? az_controller->Tenant() : config_tenant);
 
-    // 将RPC头部信息序列化为字符串, 并计算其长度
-    uint32_t header_size = 0;
-    std::string rpc_header_str;
-    if (azrpcHeader.SerializeToString(&rpc_header_str)) {
-        header_size = rpc_header_str.size();
+    // 确定本次调用的追踪上下文: 优先使用控制器上指定的, 否则继承当前线程的(在服务端处理请求时由框架设置)
+    AzRPC_TraceContext parent = AzRPC_Tracer::Current();
+    if (az_controller != nullptr && az_controller->GetTraceContext().Valid()) {
+        parent = az_controller->GetTraceContext();
+    }
+    AzRPC_TraceContext& trace = state->trace;
+    trace = parent.Valid() ? AzRPC_Tracer::NewChild(parent) : AzRPC_Tracer::NewRoot();
+    state->call_start_us = 0;
+    if (trace.Sampled()) {
+        // 只有被采样的调用才携带追踪字段, 未采样时header不变
+        azrpcHeader.set_trace_id(trace.trace_id);
+        azrpcHeader.set_span_id(trace.span_id);
+        azrpcHeader.set_parent_span_id(trace.parent_span_id);
+        azrpcHeader.set_trace_flags(trace.flags);
+        state->call_start_us = AzRPC_Tracer::NowMicros();
+    }
+
+    // 将头部长度、头部信息和请求参数拼接成完整的RPC请求报文
+    bool encoded = false;
+    if (az_controller != nullptr) {
+        az_controller->ResponseAttachment().Clear();
+        encoded = AzRPC_Codec::EncodeRequest(&azrpcHeader, args_str, az_controller->RequestAttachment(), frame, trailer);
     }
     else {
+        encoded = AzRPC_Codec::EncodeRequest(&azrpcHeader, args_str, frame);
+    }
+    if (!encoded) {
         // 序列化失败, 设置错误信息
         controller->SetFailed("serialize rpc header error!");
+        return false;
+    }
+    return true;
+}
+
+// 配置rpc_checksum=true时请求帧带上CRC32C, 服务端随之为响应带上校验和
+bool AzRPC_Channel::ChecksumEnabled() {
+    static const bool enabled = AzRPC_Application::GetConfig().Load("rpc_checksum") == "true";
+    return enabled;
+}
+
+// 根据响应帧设置调用结果, 并记录客户端span
+// owner持有body所在的内存时响应附件直接引用它, 为nullptr时拷贝响应附件
+void AzRPC_Channel::FinishCall(const CallState& state, const AzRPC::RpcResponseHeader& response_header, const char* body, std::shared_ptr<const void> owner, ::google::protobuf::RpcController* controller, ::google::protobuf::Message* response) {
+    // 服务端返回了错误
+    if (response_header.error_code() != AzRPC::OK) {
+        controller->SetFailed(response_header.error_text());
         return;
     }
 
-    // 将头部长度和头部信息拼接成完整的RPC请求报文
-    std::string send_rpc_str;
-    {
-        google::protobuf::io::StringOutputStream string_output(&send_rpc_str);
-        google::protobuf::io::CodedOutputStream coded_output(&string_output);
-        // 写入头部长度
-        coded_output.WriteVarint32(static_cast<uint32_t>(header_size));
-        // 写入头部信息
-        coded_output.WriteString(rpc_header_str);
-    }
-    send_rpc_str += args_str;   // 拼接请求参数
-
-    // 发送RPC请求到服务器
-    if (send(m_clientfd, send_rpc_str.c_str(), send_rpc_str.size(), 0) == -1) {
-        close(m_clientfd);      // 发送失败, 关闭socket
-        char errtxt[512] = {};
-        // 打印错误信息
-        std::cout << "send error: " << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;
-        controller->SetFailed(errtxt);      // 设置错误信息
+    // 响应附件紧跟在(可能被压缩的)响应体之后
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    if (az_controller != nullptr && response_header.attachment_size() > 0) {
+        const char* attachment = body + response_header.body_size();
+        if (owner) {
+            az_controller->ResponseAttachment().AppendRef(attachment, response_header.attachment_size(), std::move(owner));
+        }
+        else {
+            az_controller->ResponseAttachment().Append(attachment, response_header.attachment_size());
+        }
+    }
+
+    // 响应体被压缩时先解压
+    size_t body_size = response_header.body_size();
+    std::string raw_body;
+    if (response_header.compress_type() != AzRPC::COMPRESS_NONE) {
+        if (!AzRPC_Compress::Decompress(response_header.compress_type(), body, body_size, response_header.body_raw_size(), &raw_body)) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "decompress response error, compress type %s", AzRPC_Compress::Name(response_header.compress_type()));
+            controller->SetFailed(std::string("decompress response error: ") + AzRPC_Compress::Name(response_header.compress_type()));
+            return;
+        }
+        body = raw_body.data();
+        body_size = raw_body.size();
+    }
+
+    // 将接收到的响应数据反序列化为response对象
+    if (!response->ParseFromArray(body, body_size)) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "parse response error");
+        controller->SetFailed("parse response error");
         return;
     }
 
-    // 接受服务器响应
-    char recv_buf[1024] = {0};
-    int recv_size = recv(m_clientfd, recv_buf, 1024, 0);
-    if (recv_size == -1) {
+    // 记录客户端视角的span, 与服务端span对比即可得到网络耗时
+    if (state.trace.Sampled()) {
+        AzRPC_SpanRecord record = {};
+        record.trace_id = state.trace.trace_id;
+        record.span_id = state.trace.span_id;
+        record.parent_span_id = state.trace.parent_span_id;
+        record.start_us = state.call_start_us;
+        record.kind = AzRPC_SpanRecord::kClient;
+        record.handler_us = AzRPC_Tracer::NowMicros() - state.call_start_us;
+        AzRPC_Tracer::FillMethod(&record, state.service_name, state.method_name);
+        AzRPC_Tracer::Export(record);
+    }
+}
+
+// 发送全部数据, 处理部分写和信号中断
+bool AzRPC_Channel::SendAll(const char* data, size_t len) {
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = send(m_clientfd, data + sent, len - sent, MSG_NOSIGNAL);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// 发送一组缓冲区, 相当于带MSG_NOSIGNAL的writev, 处理部分写、信号中断和IOV_MAX的限制
+bool AzRPC_Channel::SendAllv(std::vector<struct iovec>* iov) {
+    size_t index = 0;
+    while (index < iov->size()) {
+        struct msghdr msg = {};
+        msg.msg_iov = &(*iov)[index];
+        msg.msg_iovlen = std::min(iov->size() - index, static_cast<size_t>(IOV_MAX));
+        ssize_t n = sendmsg(m_clientfd, &msg, MSG_NOSIGNAL);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // 跳过已经发送完的缓冲区, 调整发送了一部分的那个
+        size_t sent = static_cast<size_t>(n);
+        while (index < iov->size() && sent >= (*iov)[index].iov_len) {
+            sent -= (*iov)[index].iov_len;
+            ++index;
+        }
+        if (sent > 0) {
+            (*iov)[index].iov_base = static_cast<char*>((*iov)[index].iov_base) + sent;
+            (*iov)[index].iov_len -= sent;
+        }
+    }
+    return true;
+}
+
+// 发送一个请求帧, 协商了共享内存时写入请求环, 否则写入socket
+// 带附件时依次发送frame、附件的各块和trailer, socket上用一次writev发出, 附件不拷贝
+bool AzRPC_Channel::SendFrame(const std::string& frame, const AzRPC_Attachment* attachment, const std::string& trailer, std::string* err) {
+    bool has_attachment = attachment != nullptr && !attachment->empty();
+    if (m_shm) {
+        bool written = m_shm->Request().Write(frame.data(), frame.size());
+        if (written && has_attachment) {
+            for (const AzRPC_Attachment::Block& block: attachment->Blocks()) {
+                if (!(written = m_shm->Request().Write(block.data, block.size))) {
+                    break;
+                }
+            }
+        }
+        if (written && !trailer.empty()) {
+            written = m_shm->Request().Write(trailer.data(), trailer.size());
+        }
+        if (!written) {
+            *err = "shm segment closed by server";
+            return false;
+        }
+        return true;
+    }
+    bool sent = false;
+    if (has_attachment || !trailer.empty()) {
+        std::vector<struct iovec> iov;
+        iov.reserve(2 + (has_attachment ? attachment->Blocks().size() : 0));
+        iov.push_back(iovec{const_cast<char*>(frame.data()), frame.size()});
+        if (has_attachment) {
+            attachment->AppendIovec(&iov);
+        }
+        if (!trailer.empty()) {
+            iov.push_back(iovec{const_cast<char*>(trailer.data()), trailer.size()});
+        }
+        sent = SendAllv(&iov);
+    }
+    else {
+        sent = SendAll(frame.data(), frame.size());
+    }
+    if (!sent) {
         char errtxt[512] = {};
-        // 打印错误信息
-        std::cout << "recv error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;
-        controller->SetFailed(errtxt);  // 设置错误信息
+        *err = strerror_r(errno, errtxt, sizeof(errtxt));
+        return false;
+    }
+    return true;
+}
+
+// 接收一个完整的响应帧, 帧的内容保存在m_recv_buf中
+bool AzRPC_Channel::RecvFrame(AzRPC::RpcResponseHeader* response_header, size_t* body_offset, std::string* err) {
+    int frame_size = AzRPC_Codec::kIncomplete;
+    m_recv_buf.clear();
+    while (frame_size == AzRPC_Codec::kIncomplete) {
+        if (m_shm) {
+            ssize_t n = m_shm->Response().Read(&m_recv_buf, 100);
+            if (n < 0) {
+                *err = "shm segment closed by server";
+                return false;
+            }
+            if (n == 0) {
+                // 等待期间检查协商用的连接, 服务端进程退出时连接会被关闭
+                char c;
+                ssize_t peek = recv(m_clientfd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+                if (peek == 0 || (peek == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    *err = "connection closed by server";
+                    return false;
+                }
+                continue;
+            }
+        }
+        else {
+            char recv_buf[4096];
+            ssize_t recv_size = recv(m_clientfd, recv_buf, sizeof(recv_buf), 0);
+            if (recv_size <= 0) {
+                char errtxt[512] = {};
+                *err = recv_size == 0 ? "connection closed by server" : strerror_r(errno, errtxt, sizeof(errtxt));
+                return false;
+            }
+            m_recv_buf.append(recv_buf, recv_size);
+        }
+        frame_size = AzRPC_Codec::DecodeResponse(m_recv_buf.data(), m_recv_buf.size(), response_header, body_offset);
+    }
+    if (frame_size == AzRPC_Codec::kInvalid) {
+        *err = "parse response header error";
+        return false;
+    }
+    if (frame_size == AzRPC_Codec::kChecksumError) {
+        *err = "response checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+// 创建共享内存段并通过当前连接通知服务端打开它, 服务端不支持或未开启时返回错误, 继续使用socket
+void AzRPC_Channel::NegotiateShm() {
+    std::string ring_size = AzRPC_Application::GetConfig().Load("rpc_shm_ring_size");
+    std::unique_ptr<AzRPC_ShmSegment> segment = AzRPC_ShmSegment::Create(ring_size.empty() ? (1 << 20) : atol(ring_size.c_str()));
+    if (!segment) {
         return;
     }
 
-    // 将接收到的响应数据反序列化为response对象
-    if (!response->ParseFromArray(recv_buf, recv_size)) {
-        close(m_clientfd);      // 反序列化失败, 关闭socket
-        char errtxt[512] = {};
-        std::cout << "parse error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;
-        controller->SetFailed(errtxt);
+    AzRPC::RpcHeader header;
+    header.set_service_name(AZRPC_TRANSPORT_SERVICE);
+    header.set_method_name(AZRPC_SHM_ATTACH_METHOD);
+    std::string frame;
+    std::string err;
+    AzRPC::RpcResponseHeader response_header;
+    size_t body_offset = 0;
+    if (!AzRPC_Codec::EncodeRequest(&header, segment->Name(), &frame) || !SendFrame(frame, nullptr, std::string(), &err) || !RecvFrame(&response_header, &body_offset, &err)) {
+        AZRPC_LOG_WARNING("shm negotiate error: %s", err.c_str());
+        closeConnection();
+        return;
+    }
+    if (response_header.error_code() != AzRPC::OK) {
+        AZRPC_LOG_DEBUG("shm transport not available: %s", response_header.error_text().c_str());
         return;
     }
+    // 双方都已映射, 删除文件名, 进程退出后内核自动回收
+    segment->Unlink();
+    m_shm = std::move(segment);
+}
 
-    close(m_clientfd);
+// 关闭连接, 下一次调用会重新查询服务地址并连接; 在m_conn_mtx内调用
+void AzRPC_Channel::closeConnection() {
+    if (m_conn_id != 0) {
+        AzRPC_ClientLoop::Instance()->Detach(m_conn_id);
+        m_conn_id = 0;
+    }
+    if (m_shm) {
+        m_shm->Close();
+        m_shm.reset();
+    }
+    if (m_clientfd != -1) {
+        close(m_clientfd);
+        m_clientfd = -1;
+    }
 }
 
 // 创建socket连接
@@ -124,50 +889,121 @@ bool AzRPC_Channel::newConnect(const char* ip, uint16_t port) {
     int clientfd = socket(AF_INET, SOCK_STREAM, 0);
     if (clientfd == -1) {
         char errtxt[512] = {};
-        std::cout << "socket error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;
-        LOG(ERROR) << "socket error: " << errtxt;
+        AZRPC_LOG_ERROR_RATELIMIT(10, "socket error: %s", strerror_r(errno, errtxt, sizeof(errtxt)));
         return false;
     }
 
     // 设置服务器地址信息
-    struct sockaddr_in server_addr;                 // IPv4地址族
-    server_addr.sin_family = htons(port);           // 端口号
+    struct sockaddr_in server_addr = {};
+    server_addr.sin_family = AF_INET;               // IPv4地址族
+    server_addr.sin_port = htons(port);             // 端口号
     server_addr.sin_addr.s_addr = inet_addr(ip);    // IP地址
 
     // 尝试连接服务器
     if (connect(clientfd, (struct sockaddr*)&server_addr, sizeof(server_addr))) {
         close(clientfd);    // 连接失败关闭socket
         char errtxt[512] = {};
-        std::cout << "connect error" << strerror_r(errno, errtxt, sizeof(errtxt)) << std::endl;
-        LOG(ERROR) << "connect error: " << errtxt;
+        AZRPC_LOG_ERROR_RATELIMIT(10, "connect error: %s", strerror_r(errno, errtxt, sizeof(errtxt)));
         return false;
     }
 
+    // 小的请求帧不等待Nagle算法攒包, 合并发送由调用方(客户端IO引擎的每轮批量发送)负责
+    int on = 1;
+    setsockopt(clientfd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
     // 保存socket文件描述符
     m_clientfd = clientfd;
     return true;
 }
 
-// 从ZooKeeper查询服务地址
-std::string AzRPC_Channel::QueryServiceHost(ZkClient* zkclient, std::string service_name, std::string method_name, int &idx) {
+// 通过Unix域套接字连接同主机上的服务端
+bool AzRPC_Channel::newConnectUnix(const char* path) {
+    struct sockaddr_un server_addr = {};
+    server_addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(server_addr.sun_path)) {
+        return false;
+    }
+    strncpy(server_addr.sun_path, path, sizeof(server_addr.sun_path) - 1);
+
+    int clientfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (clientfd == -1) {
+        return false;
+    }
+    if (connect(clientfd, (struct sockaddr*)&server_addr, sizeof(server_addr))) {
+        // 常见原因是套接字文件属于另一台主机或另一个挂载命名空间, 由调用方回退到TCP
+        close(clientfd);
+        return false;
+    }
+    m_clientfd = clientfd;
+    return true;
+}
+
+// 从节点数据"ip:port;key=value;..."中取出附加属性, 不存在时返回空字符串
+std::string AzRPC_Channel::ParseHostAttr(const std::string& host_data, const std::string& key) {
+    std::string pattern = ";" + key + "=";
+    size_t pos = host_data.find(pattern);
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos += pattern.size();
+    size_t end = host_data.find(';', pos);
+    return host_data.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+// 配置项rpc_prefer_unix, 默认开启
+bool AzRPC_Channel::PreferUnix() {
+    std::string value = AzRPC_Application::GetConfig().Load("rpc_prefer_unix");
+    return value != "false" && value != "0";
+}
+
+// 判断服务端是否和本进程在同一台主机上: 主机名相同, 或者地址是回环地址、本机某个网卡的地址
+bool AzRPC_Channel::IsLocalHost(const std::string& ip, const std::string& host) {
+    char hostname[256] = {0};
+    if (!host.empty() && gethostname(hostname, sizeof(hostname) - 1) == 0 && host == hostname) {
+        return true;
+    }
+
+    struct in_addr addr;
+    if (inet_pton(AF_INET, ip.c_str(), &addr) != 1) {
+        return false;
+    }
+    if ((ntohl(addr.s_addr) >> 24) == 127) {
+        return true;
+    }
+    struct ifaddrs* ifs = nullptr;
+    if (getifaddrs(&ifs) == -1) {
+        return false;
+    }
+    bool local = false;
+    for (struct ifaddrs* it = ifs; it != nullptr && !local; it = it->ifa_next) {
+        if (it->ifa_addr != nullptr && it->ifa_addr->sa_family == AF_INET) {
+            local = ((struct sockaddr_in*)it->ifa_addr)->sin_addr.s_addr == addr.s_addr;
+        }
+    }
+    freeifaddrs(ifs);
+    return local;
+}
+
+// 从注册中心查询服务地址
+std::string AzRPC_Channel::QueryServiceHost(AzRPC_Registry* registry, std::string service_name, std::string method_name, int &idx) {
     // 构造ZooKeeper路径
     std::string method_path = "/" + service_name + "/" + method_name;
-    std::cout << "method_path: " << method_path << std::endl;
+    AZRPC_LOG_DEBUG("method_path: %s", method_path.c_str());
 
     std::unique_lock<std::mutex> lock(global_data_mtx);
-    // 从ZooKeeper获取数据
-    std::string host_data_1 = zkclient->GetDataAsync(method_path.c_str());
+    // 从注册中心获取数据
+    std::string host_data_1 = registry->GetData(method_path);
     lock.unlock();
 
     // 没有找到服务地址
     if (host_data_1 == "") {
-        LOG(ERROR) << method_path + " is not exist!";
+        AZRPC_LOG_ERROR_RATELIMIT(10, "%s is not exist!", method_path.c_str());
         return " ";
     }
 
     idx = host_data_1.find(":");    // 查找IP和端口的分隔符
     if (idx == -1) {
-        LOG(ERROR) << method_path + " address is not valid!";
+        AZRPC_LOG_ERROR_RATELIMIT(10, "%s address is not valid!", method_path.c_str());
         return " ";
     }
     // 返回服务器地址
@@ -175,7 +1011,7 @@ std::string AzRPC_Channel::QueryServiceHost(ZkClient* zkclient, std::string serv
 }
 
 // 构造函数, 支持延迟连接
-AzRPC_Channel::AzRPC_Channel(bool connectNow): m_clientfd(-1), m_idx(0) {
+AzRPC_Channel::AzRPC_Channel(bool connectNow): m_clientfd(-1), m_idx(0), m_conn_id(0) {
     // 不需要立即连接
     if (!connectNow) {
         return;
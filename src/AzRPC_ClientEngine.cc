@@ -0,0 +1,599 @@
+#include "AzRPC_ClientEngine.h"
+#include "AzRPC_Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifdef AZRPC_HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+std::unique_ptr<AzRPC_ClientEngine> AzRPC_ClientEngine::Create(const std::string& name, Handler* handler, int wakeup_fd) {
+    if (name == "io_uring") {
+#ifdef AZRPC_HAVE_IO_URING
+        std::unique_ptr<AzRPC_ClientEngine> uring(new AzRPC_UringEngine());
+        if (uring->Init(handler, wakeup_fd)) {
+            return uring;
+        }
+        AZRPC_LOG_WARNING("io_uring is not available, fallback to epoll");
+#else
+        AZRPC_LOG_WARNING("built without io_uring support, fallback to epoll");
+#endif
+    }
+    std::unique_ptr<AzRPC_ClientEngine> epoll(new AzRPC_EpollEngine());
+    if (epoll->Init(handler, wakeup_fd)) {
+        return epoll;
+    }
+    return nullptr;
+}
+
+namespace {
+
+std::string ErrorText(int err) {
+    char errtxt[512] = {};
+    return strerror_r(err, errtxt, sizeof(errtxt));
+}
+
+}  // namespace
+
+AzRPC_EpollEngine::AzRPC_EpollEngine(): m_handler(nullptr), m_epollfd(-1), m_pwait2(false), m_wakeupfd(-1), m_read_buf(64 * 1024) {}
+
+AzRPC_EpollEngine::~AzRPC_EpollEngine() {
+    for (auto& item: m_connections) {
+        close(item.second.fd);
+    }
+    if (m_epollfd != -1) {
+        close(m_epollfd);
+    }
+}
+
+// 连接id从1开始, 0留给唤醒fd
+bool AzRPC_EpollEngine::Init(Handler* handler, int wakeup_fd) {
+    m_handler = handler;
+    m_wakeupfd = wakeup_fd;
+    m_epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollfd == -1) {
+        AZRPC_LOG_ERROR("epoll_create error: %s", ErrorText(errno).c_str());
+        return false;
+    }
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = 0;
+    if (epoll_ctl(m_epollfd, EPOLL_CTL_ADD, m_wakeupfd, &event) != 0) {
+        return false;
+    }
+#ifdef SYS_epoll_pwait2
+    // 用零超时试探内核是否支持epoll_pwait2, 不支持时返回ENOSYS
+    struct timespec zero = {0, 0};
+    m_pwait2 = syscall(SYS_epoll_pwait2, m_epollfd, &event, 1, &zero, nullptr, 0) >= 0 || errno != ENOSYS;
+#endif
+    return true;
+}
+
+bool AzRPC_EpollEngine::Add(uint64_t id, int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = id;
+    if (epoll_ctl(m_epollfd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        close(fd);
+        return false;
+    }
+    m_connections[id] = Connection{fd, std::string()};
+    return true;
+}
+
+void AzRPC_EpollEngine::Remove(uint64_t id) {
+    auto it = m_connections.find(id);
+    if (it != m_connections.end()) {
+        epoll_ctl(m_epollfd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+        m_connections.erase(it);
+    }
+}
+
+void AzRPC_EpollEngine::Close(uint64_t id, const std::string& reason) {
+    Remove(id);
+    m_handler->OnClose(id, reason);
+}
+
+// 尽量写出缓存的数据, 返回false表示连接出错
+bool AzRPC_EpollEngine::FlushOutput(Connection& connection) {
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t n = send(connection.fd, connection.output.data() + sent, connection.output.size() - sent, MSG_NOSIGNAL);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += n;
+    }
+    connection.output.erase(0, sent);
+    return true;
+}
+
+void AzRPC_EpollEngine::Send(uint64_t id, std::string data) {
+    auto it = m_connections.find(id);
+    if (it == m_connections.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+    bool was_empty = connection.output.empty();
+    if (was_empty) {
+        connection.output.swap(data);
+    }
+    else {
+        connection.output.append(data);
+    }
+    // 已经在等待EPOLLOUT时只追加, 由可写事件统一发送
+    if (!was_empty) {
+        return;
+    }
+    if (!FlushOutput(connection)) {
+        Close(id, ErrorText(errno));
+        return;
+    }
+    if (!connection.output.empty()) {
+        struct epoll_event event = {};
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.u64 = id;
+        epoll_ctl(m_epollfd, EPOLL_CTL_MOD, connection.fd, &event);
+    }
+}
+
+// 内核支持epoll_pwait2时超时精确到微秒, 否则epoll_wait的超时以毫秒计, 不足1毫秒的超时向上取整
+void AzRPC_EpollEngine::Poll(int64_t timeout_us) {
+    struct epoll_event events[64];
+    int n;
+#ifdef SYS_epoll_pwait2
+    if (m_pwait2 && timeout_us >= 0) {
+        struct timespec timeout = {static_cast<time_t>(timeout_us / 1000000), static_cast<long>(timeout_us % 1000000 * 1000)};
+        n = static_cast<int>(syscall(SYS_epoll_pwait2, m_epollfd, events, 64, &timeout, nullptr, 0));
+    }
+    else
+#endif
+    {
+        int timeout_ms = timeout_us < 0 ? -1 : static_cast<int>(std::min<int64_t>((timeout_us + 999) / 1000, INT_MAX));
+        n = epoll_wait(m_epollfd, events, 64, timeout_ms);
+    }
+    if (n == -1) {
+        if (errno != EINTR) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "epoll_wait error: %s", ErrorText(errno).c_str());
+        }
+        return;
+    }
+    for (int i = 0; i < n; ++i) {
+        uint64_t id = events[i].data.u64;
+        if (id == 0) {
+            uint64_t value;
+            ssize_t ignored = read(m_wakeupfd, &value, sizeof(value));
+            (void)ignored;
+            m_handler->OnWakeup();
+            continue;
+        }
+
+        // 回调中可能移除连接, 每次使用前都重新查找
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            while (true) {
+                auto it = m_connections.find(id);
+                if (it == m_connections.end()) {
+                    break;
+                }
+                ssize_t len = recv(it->second.fd, m_read_buf.data(), m_read_buf.size(), 0);
+                if (len > 0) {
+                    m_handler->OnRead(id, m_read_buf.data(), len);
+                    continue;
+                }
+                if (len == 0) {
+                    Close(id, "connection closed by server");
+                }
+                else if (errno == EINTR) {
+                    continue;
+                }
+                else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    Close(id, ErrorText(errno));
+                }
+                break;
+            }
+        }
+        if (events[i].events & EPOLLOUT) {
+            auto it = m_connections.find(id);
+            if (it == m_connections.end()) {
+                continue;
+            }
+            if (!FlushOutput(it->second)) {
+                Close(id, ErrorText(errno));
+            }
+            else if (it->second.output.empty()) {
+                struct epoll_event event = {};
+                event.events = EPOLLIN;
+                event.data.u64 = id;
+                epoll_ctl(m_epollfd, EPOLL_CTL_MOD, it->second.fd, &event);
+            }
+        }
+    }
+}
+
+#ifdef AZRPC_HAVE_IO_URING
+
+namespace {
+
+const unsigned kRingEntries = 256;
+const unsigned kBufCount = 256;             // provided buffer的个数, 必须是2的幂
+const unsigned kBufSize = 16 * 1024;
+const uint16_t kBufGroup = 1;
+
+// user_data的低8位是操作类型, 高位是连接id
+enum UringOp: uint64_t { kOpRecv = 1, kOpSend = 2, kOpWakeup = 3, kOpTimeout = 4 };
+
+inline uint64_t MakeUserData(uint64_t id, UringOp op) {
+    return (id << 8) | op;
+}
+
+}  // namespace
+
+AzRPC_UringEngine::AzRPC_UringEngine()
+    : m_handler(nullptr), m_ringfd(-1), m_wakeupfd(-1), m_wakeup_value(0),
+      m_sq_ptr(MAP_FAILED), m_sq_size(0), m_cq_ptr(MAP_FAILED), m_cq_size(0), m_sqes(nullptr), m_sqes_size(0),
+      m_sq_head(nullptr), m_sq_tail(nullptr), m_sq_mask(nullptr), m_sq_array(nullptr),
+      m_cq_head(nullptr), m_cq_tail(nullptr), m_cq_mask(nullptr), m_cqes(nullptr), m_to_submit(0), m_timeout{0, 0},
+      m_buf_ring(nullptr), m_buf_ring_size(0), m_buffers(nullptr), m_buf_tail(0), m_multishot(true) {}
+
+AzRPC_UringEngine::~AzRPC_UringEngine() {
+    for (auto& item: m_connections) {
+        close(item.second.fd);
+    }
+    // 关闭ring会取消所有未完成的操作并注销buffer ring
+    if (m_ringfd != -1) {
+        close(m_ringfd);
+    }
+    if (m_cq_ptr != MAP_FAILED && m_cq_ptr != m_sq_ptr) {
+        munmap(m_cq_ptr, m_cq_size);
+    }
+    if (m_sq_ptr != MAP_FAILED) {
+        munmap(m_sq_ptr, m_sq_size);
+    }
+    if (m_sqes != nullptr) {
+        munmap(m_sqes, m_sqes_size);
+    }
+    if (m_buf_ring != nullptr) {
+        munmap(m_buf_ring, m_buf_ring_size);
+    }
+    if (m_buffers != nullptr) {
+        munmap(m_buffers, kBufCount * kBufSize);
+    }
+}
+
+bool AzRPC_UringEngine::Init(Handler* handler, int wakeup_fd) {
+    m_handler = handler;
+    m_wakeupfd = wakeup_fd;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    m_ringfd = syscall(__NR_io_uring_setup, kRingEntries, &params);
+    if (m_ringfd == -1) {
+        AZRPC_LOG_WARNING("io_uring_setup error: %s", ErrorText(errno).c_str());
+        return false;
+    }
+    // 5.7之前的内核不支持provided buffer和IORING_OP_SEND所需的特性, 直接回退
+    if (!(params.features & IORING_FEAT_FAST_POLL) || !(params.features & IORING_FEAT_NODROP)) {
+        AZRPC_LOG_WARNING("io_uring kernel features 0x%x are not enough", params.features);
+        return false;
+    }
+
+    m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+    }
+    m_sq_ptr = mmap(nullptr, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_SQ_RING);
+    if (m_sq_ptr == MAP_FAILED) {
+        return false;
+    }
+    m_cq_ptr = single_mmap ? m_sq_ptr : mmap(nullptr, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_CQ_RING);
+    if (m_cq_ptr == MAP_FAILED) {
+        return false;
+    }
+    m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringfd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(m_sq_ptr);
+    m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(m_cq_ptr);
+    m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqes = cq + params.cq_off.cqes;
+
+    // 注册接收缓冲区(5.19+), 内核在数据到达时从中选取, 省去每次提交接收时指定缓冲区
+    m_buf_ring_size = kBufCount * sizeof(struct io_uring_buf);
+    void* ring = mmap(nullptr, m_buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void* buffers = mmap(nullptr, kBufCount * kBufSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED || buffers == MAP_FAILED) {
+        return false;
+    }
+    m_buf_ring = static_cast<io_uring_buf_ring*>(ring);
+    m_buffers = static_cast<char*>(buffers);
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(m_buf_ring);
+    reg.ring_entries = kBufCount;
+    reg.bgid = kBufGroup;
+    if (syscall(__NR_io_uring_register, m_ringfd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        AZRPC_LOG_WARNING("io_uring register buffer ring error: %s", ErrorText(errno).c_str());
+        return false;
+    }
+    for (unsigned bid = 0; bid < kBufCount; ++bid) {
+        RecycleBuffer(bid);
+    }
+
+    PrepWakeup();
+    return true;
+}
+
+// 取一个空闲的SQE, 提交队列满时先提交已有的
+// 没有使用SQPOLL, 内核只在io_uring_enter中读取SQE, 因此可以先移动tail再填写内容
+io_uring_sqe* AzRPC_UringEngine::GetSqe() {
+    unsigned tail = *m_sq_tail;
+    if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) >= kRingEntries) {
+        Submit(0);
+    }
+    unsigned index = tail & *m_sq_mask;
+    io_uring_sqe* sqe = &m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    m_sq_array[index] = index;
+    __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++m_to_submit;
+    return sqe;
+}
+
+// 一次系统调用提交全部排队的SQE, wait_nr大于0时同时等待完成事件
+int AzRPC_UringEngine::Submit(unsigned wait_nr) {
+    while (true) {
+        int ret = syscall(__NR_io_uring_enter, m_ringfd, m_to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (ret >= 0) {
+            m_to_submit -= ret;
+            return ret;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        // 完成队列积压(EBUSY)时先去处理完成事件
+        if (errno != EBUSY && errno != EAGAIN) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "io_uring_enter error: %s", ErrorText(errno).c_str());
+        }
+        return -1;
+    }
+}
+
+void AzRPC_UringEngine::RecycleBuffer(unsigned bid) {
+    // 内核头文件的__DECLARE_FLEX_ARRAY在C++下会让bufs偏移8字节, 因此直接把ring当作io_uring_buf数组访问
+    // 第0项与ring的tail字段重叠, 只能逐个字段赋值
+    struct io_uring_buf* buf = reinterpret_cast<struct io_uring_buf*>(m_buf_ring) + (m_buf_tail & (kBufCount - 1));
+    buf->addr = reinterpret_cast<uint64_t>(m_buffers + static_cast<size_t>(bid) * kBufSize);
+    buf->len = kBufSize;
+    buf->bid = bid;
+    ++m_buf_tail;
+    __atomic_store_n(&m_buf_ring->tail, static_cast<uint16_t>(m_buf_tail), __ATOMIC_RELEASE);
+}
+
+// eventfd是非阻塞的, 直接提交read会立即以EAGAIN完成, 改为等待它可读后再同步读取
+void AzRPC_UringEngine::PrepWakeup() {
+    io_uring_sqe* sqe = GetSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = m_wakeupfd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = MakeUserData(0, kOpWakeup);
+}
+
+// 超时或者有一个其他操作完成时结束(off为1), 因此不会在Poll返回后长时间挂在ring中
+void AzRPC_UringEngine::PrepTimeout(int64_t timeout_us) {
+    m_timeout.tv_sec = timeout_us / 1000000;
+    m_timeout.tv_nsec = timeout_us % 1000000 * 1000;
+    io_uring_sqe* sqe = GetSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&m_timeout);
+    sqe->len = 1;
+    sqe->off = 1;
+    sqe->user_data = MakeUserData(0, kOpTimeout);
+}
+
+void AzRPC_UringEngine::PrepRecv(uint64_t id, Connection& connection) {
+    io_uring_sqe* sqe = GetSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection.fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufGroup;
+    if (m_multishot) {
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+    }
+    else {
+        sqe->len = kBufSize;
+    }
+    sqe->user_data = MakeUserData(id, kOpRecv);
+    connection.recv_inflight = true;
+}
+
+void AzRPC_UringEngine::PrepSend(uint64_t id, Connection& connection) {
+    io_uring_sqe* sqe = GetSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = connection.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(connection.sending.data() + connection.sent);
+    sqe->len = connection.sending.size() - connection.sent;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = MakeUserData(id, kOpSend);
+    connection.send_inflight = true;
+}
+
+bool AzRPC_UringEngine::Add(uint64_t id, int fd) {
+    Connection& connection = m_connections[id];
+    connection.fd = fd;
+    PrepRecv(id, connection);
+    return true;
+}
+
+// 关闭socket的两个方向, 让进行中的recv和send尽快完成, 全部完成后再close, 避免fd被复用
+void AzRPC_UringEngine::Remove(uint64_t id) {
+    auto it = m_connections.find(id);
+    if (it == m_connections.end() || it->second.closing) {
+        return;
+    }
+    it->second.closing = true;
+    shutdown(it->second.fd, SHUT_RDWR);
+    MaybeRelease(id);
+}
+
+void AzRPC_UringEngine::Close(uint64_t id, const std::string& reason) {
+    auto it = m_connections.find(id);
+    if (it == m_connections.end() || it->second.closing) {
+        return;
+    }
+    Remove(id);
+    m_handler->OnClose(id, reason);
+}
+
+void AzRPC_UringEngine::MaybeRelease(uint64_t id) {
+    auto it = m_connections.find(id);
+    if (it != m_connections.end() && it->second.closing && !it->second.recv_inflight && !it->second.send_inflight) {
+        close(it->second.fd);
+        m_connections.erase(it);
+    }
+}
+
+// 同一连接同时只有一个send在进行, 期间追加的数据在它完成后合并成一次提交
+void AzRPC_UringEngine::Send(uint64_t id, std::string data) {
+    auto it = m_connections.find(id);
+    if (it == m_connections.end() || it->second.closing) {
+        return;
+    }
+    Connection& connection = it->second;
+    if (connection.output.empty()) {
+        connection.output.swap(data);
+    }
+    else {
+        connection.output.append(data);
+    }
+    if (!connection.send_inflight) {
+        connection.sending.swap(connection.output);
+        connection.output.clear();
+        connection.sent = 0;
+        PrepSend(id, connection);
+    }
+}
+
+void AzRPC_UringEngine::Poll(int64_t timeout_us) {
+    if (timeout_us >= 0) {
+        PrepTimeout(timeout_us);
+    }
+    Submit(1);
+
+    unsigned head = *m_cq_head;
+    while (head != __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe* cqe = static_cast<struct io_uring_cqe*>(m_cqes) + (head & *m_cq_mask);
+        uint64_t user_data = cqe->user_data;
+        int res = cqe->res;
+        unsigned flags = cqe->flags;
+        // 先归还CQE再处理, 处理过程中可能提交新的请求
+        __atomic_store_n(m_cq_head, ++head, __ATOMIC_RELEASE);
+        HandleCompletion(user_data, res, flags);
+    }
+}
+
+void AzRPC_UringEngine::HandleCompletion(uint64_t user_data, int res, unsigned flags) {
+    uint64_t id = user_data >> 8;
+    UringOp op = static_cast<UringOp>(user_data & 0xff);
+    if (op == kOpTimeout) {
+        return;
+    }
+    if (op == kOpWakeup) {
+        ssize_t ignored = read(m_wakeupfd, &m_wakeup_value, sizeof(m_wakeup_value));
+        (void)ignored;
+        PrepWakeup();
+        m_handler->OnWakeup();
+        return;
+    }
+
+    auto it = m_connections.find(id);
+    if (it == m_connections.end()) {
+        if (op == kOpRecv && (flags & IORING_CQE_F_BUFFER)) {
+            RecycleBuffer(flags >> IORING_CQE_BUFFER_SHIFT);
+        }
+        return;
+    }
+    Connection& connection = it->second;
+
+    if (op == kOpRecv) {
+        bool more = flags & IORING_CQE_F_MORE;
+        if (!more) {
+            connection.recv_inflight = false;
+        }
+        if (res > 0) {
+            unsigned bid = flags >> IORING_CQE_BUFFER_SHIFT;
+            bool closing = connection.closing;
+            if (!closing) {
+                m_handler->OnRead(id, m_buffers + static_cast<size_t>(bid) * kBufSize, res);
+            }
+            RecycleBuffer(bid);
+            // 回调中可能移除了连接
+            it = m_connections.find(id);
+            if (it != m_connections.end() && !more && !it->second.closing) {
+                PrepRecv(id, it->second);
+            }
+        }
+        else if (res == -ENOBUFS && !connection.closing) {
+            // 缓冲区暂时用完, 处理完本轮事件后都会归还, 重新提交即可
+            PrepRecv(id, connection);
+        }
+        else if (res == -EINVAL && m_multishot && !connection.closing) {
+            // 内核不支持multishot recv(6.0之前), 改用单次recv
+            m_multishot = false;
+            PrepRecv(id, connection);
+        }
+        else if (!connection.closing) {
+            Close(id, res == 0 ? "connection closed by server" : ErrorText(-res));
+        }
+    }
+    else if (op == kOpSend) {
+        connection.send_inflight = false;
+        if (connection.closing) {
+            // 已经在关闭, 丢弃未发送的数据
+        }
+        else if (res < 0) {
+            Close(id, ErrorText(-res));
+        }
+        else {
+            connection.sent += res;
+            if (connection.sent < connection.sending.size()) {
+                PrepSend(id, connection);
+            }
+            else {
+                connection.sending.clear();
+                connection.sent = 0;
+                if (!connection.output.empty()) {
+                    connection.sending.swap(connection.output);
+                    PrepSend(id, connection);
+                }
+            }
+        }
+    }
+    MaybeRelease(id);
+}
+
+#endif
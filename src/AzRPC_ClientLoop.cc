@@ -0,0 +1,258 @@
+#include "AzRPC_ClientLoop.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Logger.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// 暂缓发送的批不超过这个大小, 更大的批合并的收益很小
+const size_t kMaxHeldBytes = 64 * 1024;
+
+int64_t NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+AzRPC_ClientLoop* AzRPC_ClientLoop::Instance() {
+    // 循环线程随进程一直存在, 实例不析构
+    static AzRPC_ClientLoop* instance = []() -> AzRPC_ClientLoop* {
+        std::string engine = AzRPC_Application::GetConfig().Load("client_io_engine");
+        if (engine.empty() || engine == "blocking") {
+            return nullptr;
+        }
+        AzRPC_ClientLoop* loop = new AzRPC_ClientLoop();
+        if (!loop->Start(engine)) {
+            AZRPC_LOG_ERROR("client io engine %s start error, use blocking io", engine.c_str());
+            delete loop;
+            return nullptr;
+        }
+        return loop;
+    }();
+    return instance;
+}
+
+uint64_t AzRPC_ClientLoop::NextCallId() {
+    static std::atomic<uint64_t> next_call_id(1);
+    return next_call_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+AzRPC_ClientLoop::AzRPC_ClientLoop(): m_wakeupfd(-1), m_next_conn_id(1), m_write_window_us(0) {}
+
+bool AzRPC_ClientLoop::Start(const std::string& engine) {
+    m_wakeupfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeupfd == -1) {
+        return false;
+    }
+    m_engine = AzRPC_ClientEngine::Create(engine, this, m_wakeupfd);
+    if (!m_engine) {
+        close(m_wakeupfd);
+        return false;
+    }
+    m_write_window_us = std::max(0L, atol(AzRPC_Application::GetConfig().Load("client_write_window_us").c_str()));
+    // 超时只能精确到毫秒时, 不足1毫秒的窗口会让暂缓的批最多多等1毫秒, 不如不暂缓
+    if (m_write_window_us > 0 && m_write_window_us < 1000 && !m_engine->PreciseTimeout()) {
+        AZRPC_LOG_INFO("client_write_window_us %ld below the 1ms timeout granularity of %s, write window disabled", static_cast<long>(m_write_window_us), m_engine->Name());
+        m_write_window_us = 0;
+    }
+    AZRPC_LOG_INFO("client io engine: %s", m_engine->Name());
+    m_thread = std::thread(&AzRPC_ClientLoop::Loop, this);
+    m_thread_id = m_thread.get_id();
+    m_thread.detach();
+    return true;
+}
+
+// 每轮: 等待并处理引擎事件(其中包括其他线程提交的任务), 然后把本轮积累的请求按连接一次性交给引擎
+// 开启了client_write_window_us时, 连接上还有更早的调用没有完成, 并且批还不大, 就暂缓到下一轮, 最多从批中第一个请求算起等待这么久
+// 那些调用的响应到达时循环本来就会被唤醒, 暂缓期间其他线程提交的请求合并进同一次发送; 连接上没有其他调用(低负载)时立即发送
+void AzRPC_ClientLoop::Loop() {
+    int64_t timeout_us = -1;
+    while (true) {
+        m_engine->Poll(timeout_us);
+        timeout_us = -1;
+        int64_t now_us = m_write_window_us > 0 ? NowMicros() : 0;
+        // Send可能同步关闭连接并执行响应回调, 回调中发起的调用会往m_dirty追加, 所以遍历换出来的副本
+        std::vector<uint64_t> dirty;
+        dirty.swap(m_dirty);
+        std::vector<uint64_t> held;
+        for (uint64_t id: dirty) {
+            auto it = m_connections.find(id);
+            if (it == m_connections.end() || it->second.batch.empty()) {
+                continue;
+            }
+            Connection& connection = it->second;
+            if (m_write_window_us > 0) {
+                int64_t wait_us = connection.batch_start_us + m_write_window_us - now_us;
+                if (wait_us > 0 && connection.batch.size() < kMaxHeldBytes && connection.pending.size() > connection.batch_calls) {
+                    held.push_back(id);
+                    timeout_us = timeout_us < 0 ? wait_us : std::min(timeout_us, wait_us);
+                    continue;
+                }
+            }
+            std::string batch;
+            batch.swap(connection.batch);
+            connection.batch_calls = 0;
+            m_engine->Send(id, std::move(batch));
+        }
+        // 本轮回调中新写入的请求不能等到下一个事件才发送
+        if (!m_dirty.empty()) {
+            timeout_us = 0;
+        }
+        m_dirty.insert(m_dirty.end(), held.begin(), held.end());
+    }
+}
+
+// 循环线程中直接执行(例如在响应回调中发起下一次调用), 否则排队并唤醒循环
+void AzRPC_ClientLoop::RunInLoop(std::function<void()> task) {
+    if (InLoopThread()) {
+        task();
+    }
+    else {
+        QueueInLoop(std::move(task));
+    }
+}
+
+// 排队到下一轮执行, 在循环线程中调用也不会立即执行
+void AzRPC_ClientLoop::QueueInLoop(std::function<void()> task) {
+    bool wakeup;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        wakeup = m_tasks.empty();
+        m_tasks.push_back(std::move(task));
+    }
+    // 队列非空时循环已经被唤醒过, 不需要再写eventfd
+    if (wakeup) {
+        uint64_t one = 1;
+        ssize_t ignored = write(m_wakeupfd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void AzRPC_ClientLoop::OnWakeup() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        tasks.swap(m_tasks);
+    }
+    for (auto& task: tasks) {
+        task();
+    }
+}
+
+uint64_t AzRPC_ClientLoop::Attach(int fd) {
+    uint64_t id = m_next_conn_id.fetch_add(1);
+    RunInLoop([this, id, fd] {
+        m_connections[id];
+        if (!m_engine->Add(id, fd)) {
+            Fail(id, "add connection to client io engine error");
+        }
+    });
+    return id;
+}
+
+// 总是推迟到下一轮执行, 响应回调中关闭连接时不会释放正在使用的接收缓冲区
+void AzRPC_ClientLoop::Detach(uint64_t conn_id) {
+    QueueInLoop([this, conn_id] {
+        m_engine->Remove(conn_id);
+        Fail(conn_id, "connection closed");
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_broken.erase(conn_id);
+    });
+}
+
+bool AzRPC_ClientLoop::Broken(uint64_t conn_id) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_broken.find(conn_id) != m_broken.end();
+}
+
+void AzRPC_ClientLoop::Call(uint64_t conn_id, uint64_t call_id, std::string frame, const ResponseCallback& callback) {
+    std::shared_ptr<std::string> data = std::make_shared<std::string>(std::move(frame));
+    RunInLoop([this, conn_id, call_id, data, callback] {
+        auto it = m_connections.find(conn_id);
+        if (it == m_connections.end()) {
+            callback(AzRPC::RpcResponseHeader(), nullptr, "connection closed");
+            return;
+        }
+        Connection& connection = it->second;
+        connection.pending[call_id] = callback;
+        if (connection.batch.empty()) {
+            m_dirty.push_back(conn_id);
+            connection.batch.swap(*data);
+            connection.batch_start_us = m_write_window_us > 0 ? NowMicros() : 0;
+        }
+        else {
+            connection.batch.append(*data);
+        }
+        ++connection.batch_calls;
+    });
+}
+
+// 连接失效, 所有等待中的调用以错误结束
+void AzRPC_ClientLoop::Fail(uint64_t conn_id, const std::string& reason) {
+    auto it = m_connections.find(conn_id);
+    if (it == m_connections.end()) {
+        return;
+    }
+    std::unordered_map<uint64_t, ResponseCallback> pending;
+    pending.swap(it->second.pending);
+    m_connections.erase(it);
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_broken[conn_id] = true;
+    }
+    AzRPC::RpcResponseHeader empty;
+    for (auto& item: pending) {
+        item.second(empty, nullptr, reason);
+    }
+}
+
+void AzRPC_ClientLoop::OnClose(uint64_t id, const std::string& reason) {
+    Fail(id, reason);
+}
+
+// 按帧解析收到的数据, 根据call_id找到对应的调用
+void AzRPC_ClientLoop::OnRead(uint64_t id, const char* data, size_t len) {
+    auto it = m_connections.find(id);
+    if (it == m_connections.end()) {
+        return;
+    }
+    it->second.input.append(data, len);
+
+    size_t offset = 0;
+    while (true) {
+        std::string& input = it->second.input;
+        AzRPC::RpcResponseHeader header;
+        size_t body_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeResponse(input.data() + offset, input.size() - offset, &header, &body_offset);
+        if (frame_size == AzRPC_Codec::kIncomplete) {
+            break;
+        }
+        if (frame_size < 0) {
+            // 帧边界不再可信, 断开连接, 等待中的调用全部失败
+            const char* reason = frame_size == AzRPC_Codec::kChecksumError ? "response checksum mismatch" : "parse response header error";
+            AZRPC_LOG_ERROR_RATELIMIT(10, "%s", reason);
+            m_engine->Remove(id);
+            Fail(id, reason);
+            return;
+        }
+
+        auto pit = it->second.pending.find(header.call_id());
+        if (pit != it->second.pending.end()) {
+            ResponseCallback callback;
+            callback.swap(pit->second);
+            it->second.pending.erase(pit);
+            callback(header, input.data() + offset + body_offset, std::string());
+            // 回调中可能关闭了连接
+            it = m_connections.find(id);
+            if (it == m_connections.end()) {
+                return;
+            }
+        }
+        offset += frame_size;
+    }
+    it->second.input.erase(0, offset);
+}
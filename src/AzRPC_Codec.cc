@@ -0,0 +1,157 @@
+#include "AzRPC_Codec.h"
+#include "AzRPC_Compress.h"
+#include "AzRPC_Crc32c.h"
+#include <google/protobuf/io/coded_stream.h>
+
+// 读取varint32, 最多5个字节
+int AzRPC_Codec::ReadVarint32(const char* data, size_t len, uint32_t* value) {
+    uint32_t result = 0;
+    for (size_t i = 0; i < 5; ++i) {
+        if (i >= len) {
+            return kIncomplete;
+        }
+        uint8_t byte = static_cast<uint8_t>(data[i]);
+        // 第5字节只能携带最高的4位, 更大的值超出32位, 不能截断成另一个长度
+        if (i == 4 && byte > 0x0F) {
+            return kInvalid;
+        }
+        result |= static_cast<uint32_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return static_cast<int>(i + 1);
+        }
+    }
+    return kInvalid;
+}
+
+// 编码: 长度前缀 + header + body [+ 附件] [+ CRC32C], 一次分配好内存
+// trailer不为nullptr时附件不拷贝到out, 校验和写入trailer, 计算校验和时依次扫过out中的部分和附件的各块
+bool AzRPC_Codec::Encode(const google::protobuf::Message& header, const std::string& body, const AzRPC_Attachment* attachment, bool checksum, std::string* out, std::string* trailer) {
+    size_t header_size = header.ByteSizeLong();
+    size_t offset = out->size();
+    size_t varint_size = google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(header_size));
+    // 与CheckFrame一致, 超过2GB的帧对端无法解码
+    if (varint_size + header_size + body.size() + (attachment != nullptr ? attachment->size() : 0) + kChecksumSize > 0x7FFFFFFF) {
+        return false;
+    }
+    size_t attachment_size = attachment != nullptr && trailer == nullptr ? attachment->size() : 0;
+    size_t frame_size = varint_size + header_size + body.size() + attachment_size + (checksum && trailer == nullptr ? kChecksumSize : 0);
+    out->reserve(offset + frame_size);
+    out->resize(offset + varint_size + header_size);
+
+    uint8_t* target = reinterpret_cast<uint8_t*>(&(*out)[offset]);
+    target = google::protobuf::io::CodedOutputStream::WriteVarint32ToArray(static_cast<uint32_t>(header_size), target);
+    if (!header.SerializeWithCachedSizesToArray(target)) {
+        out->resize(offset);
+        return false;
+    }
+    out->append(body);
+    if (attachment_size > 0) {
+        attachment->AppendTo(out);
+    }
+    if (checksum) {
+        uint32_t crc = AzRPC_Crc32c::Value(out->data() + offset, out->size() - offset);
+        if (trailer != nullptr && attachment != nullptr) {
+            crc = attachment->ExtendCrc32c(crc);
+        }
+        char bytes[kChecksumSize] = {static_cast<char>(crc), static_cast<char>(crc >> 8), static_cast<char>(crc >> 16), static_cast<char>(crc >> 24)};
+        (trailer != nullptr ? trailer : out)->append(bytes, kChecksumSize);
+    }
+    return true;
+}
+
+// 根据已解析的header确定帧长度, 帧完整且带校验时验证校验和
+int AzRPC_Codec::CheckFrame(const char* data, size_t len, size_t header_end, size_t body_size, bool checksum) {
+    size_t frame_size = header_end + body_size + (checksum ? kChecksumSize : 0);
+    if (frame_size > 0x7FFFFFFF) {
+        return kInvalid;
+    }
+    if (len < frame_size) {
+        return kIncomplete;
+    }
+    if (checksum) {
+        size_t crc_offset = frame_size - kChecksumSize;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data + crc_offset);
+        uint32_t expected = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+        if (AzRPC_Crc32c::Value(data, crc_offset) != expected) {
+            return kChecksumError;
+        }
+    }
+    return static_cast<int>(frame_size);
+}
+
+// 解码长度前缀和header, header_end为header之后第一个字节的偏移
+int AzRPC_Codec::DecodeHeader(const char* data, size_t len, google::protobuf::Message* header, size_t* header_end) {
+    uint32_t header_size = 0;
+    int n = ReadVarint32(data, len, &header_size);
+    if (n <= 0) {
+        return n;
+    }
+    if (header_size > kMaxHeaderSize) {
+        return kInvalid;
+    }
+    if (len < n + header_size) {
+        return kIncomplete;
+    }
+    if (!header->ParseFromArray(data + n, header_size)) {
+        return kInvalid;
+    }
+    *header_end = n + header_size;
+    return 1;
+}
+
+bool AzRPC_Codec::EncodeRequest(AzRPC::RpcHeader* header, const std::string& args, std::string* out) {
+    header->set_args_size(static_cast<uint32_t>(args.size()));
+    header->set_attachment_size(0);
+    return Encode(*header, args, nullptr, header->checksum(), out, nullptr);
+}
+
+bool AzRPC_Codec::EncodeRequest(AzRPC::RpcHeader* header, const std::string& args, const AzRPC_Attachment& attachment, std::string* out, std::string* trailer) {
+    header->set_args_size(static_cast<uint32_t>(args.size()));
+    header->set_attachment_size(static_cast<uint32_t>(attachment.size()));
+    return Encode(*header, args, &attachment, header->checksum(), out, trailer);
+}
+
+int AzRPC_Codec::DecodeRequest(const char* data, size_t len, AzRPC::RpcHeader* header, size_t* body_offset) {
+    size_t header_end = 0;
+    int rt = DecodeHeader(data, len, header, &header_end);
+    if (rt <= 0) {
+        return rt;
+    }
+    *body_offset = header_end;
+    return CheckFrame(data, len, header_end, static_cast<size_t>(header->args_size()) + header->attachment_size(), header->checksum());
+}
+
+bool AzRPC_Codec::EncodeResponse(AzRPC::RpcResponseHeader* header, const std::string& body, std::string* out) {
+    header->set_body_size(static_cast<uint32_t>(body.size()));
+    header->set_attachment_size(0);
+    return Encode(*header, body, nullptr, header->checksum(), out, nullptr);
+}
+
+bool AzRPC_Codec::EncodeResponse(AzRPC::RpcResponseHeader* header, const std::string& body, const AzRPC_Attachment& attachment, std::string* out, std::string* trailer) {
+    header->set_body_size(static_cast<uint32_t>(body.size()));
+    header->set_attachment_size(static_cast<uint32_t>(attachment.size()));
+    return Encode(*header, body, &attachment, header->checksum(), out, trailer);
+}
+
+bool AzRPC_Codec::EncodeResponse(AzRPC::RpcResponseHeader* header, const std::string& body, AzRPC::CompressType compress, const AzRPC_Attachment& attachment, std::string* out, std::string* trailer) {
+    if (compress != AzRPC::COMPRESS_NONE) {
+        std::string compressed;
+        if (AzRPC_Compress::Compress(compress, body, &compressed) != AzRPC::COMPRESS_NONE) {
+            header->set_compress_type(compress);
+            header->set_body_raw_size(static_cast<uint32_t>(body.size()));
+            return EncodeResponse(header, compressed, attachment, out, trailer);
+        }
+    }
+    return EncodeResponse(header, body, attachment, out, trailer);
+}
+
+int AzRPC_Codec::DecodeResponse(const char* data, size_t len, AzRPC::RpcResponseHeader* header, size_t* body_offset) {
+    size_t header_end = 0;
+    int rt = DecodeHeader(data, len, header, &header_end);
+    if (rt <= 0) {
+        return rt;
+    }
+    *body_offset = header_end;
+    return CheckFrame(data, len, header_end, static_cast<size_t>(header->body_size()) + header->attachment_size(), header->checksum());
+}
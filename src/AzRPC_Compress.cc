@@ -0,0 +1,211 @@
+#include "AzRPC_Compress.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Logger.h"
+#include <cstdlib>
+#ifdef AZRPC_HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef AZRPC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef AZRPC_HAVE_SNAPPY
+#include <snappy-c.h>
+#endif
+
+namespace {
+
+// 小于阈值的数据压缩收益很小, 直接发送
+size_t Threshold() {
+    static const size_t threshold = []() -> size_t {
+        std::string value = AzRPC_Application::GetConfig().Load("rpc_compress_threshold");
+        return value.empty() ? 1024 : strtoul(value.c_str(), nullptr, 10);
+    }();
+    return threshold;
+}
+
+#ifdef AZRPC_HAVE_ZSTD
+int ZstdLevel() {
+    static const int level = []() -> int {
+        std::string value = AzRPC_Application::GetConfig().Load("rpc_compress_zstd_level");
+        return value.empty() ? 1 : atoi(value.c_str());
+    }();
+    return level;
+}
+
+// 每个线程复用自己的压缩和解压上下文, 避免每次调用都分配内部的窗口和哈希表
+struct ZstdContext {
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    ~ZstdContext() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+ZstdContext& LocalZstdContext() {
+    static thread_local ZstdContext context;
+    return context;
+}
+#endif
+
+// 压缩到out中, 失败或压缩后没有变小时返回false
+bool CompressTo(AzRPC::CompressType type, const std::string& data, std::string* out) {
+    switch (type) {
+#ifdef AZRPC_HAVE_LZ4
+    case AzRPC::COMPRESS_LZ4: {
+        if (data.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+            return false;
+        }
+        out->resize(LZ4_compressBound(static_cast<int>(data.size())));
+        int n = LZ4_compress_default(data.data(), &(*out)[0], static_cast<int>(data.size()), static_cast<int>(out->size()));
+        if (n <= 0) {
+            return false;
+        }
+        out->resize(n);
+        break;
+    }
+#endif
+#ifdef AZRPC_HAVE_ZSTD
+    case AzRPC::COMPRESS_ZSTD: {
+        out->resize(ZSTD_compressBound(data.size()));
+        size_t n = ZSTD_compressCCtx(LocalZstdContext().cctx, &(*out)[0], out->size(), data.data(), data.size(), ZstdLevel());
+        if (ZSTD_isError(n)) {
+            return false;
+        }
+        out->resize(n);
+        break;
+    }
+#endif
+#ifdef AZRPC_HAVE_SNAPPY
+    case AzRPC::COMPRESS_SNAPPY: {
+        size_t n = snappy_max_compressed_length(data.size());
+        out->resize(n);
+        if (snappy_compress(data.data(), data.size(), &(*out)[0], &n) != SNAPPY_OK) {
+            return false;
+        }
+        out->resize(n);
+        break;
+    }
+#endif
+    default:
+        return false;
+    }
+    return out->size() < data.size();
+}
+
+}  // namespace
+
+bool AzRPC_Compress::Supported(AzRPC::CompressType type) {
+    switch (type) {
+    case AzRPC::COMPRESS_NONE:
+        return true;
+#ifdef AZRPC_HAVE_LZ4
+    case AzRPC::COMPRESS_LZ4:
+        return true;
+#endif
+#ifdef AZRPC_HAVE_ZSTD
+    case AzRPC::COMPRESS_ZSTD:
+        return true;
+#endif
+#ifdef AZRPC_HAVE_SNAPPY
+    case AzRPC::COMPRESS_SNAPPY:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool AzRPC_Compress::Parse(const std::string& name, AzRPC::CompressType* type) {
+    if (name == "none") {
+        *type = AzRPC::COMPRESS_NONE;
+    }
+    else if (name == "lz4") {
+        *type = AzRPC::COMPRESS_LZ4;
+    }
+    else if (name == "zstd") {
+        *type = AzRPC::COMPRESS_ZSTD;
+    }
+    else if (name == "snappy") {
+        *type = AzRPC::COMPRESS_SNAPPY;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+const char* AzRPC_Compress::Name(AzRPC::CompressType type) {
+    switch (type) {
+    case AzRPC::COMPRESS_NONE:
+        return "none";
+    case AzRPC::COMPRESS_LZ4:
+        return "lz4";
+    case AzRPC::COMPRESS_ZSTD:
+        return "zstd";
+    case AzRPC::COMPRESS_SNAPPY:
+        return "snappy";
+    default:
+        return "unknown";
+    }
+}
+
+AzRPC::CompressType AzRPC_Compress::ForMethod(const std::string& service_name, const std::string& method_name) {
+    // 没有任何压缩配置时(默认情况)不做逐次查找; 只匹配rpc_compress和rpc_compress.*, rpc_compress_threshold和rpc_compress_zstd_level不算
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpc_compress");
+    if (!configured) {
+        return AzRPC::COMPRESS_NONE;
+    }
+
+    std::string name = AzRPC_Application::GetConfig().LoadForMethod("rpc_compress", service_name, method_name);
+    AzRPC::CompressType type = AzRPC::COMPRESS_NONE;
+    if (!name.empty() && !Parse(name, &type)) {
+        AZRPC_LOG_ERROR_RATELIMIT(1, "unknown compress type %s for %s.%s", name.c_str(), service_name.c_str(), method_name.c_str());
+    }
+    return type;
+}
+
+AzRPC::CompressType AzRPC_Compress::Compress(AzRPC::CompressType type, const std::string& data, std::string* out) {
+    if (type == AzRPC::COMPRESS_NONE || data.size() < Threshold()) {
+        return AzRPC::COMPRESS_NONE;
+    }
+    if (!Supported(type)) {
+        AZRPC_LOG_ERROR_RATELIMIT(1, "compress type %s is not built in, send uncompressed", Name(type));
+        return AzRPC::COMPRESS_NONE;
+    }
+    std::string compressed;
+    if (!CompressTo(type, data, &compressed)) {
+        return AzRPC::COMPRESS_NONE;
+    }
+    out->swap(compressed);
+    return type;
+}
+
+bool AzRPC_Compress::Decompress(AzRPC::CompressType type, const char* data, size_t len, size_t raw_size, std::string* out) {
+    if (raw_size > kMaxRawSize) {
+        return false;
+    }
+    out->resize(raw_size);
+    switch (type) {
+#ifdef AZRPC_HAVE_LZ4
+    case AzRPC::COMPRESS_LZ4: {
+        int n = LZ4_decompress_safe(data, &(*out)[0], static_cast<int>(len), static_cast<int>(raw_size));
+        return n >= 0 && static_cast<size_t>(n) == raw_size;
+    }
+#endif
+#ifdef AZRPC_HAVE_ZSTD
+    case AzRPC::COMPRESS_ZSTD: {
+        size_t n = ZSTD_decompressDCtx(LocalZstdContext().dctx, &(*out)[0], raw_size, data, len);
+        return !ZSTD_isError(n) && n == raw_size;
+    }
+#endif
+#ifdef AZRPC_HAVE_SNAPPY
+    case AzRPC::COMPRESS_SNAPPY: {
+        size_t n = raw_size;
+        return snappy_uncompress(data, len, &(*out)[0], &n) == SNAPPY_OK && n == raw_size;
+    }
+#endif
+    default:
+        return false;
+    }
+}
@@ -52,6 +52,32 @@ std::string AzRPC_Config::Load(const std::string& key) {
     return it->second;
 }
 
+// 按方法查找配置, 方法优先于服务, 服务优先于全局
+std::string AzRPC_Config::LoadForMethod(const std::string& prefix, const std::string& service_name, const std::string& method_name) {
+    std::string value = Load(prefix + "." + service_name + "." + method_name);
+    if (value.empty()) {
+        value = Load(prefix + "." + service_name);
+    }
+    if (value.empty()) {
+        value = Load(prefix);
+    }
+    return value;
+}
+
+bool AzRPC_Config::HasPrefix(const std::string& prefix) const {
+    for (auto& item: config_map) {
+        if (item.first == prefix || item.first.compare(0, prefix.size() + 1, prefix + ".") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 获取全部键值对
+const std::unordered_map<std::string, std::string>& AzRPC_Config::All() const {
+    return config_map;
+}
+
 // 去掉字符串前后空格的函数
 void AzRPC_Config::Trim(std::string& read_buf) {
     // 先去掉前面的空格
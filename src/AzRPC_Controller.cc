@@ -1,15 +1,36 @@
 #include "AzRPC_Controller.h"
+#include <algorithm>
 
 // 构造函数, 初始化控制器状态
 AzRPC_Controller::AzRPC_Controller() {
     m_failed = false;
     m_errText = "";
+    m_compress_set = false;
+    m_compress = AzRPC::COMPRESS_NONE;
+    m_priority_set = false;
+    m_priority = AzRPC::PRIORITY_NORMAL;
+    m_canceled = false;
+}
+
+AzRPC_Controller::~AzRPC_Controller() {
+    ClearCancelCallbacks();
 }
 
 // 重置控制器状态, 将失败标志和错误消息清空
 void AzRPC_Controller::Reset() {
     m_failed = false;
     m_errText = "";
+    m_trace = AzRPC_TraceContext();
+    m_compress_set = false;
+    m_compress = AzRPC::COMPRESS_NONE;
+    m_priority_set = false;
+    m_priority = AzRPC::PRIORITY_NORMAL;
+    m_tenant.clear();
+    m_request_attachment.Clear();
+    m_response_attachment.Clear();
+    ClearCancelCallbacks();
+    std::lock_guard<std::mutex> lock(m_cancel_mtx);
+    m_canceled = false;
 }
 
 // 判断当前RPC调用是否失败
@@ -28,18 +49,111 @@ void AzRPC_Controller::SetFailed(const std::string& reason) {
     m_errText = reason;
 }
 
-// 以下功能未实现，是RPC服务端提供的取消功能
-// 开始取消RPC调用（未实现）
+// 取消调用, 注册的回调在锁外执行, 回调中可以再访问controller
 void AzRPC_Controller::StartCancel() {
-    // 目前为空，未实现具体功能
+    std::vector<google::protobuf::Closure*> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_cancel_mtx);
+        if (m_canceled) {
+            return;
+        }
+        m_canceled = true;
+        callbacks.swap(m_cancel_callbacks);
+    }
+    for (google::protobuf::Closure* callback: callbacks) {
+        callback->Run();
+    }
 }
 
-// 判断RPC调用是否被取消（未实现）
+// 判断调用是否已被取消
 bool AzRPC_Controller::IsCanceled() const {
-    return false;  // 默认返回false，表示未被取消
+    std::lock_guard<std::mutex> lock(m_cancel_mtx);
+    return m_canceled;
 }
 
-// 注册取消回调函数（未实现）
+// 注册取消回调
 void AzRPC_Controller::NotifyOnCancel(google::protobuf::Closure* callback) {
-    // 目前为空，未实现具体功能
-}
\ No newline at end of file
+    {
+        std::lock_guard<std::mutex> lock(m_cancel_mtx);
+        if (!m_canceled) {
+            m_cancel_callbacks.push_back(callback);
+            return;
+        }
+    }
+    callback->Run();
+}
+
+// 删除指定的取消回调
+bool AzRPC_Controller::RemoveCancelCallback(google::protobuf::Closure* callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_cancel_mtx);
+        auto it = std::find(m_cancel_callbacks.begin(), m_cancel_callbacks.end(), callback);
+        if (it == m_cancel_callbacks.end()) {
+            return false;
+        }
+        m_cancel_callbacks.erase(it);
+    }
+    delete callback;
+    return true;
+}
+
+// 删除没有执行的取消回调
+void AzRPC_Controller::ClearCancelCallbacks() {
+    std::vector<google::protobuf::Closure*> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_cancel_mtx);
+        callbacks.swap(m_cancel_callbacks);
+    }
+    for (google::protobuf::Closure* callback: callbacks) {
+        delete callback;
+    }
+}
+
+// 设置本次调用的追踪上下文
+void AzRPC_Controller::SetTraceContext(const AzRPC_TraceContext& context) {
+    m_trace = context;
+}
+
+// 获取本次调用的追踪上下文
+const AzRPC_TraceContext& AzRPC_Controller::GetTraceContext() const {
+    return m_trace;
+}
+
+// 设置本次调用的压缩算法
+void AzRPC_Controller::SetCompressType(AzRPC::CompressType type) {
+    m_compress_set = true;
+    m_compress = type;
+}
+
+// 获取本次调用指定的压缩算法
+bool AzRPC_Controller::GetCompressType(AzRPC::CompressType* type) const {
+    if (!m_compress_set) {
+        return false;
+    }
+    *type = m_compress;
+    return true;
+}
+// 指定本次调用的优先级类别
+void AzRPC_Controller::SetPriority(AzRPC::Priority priority) {
+    m_priority_set = true;
+    m_priority = priority;
+}
+
+// 获取本次调用指定的优先级类别
+bool AzRPC_Controller::GetPriority(AzRPC::Priority* priority) const {
+    if (!m_priority_set) {
+        return false;
+    }
+    *priority = m_priority;
+    return true;
+}
+
+// 指定本次调用所属的租户
+void AzRPC_Controller::SetTenant(const std::string& tenant) {
+    m_tenant = tenant;
+}
+
+// 获取本次调用指定的租户
+const std::string& AzRPC_Controller::Tenant() const {
+    return m_tenant;
+}
@@ -0,0 +1,82 @@
+#include "AzRPC_Cork.h"
+#include <muduo/net/EventLoop.h>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+struct CorkedOutput {
+    muduo::net::TcpConnectionPtr connection;
+    std::string data;
+};
+// 每个IO线程各自的暂存
+thread_local std::unordered_map<muduo::net::TcpConnection*, CorkedOutput> corked_outputs;
+
+// 写出一个连接暂存的数据
+void FlushConnection(const muduo::net::TcpConnectionPtr& connection) {
+    auto it = corked_outputs.find(connection.get());
+    if (it != corked_outputs.end() && !it->second.data.empty()) {
+        connection->send(it->second.data);
+        it->second.data.clear();
+    }
+}
+
+}  // namespace
+
+const size_t AzRPC_Cork::kFlushBytes;
+
+void AzRPC_Cork::Send(const muduo::net::TcpConnectionPtr& connection, const char* data, size_t len) {
+    if (corked_outputs.empty()) {
+        connection->getLoop()->queueInLoop(&AzRPC_Cork::Flush);
+    }
+    CorkedOutput& output = corked_outputs[connection.get()];
+    if (!output.connection) {
+        output.connection = connection;
+    }
+    if (output.data.size() + len < kFlushBytes) {
+        output.data.append(data, len);
+        return;
+    }
+    // 已经足够大, 按顺序立即写出
+    SendDirect(connection, data, len);
+}
+
+void AzRPC_Cork::Send(const muduo::net::TcpConnectionPtr& connection, const std::string& frame, const AzRPC_Attachment& attachment, const std::string& trailer) {
+    if (frame.size() + attachment.size() + trailer.size() < kFlushBytes) {
+        // 较小的附件随帧一起暂存, 各部分连续追加, 不会插入其他响应
+        Send(connection, frame.data(), frame.size());
+        for (const AzRPC_Attachment::Block& block: attachment.Blocks()) {
+            Send(connection, block.data, block.size);
+        }
+        Send(connection, trailer.data(), trailer.size());
+        return;
+    }
+    // 直接写socket, 先写出本轮暂存的响应; 写不完的部分进入输出缓冲区, 各部分之间不会插入其他响应
+    SendDirect(connection, frame.data(), frame.size());
+    for (const AzRPC_Attachment::Block& block: attachment.Blocks()) {
+        connection->send(block.data, static_cast<int>(block.size));
+    }
+    if (!trailer.empty()) {
+        connection->send(trailer.data(), static_cast<int>(trailer.size()));
+    }
+}
+
+void AzRPC_Cork::SendDirect(const muduo::net::TcpConnectionPtr& connection, const char* data, size_t len) {
+    FlushConnection(connection);
+    connection->send(data, static_cast<int>(len));
+}
+
+size_t AzRPC_Cork::Pending(const muduo::net::TcpConnection* connection) {
+    auto it = corked_outputs.find(const_cast<muduo::net::TcpConnection*>(connection));
+    return it != corked_outputs.end() ? it->second.data.size() : 0;
+}
+
+void AzRPC_Cork::Flush() {
+    for (auto& item: corked_outputs) {
+        CorkedOutput& output = item.second;
+        if (!output.data.empty() && output.connection->connected()) {
+            output.connection->send(output.data);
+        }
+    }
+    corked_outputs.clear();
+}
@@ -0,0 +1,216 @@
+#include "AzRPC_Crc32c.h"
+#include <cstring>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define AZRPC_CRC32C_SSE42 1
+#endif
+
+namespace {
+
+const uint32_t kPoly = 0x82f63b78;      // CRC32C多项式(反射形式)
+
+inline uint64_t Load64(const unsigned char* p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// 查表实现: slicing-by-8, 每次处理8个字节
+struct SoftwareTable {
+    uint32_t table[8][256];
+
+    SoftwareTable() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t crc = n;
+            for (int k = 0; k < 8; ++k) {
+                crc = crc & 1 ? (crc >> 1) ^ kPoly : crc >> 1;
+            }
+            table[0][n] = crc;
+        }
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t crc = table[0][n];
+            for (int k = 1; k < 8; ++k) {
+                crc = table[0][crc & 0xff] ^ (crc >> 8);
+                table[k][n] = crc;
+            }
+        }
+    }
+};
+
+const SoftwareTable& GetSoftwareTable() {
+    static const SoftwareTable table;
+    return table;
+}
+
+uint32_t ExtendSoftware(uint32_t crc, const unsigned char* next, size_t len) {
+    const uint32_t (*table)[256] = GetSoftwareTable().table;
+    uint64_t crc0 = crc ^ 0xffffffff;
+    while (len > 0 && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+        crc0 = table[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+        --len;
+    }
+    while (len >= 8) {
+        // 小端机器上低位字节在前
+        crc0 ^= Load64(next);
+        crc0 = table[7][crc0 & 0xff] ^ table[6][(crc0 >> 8) & 0xff] ^
+               table[5][(crc0 >> 16) & 0xff] ^ table[4][(crc0 >> 24) & 0xff] ^
+               table[3][(crc0 >> 32) & 0xff] ^ table[2][(crc0 >> 40) & 0xff] ^
+               table[1][(crc0 >> 48) & 0xff] ^ table[0][crc0 >> 56];
+        next += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        crc0 = table[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+        --len;
+    }
+    return static_cast<uint32_t>(crc0) ^ 0xffffffff;
+}
+
+#ifdef AZRPC_CRC32C_SSE42
+
+// crc32指令延迟3个周期、每周期可以发射一条, 单路串行计算只能用到三分之一的吞吐
+// 把一段数据分成相邻的三块同时计算, 再把前两块的结果"移过"后面块的长度后合并
+// 移位操作是GF(2)上的线性变换, 预先为固定的块长生成查找表(见Mark Adler的crc32c.c)
+const size_t kLongBlock = 8192;
+const size_t kShortBlock = 256;
+
+uint32_t MatrixTimes(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+        vec >>= 1;
+        ++mat;
+    }
+    return sum;
+}
+
+void MatrixSquare(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; ++n) {
+        square[n] = MatrixTimes(mat, mat[n]);
+    }
+}
+
+// 生成CRC后接len个0字节的变换矩阵, len必须是2的幂
+void ZerosOperator(uint32_t* even, size_t len) {
+    uint32_t odd[32];
+    odd[0] = kPoly;         // 1个0比特
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    MatrixSquare(even, odd);    // 2个0比特
+    MatrixSquare(odd, even);    // 4个0比特
+    // 下一次平方得到1个0字节, 之后每次平方长度翻倍
+    do {
+        MatrixSquare(even, odd);
+        len >>= 1;
+        if (len == 0) {
+            return;
+        }
+        MatrixSquare(odd, even);
+        len >>= 1;
+    } while (len);
+    memcpy(even, odd, sizeof(odd));
+}
+
+struct ShiftTable {
+    uint32_t zeros[4][256];
+
+    explicit ShiftTable(size_t len) {
+        uint32_t op[32];
+        ZerosOperator(op, len);
+        for (uint32_t n = 0; n < 256; ++n) {
+            zeros[0][n] = MatrixTimes(op, n);
+            zeros[1][n] = MatrixTimes(op, n << 8);
+            zeros[2][n] = MatrixTimes(op, n << 16);
+            zeros[3][n] = MatrixTimes(op, n << 24);
+        }
+    }
+
+    uint32_t Shift(uint32_t crc) const {
+        return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+    }
+};
+
+const ShiftTable& LongShift() {
+    static const ShiftTable table(kLongBlock);
+    return table;
+}
+
+const ShiftTable& ShortShift() {
+    static const ShiftTable table(kShortBlock);
+    return table;
+}
+
+// 三路交错计算每块block字节, 处理完len中所有完整的3*block
+__attribute__((target("sse4.2")))
+uint64_t ExtendInterleaved(uint64_t crc0, const unsigned char*& next, size_t& len, size_t block, const ShiftTable& shift) {
+    while (len >= block * 3) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        const unsigned char* end = next + block;
+        do {
+            crc0 = _mm_crc32_u64(crc0, Load64(next));
+            crc1 = _mm_crc32_u64(crc1, Load64(next + block));
+            crc2 = _mm_crc32_u64(crc2, Load64(next + block * 2));
+            next += 8;
+        } while (next < end);
+        crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc1;
+        crc0 = shift.Shift(static_cast<uint32_t>(crc0)) ^ crc2;
+        next += block * 2;
+        len -= block * 3;
+    }
+    return crc0;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t ExtendHardware(uint32_t crc, const unsigned char* next, size_t len) {
+    uint64_t crc0 = crc ^ 0xffffffff;
+    while (len > 0 && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+        --len;
+    }
+    crc0 = ExtendInterleaved(crc0, next, len, kLongBlock, LongShift());
+    crc0 = ExtendInterleaved(crc0, next, len, kShortBlock, ShortShift());
+    while (len >= 8) {
+        crc0 = _mm_crc32_u64(crc0, Load64(next));
+        next += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+        --len;
+    }
+    return static_cast<uint32_t>(crc0) ^ 0xffffffff;
+}
+
+bool HardwareSupported() {
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+
+#endif
+
+}  // namespace
+
+uint32_t AzRPC_Crc32c::Extend(uint32_t crc, const char* data, size_t len) {
+    const unsigned char* next = reinterpret_cast<const unsigned char*>(data);
+#ifdef AZRPC_CRC32C_SSE42
+    if (HardwareSupported()) {
+        return ExtendHardware(crc, next, len);
+    }
+#endif
+    return ExtendSoftware(crc, next, len);
+}
+
+const char* AzRPC_Crc32c::Implementation() {
+#ifdef AZRPC_CRC32C_SSE42
+    if (HardwareSupported()) {
+        return "sse4.2";
+    }
+#endif
+    return "table";
+}
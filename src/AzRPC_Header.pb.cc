@@ -25,7 +25,22 @@ PROTOBUF_CONSTEXPR RpcHeader::RpcHeader(
     ::_pbi::ConstantInitialized): _impl_{
     /*decltype(_impl_.service_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.method_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.tenant_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.trace_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.span_id_)*/uint64_t{0u}
   , /*decltype(_impl_.args_size_)*/0u
+  , /*decltype(_impl_.trace_flags_)*/0u
+  , /*decltype(_impl_.parent_span_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.call_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.compress_type_)*/0
+  , /*decltype(_impl_.args_raw_size_)*/0u
+  , /*decltype(_impl_.response_compress_)*/0
+  , /*decltype(_impl_.checksum_)*/false
+  , /*decltype(_impl_.attachment_size_)*/0u
+  , /*decltype(_impl_.stream_type_)*/0
+  , /*decltype(_impl_.stream_credits_)*/0u
+  , /*decltype(_impl_.batch_count_)*/0u
+  , /*decltype(_impl_.priority_)*/0
   , /*decltype(_impl_._cached_size_)*/{}} {}
 struct RpcHeaderDefaultTypeInternal {
   PROTOBUF_CONSTEXPR RpcHeaderDefaultTypeInternal()
@@ -36,9 +51,32 @@ struct RpcHeaderDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcHeaderDefaultTypeInternal _RpcHeader_default_instance_;
+PROTOBUF_CONSTEXPR RpcResponseHeader::RpcResponseHeader(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.error_text_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.body_size_)*/0u
+  , /*decltype(_impl_.error_code_)*/0
+  , /*decltype(_impl_.call_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.compress_type_)*/0
+  , /*decltype(_impl_.body_raw_size_)*/0u
+  , /*decltype(_impl_.checksum_)*/false
+  , /*decltype(_impl_.attachment_size_)*/0u
+  , /*decltype(_impl_.stream_type_)*/0
+  , /*decltype(_impl_.stream_credits_)*/0u
+  , /*decltype(_impl_.batch_count_)*/0u
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct RpcResponseHeaderDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR RpcResponseHeaderDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~RpcResponseHeaderDefaultTypeInternal() {}
+  union {
+    RpcResponseHeader _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcResponseHeaderDefaultTypeInternal _RpcResponseHeader_default_instance_;
 }  // namespace AzRPC
-static ::_pb::Metadata file_level_metadata_AzRPC_5fHeader_2eproto[1];
-static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_AzRPC_5fHeader_2eproto = nullptr;
+static ::_pb::Metadata file_level_metadata_AzRPC_5fHeader_2eproto[2];
+static const ::_pb::EnumDescriptor* file_level_enum_descriptors_AzRPC_5fHeader_2eproto[4];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_AzRPC_5fHeader_2eproto = nullptr;
 
 const uint32_t TableStruct_AzRPC_5fHeader_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
@@ -51,25 +89,89 @@ const uint32_t TableStruct_AzRPC_5fHeader_2eproto::offsets[] PROTOBUF_SECTION_VA
   PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.service_name_),
   PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.method_name_),
   PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.args_size_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.trace_id_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.span_id_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.parent_span_id_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.trace_flags_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.call_id_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.compress_type_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.args_raw_size_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.response_compress_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.checksum_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.attachment_size_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.stream_type_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.stream_credits_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.batch_count_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.priority_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcHeader, _impl_.tenant_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.body_size_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.error_code_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.error_text_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.call_id_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.compress_type_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.body_raw_size_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.checksum_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.attachment_size_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.stream_type_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.stream_credits_),
+  PROTOBUF_FIELD_OFFSET(::AzRPC::RpcResponseHeader, _impl_.batch_count_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, -1, sizeof(::AzRPC::RpcHeader)},
+  { 24, -1, -1, sizeof(::AzRPC::RpcResponseHeader)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
   &::AzRPC::_RpcHeader_default_instance_._instance,
+  &::AzRPC::_RpcResponseHeader_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_AzRPC_5fHeader_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
-  "\n\022AzRPC_Header.proto\022\005AzRPC\"I\n\tRpcHeader"
-  "\022\024\n\014service_name\030\001 \001(\014\022\023\n\013method_name\030\002 "
-  "\001(\014\022\021\n\targs_size\030\003 \001(\rb\006proto3"
+  "\n\022AzRPC_Header.proto\022\005AzRPC\"\325\003\n\tRpcHeade"
+  "r\022\024\n\014service_name\030\001 \001(\014\022\023\n\013method_name\030\002"
+  " \001(\014\022\021\n\targs_size\030\003 \001(\r\022\020\n\010trace_id\030\004 \001("
+  "\006\022\017\n\007span_id\030\005 \001(\006\022\026\n\016parent_span_id\030\006 \001"
+  "(\006\022\023\n\013trace_flags\030\007 \001(\r\022\017\n\007call_id\030\010 \001(\004"
+  "\022*\n\rcompress_type\030\t \001(\0162\023.AzRPC.Compress"
+  "Type\022\025\n\rargs_raw_size\030\n \001(\r\022.\n\021response_"
+  "compress\030\013 \001(\0162\023.AzRPC.CompressType\022\020\n\010c"
+  "hecksum\030\014 \001(\010\022\027\n\017attachment_size\030\r \001(\r\022+"
+  "\n\013stream_type\030\016 \001(\0162\026.AzRPC.StreamFrameT"
+  "ype\022\026\n\016stream_credits\030\017 \001(\r\022\023\n\013batch_cou"
+  "nt\030\020 \001(\r\022!\n\010priority\030\021 \001(\0162\017.AzRPC.Prior"
+  "ity\022\016\n\006tenant\030\022 \001(\014\"\271\002\n\021RpcResponseHeade"
+  "r\022\021\n\tbody_size\030\001 \001(\r\022$\n\nerror_code\030\002 \001(\016"
+  "2\020.AzRPC.ErrorCode\022\022\n\nerror_text\030\003 \001(\014\022\017"
+  "\n\007call_id\030\004 \001(\004\022*\n\rcompress_type\030\005 \001(\0162\023"
+  ".AzRPC.CompressType\022\025\n\rbody_raw_size\030\006 \001"
+  "(\r\022\020\n\010checksum\030\007 \001(\010\022\027\n\017attachment_size\030"
+  "\010 \001(\r\022+\n\013stream_type\030\t \001(\0162\026.AzRPC.Strea"
+  "mFrameType\022\026\n\016stream_credits\030\n \001(\r\022\023\n\013ba"
+  "tch_count\030\013 \001(\r*[\n\014CompressType\022\021\n\rCOMPR"
+  "ESS_NONE\020\000\022\020\n\014COMPRESS_LZ4\020\001\022\021\n\rCOMPRESS"
+  "_ZSTD\020\002\022\023\n\017COMPRESS_SNAPPY\020\003*g\n\017StreamFr"
+  "ameType\022\017\n\013STREAM_NONE\020\000\022\017\n\013STREAM_OPEN\020"
+  "\001\022\017\n\013STREAM_DATA\020\002\022\016\n\nSTREAM_END\020\003\022\021\n\rST"
+  "REAM_CREDIT\020\004*[\n\010Priority\022\023\n\017PRIORITY_NO"
+  "RMAL\020\000\022\020\n\014PRIORITY_LOW\020\001\022\021\n\rPRIORITY_HIG"
+  "H\020\002\022\025\n\021PRIORITY_CRITICAL\020\003*\257\001\n\tErrorCode"
+  "\022\006\n\002OK\020\000\022\025\n\021SERVICE_NOT_FOUND\020\001\022\024\n\020METHO"
+  "D_NOT_FOUND\020\002\022\027\n\023REQUEST_PARSE_ERROR\020\003\022\034"
+  "\n\030RESPONSE_SERIALIZE_ERROR\020\004\022\022\n\016HANDLER_"
+  "FAILED\020\005\022\022\n\016CHECKSUM_ERROR\020\006\022\016\n\nOVERLOAD"
+  "ED\020\007b\006proto3"
   ;
 static ::_pbi::once_flag descriptor_table_AzRPC_5fHeader_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_AzRPC_5fHeader_2eproto = {
-    false, false, 110, descriptor_table_protodef_AzRPC_5fHeader_2eproto,
+    false, false, 1292, descriptor_table_protodef_AzRPC_5fHeader_2eproto,
     "AzRPC_Header.proto",
-    &descriptor_table_AzRPC_5fHeader_2eproto_once, nullptr, 0, 1,
+    &descriptor_table_AzRPC_5fHeader_2eproto_once, nullptr, 0, 2,
     schemas, file_default_instances, TableStruct_AzRPC_5fHeader_2eproto::offsets,
     file_level_metadata_AzRPC_5fHeader_2eproto, file_level_enum_descriptors_AzRPC_5fHeader_2eproto,
     file_level_service_descriptors_AzRPC_5fHeader_2eproto,
@@ -81,6 +183,75 @@ PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_AzRPC_5f
 // Force running AddDescriptors() at dynamic initialization time.
 PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_AzRPC_5fHeader_2eproto(&descriptor_table_AzRPC_5fHeader_2eproto);
 namespace AzRPC {
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* CompressType_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_AzRPC_5fHeader_2eproto);
+  return file_level_enum_descriptors_AzRPC_5fHeader_2eproto[0];
+}
+bool CompressType_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* StreamFrameType_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_AzRPC_5fHeader_2eproto);
+  return file_level_enum_descriptors_AzRPC_5fHeader_2eproto[1];
+}
+bool StreamFrameType_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* Priority_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_AzRPC_5fHeader_2eproto);
+  return file_level_enum_descriptors_AzRPC_5fHeader_2eproto[2];
+}
+bool Priority_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      return true;
+    default:
+      return false;
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* ErrorCode_descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_AzRPC_5fHeader_2eproto);
+  return file_level_enum_descriptors_AzRPC_5fHeader_2eproto[3];
+}
+bool ErrorCode_IsValid(int value) {
+  switch (value) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+    case 7:
+      return true;
+    default:
+      return false;
+  }
+}
+
 
 // ===================================================================
 
@@ -100,7 +271,22 @@ RpcHeader::RpcHeader(const RpcHeader& from)
   new (&_impl_) Impl_{
       decltype(_impl_.service_name_){}
     , decltype(_impl_.method_name_){}
+    , decltype(_impl_.tenant_){}
+    , decltype(_impl_.trace_id_){}
+    , decltype(_impl_.span_id_){}
     , decltype(_impl_.args_size_){}
+    , decltype(_impl_.trace_flags_){}
+    , decltype(_impl_.parent_span_id_){}
+    , decltype(_impl_.call_id_){}
+    , decltype(_impl_.compress_type_){}
+    , decltype(_impl_.args_raw_size_){}
+    , decltype(_impl_.response_compress_){}
+    , decltype(_impl_.checksum_){}
+    , decltype(_impl_.attachment_size_){}
+    , decltype(_impl_.stream_type_){}
+    , decltype(_impl_.stream_credits_){}
+    , decltype(_impl_.batch_count_){}
+    , decltype(_impl_.priority_){}
     , /*decltype(_impl_._cached_size_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
@@ -120,7 +306,17 @@ RpcHeader::RpcHeader(const RpcHeader& from)
     _this->_impl_.method_name_.Set(from._internal_method_name(), 
       _this->GetArenaForAllocation());
   }
-  _this->_impl_.args_size_ = from._impl_.args_size_;
+  _impl_.tenant_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tenant_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_tenant().empty()) {
+    _this->_impl_.tenant_.Set(from._internal_tenant(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.trace_id_, &from._impl_.trace_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.priority_) -
+    reinterpret_cast<char*>(&_impl_.trace_id_)) + sizeof(_impl_.priority_));
   // @@protoc_insertion_point(copy_constructor:AzRPC.RpcHeader)
 }
 
@@ -131,7 +327,22 @@ inline void RpcHeader::SharedCtor(
   new (&_impl_) Impl_{
       decltype(_impl_.service_name_){}
     , decltype(_impl_.method_name_){}
+    , decltype(_impl_.tenant_){}
+    , decltype(_impl_.trace_id_){uint64_t{0u}}
+    , decltype(_impl_.span_id_){uint64_t{0u}}
     , decltype(_impl_.args_size_){0u}
+    , decltype(_impl_.trace_flags_){0u}
+    , decltype(_impl_.parent_span_id_){uint64_t{0u}}
+    , decltype(_impl_.call_id_){uint64_t{0u}}
+    , decltype(_impl_.compress_type_){0}
+    , decltype(_impl_.args_raw_size_){0u}
+    , decltype(_impl_.response_compress_){0}
+    , decltype(_impl_.checksum_){false}
+    , decltype(_impl_.attachment_size_){0u}
+    , decltype(_impl_.stream_type_){0}
+    , decltype(_impl_.stream_credits_){0u}
+    , decltype(_impl_.batch_count_){0u}
+    , decltype(_impl_.priority_){0}
     , /*decltype(_impl_._cached_size_)*/{}
   };
   _impl_.service_name_.InitDefault();
@@ -142,6 +353,10 @@ inline void RpcHeader::SharedCtor(
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
     _impl_.method_name_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  _impl_.tenant_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.tenant_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 RpcHeader::~RpcHeader() {
@@ -157,6 +372,7 @@ inline void RpcHeader::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   _impl_.service_name_.Destroy();
   _impl_.method_name_.Destroy();
+  _impl_.tenant_.Destroy();
 }
 
 void RpcHeader::SetCachedSize(int size) const {
@@ -171,7 +387,10 @@ void RpcHeader::Clear() {
 
   _impl_.service_name_.ClearToEmpty();
   _impl_.method_name_.ClearToEmpty();
-  _impl_.args_size_ = 0u;
+  _impl_.tenant_.ClearToEmpty();
+  ::memset(&_impl_.trace_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.priority_) -
+      reinterpret_cast<char*>(&_impl_.trace_id_)) + sizeof(_impl_.priority_));
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -207,6 +426,131 @@ const char* RpcHeader::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx
         } else
           goto handle_unusual;
         continue;
+      // fixed64 trace_id = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 33)) {
+          _impl_.trace_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // fixed64 span_id = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 41)) {
+          _impl_.span_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // fixed64 parent_span_id = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 49)) {
+          _impl_.parent_span_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 trace_flags = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _impl_.trace_flags_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 call_id = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          _impl_.call_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.CompressType compress_type = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 72)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_compress_type(static_cast<::AzRPC::CompressType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 args_raw_size = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 80)) {
+          _impl_.args_raw_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.CompressType response_compress = 11;
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 88)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_response_compress(static_cast<::AzRPC::CompressType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // bool checksum = 12;
+      case 12:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 96)) {
+          _impl_.checksum_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 attachment_size = 13;
+      case 13:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 104)) {
+          _impl_.attachment_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.StreamFrameType stream_type = 14;
+      case 14:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 112)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_stream_type(static_cast<::AzRPC::StreamFrameType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_credits = 15;
+      case 15:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 120)) {
+          _impl_.stream_credits_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 batch_count = 16;
+      case 16:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 128)) {
+          _impl_.batch_count_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.Priority priority = 17;
+      case 17:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 136)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_priority(static_cast<::AzRPC::Priority>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes tenant = 18;
+      case 18:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 146)) {
+          auto str = _internal_mutable_tenant();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -254,6 +598,100 @@ uint8_t* RpcHeader::_InternalSerialize(
     target = ::_pbi::WireFormatLite::WriteUInt32ToArray(3, this->_internal_args_size(), target);
   }
 
+  // fixed64 trace_id = 4;
+  if (this->_internal_trace_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(4, this->_internal_trace_id(), target);
+  }
+
+  // fixed64 span_id = 5;
+  if (this->_internal_span_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(5, this->_internal_span_id(), target);
+  }
+
+  // fixed64 parent_span_id = 6;
+  if (this->_internal_parent_span_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(6, this->_internal_parent_span_id(), target);
+  }
+
+  // uint32 trace_flags = 7;
+  if (this->_internal_trace_flags() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(7, this->_internal_trace_flags(), target);
+  }
+
+  // uint64 call_id = 8;
+  if (this->_internal_call_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(8, this->_internal_call_id(), target);
+  }
+
+  // .AzRPC.CompressType compress_type = 9;
+  if (this->_internal_compress_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      9, this->_internal_compress_type(), target);
+  }
+
+  // uint32 args_raw_size = 10;
+  if (this->_internal_args_raw_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(10, this->_internal_args_raw_size(), target);
+  }
+
+  // .AzRPC.CompressType response_compress = 11;
+  if (this->_internal_response_compress() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      11, this->_internal_response_compress(), target);
+  }
+
+  // bool checksum = 12;
+  if (this->_internal_checksum() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(12, this->_internal_checksum(), target);
+  }
+
+  // uint32 attachment_size = 13;
+  if (this->_internal_attachment_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(13, this->_internal_attachment_size(), target);
+  }
+
+  // .AzRPC.StreamFrameType stream_type = 14;
+  if (this->_internal_stream_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      14, this->_internal_stream_type(), target);
+  }
+
+  // uint32 stream_credits = 15;
+  if (this->_internal_stream_credits() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(15, this->_internal_stream_credits(), target);
+  }
+
+  // uint32 batch_count = 16;
+  if (this->_internal_batch_count() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(16, this->_internal_batch_count(), target);
+  }
+
+  // .AzRPC.Priority priority = 17;
+  if (this->_internal_priority() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      17, this->_internal_priority(), target);
+  }
+
+  // bytes tenant = 18;
+  if (!this->_internal_tenant().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        18, this->_internal_tenant(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -284,11 +722,94 @@ size_t RpcHeader::ByteSizeLong() const {
         this->_internal_method_name());
   }
 
+  // bytes tenant = 18;
+  if (!this->_internal_tenant().empty()) {
+    total_size += 2 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_tenant());
+  }
+
+  // fixed64 trace_id = 4;
+  if (this->_internal_trace_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  // fixed64 span_id = 5;
+  if (this->_internal_span_id() != 0) {
+    total_size += 1 + 8;
+  }
+
   // uint32 args_size = 3;
   if (this->_internal_args_size() != 0) {
     total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_args_size());
   }
 
+  // uint32 trace_flags = 7;
+  if (this->_internal_trace_flags() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_trace_flags());
+  }
+
+  // fixed64 parent_span_id = 6;
+  if (this->_internal_parent_span_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  // uint64 call_id = 8;
+  if (this->_internal_call_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_call_id());
+  }
+
+  // .AzRPC.CompressType compress_type = 9;
+  if (this->_internal_compress_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_compress_type());
+  }
+
+  // uint32 args_raw_size = 10;
+  if (this->_internal_args_raw_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_args_raw_size());
+  }
+
+  // .AzRPC.CompressType response_compress = 11;
+  if (this->_internal_response_compress() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_response_compress());
+  }
+
+  // bool checksum = 12;
+  if (this->_internal_checksum() != 0) {
+    total_size += 1 + 1;
+  }
+
+  // uint32 attachment_size = 13;
+  if (this->_internal_attachment_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_attachment_size());
+  }
+
+  // .AzRPC.StreamFrameType stream_type = 14;
+  if (this->_internal_stream_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_stream_type());
+  }
+
+  // uint32 stream_credits = 15;
+  if (this->_internal_stream_credits() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_credits());
+  }
+
+  // uint32 batch_count = 16;
+  if (this->_internal_batch_count() != 0) {
+    total_size += 2 +
+      ::_pbi::WireFormatLite::UInt32Size(
+        this->_internal_batch_count());
+  }
+
+  // .AzRPC.Priority priority = 17;
+  if (this->_internal_priority() != 0) {
+    total_size += 2 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_priority());
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -313,9 +834,54 @@ void RpcHeader::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROT
   if (!from._internal_method_name().empty()) {
     _this->_internal_set_method_name(from._internal_method_name());
   }
+  if (!from._internal_tenant().empty()) {
+    _this->_internal_set_tenant(from._internal_tenant());
+  }
+  if (from._internal_trace_id() != 0) {
+    _this->_internal_set_trace_id(from._internal_trace_id());
+  }
+  if (from._internal_span_id() != 0) {
+    _this->_internal_set_span_id(from._internal_span_id());
+  }
   if (from._internal_args_size() != 0) {
     _this->_internal_set_args_size(from._internal_args_size());
   }
+  if (from._internal_trace_flags() != 0) {
+    _this->_internal_set_trace_flags(from._internal_trace_flags());
+  }
+  if (from._internal_parent_span_id() != 0) {
+    _this->_internal_set_parent_span_id(from._internal_parent_span_id());
+  }
+  if (from._internal_call_id() != 0) {
+    _this->_internal_set_call_id(from._internal_call_id());
+  }
+  if (from._internal_compress_type() != 0) {
+    _this->_internal_set_compress_type(from._internal_compress_type());
+  }
+  if (from._internal_args_raw_size() != 0) {
+    _this->_internal_set_args_raw_size(from._internal_args_raw_size());
+  }
+  if (from._internal_response_compress() != 0) {
+    _this->_internal_set_response_compress(from._internal_response_compress());
+  }
+  if (from._internal_checksum() != 0) {
+    _this->_internal_set_checksum(from._internal_checksum());
+  }
+  if (from._internal_attachment_size() != 0) {
+    _this->_internal_set_attachment_size(from._internal_attachment_size());
+  }
+  if (from._internal_stream_type() != 0) {
+    _this->_internal_set_stream_type(from._internal_stream_type());
+  }
+  if (from._internal_stream_credits() != 0) {
+    _this->_internal_set_stream_credits(from._internal_stream_credits());
+  }
+  if (from._internal_batch_count() != 0) {
+    _this->_internal_set_batch_count(from._internal_batch_count());
+  }
+  if (from._internal_priority() != 0) {
+    _this->_internal_set_priority(from._internal_priority());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
@@ -343,7 +909,16 @@ void RpcHeader::InternalSwap(RpcHeader* other) {
       &_impl_.method_name_, lhs_arena,
       &other->_impl_.method_name_, rhs_arena
   );
-  swap(_impl_.args_size_, other->_impl_.args_size_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.tenant_, lhs_arena,
+      &other->_impl_.tenant_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(RpcHeader, _impl_.priority_)
+      + sizeof(RpcHeader::_impl_.priority_)
+      - PROTOBUF_FIELD_OFFSET(RpcHeader, _impl_.trace_id_)>(
+          reinterpret_cast<char*>(&_impl_.trace_id_),
+          reinterpret_cast<char*>(&other->_impl_.trace_id_));
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata RpcHeader::GetMetadata() const {
@@ -352,6 +927,465 @@ void RpcHeader::InternalSwap(RpcHeader* other) {
       file_level_metadata_AzRPC_5fHeader_2eproto[0]);
 }
 
+// ===================================================================
+
+class RpcResponseHeader::_Internal {
+ public:
+};
+
+RpcResponseHeader::RpcResponseHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:AzRPC.RpcResponseHeader)
+}
+RpcResponseHeader::RpcResponseHeader(const RpcResponseHeader& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  RpcResponseHeader* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.error_text_){}
+    , decltype(_impl_.body_size_){}
+    , decltype(_impl_.error_code_){}
+    , decltype(_impl_.call_id_){}
+    , decltype(_impl_.compress_type_){}
+    , decltype(_impl_.body_raw_size_){}
+    , decltype(_impl_.checksum_){}
+    , decltype(_impl_.attachment_size_){}
+    , decltype(_impl_.stream_type_){}
+    , decltype(_impl_.stream_credits_){}
+    , decltype(_impl_.batch_count_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.error_text_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.error_text_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_error_text().empty()) {
+    _this->_impl_.error_text_.Set(from._internal_error_text(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.body_size_, &from._impl_.body_size_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.batch_count_) -
+    reinterpret_cast<char*>(&_impl_.body_size_)) + sizeof(_impl_.batch_count_));
+  // @@protoc_insertion_point(copy_constructor:AzRPC.RpcResponseHeader)
+}
+
+inline void RpcResponseHeader::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.error_text_){}
+    , decltype(_impl_.body_size_){0u}
+    , decltype(_impl_.error_code_){0}
+    , decltype(_impl_.call_id_){uint64_t{0u}}
+    , decltype(_impl_.compress_type_){0}
+    , decltype(_impl_.body_raw_size_){0u}
+    , decltype(_impl_.checksum_){false}
+    , decltype(_impl_.attachment_size_){0u}
+    , decltype(_impl_.stream_type_){0}
+    , decltype(_impl_.stream_credits_){0u}
+    , decltype(_impl_.batch_count_){0u}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.error_text_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.error_text_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+RpcResponseHeader::~RpcResponseHeader() {
+  // @@protoc_insertion_point(destructor:AzRPC.RpcResponseHeader)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void RpcResponseHeader::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.error_text_.Destroy();
+}
+
+void RpcResponseHeader::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void RpcResponseHeader::Clear() {
+// @@protoc_insertion_point(message_clear_start:AzRPC.RpcResponseHeader)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.error_text_.ClearToEmpty();
+  ::memset(&_impl_.body_size_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.batch_count_) -
+      reinterpret_cast<char*>(&_impl_.body_size_)) + sizeof(_impl_.batch_count_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* RpcResponseHeader::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // uint32 body_size = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.body_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.ErrorCode error_code = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_error_code(static_cast<::AzRPC::ErrorCode>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // bytes error_text = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_error_text();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 call_id = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _impl_.call_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.CompressType compress_type = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_compress_type(static_cast<::AzRPC::CompressType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 body_raw_size = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _impl_.body_raw_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool checksum = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _impl_.checksum_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 attachment_size = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          _impl_.attachment_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .AzRPC.StreamFrameType stream_type = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 72)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          _internal_set_stream_type(static_cast<::AzRPC::StreamFrameType>(val));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 stream_credits = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 80)) {
+          _impl_.stream_credits_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 batch_count = 11;
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 88)) {
+          _impl_.batch_count_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* RpcResponseHeader::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:AzRPC.RpcResponseHeader)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // uint32 body_size = 1;
+  if (this->_internal_body_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(1, this->_internal_body_size(), target);
+  }
+
+  // .AzRPC.ErrorCode error_code = 2;
+  if (this->_internal_error_code() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      2, this->_internal_error_code(), target);
+  }
+
+  // bytes error_text = 3;
+  if (!this->_internal_error_text().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        3, this->_internal_error_text(), target);
+  }
+
+  // uint64 call_id = 4;
+  if (this->_internal_call_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(4, this->_internal_call_id(), target);
+  }
+
+  // .AzRPC.CompressType compress_type = 5;
+  if (this->_internal_compress_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      5, this->_internal_compress_type(), target);
+  }
+
+  // uint32 body_raw_size = 6;
+  if (this->_internal_body_raw_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(6, this->_internal_body_raw_size(), target);
+  }
+
+  // bool checksum = 7;
+  if (this->_internal_checksum() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(7, this->_internal_checksum(), target);
+  }
+
+  // uint32 attachment_size = 8;
+  if (this->_internal_attachment_size() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(8, this->_internal_attachment_size(), target);
+  }
+
+  // .AzRPC.StreamFrameType stream_type = 9;
+  if (this->_internal_stream_type() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+      9, this->_internal_stream_type(), target);
+  }
+
+  // uint32 stream_credits = 10;
+  if (this->_internal_stream_credits() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(10, this->_internal_stream_credits(), target);
+  }
+
+  // uint32 batch_count = 11;
+  if (this->_internal_batch_count() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(11, this->_internal_batch_count(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:AzRPC.RpcResponseHeader)
+  return target;
+}
+
+size_t RpcResponseHeader::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:AzRPC.RpcResponseHeader)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes error_text = 3;
+  if (!this->_internal_error_text().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_error_text());
+  }
+
+  // uint32 body_size = 1;
+  if (this->_internal_body_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_body_size());
+  }
+
+  // .AzRPC.ErrorCode error_code = 2;
+  if (this->_internal_error_code() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_error_code());
+  }
+
+  // uint64 call_id = 4;
+  if (this->_internal_call_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_call_id());
+  }
+
+  // .AzRPC.CompressType compress_type = 5;
+  if (this->_internal_compress_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_compress_type());
+  }
+
+  // uint32 body_raw_size = 6;
+  if (this->_internal_body_raw_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_body_raw_size());
+  }
+
+  // bool checksum = 7;
+  if (this->_internal_checksum() != 0) {
+    total_size += 1 + 1;
+  }
+
+  // uint32 attachment_size = 8;
+  if (this->_internal_attachment_size() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_attachment_size());
+  }
+
+  // .AzRPC.StreamFrameType stream_type = 9;
+  if (this->_internal_stream_type() != 0) {
+    total_size += 1 +
+      ::_pbi::WireFormatLite::EnumSize(this->_internal_stream_type());
+  }
+
+  // uint32 stream_credits = 10;
+  if (this->_internal_stream_credits() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_stream_credits());
+  }
+
+  // uint32 batch_count = 11;
+  if (this->_internal_batch_count() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_batch_count());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData RpcResponseHeader::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    RpcResponseHeader::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*RpcResponseHeader::GetClassData() const { return &_class_data_; }
+
+
+void RpcResponseHeader::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<RpcResponseHeader*>(&to_msg);
+  auto& from = static_cast<const RpcResponseHeader&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:AzRPC.RpcResponseHeader)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_error_text().empty()) {
+    _this->_internal_set_error_text(from._internal_error_text());
+  }
+  if (from._internal_body_size() != 0) {
+    _this->_internal_set_body_size(from._internal_body_size());
+  }
+  if (from._internal_error_code() != 0) {
+    _this->_internal_set_error_code(from._internal_error_code());
+  }
+  if (from._internal_call_id() != 0) {
+    _this->_internal_set_call_id(from._internal_call_id());
+  }
+  if (from._internal_compress_type() != 0) {
+    _this->_internal_set_compress_type(from._internal_compress_type());
+  }
+  if (from._internal_body_raw_size() != 0) {
+    _this->_internal_set_body_raw_size(from._internal_body_raw_size());
+  }
+  if (from._internal_checksum() != 0) {
+    _this->_internal_set_checksum(from._internal_checksum());
+  }
+  if (from._internal_attachment_size() != 0) {
+    _this->_internal_set_attachment_size(from._internal_attachment_size());
+  }
+  if (from._internal_stream_type() != 0) {
+    _this->_internal_set_stream_type(from._internal_stream_type());
+  }
+  if (from._internal_stream_credits() != 0) {
+    _this->_internal_set_stream_credits(from._internal_stream_credits());
+  }
+  if (from._internal_batch_count() != 0) {
+    _this->_internal_set_batch_count(from._internal_batch_count());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void RpcResponseHeader::CopyFrom(const RpcResponseHeader& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:AzRPC.RpcResponseHeader)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool RpcResponseHeader::IsInitialized() const {
+  return true;
+}
+
+void RpcResponseHeader::InternalSwap(RpcResponseHeader* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.error_text_, lhs_arena,
+      &other->_impl_.error_text_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(RpcResponseHeader, _impl_.batch_count_)
+      + sizeof(RpcResponseHeader::_impl_.batch_count_)
+      - PROTOBUF_FIELD_OFFSET(RpcResponseHeader, _impl_.body_size_)>(
+          reinterpret_cast<char*>(&_impl_.body_size_),
+          reinterpret_cast<char*>(&other->_impl_.body_size_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata RpcResponseHeader::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_AzRPC_5fHeader_2eproto_getter, &descriptor_table_AzRPC_5fHeader_2eproto_once,
+      file_level_metadata_AzRPC_5fHeader_2eproto[1]);
+}
+
 // @@protoc_insertion_point(namespace_scope)
 }  // namespace AzRPC
 PROTOBUF_NAMESPACE_OPEN
@@ -359,6 +1393,10 @@ template<> PROTOBUF_NOINLINE ::AzRPC::RpcHeader*
 Arena::CreateMaybeMessage< ::AzRPC::RpcHeader >(Arena* arena) {
   return Arena::CreateMessageInternal< ::AzRPC::RpcHeader >(arena);
 }
+template<> PROTOBUF_NOINLINE ::AzRPC::RpcResponseHeader*
+Arena::CreateMaybeMessage< ::AzRPC::RpcResponseHeader >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::AzRPC::RpcResponseHeader >(arena);
+}
 PROTOBUF_NAMESPACE_CLOSE
 
 // @@protoc_insertion_point(global_scope)
@@ -0,0 +1,269 @@
+#include "AzRPC_Logger.h"
+#include "AzRPC_Application.h"
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+std::atomic<int> AzRPC_AsyncLogging::s_level(AzRPC_LOG_INFO);
+
+namespace {
+
+const size_t kRecordSize = 256;         // 每条日志占用的固定大小, 超长的内容会被截断
+const size_t kRingRecords = 512;        // 每个线程缓冲区可以容纳的日志条数(2的幂)
+const size_t kBatchBytes = 64 * 1024;   // 后台线程单次write的最大字节数
+
+struct LogRecord {
+    int64_t time_us;
+    const char* file;       // 指向__FILE__字面量, 无需拷贝
+    int32_t line;
+    uint16_t level;
+    uint16_t len;
+    char text[kRecordSize - 24];
+};
+static_assert(sizeof(LogRecord) == kRecordSize, "LogRecord size mismatch");
+
+// 线程私有的环形缓冲区, 所属线程是唯一的生产者, 后台线程是唯一的消费者
+struct ThreadBuffer {
+    std::atomic<uint64_t> head{0};      // 生产者下一次写入的位置
+    std::atomic<uint64_t> tail{0};      // 消费者下一次读取的位置
+    std::atomic<bool> closed{false};    // 所属线程已经退出
+    long tid = 0;
+    LogRecord records[kRingRecords];
+};
+
+class Backend {
+public:
+    Backend(): m_fd(STDERR_FILENO), m_stop(false), m_dropped(0) {
+        AzRPC_Config& config = AzRPC_Application::GetConfig();
+        std::string log_file = config.Load("log_file");
+        if (!log_file.empty()) {
+            int fd = open(log_file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (fd >= 0) {
+                m_fd = fd;
+            }
+        }
+        std::string level = config.Load("log_level");
+        if (level == "DEBUG") AzRPC_AsyncLogging::SetLevel(AzRPC_LOG_DEBUG);
+        else if (level == "WARNING") AzRPC_AsyncLogging::SetLevel(AzRPC_LOG_WARNING);
+        else if (level == "ERROR") AzRPC_AsyncLogging::SetLevel(AzRPC_LOG_ERROR);
+
+        m_thread = std::thread(&Backend::FlushLoop, this);
+    }
+
+    ~Backend() {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mtx);
+            m_stop = true;
+        }
+        m_cond.notify_one();
+        m_thread.join();
+        if (m_fd != STDERR_FILENO) {
+            close(m_fd);
+        }
+    }
+
+    // 获取当前线程的缓冲区, 第一次调用时注册到后台线程
+    ThreadBuffer* Local() {
+        // 线程退出时只做标记, 缓冲区中剩余的日志仍由后台线程写完后回收
+        struct Holder {
+            std::shared_ptr<ThreadBuffer> buffer;
+            ~Holder() {
+                if (buffer) buffer->closed.store(true, std::memory_order_release);
+            }
+        };
+        thread_local Holder holder;
+        if (!holder.buffer) {
+            holder.buffer = std::make_shared<ThreadBuffer>();
+            holder.buffer->tid = syscall(SYS_gettid);
+            std::lock_guard<std::mutex> lock(m_buffers_mtx);
+            m_buffers.push_back(holder.buffer);
+        }
+        return holder.buffer.get();
+    }
+
+    void Dropped() {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t DroppedCount() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    // 缓冲区快满时提前唤醒后台线程, 平时由后台线程定时轮询, 生产者不需要任何系统调用
+    void Wakeup() {
+        m_cond.notify_one();
+    }
+
+    // 把所有线程缓冲区中的日志写出去, 同一时刻只有一个消费者
+    void Drain() {
+        std::lock_guard<std::mutex> drain_lock(m_drain_mtx);
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lock(m_buffers_mtx);
+            buffers = m_buffers;
+        }
+
+        for (auto& buffer: buffers) {
+            bool closed = buffer->closed.load(std::memory_order_acquire);
+            uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            for (; tail < head; ++tail) {
+                Format(buffer->records[tail & (kRingRecords - 1)], buffer->tid);
+                if (m_batch.size() >= kBatchBytes) {
+                    Write();
+                }
+            }
+            buffer->tail.store(tail, std::memory_order_release);
+
+            // 线程已退出且日志已写完, 回收它的缓冲区
+            if (closed) {
+                std::lock_guard<std::mutex> lock(m_buffers_mtx);
+                for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+                    if (*it == buffer) {
+                        m_buffers.erase(it);
+                        break;
+                    }
+                }
+            }
+        }
+        Write();
+    }
+
+private:
+    int m_fd;
+    bool m_stop;
+    std::atomic<uint64_t> m_dropped;
+    std::mutex m_buffers_mtx;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+    std::mutex m_drain_mtx;
+    std::string m_batch;                // 待写出的日志, 由持有m_drain_mtx的消费者使用
+    time_t m_cached_second = 0;         // 缓存的时间前缀, 同一秒内的日志无需重复格式化
+    char m_cached_time[32] = {0};
+    std::mutex m_wake_mtx;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+
+    void FlushLoop() {
+        std::unique_lock<std::mutex> lock(m_wake_mtx);
+        while (!m_stop) {
+            m_cond.wait_for(lock, std::chrono::milliseconds(50));
+            lock.unlock();
+            Drain();
+            lock.lock();
+        }
+        lock.unlock();
+        Drain();
+    }
+
+    // 格式与glog保持一致: I1019 12:34:56.123456 12345 file.cc:12] message
+    void Format(const LogRecord& record, long tid) {
+        static const char kLevelChar[] = {'D', 'I', 'W', 'E'};
+        time_t second = record.time_us / 1000000;
+        if (second != m_cached_second) {
+            struct tm tm_time;
+            localtime_r(&second, &tm_time);
+            strftime(m_cached_time, sizeof(m_cached_time), "%m%d %H:%M:%S", &tm_time);
+            m_cached_second = second;
+        }
+        const char* base = strrchr(record.file, '/');
+        base = base != nullptr ? base + 1 : record.file;
+
+        char prefix[128];
+        int n = snprintf(prefix, sizeof(prefix), "%c%s.%06d %ld %s:%d] ", kLevelChar[record.level & 3], m_cached_time, static_cast<int>(record.time_us % 1000000), tid, base, record.line);
+        m_batch.append(prefix, n);
+        m_batch.append(record.text, record.len);
+        m_batch.push_back('\n');
+    }
+
+    void Write() {
+        size_t written = 0;
+        while (written < m_batch.size()) {
+            ssize_t n = ::write(m_fd, m_batch.data() + written, m_batch.size() - written);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                break;
+            }
+            written += n;
+        }
+        m_batch.clear();
+    }
+};
+
+Backend& GetBackend() {
+    static Backend backend;
+    return backend;
+}
+
+}  // namespace
+
+void AzRPC_AsyncLogging::Append(int level, const char* file, int line, const char* fmt, ...) {
+    Backend& backend = GetBackend();
+    ThreadBuffer* buffer = backend.Local();
+
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    uint64_t used = head - buffer->tail.load(std::memory_order_acquire);
+    if (used >= kRingRecords) {
+        // 缓冲区已满, 丢弃而不是阻塞业务线程
+        backend.Dropped();
+        backend.Wakeup();
+        return;
+    }
+
+    LogRecord& record = buffer->records[head & (kRingRecords - 1)];
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    record.time_us = static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+    record.file = file;
+    record.line = line;
+    record.level = static_cast<uint16_t>(level);
+
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(record.text, sizeof(record.text), fmt, args);
+    va_end(args);
+    if (n < 0) n = 0;
+    record.len = static_cast<uint16_t>(n < static_cast<int>(sizeof(record.text)) ? n : sizeof(record.text) - 1);
+
+    buffer->head.store(head + 1, std::memory_order_release);
+    if (used + 1 == kRingRecords * 3 / 4) {
+        backend.Wakeup();
+    }
+}
+
+void AzRPC_AsyncLogging::Flush() {
+    GetBackend().Drain();
+}
+
+uint64_t AzRPC_AsyncLogging::Dropped() {
+    return GetBackend().DroppedCount();
+}
+
+bool AzRPC_LogRateLimiter::Allow(uint64_t* suppressed) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    int64_t second = ts.tv_sec;
+
+    // 进入新的一秒时重置计数, 只有一个线程能完成切换
+    int64_t current = m_second.load(std::memory_order_relaxed);
+    if (current != second && m_second.compare_exchange_strong(current, second, std::memory_order_relaxed)) {
+        m_count.store(0, std::memory_order_relaxed);
+    }
+
+    if (m_count.fetch_add(1, std::memory_order_relaxed) < m_rate) {
+        *suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
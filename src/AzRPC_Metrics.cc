@@ -0,0 +1,45 @@
+#include "AzRPC_Metrics.h"
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct Registry {
+    std::mutex mtx;
+    std::map<std::string, std::unique_ptr<std::atomic<uint64_t>>> counters;
+};
+
+Registry& GetRegistry() {
+    static Registry* registry = new Registry();     // 不析构, 进程退出时其他静态对象可能还在计数
+    return *registry;
+}
+
+}  // namespace
+
+std::atomic<uint64_t>& AzRPC_Metrics::Counter(const std::string& name) {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    std::unique_ptr<std::atomic<uint64_t>>& counter = registry.counters[name];
+    if (!counter) {
+        counter.reset(new std::atomic<uint64_t>(0));
+    }
+    return *counter;
+}
+
+std::map<std::string, uint64_t> AzRPC_Metrics::Snapshot() {
+    Registry& registry = GetRegistry();
+    std::map<std::string, uint64_t> values;
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    for (auto& item: registry.counters) {
+        values[item.first] = item.second->load(std::memory_order_relaxed);
+    }
+    return values;
+}
+
+std::string AzRPC_Metrics::Dump() {
+    std::string out;
+    for (auto& item: Snapshot()) {
+        out += item.first + " " + std::to_string(item.second) + "\n";
+    }
+    return out;
+}
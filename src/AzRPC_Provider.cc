@@ -1,8 +1,102 @@
 #include "AzRPC_Provider.h"
 #include "AzRPC_Application.h"
 #include "AzRPC_Header.pb.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Compress.h"
+#include "AzRPC_Cache.h"
+#include "AzRPC_Cork.h"
 #include "AzRPC_Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+// 不小于这个长度的请求附件不拷贝: 接收缓冲区整个交给附件持有, 帧之后的剩余数据拷回连接的缓冲区
+const size_t kZeroCopyAttachmentSize = 64 * 1024;
+
+// Unix域连接的名字前缀, 后接递增的编号
+const char* const kUnixConnectionPrefix = "AzRPC_Provider-unix#";
+
+// 服务端请求合并, 依次查找配置项rpcserver_singleflight.<服务名>.<方法名>、rpcserver_singleflight.<服务名>、rpcserver_singleflight
+bool SingleFlightEnabled(const std::string& service_name, const std::string& method_name) {
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpcserver_singleflight");
+    return configured && AzRPC_Application::GetConfig().LoadForMethod("rpcserver_singleflight", service_name, method_name) == "true";
+}
+
+// 服务端响应缓存的有效期, 依次查找rpcserver_cache_ttl_ms.<服务名>.<方法名>、rpcserver_cache_ttl_ms.<服务名>、rpcserver_cache_ttl_ms
+int64_t CacheTtlMs(const std::string& service_name, const std::string& method_name) {
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpcserver_cache_ttl_ms");
+    if (!configured) {
+        return 0;
+    }
+    return atoll(AzRPC_Application::GetConfig().LoadForMethod("rpcserver_cache_ttl_ms", service_name, method_name).c_str());
+}
+
+// 进程内的服务端响应缓存, 容量rpcserver_cache_bytes(默认64MB), 分片数rpcserver_cache_shards(默认16)
+AzRPC_Cache& ResponseCache() {
+    static AzRPC_Cache* cache = [] {
+        AzRPC_Config& config = AzRPC_Application::GetConfig();
+        std::string bytes = config.Load("rpcserver_cache_bytes");
+        std::string shards = config.Load("rpcserver_cache_shards");
+        return new AzRPC_Cache("provider_cache", bytes.empty() ? (64 << 20) : strtoul(bytes.c_str(), nullptr, 10), shards.empty() ? 16 : strtoul(shards.c_str(), nullptr, 10));
+    }();
+    return *cache;
+}
+
+// 每次失效加一; 业务方法执行期间发生过失效时, 它的结果可能基于旧数据, 不放入缓存
+std::atomic<uint64_t> cache_generation(0);
+
+// 请求合并和响应缓存共用的键: 服务名、方法名和序列化后的请求参数
+std::string RequestKey(const std::string& service_name, const std::string& method_name, const char* args, size_t args_size) {
+    std::string key;
+    key.reserve(service_name.size() + method_name.size() + 2 + args_size);
+    key.append(service_name).append(1, '\0').append(method_name).append(1, '\0').append(args, args_size);
+    return key;
+}
+
+// 批量调用中每个IO线程至少处理的子请求数, 配置项rpcserver_batch_chunk, 默认16; 子请求较少时不值得跨线程投递
+size_t BatchChunk() {
+    static const size_t chunk = [] {
+        long value = atol(AzRPC_Application::GetConfig().Load("rpcserver_batch_chunk").c_str());
+        return value > 0 ? static_cast<size_t>(value) : static_cast<size_t>(16);
+    }();
+    return chunk;
+}
+
+// 开启了调度时请求的优先级类别: 按方法配置了rpcserver_priority时以配置为准(健康检查等方法配置为critical), 否则使用调用方指定的
+// 依次查找rpcserver_priority.<服务名>.<方法名>、rpcserver_priority.<服务名>、rpcserver_priority
+AzRPC::Priority MethodPriority(const std::string& service_name, const std::string& method_name, AzRPC::Priority requested) {
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpcserver_priority");
+    AzRPC::Priority priority = requested;
+    if (configured) {
+        AzRPC_Scheduler::ParsePriority(AzRPC_Application::GetConfig().LoadForMethod("rpcserver_priority", service_name, method_name), &priority);
+    }
+    return priority;
+}
+
+// 调度时流的权重, 默认1: 租户的流查找rpcserver_tenant_weight.<租户>
+// 没有租户时按方法分流, 依次查找rpcserver_weight.<服务名>.<方法名>、rpcserver_weight.<服务名>、rpcserver_weight
+uint32_t FlowWeight(const AzRPC::RpcHeader& header) {
+    static const bool tenant_configured = AzRPC_Application::GetConfig().HasPrefix("rpcserver_tenant_weight");
+    static const bool method_configured = AzRPC_Application::GetConfig().HasPrefix("rpcserver_weight");
+    std::string weight;
+    if (!header.tenant().empty()) {
+        if (tenant_configured) {
+            weight = AzRPC_Application::GetConfig().Load("rpcserver_tenant_weight." + header.tenant());
+        }
+    }
+    else if (method_configured) {
+        weight = AzRPC_Application::GetConfig().LoadForMethod("rpcserver_weight", header.service_name(), header.method_name());
+    }
+    long value = atol(weight.c_str());
+    return value > 0 ? static_cast<uint32_t>(value) : 1;
+}
+
+}  // namespace
 
 // 注册服务对象及其方法, 以便服务端能够处理客户端的RPC请求
 void AzRPC_Provider::NotifyService(google::protobuf::Service* service) {
@@ -26,21 +120,71 @@ void AzRPC_Provider::NotifyService(google::protobuf::Service* service) {
     int method_count = psd->method_count();
 
     // 打印服务名
-    std::cout << "service_name = " << service_name << std::endl;
+    AZRPC_LOG_INFO("service_name = %s", service_name.c_str());
 
     // 遍历服务中的所有方法, 并注册到服务信息中
     for (int i = 0; i < method_count; ++i) {
         // 获取服务中的方法描述
         const google::protobuf::MethodDescriptor* pmd = psd->method(i);
         std::string method_name = pmd->name();
-        std::cout << "method_name = " << method_name << std::endl;
+        AZRPC_LOG_INFO("method_name = %s", method_name.c_str());
         // 将方法名和方法描述符存入map
         service_info.method_map.emplace(method_name, pmd);
     }
     service_info.service = service;     // 保存服务对象
+
+    // 生成的分发器: proto中声明为stream的方法注册为流式方法
+    service_info.dispatcher = dynamic_cast<AzRPC_Dispatcher*>(service);
+    if (service_info.dispatcher != nullptr) {
+        AzRPC_Dispatcher* dispatcher = service_info.dispatcher;
+        for (int i = 0; i < method_count; ++i) {
+            const google::protobuf::MethodDescriptor* pmd = psd->method(i);
+            if (pmd->client_streaming() || pmd->server_streaming()) {
+                AZRPC_LOG_INFO("stream method = %s.%s", service_name.c_str(), pmd->name().c_str());
+                service_info.stream_handlers[pmd->name()] = [dispatcher, i](AzRPC_ServerStream* stream) {
+                    dispatcher->DispatchStream(i, stream);
+                };
+            }
+        }
+    }
     service_map.emplace(service_name, service_info);    // 将服务信息存入服务map
 }
 
+// 注册流式方法的处理函数
+void AzRPC_Provider::NotifyStreamMethod(const std::string& service_name, const std::string& method_name, StreamHandler handler) {
+    auto it = service_map.find(service_name);
+    if (it == service_map.end() || it->second.method_map.find(method_name) == it->second.method_map.end()) {
+        AZRPC_LOG_ERROR("stream method %s.%s is not published", service_name.c_str(), method_name.c_str());
+        return;
+    }
+    AZRPC_LOG_INFO("stream method = %s.%s", service_name.c_str(), method_name.c_str());
+    it->second.stream_handlers[method_name] = std::move(handler);
+}
+
+// 根据服务名和方法名查找已注册的服务对象和方法描述
+AzRPC::ErrorCode AzRPC_Provider::FindMethod(const std::string& service_name, const std::string& method_name, google::protobuf::Service** service, const google::protobuf::MethodDescriptor** method) const {
+    const ServiceInfo* service_info = nullptr;
+    AzRPC::ErrorCode lookup = FindMethod(service_name, method_name, &service_info, method);
+    if (lookup == AzRPC::OK) {
+        *service = service_info->service;
+    }
+    return lookup;
+}
+
+AzRPC::ErrorCode AzRPC_Provider::FindMethod(const std::string& service_name, const std::string& method_name, const ServiceInfo** service_info, const google::protobuf::MethodDescriptor** method) const {
+    auto it = service_map.find(service_name);
+    if (it == service_map.end()) {
+        return AzRPC::SERVICE_NOT_FOUND;
+    }
+    auto mit = it->second.method_map.find(method_name);
+    if (mit == it->second.method_map.end()) {
+        return AzRPC::METHOD_NOT_FOUND;
+    }
+    *service_info = &it->second;
+    *method = mit->second;
+    return AzRPC::OK;
+}
+
 // 启动RPC服务器结点, 开始提供远程网络调用服务
 void AzRPC_Provider::Run() {
     // 读取配置文件中的RPC服务器IP和端口
@@ -50,147 +194,1057 @@ void AzRPC_Provider::Run() {
     // 使用muduo网络库, 创建地址对象
     muduo::net::InetAddress address(ip, port);
 
-    // 创建TpcServer对象
-    std::shared_ptr<muduo::net::TcpServer> server = std::make_shared<muduo::net::TcpServer>(&event_loop, address, "AzRPC_Provider");
+    // 使用muduo库的IO线程数量
+    std::string threads = AzRPC_Application::GetConfig().Load("rpcserver_threads");
+    int thread_num = threads.empty() ? 4 : std::max(1, atoi(threads.c_str()));
+    std::string high_water = AzRPC_Application::GetConfig().Load("rpcserver_output_high_water");
+    if (!high_water.empty()) {
+        output_high_water = std::max(1L, atol(high_water.c_str()));
+    }
+
+    // 流式调用的处理函数各占一个线程, 全局和每个连接的流数都有上限
+    std::string max_streams_conf = AzRPC_Application::GetConfig().Load("rpcserver_max_streams");
+    if (!max_streams_conf.empty()) {
+        max_streams = std::max(1L, atol(max_streams_conf.c_str()));
+    }
+    std::string max_streams_per_connection_conf = AzRPC_Application::GetConfig().Load("rpcserver_max_streams_per_connection");
+    if (!max_streams_per_connection_conf.empty()) {
+        max_streams_per_connection = std::max(1L, atol(max_streams_per_connection_conf.c_str()));
+    }
+
+    // 配置了处理线程数时开启调度, 排队总数上限rpcserver_queue_limit, 默认10000
+    std::string workers = AzRPC_Application::GetConfig().Load("rpcserver_workers");
+    if (atoi(workers.c_str()) > 0) {
+        std::string queue_limit = AzRPC_Application::GetConfig().Load("rpcserver_queue_limit");
+        scheduler.reset(new AzRPC_Scheduler(atoi(workers.c_str()), queue_limit.empty() ? 10000 : std::max(1L, atol(queue_limit.c_str()))));
+    }
+
+    // 按方法限制同时执行的业务方法数, 依次查找rpcserver_max_concurrency.<服务名>.<方法名>、rpcserver_max_concurrency.<服务名>、rpcserver_max_concurrency
+    // 上限对每个方法分别生效; 名额用完后等待的请求数rpcserver_max_queue同样按方法配置, 默认100
+    // 开启调度时等待的请求由处理线程恢复执行, 否则回到等待时所在的事件循环中执行
+    if (AzRPC_Application::GetConfig().HasPrefix("rpcserver_max_concurrency")) {
+        for (auto& sp: service_map) {
+            for (auto& mp: sp.second.method_map) {
+                long max_concurrency = atol(AzRPC_Application::GetConfig().LoadForMethod("rpcserver_max_concurrency", sp.first, mp.first).c_str());
+                if (max_concurrency <= 0) {
+                    continue;
+                }
+                std::string queue = AzRPC_Application::GetConfig().LoadForMethod("rpcserver_max_queue", sp.first, mp.first);
+                long max_queue = queue.empty() ? 100 : std::max(0L, atol(queue.c_str()));
+                sp.second.bulkheads[mp.first] = std::make_shared<AzRPC_Bulkhead>("provider_" + sp.first + "." + mp.first, max_concurrency, max_queue,
+                    [this](AzRPC_Bulkhead::Task task) {
+                        if (scheduler) {
+                            scheduler->Resume(std::move(task));
+                        }
+                        else {
+                            // 没有调度时等待的任务自己投递回事件循环
+                            task();
+                        }
+                    });
+            }
+        }
+    }
+
+    // RPC服务端准备启动, 打印信息
+    std::cout << "AzRPC_Provider start service at ip: " << ip << " port: " << port << std::endl;
 
-    // 绑定连接回调和消息回调, 分离网络链接业务和消息处理业务
-    server->setConnectionCallback(std::bind(&AzRPC_Provider::OnConnection, this, std::placeholders::_1));
-    server->setMessageCallback(std::bind(&AzRPC_Provider::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    // 启动网络服务, 先开始监听再注册, 保证客户端发现服务时已经可以连接
+    if (AzRPC_Application::GetConfig().Load("rpcserver_reuseport") == "true") {
+        StartReusePort(address, thread_num);
+    }
+    else {
+        // 创建TpcServer对象
+        server = std::make_shared<muduo::net::TcpServer>(&event_loop, address, "AzRPC_Provider");
 
+        // 绑定连接回调和消息回调, 分离网络链接业务和消息处理业务
+        server->setConnectionCallback(std::bind(&AzRPC_Provider::OnConnection, this, std::placeholders::_1));
+        server->setMessageCallback(std::bind(&AzRPC_Provider::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 
-    // 使用muduo库的线程数量
-    server->setThreadNum(4);
+        server->setThreadNum(thread_num);
+        server->start();
+        io_loops = server->threadPool()->getAllLoops();
+    }
 
-    // 将当前RPC节点上要发布的服务全部注册到ZooKeeper上，让RPC客户端可以在ZooKeeper上发现服务
-    ZkClient zkclient;
-    zkclient.Start();   // 连接Zookeeper服务器
+    // 同主机的调用方可以走Unix域套接字, 在节点数据中附带套接字路径和主机名
+    std::string node_data = ip + ":" + std::to_string(port);
+    std::string unix_path = AzRPC_Application::GetConfig().Load("rpcserver_unix_path");
+    if (!unix_path.empty()) {
+        unix_acceptor.reset(new AzRPC_UnixAcceptor(&event_loop, unix_path));
+        unix_acceptor->SetNewConnectionCallback(std::bind(&AzRPC_Provider::OnUnixConnection, this, std::placeholders::_1));
+        if (unix_acceptor->Listen()) {
+            char hostname[256] = {0};
+            gethostname(hostname, sizeof(hostname) - 1);
+            node_data += ";unix=" + unix_path + ";host=" + hostname;
+            std::cout << "AzRPC_Provider start service at unix: " << unix_path << std::endl;
+        }
+        else {
+            // 监听失败不影响TCP服务
+            unix_acceptor.reset();
+        }
+    }
+
+    // 将当前RPC节点上要发布的服务全部注册到注册中心(默认为ZooKeeper)上，让RPC客户端可以发现服务
+    std::unique_ptr<AzRPC_Registry> registry = AzRPC_Registry::NewFromConfig();
+    if (!registry->Start()) {
+        AzRPC_Logger::Fatal("registry start error");
+    }
     // service_name为永久结点, method_name为临时结点
     for (auto& sp: service_map) {
         // service_name 在ZooKeeper中的目录是"/"+service_name
         std::string service_path = "/" + sp.first;
-        // 创建服务结点(持久节点, state=0)
-        zkclient.CreateAsync(service_path.c_str(), nullptr, 0, 0);
+        // 创建服务结点(持久节点)
+        registry->Create(service_path, "", false);
         for (auto& mp: sp.second.method_map) {
             std::string method_path = service_path + "/" +mp.first;
-            char method_path_data[128] = {0};
-            // 将IP和端口信息存入结点数据
-            sprintf(method_path_data, "%s:%d", ip.c_str(), port);
-            // ZOO_EPHEMERAL表示这个节点是临时节点, 在客户端断开连接后, ZooKeeper会自动删除这个节点
-            zkclient.CreateAsync(method_path.c_str(), method_path_data, strlen(method_path_data), ZOO_EPHEMERAL);
+            // 将IP和端口信息存入结点数据, 格式为"ip:port[;unix=path;host=hostname]"
+            // 临时节点, 在服务端断开与注册中心的会话后会被自动删除
+            registry->Create(method_path, node_data, true);
         }
     }
 
-    // RPC服务端准备启动, 打印信息
-    std::cout << "AzRPC_Provider start service at ip: " << ip << " port: " << port << std::endl;
-
-    // 启动网络服务
-    server->start();
     // 进入事件循环
     event_loop.loop();
 }
 
+// 停止事件循环, Run()随之返回, 注册的临时节点也随注册中心会话结束而删除, 可以在其他线程调用
+void AzRPC_Provider::Stop() {
+    event_loop.quit();
+}
+
+// 每个线程创建一个SO_REUSEPORT的TcpServer并开始监听, 全部监听成功后返回
+// TcpServer::start和析构都要求在所属事件循环中执行, 因此创建、启动都投递到对应线程中完成
+void AzRPC_Provider::StartReusePort(const muduo::net::InetAddress& address, int thread_num) {
+    for (int i = 0; i < thread_num; ++i) {
+        std::string name = "AzRPC_Provider-" + std::to_string(i);
+        ReusePortAcceptor acceptor;
+        acceptor.thread.reset(new muduo::net::EventLoopThread(muduo::net::EventLoopThread::ThreadInitCallback(), name));
+        muduo::net::EventLoop* loop = acceptor.thread->startLoop();
+
+        std::promise<std::shared_ptr<muduo::net::TcpServer>> started;
+        loop->runInLoop([this, loop, &address, &name, &started] {
+            std::shared_ptr<muduo::net::TcpServer> tcp_server = std::make_shared<muduo::net::TcpServer>(loop, address, name, muduo::net::TcpServer::kReusePort);
+            tcp_server->setConnectionCallback(std::bind(&AzRPC_Provider::OnConnection, this, std::placeholders::_1));
+            tcp_server->setMessageCallback(std::bind(&AzRPC_Provider::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+            // 线程数为0时连接留在接受它的事件循环中
+            tcp_server->setThreadNum(0);
+            tcp_server->start();
+            started.set_value(tcp_server);
+        });
+        acceptor.server = started.get_future().get();
+        io_loops.push_back(loop);
+        reuseport_acceptors.push_back(std::move(acceptor));
+    }
+    AZRPC_LOG_INFO("reuseport acceptors: %d", thread_num);
+}
+
+// 在各自的事件循环中销毁TcpServer(同时销毁其上的连接), 然后停止线程
+void AzRPC_Provider::StopReusePort() {
+    for (auto& acceptor: reuseport_acceptors) {
+        std::promise<void> stopped;
+        std::shared_ptr<muduo::net::TcpServer>& tcp_server = acceptor.server;
+        acceptor.server->getLoop()->runInLoop([&tcp_server, &stopped] {
+            tcp_server.reset();
+            stopped.set_value();
+        });
+        stopped.get_future().wait();
+        acceptor.thread.reset();
+    }
+    reuseport_acceptors.clear();
+    io_loops.clear();
+}
+
+// Unix域连接分配到的IO线程, 与TCP连接共用同一组线程
+muduo::net::EventLoop* AzRPC_Provider::NextIoLoop() {
+    if (server) {
+        return server->threadPool()->getNextLoop();
+    }
+    if (reuseport_acceptors.empty()) {
+        return &event_loop;
+    }
+    ReusePortAcceptor& acceptor = reuseport_acceptors[next_reuseport_acceptor++ % reuseport_acceptors.size()];
+    return acceptor.server->getLoop();
+}
+
 // 连接回调函数, 处理客户端连接事件
 void AzRPC_Provider::OnConnection(const muduo::net::TcpConnectionPtr& connection) {
-    if (!connection->connected()) {
+    if (connection->connected()) {
+        // 响应由写合并负责攒批, 不再需要Nagle算法; 对Unix域连接无效, 忽略错误
+        connection->setTcpNoDelay(true);
+        // 其他线程(流式调用、异步完成的业务方法)发送的响应超过高水位时同样暂停读取
+        connection->setHighWaterMarkCallback(std::bind(&AzRPC_Provider::OnHighWaterMark, this, std::placeholders::_1, std::placeholders::_2), output_high_water);
+        connection->setWriteCompleteCallback(std::bind(&AzRPC_Provider::OnWriteComplete, this, std::placeholders::_1));
+    }
+    else {
+        // 连接上协商的共享内存会话和进行中的流随之结束
+        DetachShm(connection);
+        CloseStreams(connection);
         // 如果连接关闭则断开连接
         connection->shutdown();
     }
 }
 
+// 输出缓冲区越过高水位, 在IO线程中调用; 回调是排队执行的, 执行时缓冲区可能已经发完
+void AzRPC_Provider::OnHighWaterMark(const muduo::net::TcpConnectionPtr& connection, size_t output_size) {
+    if (connection->connected() && connection->isReading() && connection->outputBuffer()->readableBytes() > 0) {
+        AZRPC_LOG_DEBUG("%s output backed up (%zu bytes), stop reading", connection->name().c_str(), output_size);
+        connection->stopRead();
+    }
+}
+
+// 输出缓冲区发送完毕, 恢复读取并处理暂停期间留在输入缓冲区中的请求
+// muduo只在缓冲区清空时通知, 因此低水位为0
+void AzRPC_Provider::OnWriteComplete(const muduo::net::TcpConnectionPtr& connection) {
+    if (!connection->connected() || connection->isReading()) {
+        return;
+    }
+    AZRPC_LOG_DEBUG("%s output drained, resume reading", connection->name().c_str());
+    connection->startRead();
+    if (connection->inputBuffer()->readableBytes() > 0) {
+        OnMessage(connection, connection->inputBuffer(), muduo::Timestamp::now());
+    }
+}
+
+// Unix域套接字上的新连接, 在基础事件循环中调用
+// 仿照muduo::net::TcpServer::newConnection, 把fd包装成TcpConnection并分配给一个IO线程
+void AzRPC_Provider::OnUnixConnection(int sockfd) {
+    muduo::net::EventLoop* io_loop = NextIoLoop();
+    std::string name = kUnixConnectionPrefix + std::to_string(next_unix_conn_id++);
+    // Unix域连接没有IP地址, 本端和对端地址均填0.0.0.0:0
+    muduo::net::TcpConnectionPtr connection = std::make_shared<muduo::net::TcpConnection>(io_loop, name, sockfd, muduo::net::InetAddress(0), muduo::net::InetAddress(0));
+    unix_connections[name] = connection;
+    connection->setConnectionCallback(std::bind(&AzRPC_Provider::OnConnection, this, std::placeholders::_1));
+    connection->setMessageCallback(std::bind(&AzRPC_Provider::OnMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+    connection->setCloseCallback(std::bind(&AzRPC_Provider::RemoveUnixConnection, this, std::placeholders::_1));
+    io_loop->runInLoop(std::bind(&muduo::net::TcpConnection::connectEstablished, connection));
+}
+
+// 连接关闭回调在IO线程中调用, 转到基础事件循环中删除连接
+void AzRPC_Provider::RemoveUnixConnection(const muduo::net::TcpConnectionPtr& connection) {
+    event_loop.runInLoop(std::bind(&AzRPC_Provider::RemoveUnixConnectionInLoop, this, connection));
+}
+
+void AzRPC_Provider::RemoveUnixConnectionInLoop(const muduo::net::TcpConnectionPtr& connection) {
+    unix_connections.erase(connection->name());
+    connection->getLoop()->queueInLoop(std::bind(&muduo::net::TcpConnection::connectDestroyed, connection));
+}
+
 // 消息回调函数, 处理客户端发送的RPC请求
 void AzRPC_Provider::OnMessage(const muduo::net::TcpConnectionPtr& connection, muduo::net::Buffer* buffer, muduo::Timestamp receive_time) {
-    std::cout << "OnMessage" << std::endl;
-
-    // 从网络缓冲区中读取RPC请求的字符流
-    std::string receive_buf = buffer->retrieveAllAsString();
-
-    // 使用protobuf的CodeInputStream反序列化RPC请求
-    google::protobuf::io::ArrayInputStream raw_input(receive_buf.data(), receive_buf.size());
-    google::protobuf::io::CodedInputStream coded_input(&raw_input);
-
-    uint32_t header_size{};
-    coded_input.ReadVarint32(&header_size);     // 解析header_size
-    
-    // 根据header_size读取数据头的原始字符流, 反序列化数据, 得到RPC请求的详细信息
-    std::string rpc_header_str;
-    AzRPC::RpcHeader AzRPC_Header;
-    std::string service_name;
-    std::string method_name;
-    uint32_t args_size{};
-
-    // 设置读取限制
-    google::protobuf::io::CodedInputStream::Limit msg_limit = coded_input.PushLimit(header_size);
-    coded_input.ReadString(&rpc_header_str, header_size);
-    // 恢复之前的限制, 以便安全地继续读取其他数据
-    coded_input.PopLimit(msg_limit);
-
-    if (AzRPC_Header.ParseFromString(rpc_header_str)) {
-        service_name = AzRPC_Header.service_name();
-        method_name = AzRPC_Header.method_name();
-        args_size = AzRPC_Header.args_size();
+    AZRPC_LOG_DEBUG("OnMessage from %s", connection->peerAddress().toIpPort().c_str());
+
+    // 一次可读事件里可能有多个请求, 也可能只有半个请求
+    // 只处理缓冲区中完整的帧, 不完整的部分留在缓冲区里等待后续数据
+    while (buffer->readableBytes() > 0) {
+        // 调用方没有及时读取响应, 剩下的请求留在输入缓冲区, 输出缓冲区发完后(OnWriteComplete)再处理
+        // 本轮暂存还没有写出的响应同样计入
+        if (!connection->isReading() || connection->outputBuffer()->readableBytes() + AzRPC_Cork::Pending(connection.get()) >= output_high_water) {
+            if (connection->isReading()) {
+                AZRPC_LOG_DEBUG("%s output backed up, stop reading", connection->name().c_str());
+                connection->stopRead();
+            }
+            break;
+        }
+        int64_t decode_start_us = AzRPC_Tracer::NowMicros();
+        AzRPC::RpcHeader AzRPC_Header;
+        size_t args_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeRequest(buffer->peek(), buffer->readableBytes(), &AzRPC_Header, &args_offset);
+        if (frame_size == AzRPC_Codec::kIncomplete) {
+            break;
+        }
+        if (frame_size == AzRPC_Codec::kInvalid) {
+            // 数据流已经错位, 无法再找到下一帧的边界, 只能断开连接
+            AZRPC_LOG_ERROR_RATELIMIT(10, "AzRPC_Header parse error from %s", connection->peerAddress().toIpPort().c_str());
+            buffer->retrieveAll();
+            connection->shutdown();
+            break;
+        }
+        if (frame_size == AzRPC_Codec::kChecksumError) {
+            // 帧在传输中损坏, 告知调用方后断开, 损坏的长度字段可能已经让后续的帧错位
+            AZRPC_LOG_ERROR_RATELIMIT(10, "request checksum mismatch from %s", connection->peerAddress().toIpPort().c_str());
+            SendRpcError(ReplyTarget{connection, nullptr, AzRPC_Header.call_id(), true}, AzRPC::CHECKSUM_ERROR, "request checksum mismatch");
+            buffer->retrieveAll();
+            connection->shutdown();
+            break;
+        }
+
+        if (AzRPC_Header.service_name() == AZRPC_TRANSPORT_SERVICE && AzRPC_Header.method_name() == AZRPC_SHM_ATTACH_METHOD) {
+            AttachShm(connection, std::string(buffer->peek() + args_offset, AzRPC_Header.args_size()));
+            buffer->retrieve(frame_size);
+            continue;
+        }
+        if (AzRPC_Header.stream_type() != AzRPC::STREAM_NONE) {
+            HandleStreamFrame(connection, AzRPC_Header, buffer->peek() + args_offset);
+            buffer->retrieve(frame_size);
+            continue;
+        }
+
+        // 请求附件: 较小的拷贝出来, 较大的把整个缓冲区换出来交给附件持有, 业务方法结束前一直有效
+        AzRPC_Attachment attachment;
+        size_t attachment_size = AzRPC_Header.attachment_size();
+        const char* frame = buffer->peek();
+        if (attachment_size >= kZeroCopyAttachmentSize) {
+            std::shared_ptr<muduo::net::Buffer> holder = std::make_shared<muduo::net::Buffer>();
+            holder->swap(*buffer);
+            frame = holder->peek();
+            buffer->append(frame + frame_size, holder->readableBytes() - frame_size);
+            attachment.AppendRef(frame + args_offset + AzRPC_Header.args_size(), attachment_size, holder);
+        }
+        else {
+            attachment.Append(frame + args_offset + AzRPC_Header.args_size(), attachment_size);
+            buffer->retrieve(frame_size);
+        }
+        HandleRequest(ReplyTarget{connection, nullptr, AzRPC_Header.call_id(), AzRPC_Header.checksum()}, AzRPC_Header, frame + args_offset, std::move(attachment), receive_time, decode_start_us);
     }
-    else {
-        AzRPC_Logger::ERROR("AzRPC_Header parse error");
+}
+
+// 处理一个完整的请求帧, attachment为请求附件, 交给业务方法的controller
+// 开启了调度时拷贝出请求排队, 由处理线程执行; 队列已满并且没有更低优先级的请求可以丢弃时, 回复OVERLOADED
+void AzRPC_Provider::HandleRequest(const ReplyTarget& target, const AzRPC::RpcHeader& AzRPC_Header, const char* args_data, AzRPC_Attachment&& attachment, muduo::Timestamp receive_time, int64_t decode_start_us) {
+    if (AzRPC_Header.batch_count() > 0) {
+        HandleBatch(target, AzRPC_Header, args_data, receive_time, decode_start_us);
         return;
     }
-
-    std::string args_str;   // RPC参数
-    // 直接读取args_size长度的字符串数据
-    bool read_args_success = coded_input.ReadString(&args_str, args_size);
-    if (!read_args_success) {
-        AzRPC_Logger::ERROR("read args error");
+    if (!scheduler) {
+        ProcessRequest(target, AzRPC_Header, args_data, std::move(attachment), receive_time, decode_start_us);
         return;
     }
 
+    std::shared_ptr<QueuedRequest> queued = MakeQueued(target, AzRPC_Header, args_data, std::move(attachment), receive_time, decode_start_us);
+    // 同一类别中按租户分流, 没有租户时按方法分流
+    std::string flow = AzRPC_Header.tenant().empty() ? AzRPC_Header.service_name() + "." + AzRPC_Header.method_name() : AzRPC_Header.tenant();
+    AzRPC::Priority priority = MethodPriority(AzRPC_Header.service_name(), AzRPC_Header.method_name(), AzRPC_Header.priority());
+    bool accepted = scheduler->Submit(priority, flow, FlowWeight(AzRPC_Header),
+        [this, queued] { RunQueued(queued, false); },
+        [this, target] { SendRpcError(target, AzRPC::OVERLOADED, "server overloaded, request shed"); });
+    if (!accepted) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "server overloaded, reject %s.%s", AzRPC_Header.service_name().c_str(), AzRPC_Header.method_name().c_str());
+        SendRpcError(target, AzRPC::OVERLOADED, "server overloaded, request rejected");
+    }
+}
+
+// 拷贝出请求参数, 排队期间接收缓冲区可能已经被复用
+std::shared_ptr<AzRPC_Provider::QueuedRequest> AzRPC_Provider::MakeQueued(const ReplyTarget& target, const AzRPC::RpcHeader& header, const char* args_data, AzRPC_Attachment&& attachment, muduo::Timestamp receive_time, int64_t decode_start_us) {
+    std::shared_ptr<QueuedRequest> queued = std::make_shared<QueuedRequest>();
+    queued->target = target;
+    queued->header = header;
+    queued->args.assign(args_data, header.args_size());
+    queued->attachment = std::move(attachment);
+    queued->receive_time = receive_time;
+    queued->decode_start_us = decode_start_us;
+    queued->submit_us = AzRPC_Tracer::NowMicros();
+    return queued;
+}
+
+// 在处理线程中处理排队的请求, 排队的时间计入追踪记录的queue_us
+void AzRPC_Provider::RunQueued(const std::shared_ptr<QueuedRequest>& queued, bool admitted) {
+    int64_t waited_us = AzRPC_Tracer::NowMicros() - queued->submit_us;
+    ProcessRequest(queued->target, queued->header, queued->args.data(), std::move(queued->attachment), queued->receive_time, queued->decode_start_us + waited_us, admitted);
+}
+
+// 查找方法, 解压和解析请求参数, 经过响应缓存和请求合并后调用业务方法
+void AzRPC_Provider::ProcessRequest(const ReplyTarget& target, const AzRPC::RpcHeader& AzRPC_Header, const char* args_data, AzRPC_Attachment&& attachment, muduo::Timestamp receive_time, int64_t decode_start_us, bool admitted) {
+    const std::string& service_name = AzRPC_Header.service_name();
+    const std::string& method_name = AzRPC_Header.method_name();
+
     // 获取service对象和method对象
-    auto it = service_map.find(service_name);
-    if (it == service_map.end()) {
-        std::cout << service_name << " does not exist!" << std::endl;
+    const ServiceInfo* service_info = nullptr;
+    const google::protobuf::MethodDescriptor* method = nullptr;
+    AzRPC::ErrorCode lookup = FindMethod(service_name, method_name, &service_info, &method);
+    if (lookup != AzRPC::OK) {
+        std::string error_text = (lookup == AzRPC::SERVICE_NOT_FOUND ? service_name : service_name + "." + method_name) + " does not exist!";
+        AZRPC_LOG_ERROR_RATELIMIT(10, "%s", error_text.c_str());
+        SendRpcError(target, lookup, error_text);
         return;
     }
-    auto mit = it->second.method_map.find(method_name);
-    if (mit == it->second.method_map.end()) {
-        std::cout << service_name << "." << method_name << " does not exist!" << std::endl;
+
+    // 方法配置了并发上限: 名额用完时请求在方法自己的队列中等待, 不占用处理线程和IO线程; 队列已满时拒绝
+    AzRPC_Bulkhead* bulkhead = nullptr;
+    if (!service_info->bulkheads.empty()) {
+        auto it = service_info->bulkheads.find(method_name);
+        if (it != service_info->bulkheads.end()) {
+            bulkhead = it->second.get();
+        }
+    }
+    if (bulkhead != nullptr && !admitted && !bulkhead->TryAcquire()) {
+        std::shared_ptr<QueuedRequest> queued = MakeQueued(target, AzRPC_Header, args_data, std::move(attachment), receive_time, decode_start_us);
+        AzRPC_Bulkhead::Task resume = [this, queued] { RunQueued(queued, true); };
+        if (!scheduler) {
+            // 没有调度时Release可能在任意线程(异步回调、其他连接)中调用, 恢复的请求投递回当前事件循环执行
+            // 用queueInLoop而不是runInLoop, 不在归还名额的调用栈中嵌套执行业务方法
+            // 共享内存通道等不在事件循环中的请求分给IO线程
+            muduo::net::EventLoop* loop = muduo::net::EventLoop::getEventLoopOfCurrentThread();
+            if (loop == nullptr) {
+                loop = io_loops.empty() ? &event_loop : io_loops[next_batch_loop.fetch_add(1) % io_loops.size()];
+            }
+            resume = [loop, resume] { loop->queueInLoop(resume); };
+        }
+        AzRPC_Bulkhead::Result result = bulkhead->Wait(resume);
+        if (result == AzRPC_Bulkhead::kAcquired) {
+            // 检查期间名额空出, 请求已经拷贝出来, 从拷贝继续处理
+            RunQueued(queued, true);
+        }
+        else if (result == AzRPC_Bulkhead::kRejected) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "%s.%s concurrency limit reached", service_name.c_str(), method_name.c_str());
+            SendRpcError(target, AzRPC::OVERLOADED, service_name + "." + method_name + " concurrency limit reached");
+        }
         return;
     }
+    // 请求没有交给业务方法就结束时在这里归还名额, 交给业务方法后由SendRpcResponse归还
+    struct BulkheadGuard {
+        AzRPC_Bulkhead* bulkhead;
+        ~BulkheadGuard() {
+            if (bulkhead != nullptr) {
+                bulkhead->Release();
+            }
+        }
+    } bulkhead_guard{bulkhead};
 
-    // 获取服务对象
-    google::protobuf::Service* service = it->second.service;
-    // 获取方法对象
-    const google::protobuf::MethodDescriptor* method = mit->second;
+    google::protobuf::Service* service = service_info->service;
+    // 生成的分发器按方法编号直接创建具体类型的消息和调用业务方法
+    AzRPC_Dispatcher* dispatcher = service_info->dispatcher;
+    int method_index = method->index();
 
     // 生成RPC方法调用请求的request和响应的response参数
     // 动态创新请求对象
-    google::protobuf::Message* request = service->GetRequestPrototype(method).New();
-    if (!request->ParseFromString(args_str)) {
-        std::cout << service_name << "." << method_name << " parse error!" << std::endl;
+    // 请求参数被压缩时先解压
+    size_t args_size = AzRPC_Header.args_size();
+    std::string raw_args;
+    if (AzRPC_Header.compress_type() != AzRPC::COMPRESS_NONE) {
+        if (!AzRPC_Compress::Decompress(AzRPC_Header.compress_type(), args_data, args_size, AzRPC_Header.args_raw_size(), &raw_args)) {
+            const char* compress_name = AzRPC_Compress::Name(AzRPC_Header.compress_type());
+            AZRPC_LOG_ERROR_RATELIMIT(10, "%s.%s decompress error, compress type %s", service_name.c_str(), method_name.c_str(), compress_name);
+            SendRpcError(target, AzRPC::REQUEST_PARSE_ERROR, service_name + "." + method_name + " decompress error, compress type " + compress_name);
+            return;
+        }
+        args_data = raw_args.data();
+        args_size = raw_args.size();
+    }
+
+    // 开启了响应缓存的方法, 命中时直接发送缓存的响应, 不解析请求也不执行业务方法; 带附件的请求不缓存
+    int64_t cache_ttl_ms = attachment.empty() ? CacheTtlMs(service_name, method_name) : 0;
+    bool single_flight = attachment.empty() && SingleFlightEnabled(service_name, method_name);
+    std::string request_key;
+    uint64_t generation = cache_generation.load();
+    if (cache_ttl_ms > 0 || single_flight) {
+        request_key = RequestKey(service_name, method_name, args_data, args_size);
+    }
+    if (cache_ttl_ms > 0) {
+        AzRPC_Cache::ValuePtr value = ResponseCache().Get(request_key);
+        if (value) {
+            std::string send_str;
+            std::string trailer;
+            if (EncodeRpcResponse(target, AzRPC_Header.response_compress(), value->data, value->attachment, &send_str, &trailer)) {
+                target.Send(send_str, value->attachment, trailer);
+            }
+            return;
+        }
+    }
+
+    google::protobuf::Message* request = dispatcher != nullptr ? dispatcher->NewRequest(method_index) : service->GetRequestPrototype(method).New();
+    if (!request->ParseFromArray(args_data, args_size)) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "%s.%s parse error!", service_name.c_str(), method_name.c_str());
+        SendRpcError(target, AzRPC::REQUEST_PARSE_ERROR, service_name + "." + method_name + " parse error!");
+        delete request;
         return;
     }
-    // 动态创建响应对象
-    google::protobuf::Message* response = service->GetResponsePrototype(method).New();
+
+    // 开启了请求合并的方法: 方法和请求参数都相同的请求正在处理时, 登记后等待它的响应
+    std::string flight_key;
+    if (single_flight) {
+        flight_key = request_key;
+        std::lock_guard<std::mutex> lock(flight_mtx);
+        auto it = flights.find(flight_key);
+        if (it != flights.end()) {
+            it->second.push_back(FlightWaiter{target, AzRPC_Header.response_compress()});
+            delete request;
+            return;
+        }
+        flights.emplace(flight_key, std::vector<FlightWaiter>());
+    }
+
+    // 创建本次调用的上下文, 动态创建响应对象
+    CallContext* context = new CallContext();
+    context->target = target;
+    context->response_compress = AzRPC_Header.response_compress();
+    context->flight_key.swap(flight_key);
+    if (cache_ttl_ms > 0) {
+        context->cache_key.swap(request_key);
+    }
+    context->cache_ttl_ms = cache_ttl_ms;
+    context->cache_generation = generation;
+    context->request = request;
+    context->response = dispatcher != nullptr ? dispatcher->NewResponse(method_index) : service->GetResponsePrototype(method).New();
+    context->controller.RequestAttachment() = std::move(attachment);
+    context->bulkhead = bulkhead_guard.bulkhead;
+    bulkhead_guard.bulkhead = nullptr;
+
+    // 上游传来了被采样的追踪上下文时, 记录服务端span的各阶段耗时
+    AzRPC_TraceContext trace;
+    if (AzRPC_Header.trace_flags() & AzRPC_TraceContext::kSampled) {
+        trace.trace_id = AzRPC_Header.trace_id();
+        trace.span_id = AzRPC_Header.span_id();
+        trace.parent_span_id = AzRPC_Header.parent_span_id();
+        trace.flags = AzRPC_Header.trace_flags();
+        context->controller.SetTraceContext(trace);
+
+        AzRPC_SpanRecord& span = context->span;
+        span.trace_id = trace.trace_id;
+        span.span_id = trace.span_id;
+        span.parent_span_id = trace.parent_span_id;
+        span.kind = AzRPC_SpanRecord::kServer;
+        span.start_us = receive_time.microSecondsSinceEpoch();
+        span.queue_us = decode_start_us - span.start_us;
+        context->stage_us = AzRPC_Tracer::NowMicros();
+        span.decode_us = context->stage_us - decode_start_us;
+        AzRPC_Tracer::FillMethod(&span, service_name, method_name);
+    }
 
     // 绑定回调函数, 用于在方法调用完成后发送响应
-    google::protobuf::Closure* done = google::protobuf::NewCallback<AzRPC_Provider, const muduo::net::TcpConnectionPtr&, google::protobuf::Message*>(this, &AzRPC_Provider::SendRpcResponse, connection,response);
+    google::protobuf::Closure* done = google::protobuf::NewCallback<AzRPC_Provider, CallContext*>(this, &AzRPC_Provider::SendRpcResponse, context);
 
     // 根据RPC请求, 调用当前RPC结点上发布的方法
-    service->CallMethod(method, nullptr, request, response, done);
+    // 执行期间把追踪上下文设为当前线程的上下文, 业务方法发起的下游调用会自动成为它的子span
+    AzRPC_TraceScope trace_scope(trace);
+    if (dispatcher != nullptr) {
+        dispatcher->Dispatch(method_index, &context->controller, request, context->response, done);
+    }
+    else {
+        service->CallMethod(method, &context->controller, request, context->response, done);
+    }
+}
+
+// 批量调用: 解出所有子请求, 每rpcserver_batch_chunk个以上分为一组, 分到各IO线程中并行处理
+// 第一组在当前线程中处理, 其余投递到其他IO线程; 子请求各自走完整的处理流程(响应缓存、请求合并、追踪), 只是响应先交给批
+void AzRPC_Provider::HandleBatch(const ReplyTarget& target, const AzRPC::RpcHeader& header, const char* args_data, muduo::Timestamp receive_time, int64_t decode_start_us) {
+    BatchContextPtr batch = std::make_shared<BatchContext>();
+    batch->target = target;
+    batch->response_compress = header.response_compress();
+
+    // 子请求可能在其他线程中处理, 请求参数拷贝到批中; 被压缩时先解压
+    if (header.compress_type() != AzRPC::COMPRESS_NONE) {
+        if (!AzRPC_Compress::Decompress(header.compress_type(), args_data, header.args_size(), header.args_raw_size(), &batch->body)) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "batch decompress error, compress type %s", AzRPC_Compress::Name(header.compress_type()));
+            SendRpcError(target, AzRPC::REQUEST_PARSE_ERROR, std::string("batch decompress error, compress type ") + AzRPC_Compress::Name(header.compress_type()));
+            return;
+        }
+    }
+    else {
+        batch->body.assign(args_data, header.args_size());
+    }
+    size_t offset = 0;
+    while (offset < batch->body.size()) {
+        AzRPC::RpcHeader sub_header;
+        size_t args_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeRequest(batch->body.data() + offset, batch->body.size() - offset, &sub_header, &args_offset);
+        // 子请求不能再是批量调用或流式调用
+        if (frame_size <= 0 || sub_header.batch_count() > 0 || sub_header.stream_type() != AzRPC::STREAM_NONE) {
+            break;
+        }
+        batch->requests.emplace_back(std::move(sub_header), offset + args_offset);
+        offset += frame_size;
+    }
+    if (offset != batch->body.size() || batch->requests.size() != header.batch_count()) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "batch request decode error, %zu of %u requests", batch->requests.size(), header.batch_count());
+        SendRpcError(target, AzRPC::REQUEST_PARSE_ERROR, "batch request decode error");
+        return;
+    }
+
+    size_t count = batch->requests.size();
+    batch->frames.resize(count);
+    batch->remaining = count;
+    // 开启了调度时子请求各自排队, 由处理线程并行执行, 不再分到其他IO线程
+    size_t parts = scheduler ? 1 : std::max(static_cast<size_t>(1), std::min(io_loops.size(), (count + BatchChunk() - 1) / BatchChunk()));
+    size_t per_part = (count + parts - 1) / parts;
+    size_t first_loop = next_batch_loop.fetch_add(parts);
+    for (size_t part = 1; part < parts && part * per_part < count; ++part) {
+        muduo::net::EventLoop* loop = io_loops[(first_loop + part) % io_loops.size()];
+        loop->queueInLoop(std::bind(&AzRPC_Provider::RunBatch, this, batch, part * per_part, std::min(count, (part + 1) * per_part), receive_time, decode_start_us));
+    }
+    RunBatch(batch, 0, per_part, receive_time, decode_start_us);
+}
+
+// 处理批中[begin, end)的子请求, 子请求的附件拷贝出来交给各自的controller
+void AzRPC_Provider::RunBatch(const BatchContextPtr& batch, size_t begin, size_t end, muduo::Timestamp receive_time, int64_t decode_start_us) {
+    for (size_t i = begin; i < end; ++i) {
+        const AzRPC::RpcHeader& header = batch->requests[i].first;
+        const char* args_data = batch->body.data() + batch->requests[i].second;
+        AzRPC_Attachment attachment;
+        attachment.Append(args_data + header.args_size(), header.attachment_size());
+        HandleRequest(ReplyTarget{nullptr, nullptr, header.call_id(), false, batch, static_cast<uint32_t>(i)}, header, args_data, std::move(attachment), receive_time, decode_start_us);
+    }
+}
+
+// 保存一个子请求的响应帧, 最后完成的子请求把所有响应帧按顺序拼成响应体, 用一个响应帧发给调用方
+void AzRPC_Provider::BatchContext::Complete(uint32_t index, std::string frame) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        frames[index].swap(frame);
+        if (--remaining > 0) {
+            return;
+        }
+    }
+    size_t body_size = 0;
+    for (const std::string& sub_frame: frames) {
+        body_size += sub_frame.size();
+    }
+    std::string body;
+    body.reserve(body_size);
+    for (std::string& sub_frame: frames) {
+        body.append(sub_frame);
+        std::string().swap(sub_frame);
+    }
+    std::string send_str;
+    std::string trailer;
+    if (EncodeRpcResponse(target, response_compress, body, AzRPC_Attachment(), &send_str, &trailer, static_cast<uint32_t>(frames.size()))) {
+        target.Send(send_str, AzRPC_Attachment(), trailer);
+    }
+    else {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "batch response too large: %zu bytes", body.size());
+        AzRPC::RpcResponseHeader response_header;
+        response_header.set_error_code(AzRPC::RESPONSE_SERIALIZE_ERROR);
+        response_header.set_error_text("batch response too large");
+        response_header.set_call_id(target.call_id);
+        response_header.set_checksum(target.checksum);
+        send_str.clear();
+        if (AzRPC_Codec::EncodeResponse(&response_header, std::string(), &send_str)) {
+            target.Send(send_str);
+        }
+    }
 }
 
 // 发送RPC响应给客户端
-void AzRPC_Provider::SendRpcResponse(const muduo::net::TcpConnectionPtr& connection, google::protobuf::Message* response) {
-    std::string response_str;
-    if (response->SerializeToString(&response_str)) {
-        // 序列化成功，通过网络把RPC方法执行的结果返回给RPC调用方
-        connection->send(response_str);
+void AzRPC_Provider::SendRpcResponse(CallContext* context) {
+    bool sampled = context->controller.GetTraceContext().Sampled();
+    int64_t now_us = 0;
+    if (sampled) {
+        now_us = AzRPC_Tracer::NowMicros();
+        context->span.handler_us = now_us - context->stage_us;
+        context->stage_us = now_us;
+    }
+
+    // 处理期间合并进来的相同请求, 得到同样的结果
+    std::vector<FlightWaiter> waiters = LeaveFlight(context->flight_key);
+    if (context->controller.Failed()) {
+        // 业务方法通过controller报告了失败, 把错误信息带回给调用方
+        SendRpcError(context->target, AzRPC::HANDLER_FAILED, context->controller.ErrorText());
+        for (const FlightWaiter& waiter: waiters) {
+            SendRpcError(waiter.target, AzRPC::HANDLER_FAILED, context->controller.ErrorText());
+        }
     }
     else {
-        std::cout << "serialize error!" << std:: endl;
+        std::string response_str;
+        std::string send_str;
+        std::string trailer;
+        // 响应附件不压缩, 单独发送, 不拷贝进send_str
+        const AzRPC_Attachment& attachment = context->controller.ResponseAttachment();
+        if (context->response->SerializeToString(&response_str) && EncodeRpcResponse(context->target, context->response_compress, response_str, attachment, &send_str, &trailer)) {
+            if (sampled) {
+                now_us = AzRPC_Tracer::NowMicros();
+                context->span.encode_us = now_us - context->stage_us;
+                context->stage_us = now_us;
+            }
+            // 序列化成功，通过网络把RPC方法执行的结果返回给RPC调用方
+            context->target.Send(send_str, attachment, trailer);
+            if (sampled) {
+                context->span.send_us = AzRPC_Tracer::NowMicros() - context->stage_us;
+                AzRPC_Tracer::Export(context->span);
+            }
+            // 等待者各自的call_id和压缩算法不同, 分别编码
+            for (const FlightWaiter& waiter: waiters) {
+                send_str.clear();
+                trailer.clear();
+                if (EncodeRpcResponse(waiter.target, waiter.response_compress, response_str, attachment, &send_str, &trailer)) {
+                    waiter.target.Send(send_str, attachment, trailer);
+                }
+            }
+            // 缓存序列化后的响应, 命中时不再执行业务方法和序列化
+            if (!context->cache_key.empty() && cache_generation.load() == context->cache_generation) {
+                std::shared_ptr<AzRPC_Cache::Value> value = std::make_shared<AzRPC_Cache::Value>();
+                value->data.swap(response_str);
+                value->attachment.Append(attachment);
+                ResponseCache().Put(context->cache_key, value, context->cache_ttl_ms);
+            }
+        }
+        else {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "serialize error!");
+            SendRpcError(context->target, AzRPC::RESPONSE_SERIALIZE_ERROR, "serialize response error!");
+            for (const FlightWaiter& waiter: waiters) {
+                SendRpcError(waiter.target, AzRPC::RESPONSE_SERIALIZE_ERROR, "serialize response error!");
+            }
+        }
     }
     // conn->shutdown(); // 模拟HTTP短链接，由RpcProvider主动断开连接
+
+    // 本次调用结束, 归还方法的名额, 释放请求、响应和上下文
+    if (context->bulkhead != nullptr) {
+        context->bulkhead->Release();
+    }
+    delete context->request;
+    delete context->response;
+    delete context;
+}
+
+// 用调用方选择的算法压缩响应并编码响应帧, 太小或压缩后没有变小时原样发送
+bool AzRPC_Provider::EncodeRpcResponse(const ReplyTarget& target, AzRPC::CompressType response_compress, const std::string& body, const AzRPC_Attachment& attachment, std::string* frame, std::string* trailer, uint32_t batch_count) {
+    AzRPC::RpcResponseHeader response_header;
+    response_header.set_call_id(target.call_id);
+    response_header.set_checksum(target.checksum);
+    response_header.set_batch_count(batch_count);
+    return AzRPC_Codec::EncodeResponse(&response_header, body, response_compress, attachment, frame, trailer);
+}
+
+// 结束一次合并的请求, 返回期间登记的等待者
+std::vector<AzRPC_Provider::FlightWaiter> AzRPC_Provider::LeaveFlight(const std::string& key) {
+    std::vector<FlightWaiter> waiters;
+    if (key.empty()) {
+        return waiters;
+    }
+    std::lock_guard<std::mutex> lock(flight_mtx);
+    auto it = flights.find(key);
+    if (it != flights.end()) {
+        waiters.swap(it->second);
+        flights.erase(it);
+    }
+    return waiters;
+}
+
+void AzRPC_Provider::InvalidateCache(const std::string& service_name, const std::string& method_name, const google::protobuf::Message& request) {
+    std::string args;
+    if (!request.SerializeToString(&args)) {
+        return;
+    }
+    cache_generation.fetch_add(1);
+    ResponseCache().Erase(RequestKey(service_name, method_name, args.data(), args.size()));
+}
+
+void AzRPC_Provider::InvalidateCachePrefix(const std::string& service_name, const std::string& method_name, const std::string& request_prefix) {
+    std::string prefix = service_name + '\0';
+    if (!method_name.empty()) {
+        prefix.append(method_name).append(1, '\0').append(request_prefix);
+    }
+    cache_generation.fetch_add(1);
+    ResponseCache().ErasePrefix(prefix);
+}
+
+// 发送错误响应, 调用方据此设置controller的失败状态, 而不是一直等待
+void AzRPC_Provider::SendRpcError(const ReplyTarget& target, AzRPC::ErrorCode error_code, const std::string& error_text) {
+    AzRPC::RpcResponseHeader response_header;
+    response_header.set_error_code(error_code);
+    response_header.set_error_text(error_text);
+    response_header.set_call_id(target.call_id);
+    response_header.set_checksum(target.checksum);
+    std::string send_str;
+    if (AzRPC_Codec::EncodeResponse(&response_header, std::string(), &send_str)) {
+        target.Send(send_str);
+    }
+}
+
+void AzRPC_Provider::ReplyTarget::Send(const std::string& frame) const {
+    if (batch) {
+        batch->Complete(batch_index, frame);
+    }
+    else if (shm) {
+        // 段已关闭时调用方已经离开, 丢弃响应
+        std::lock_guard<std::mutex> lock(shm->write_mtx);
+        shm->segment->Response().Write(frame.data(), frame.size());
+    }
+    else if (connection->getLoop()->isInLoopThread()) {
+        AzRPC_Cork::Send(connection, frame.data(), frame.size());
+    }
+    else {
+        // 其他线程中完成的响应投递到IO线程后再暂存, 同一轮中投递过来的响应合并写出
+        muduo::net::TcpConnectionPtr target_connection = connection;
+        std::string data = frame;
+        connection->getLoop()->runInLoop([target_connection, data] { AzRPC_Cork::Send(target_connection, data.data(), data.size()); });
+    }
+}
+
+void AzRPC_Provider::ReplyTarget::Send(const std::string& frame, const AzRPC_Attachment& attachment, const std::string& trailer) const {
+    if (attachment.empty() && trailer.empty()) {
+        Send(frame);
+        return;
+    }
+    if (batch) {
+        std::string whole;
+        whole.reserve(frame.size() + attachment.size() + trailer.size());
+        whole.append(frame);
+        attachment.AppendTo(&whole);
+        whole.append(trailer);
+        batch->Complete(batch_index, std::move(whole));
+    }
+    else if (shm) {
+        // 持锁写入各部分, 其他线程的响应不会插入到中间
+        std::lock_guard<std::mutex> lock(shm->write_mtx);
+        bool written = shm->segment->Response().Write(frame.data(), frame.size());
+        for (size_t i = 0; written && i < attachment.Blocks().size(); ++i) {
+            written = shm->segment->Response().Write(attachment.Blocks()[i].data, attachment.Blocks()[i].size);
+        }
+        if (written && !trailer.empty()) {
+            shm->segment->Response().Write(trailer.data(), trailer.size());
+        }
+    }
+    else if (connection->getLoop()->isInLoopThread()) {
+        AzRPC_Cork::Send(connection, frame, attachment, trailer);
+    }
+    else {
+        // 其他线程中分几次投递可能与其他响应交错, 拼成一帧投递到IO线程
+        std::string whole;
+        whole.reserve(frame.size() + attachment.size() + trailer.size());
+        whole.append(frame);
+        attachment.AppendTo(&whole);
+        whole.append(trailer);
+        Send(whole);
+    }
+}
+
+// 流式调用的帧, 在IO线程中调用
+void AzRPC_Provider::HandleStreamFrame(const muduo::net::TcpConnectionPtr& connection, const AzRPC::RpcHeader& header, const char* body) {
+    if (header.stream_type() == AzRPC::STREAM_OPEN) {
+        OpenStream(connection, header);
+        return;
+    }
+    ServerStreamPtr stream;
+    {
+        std::lock_guard<std::mutex> lock(stream_mtx);
+        auto it = streams.find(std::make_pair(connection->name(), header.call_id()));
+        if (it == streams.end()) {
+            // 流已经结束, 调用方还在途中的帧直接丢弃
+            return;
+        }
+        stream = it->second;
+    }
+    stream->OnFrame(header, body);
+}
+
+// 打开流: 查找处理函数, 在新线程中执行它, 处理函数返回后结束流
+// 流数达到上限或者创建线程失败时回复OVERLOADED, 调用方可以稍后重试
+void AzRPC_Provider::OpenStream(const muduo::net::TcpConnectionPtr& connection, const AzRPC::RpcHeader& header) {
+    const std::string& service_name = header.service_name();
+    const std::string& method_name = header.method_name();
+    ReplyTarget target{connection, nullptr, header.call_id(), header.checksum()};
+
+    auto it = service_map.find(service_name);
+    if (it == service_map.end()) {
+        SendRpcError(target, AzRPC::SERVICE_NOT_FOUND, service_name + " does not exist!");
+        return;
+    }
+    auto hit = it->second.stream_handlers.find(method_name);
+    if (hit == it->second.stream_handlers.end()) {
+        SendRpcError(target, AzRPC::METHOD_NOT_FOUND, service_name + "." + method_name + " is not a stream method!");
+        return;
+    }
+
+    ServerStreamPtr stream = std::make_shared<AzRPC_ServerStream>(header.call_id(), header.checksum(), header.stream_credits(), [target](const std::string& frame) {
+        target.Send(frame);
+    });
+    std::pair<std::string, uint64_t> key(connection->name(), header.call_id());
+    {
+        std::lock_guard<std::mutex> lock(stream_mtx);
+        size_t on_connection = 0;
+        for (auto sit = streams.lower_bound(std::make_pair(connection->name(), uint64_t(0))); sit != streams.end() && sit->first.first == connection->name(); ++sit) {
+            ++on_connection;
+        }
+        if (streams.size() >= max_streams || on_connection >= max_streams_per_connection) {
+            AZRPC_LOG_ERROR_RATELIMIT(10, "too many streams, reject %s.%s from %s", service_name.c_str(), method_name.c_str(), connection->name().c_str());
+            SendRpcError(target, AzRPC::OVERLOADED, "server overloaded, too many streams");
+            return;
+        }
+        if (!streams.emplace(key, stream).second) {
+            SendRpcError(target, AzRPC::HANDLER_FAILED, "duplicate stream call id");
+            return;
+        }
+    }
+
+    // 流的所有帧(包括打开时的信用帧)都从处理线程发出, 保持顺序; 线程没有创建成功时调用方只会收到错误
+    StreamHandler handler = hit->second;
+    try {
+        std::thread([this, key, stream, handler] {
+            stream->Open();
+            handler(stream.get());
+            stream->Finish();
+            std::lock_guard<std::mutex> lock(stream_mtx);
+            streams.erase(key);
+            stream_cv.notify_all();
+        }).detach();
+    }
+    catch (const std::system_error& e) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "create stream thread error: %s", e.what());
+        {
+            std::lock_guard<std::mutex> lock(stream_mtx);
+            streams.erase(key);
+            stream_cv.notify_all();
+        }
+        SendRpcError(target, AzRPC::OVERLOADED, "server overloaded, cannot start stream");
+    }
+}
+
+// 连接断开, 唤醒其上所有阻塞在Read/Write中的处理函数
+void AzRPC_Provider::CloseStreams(const muduo::net::TcpConnectionPtr& connection) {
+    std::lock_guard<std::mutex> lock(stream_mtx);
+    for (auto it = streams.lower_bound(std::make_pair(connection->name(), uint64_t(0))); it != streams.end() && it->first.first == connection->name(); ++it) {
+        it->second->Close();
+    }
+}
+
+// 连接来自本机: Unix域连接, 或对端为回环地址的TCP连接
+bool AzRPC_Provider::IsLocalConnection(const muduo::net::TcpConnectionPtr& connection) {
+    if (connection->name().compare(0, strlen(kUnixConnectionPrefix), kUnixConnectionPrefix) == 0) {
+        return true;
+    }
+    std::string ip = connection->peerAddress().toIp();
+    return ip.compare(0, 4, "127.") == 0 || ip == "::1" || ip.compare(0, 11, "::ffff:127.") == 0;
+}
+
+// 调用方请求改用共享内存传输, 需要配置rpc_shm=true, 且只接受本机的连接
+// 应答通过原连接返回: 成功为OK, 否则为错误码, 调用方收到错误后继续使用原连接
+void AzRPC_Provider::AttachShm(const muduo::net::TcpConnectionPtr& connection, const std::string& name) {
+    ReplyTarget reply{connection, nullptr, 0, false};
+    if (AzRPC_Application::GetConfig().Load("rpc_shm") != "true") {
+        SendRpcError(reply, AzRPC::SERVICE_NOT_FOUND, "shm transport is disabled");
+        return;
+    }
+    if (!IsLocalConnection(connection)) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "shm attach from remote peer %s rejected", connection->peerAddress().toIpPort().c_str());
+        SendRpcError(reply, AzRPC::SERVICE_NOT_FOUND, "shm transport is only available to local peers");
+        return;
+    }
+    std::unique_ptr<AzRPC_ShmSegment> segment = AzRPC_ShmSegment::Open(name);
+    if (!segment) {
+        SendRpcError(reply, AzRPC::HANDLER_FAILED, "open shm segment failed");
+        return;
+    }
+
+    ShmSessionPtr session = std::make_shared<ShmSession>();
+    session->segment = std::move(segment);
+    {
+        std::lock_guard<std::mutex> lock(shm_mtx);
+        if (!shm_sessions.emplace(connection->name(), session).second) {
+            SendRpcError(reply, AzRPC::HANDLER_FAILED, "shm segment already attached");
+            return;
+        }
+        ++shm_threads;
+    }
+    std::thread([this, session] {
+        ServeShm(session);
+        std::lock_guard<std::mutex> lock(shm_mtx);
+        --shm_threads;
+        shm_cv.notify_all();
+    }).detach();
+
+    AzRPC::RpcResponseHeader response_header;
+    std::string send_str;
+    AzRPC_Codec::EncodeResponse(&response_header, std::string(), &send_str);
+    connection->send(send_str);
+}
+
+void AzRPC_Provider::DetachShm(const muduo::net::TcpConnectionPtr& connection) {
+    ShmSessionPtr session;
+    {
+        std::lock_guard<std::mutex> lock(shm_mtx);
+        auto it = shm_sessions.find(connection->name());
+        if (it == shm_sessions.end()) {
+            return;
+        }
+        session = it->second;
+        shm_sessions.erase(it);
+    }
+    // 在IO线程中调用, 只通知服务线程退出, 不等待它
+    session->segment->Close();
+}
+
+// 共享内存会话的服务线程: 从请求环中读出字节流, 按帧分发, 与OnMessage的处理方式相同
+void AzRPC_Provider::ServeShm(ShmSessionPtr session) {
+    AzRPC_ShmRing& ring = session->segment->Request();
+    std::string buffer;
+    while (true) {
+        ssize_t n = ring.Read(&buffer, 100);
+        if (n < 0) {
+            break;
+        }
+        if (n == 0) {
+            continue;
+        }
+        muduo::Timestamp receive_time = muduo::Timestamp::now();
+        size_t offset = 0;
+        while (offset < buffer.size()) {
+            int64_t decode_start_us = AzRPC_Tracer::NowMicros();
+            AzRPC::RpcHeader AzRPC_Header;
+            size_t args_offset = 0;
+            int frame_size = AzRPC_Codec::DecodeRequest(buffer.data() + offset, buffer.size() - offset, &AzRPC_Header, &args_offset);
+            if (frame_size == AzRPC_Codec::kIncomplete) {
+                break;
+            }
+            if (frame_size == AzRPC_Codec::kInvalid) {
+                AZRPC_LOG_ERROR_RATELIMIT(10, "AzRPC_Header parse error from shm %s", session->segment->Name().c_str());
+                session->segment->Close();
+                return;
+            }
+            if (frame_size == AzRPC_Codec::kChecksumError) {
+                AZRPC_LOG_ERROR_RATELIMIT(10, "request checksum mismatch from shm %s", session->segment->Name().c_str());
+                SendRpcError(ReplyTarget{nullptr, session, AzRPC_Header.call_id(), true}, AzRPC::CHECKSUM_ERROR, "request checksum mismatch");
+                session->segment->Close();
+                return;
+            }
+            if (AzRPC_Header.stream_type() != AzRPC::STREAM_NONE) {
+                // 流式调用总是使用单独的socket连接
+                if (AzRPC_Header.stream_type() == AzRPC::STREAM_OPEN) {
+                    SendRpcError(ReplyTarget{nullptr, session, AzRPC_Header.call_id(), AzRPC_Header.checksum()}, AzRPC::METHOD_NOT_FOUND, "stream call over shm is not supported");
+                }
+                offset += frame_size;
+                continue;
+            }
+            // 请求附件的处理与OnMessage相同, 较大时把整个缓冲区交给附件, 剩余数据留在新的缓冲区中
+            AzRPC_Attachment attachment;
+            size_t attachment_size = AzRPC_Header.attachment_size();
+            const char* frame = buffer.data() + offset;
+            size_t next_offset = offset + frame_size;
+            if (attachment_size >= kZeroCopyAttachmentSize) {
+                std::shared_ptr<std::string> holder = std::make_shared<std::string>();
+                holder->swap(buffer);
+                frame = holder->data() + offset;
+                buffer.assign(holder->data() + next_offset, holder->size() - next_offset);
+                next_offset = 0;
+                attachment.AppendRef(frame + args_offset + AzRPC_Header.args_size(), attachment_size, holder);
+            }
+            else {
+                attachment.Append(frame + args_offset + AzRPC_Header.args_size(), attachment_size);
+            }
+            HandleRequest(ReplyTarget{nullptr, session, AzRPC_Header.call_id(), AzRPC_Header.checksum()}, AzRPC_Header, frame + args_offset, std::move(attachment), receive_time, decode_start_us);
+            offset = next_offset;
+        }
+        buffer.erase(0, offset);
+    }
 }
 
 // 析构函数退出事件循环
 AzRPC_Provider::~AzRPC_Provider() {
-    std::cout << "~AzRPC_Provider()" << std::endl;
+    AZRPC_LOG_INFO("~AzRPC_Provider()");
+    // 先停止处理线程, 排队中的请求不再执行; 调度器本身保留到析构结束, 异步完成的请求归还舱壁名额时仍可以调用Resume, 任务被丢弃
+    if (scheduler) {
+        scheduler->Stop();
+    }
+    // 与TcpServer的析构相同, 在各自的IO线程中销毁还未关闭的Unix域连接
+    for (auto& item: unix_connections) {
+        muduo::net::TcpConnectionPtr connection(item.second);
+        item.second.reset();
+        connection->getLoop()->runInLoop(std::bind(&muduo::net::TcpConnection::connectDestroyed, connection));
+    }
+    StopReusePort();
+    // 停止共享内存会话的服务线程, 包括连接断开时已经通知退出的
+    {
+        std::unique_lock<std::mutex> lock(shm_mtx);
+        for (auto& item: shm_sessions) {
+            item.second->segment->Close();
+        }
+        shm_cv.wait(lock, [this] { return shm_threads == 0; });
+    }
+    // 关闭所有流, 等待处理函数的线程退出
+    {
+        std::unique_lock<std::mutex> lock(stream_mtx);
+        for (auto& item: streams) {
+            item.second->Close();
+        }
+        stream_cv.wait(lock, [this] { return streams.empty(); });
+    }
     event_loop.quit();
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "AzRPC_Registry.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Logger.h"
+#include "ZooKeeperUtil.h"
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <vector>
+
+std::unique_ptr<AzRPC_Registry> AzRPC_Registry::NewFromConfig() {
+    AzRPC_Config& config = AzRPC_Application::GetConfig();
+    std::string type = config.Load("registry");
+    if (type == "memory") {
+        return std::unique_ptr<AzRPC_Registry>(new AzRPC_MemoryRegistry());
+    }
+    if (type == "file") {
+        return std::unique_ptr<AzRPC_Registry>(new AzRPC_FileRegistry(config.Load("registry_file")));
+    }
+    return std::unique_ptr<AzRPC_Registry>(new ZkClient());
+}
+
+namespace {
+
+// 进程内注册中心的全局状态
+struct MemoryNode {
+    std::string data;
+    uint64_t owner;     // 临时节点所属的会话, 持久节点为0
+};
+
+struct MemoryTree {
+    std::mutex mtx;
+    uint64_t next_session = 1;
+    std::map<std::string, MemoryNode> nodes;
+    std::multimap<std::string, AzRPC_Registry::WatchCallback> watches;
+
+    // 取出某个路径上的所有watch, 由调用方在释放锁之后执行, 回调中可以再次访问注册中心
+    std::vector<AzRPC_Registry::WatchCallback> TakeWatches(const std::string& path) {
+        std::vector<AzRPC_Registry::WatchCallback> fired;
+        auto range = watches.equal_range(path);
+        for (auto it = range.first; it != range.second; ++it) {
+            fired.push_back(it->second);
+        }
+        watches.erase(range.first, range.second);
+        return fired;
+    }
+};
+
+MemoryTree& Tree() {
+    static MemoryTree tree;
+    return tree;
+}
+
+void Fire(const std::vector<AzRPC_Registry::WatchCallback>& fired, const std::string& path) {
+    for (auto& callback: fired) {
+        callback(path);
+    }
+}
+
+}  // namespace
+
+AzRPC_MemoryRegistry::AzRPC_MemoryRegistry() {
+    std::lock_guard<std::mutex> lock(Tree().mtx);
+    m_session = Tree().next_session++;
+}
+
+// 会话结束, 删除本会话创建的临时节点
+AzRPC_MemoryRegistry::~AzRPC_MemoryRegistry() {
+    std::vector<std::pair<std::string, std::vector<WatchCallback>>> fired;
+    {
+        MemoryTree& tree = Tree();
+        std::lock_guard<std::mutex> lock(tree.mtx);
+        for (auto it = tree.nodes.begin(); it != tree.nodes.end();) {
+            if (it->second.owner == m_session) {
+                fired.emplace_back(it->first, tree.TakeWatches(it->first));
+                it = tree.nodes.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    for (auto& f: fired) {
+        Fire(f.second, f.first);
+    }
+}
+
+bool AzRPC_MemoryRegistry::Start() {
+    return true;
+}
+
+bool AzRPC_MemoryRegistry::Create(const std::string& path, const std::string& data, bool ephemeral) {
+    std::vector<WatchCallback> fired;
+    {
+        MemoryTree& tree = Tree();
+        std::lock_guard<std::mutex> lock(tree.mtx);
+        // 与ZooKeeper一致: 父节点必须存在, 节点不能重复创建
+        size_t pos = path.rfind('/');
+        if (pos != 0 && pos != std::string::npos && tree.nodes.find(path.substr(0, pos)) == tree.nodes.end()) {
+            AZRPC_LOG_ERROR("znode create failed... path: %s, error: no parent node", path.c_str());
+            return false;
+        }
+        if (!tree.nodes.emplace(path, MemoryNode{data, ephemeral ? m_session : 0}).second) {
+            AZRPC_LOG_ERROR("znode create failed... path: %s, error: node exists", path.c_str());
+            return false;
+        }
+        fired = tree.TakeWatches(path);
+    }
+    Fire(fired, path);
+    return true;
+}
+
+std::string AzRPC_MemoryRegistry::GetData(const std::string& path) {
+    MemoryTree& tree = Tree();
+    std::lock_guard<std::mutex> lock(tree.mtx);
+    auto it = tree.nodes.find(path);
+    return it == tree.nodes.end() ? "" : it->second.data;
+}
+
+bool AzRPC_MemoryRegistry::Exists(const std::string& path) {
+    MemoryTree& tree = Tree();
+    std::lock_guard<std::mutex> lock(tree.mtx);
+    return tree.nodes.find(path) != tree.nodes.end();
+}
+
+bool AzRPC_MemoryRegistry::Watch(const std::string& path, const WatchCallback& callback) {
+    MemoryTree& tree = Tree();
+    std::lock_guard<std::mutex> lock(tree.mtx);
+    tree.watches.emplace(path, callback);
+    return true;
+}
+
+bool AzRPC_MemoryRegistry::SetData(const std::string& path, const std::string& data) {
+    std::vector<WatchCallback> fired;
+    {
+        MemoryTree& tree = Tree();
+        std::lock_guard<std::mutex> lock(tree.mtx);
+        auto it = tree.nodes.find(path);
+        if (it == tree.nodes.end()) {
+            return false;
+        }
+        it->second.data = data;
+        fired = tree.TakeWatches(path);
+    }
+    Fire(fired, path);
+    return true;
+}
+
+bool AzRPC_MemoryRegistry::Delete(const std::string& path) {
+    std::vector<WatchCallback> fired;
+    {
+        MemoryTree& tree = Tree();
+        std::lock_guard<std::mutex> lock(tree.mtx);
+        if (tree.nodes.erase(path) == 0) {
+            return false;
+        }
+        fired = tree.TakeWatches(path);
+    }
+    Fire(fired, path);
+    return true;
+}
+
+AzRPC_FileRegistry::AzRPC_FileRegistry(const std::string& file): m_file(file) {}
+
+// 加载静态文件, 格式与框架配置文件相同(key=value, #开头为注释)
+bool AzRPC_FileRegistry::Start() {
+    std::unique_ptr<FILE, int(*)(FILE*)> pf(fopen(m_file.c_str(), "r"), &fclose);
+    if (pf == nullptr) {
+        AZRPC_LOG_ERROR("open registry file error: %s", m_file.c_str());
+        return false;
+    }
+    pf.reset();
+
+    AzRPC_Config nodes;
+    nodes.LoadConfigFile(m_file.c_str());
+    m_nodes = nodes.All();
+    return true;
+}
+
+bool AzRPC_FileRegistry::Create(const std::string& path, const std::string& data, bool ephemeral) {
+    return true;
+}
+
+std::string AzRPC_FileRegistry::GetData(const std::string& path) {
+    auto it = m_nodes.find(path);
+    if (it != m_nodes.end()) {
+        return it->second;
+    }
+    // 方法没有单独配置时使用服务的地址
+    size_t pos = path.rfind('/');
+    if (pos != 0 && pos != std::string::npos) {
+        it = m_nodes.find(path.substr(0, pos));
+        if (it != m_nodes.end()) {
+            return it->second;
+        }
+    }
+    return "";
+}
+
+bool AzRPC_FileRegistry::Exists(const std::string& path) {
+    return !GetData(path).empty();
+}
+
+bool AzRPC_FileRegistry::Watch(const std::string& path, const WatchCallback& callback) {
+    return false;
+}
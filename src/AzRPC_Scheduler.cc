@@ -0,0 +1,182 @@
+#include "AzRPC_Scheduler.h"
+#include "AzRPC_Metrics.h"
+#include <algorithm>
+
+namespace {
+
+const char* const kLevelNames[] = {"critical", "high", "normal", "low"};
+
+}  // namespace
+
+AzRPC_Scheduler::AzRPC_Scheduler(size_t worker_num, size_t queue_limit)
+    : m_queued(0), m_queue_limit(std::max(static_cast<size_t>(1), queue_limit)), m_stop(false) {
+    for (int level = 0; level < kLevels; ++level) {
+        m_shed[level] = &AzRPC_Metrics::Counter(std::string("provider_shed_") + kLevelNames[level]);
+    }
+    for (size_t i = 0; i < worker_num; ++i) {
+        m_workers.emplace_back(&AzRPC_Scheduler::Work, this);
+    }
+}
+
+AzRPC_Scheduler::~AzRPC_Scheduler() {
+    Stop();
+}
+
+void AzRPC_Scheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (std::thread& worker: m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+int AzRPC_Scheduler::Level(AzRPC::Priority priority) {
+    switch (priority) {
+        case AzRPC::PRIORITY_CRITICAL: return 0;
+        case AzRPC::PRIORITY_HIGH: return 1;
+        case AzRPC::PRIORITY_LOW: return 3;
+        default: return 2;
+    }
+}
+
+bool AzRPC_Scheduler::ParsePriority(const std::string& name, AzRPC::Priority* priority) {
+    static const AzRPC::Priority kPriorities[] = {AzRPC::PRIORITY_CRITICAL, AzRPC::PRIORITY_HIGH, AzRPC::PRIORITY_NORMAL, AzRPC::PRIORITY_LOW};
+    for (int level = 0; level < kLevels; ++level) {
+        if (name == kLevelNames[level]) {
+            *priority = kPriorities[level];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AzRPC_Scheduler::Submit(AzRPC::Priority priority, const std::string& flow, uint32_t weight, Task run, Task shed) {
+    int level = Level(priority);
+    Item victim;
+    bool shed_one = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_stop) {
+            return false;
+        }
+        // 队列已满: 挤掉更低类别的一个请求, 否则拒绝新请求
+        if (m_queued >= m_queue_limit) {
+            shed_one = ShedLowest(level, &victim);
+            if (!shed_one) {
+                m_shed[level]->fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        Queue& queue = m_queues[level];
+        Flow& entry = queue.flows[flow];
+        if (entry.items.empty()) {
+            entry.key = flow;
+            entry.weight = std::max(1u, weight);
+            entry.deficit = 0;
+            queue.active.push_back(&entry);
+        }
+        entry.items.push_back(Item{std::move(run), std::move(shed)});
+        // 挤掉一个时排队总数不变, 不需要唤醒更多的处理线程
+        if (!shed_one) {
+            ++m_queued;
+        }
+    }
+    if (shed_one) {
+        if (victim.shed) {
+            victim.shed();
+        }
+    }
+    else {
+        m_cv.notify_one();
+    }
+    return true;
+}
+
+void AzRPC_Scheduler::Resume(Task run) {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_stop) {
+            return;
+        }
+        m_resumed.push_back(std::move(run));
+    }
+    m_cv.notify_one();
+}
+
+// 在比level低的类别中从最低的开始找, 丢弃其中排队最多的流的最新请求; 在锁内调用
+bool AzRPC_Scheduler::ShedLowest(int level, Item* victim) {
+    for (int lower = kLevels - 1; lower > level; --lower) {
+        Queue& queue = m_queues[lower];
+        if (queue.active.empty()) {
+            continue;
+        }
+        Flow* largest = queue.active.front();
+        for (Flow* flow: queue.active) {
+            if (flow->items.size() > largest->items.size()) {
+                largest = flow;
+            }
+        }
+        *victim = std::move(largest->items.back());
+        largest->items.pop_back();
+        if (largest->items.empty()) {
+            queue.active.erase(std::find(queue.active.begin(), queue.active.end(), largest));
+            queue.flows.erase(queue.flows.find(largest->key));
+        }
+        m_shed[lower]->fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+// 取出下一个要执行的请求: 先执行等到了名额的请求, 然后是最高的非空类别中轮转到的流的队首; 在锁内调用
+bool AzRPC_Scheduler::Pop(Item* item) {
+    if (!m_resumed.empty()) {
+        item->run = std::move(m_resumed.front());
+        m_resumed.pop_front();
+        return true;
+    }
+    for (Queue& queue: m_queues) {
+        if (queue.active.empty()) {
+            continue;
+        }
+        Flow* flow = queue.active.front();
+        if (flow->deficit == 0) {
+            flow->deficit = flow->weight;
+        }
+        *item = std::move(flow->items.front());
+        flow->items.pop_front();
+        --flow->deficit;
+        --m_queued;
+        if (flow->items.empty()) {
+            queue.active.pop_front();
+            queue.flows.erase(queue.flows.find(flow->key));
+        }
+        else if (flow->deficit == 0) {
+            // 本轮的份额用完, 排到队尾
+            queue.active.pop_front();
+            queue.active.push_back(flow);
+        }
+        return true;
+    }
+    return false;
+}
+
+void AzRPC_Scheduler::Work() {
+    while (true) {
+        Item item;
+        {
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait(lock, [this] { return m_stop || m_queued > 0 || !m_resumed.empty(); });
+            if (m_stop) {
+                return;
+            }
+            Pop(&item);
+        }
+        item.run();
+    }
+}
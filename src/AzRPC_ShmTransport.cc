@@ -0,0 +1,333 @@
+#include "AzRPC_ShmTransport.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t kShmMagic = 0x415A534D;     // "AZSM"
+const uint32_t kShmVersion = 1;
+const size_t kMinRingSize = 4096;
+const size_t kMaxRingSize = 1UL << 30;
+const int kMinSpin = 32;
+const int kWriteWaitMs = 100;              // 环满时每次等待的时长, 醒来后检查段是否已关闭
+
+// 段的开头, 后面依次是请求环和响应环的控制块以及它们的数据区
+struct SegmentHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t ring_size;
+    std::atomic<uint32_t> closed;
+};
+
+const size_t kSegmentHeaderSize = 64;
+static_assert(sizeof(SegmentHeader) <= kSegmentHeaderSize, "segment header too large");
+static_assert(sizeof(AzRPC_ShmRingHeader) % 64 == 0, "ring header must be cache line aligned");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+size_t SegmentSize(size_t ring_size) {
+    return kSegmentHeaderSize + 2 * sizeof(AzRPC_ShmRingHeader) + 2 * ring_size;
+}
+
+// 共享内存跨进程使用, 不能用FUTEX_PRIVATE_FLAG
+void FutexWait(std::atomic<uint32_t>* word, uint32_t value, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, value, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// 自旋次数的上限, 配置项rpc_shm_spin, 单核机器上自旋只会推迟对端运行, 不自旋
+int MaxSpin() {
+    static int max_spin = [] {
+        if (sysconf(_SC_NPROCESSORS_ONLN) <= 1) {
+            return 0;
+        }
+        std::string value = AzRPC_Application::GetConfig().Load("rpc_shm_spin");
+        return value.empty() ? 16384 : std::max(0, atoi(value.c_str()));
+    }();
+    return max_spin;
+}
+
+int64_t NowMillis() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+}  // namespace
+
+AzRPC_ShmRing::AzRPC_ShmRing(AzRPC_ShmRingHeader* header, char* data, std::atomic<uint32_t>* closed)
+    : m_header(header), m_data(data), m_capacity(header->capacity), m_closed(closed), m_spin(std::min(1024, MaxSpin())) {}
+
+bool AzRPC_ShmRing::Readable() const {
+    return m_header->head.load(std::memory_order_acquire) != m_header->tail.load(std::memory_order_relaxed);
+}
+
+bool AzRPC_ShmRing::Writable() const {
+    return m_header->head.load(std::memory_order_relaxed) - m_header->tail.load(std::memory_order_acquire) < m_capacity;
+}
+
+// 头尾计数都在共享内存中, 对端可以任意改写, 两者之差超过容量时按它们计算的偏移会越界
+bool AzRPC_ShmRing::Corrupted(uint64_t head, uint64_t tail) {
+    if (head - tail <= m_capacity) {
+        return false;
+    }
+    AZRPC_LOG_ERROR_RATELIMIT(10, "shm ring offsets out of range, head %llu tail %llu capacity %llu", static_cast<unsigned long long>(head), static_cast<unsigned long long>(tail), static_cast<unsigned long long>(m_capacity));
+    m_closed->store(1);
+    WakeAll();
+    return true;
+}
+
+// 自旋期间等到了就加倍自旋次数, 最终还是睡眠了说明自旋是浪费, 减半
+void AzRPC_ShmRing::AdjustSpin(bool spun) {
+    int max_spin = MaxSpin();
+    if (spun) {
+        m_spin = std::min(max_spin, std::max(kMinSpin, m_spin * 2));
+    }
+    else {
+        m_spin = std::min(max_spin, std::max(kMinSpin, m_spin / 2));
+    }
+}
+
+// 等待ready成立: 先自旋, 再在seq上futex睡眠
+// 先置waiting再读取seq并重新检查条件, 对端先更新数据再递增seq、最后检查waiting, 因此不会丢失唤醒
+bool AzRPC_ShmRing::WaitChange(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiting, int timeout_ms, bool (AzRPC_ShmRing::*ready)() const) {
+    for (int i = 0; i < m_spin; ++i) {
+        if ((this->*ready)()) {
+            AdjustSpin(true);
+            return true;
+        }
+        CpuRelax();
+    }
+
+    int64_t deadline = NowMillis() + timeout_ms;
+    waiting->store(1);
+    while (true) {
+        uint32_t seen = seq->load();
+        if ((this->*ready)() || m_closed->load()) {
+            break;
+        }
+        int64_t remaining = deadline - NowMillis();
+        if (remaining <= 0) {
+            break;
+        }
+        FutexWait(seq, seen, static_cast<int>(remaining));
+    }
+    waiting->store(0);
+    AdjustSpin(false);
+    return (this->*ready)();
+}
+
+bool AzRPC_ShmRing::Write(const char* data, size_t len) {
+    const uint64_t capacity = m_capacity;
+    while (len > 0) {
+        if (m_closed->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        uint64_t head = m_header->head.load(std::memory_order_relaxed);
+        uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+        if (Corrupted(head, tail)) {
+            return false;
+        }
+        uint64_t space = capacity - (head - tail);
+        if (space == 0) {
+            WaitChange(&m_header->space_seq, &m_header->writer_waiting, kWriteWaitMs, &AzRPC_ShmRing::Writable);
+            continue;
+        }
+
+        // 数据区是环形的, 写入位置到末尾不够时分两段拷贝
+        size_t n = std::min<uint64_t>(len, space);
+        size_t offset = head & (capacity - 1);
+        size_t first = std::min<uint64_t>(n, capacity - offset);
+        memcpy(m_data + offset, data, first);
+        memcpy(m_data, data + first, n - first);
+
+        m_header->head.store(head + n);
+        m_header->data_seq.fetch_add(1);
+        if (m_header->reader_waiting.load()) {
+            FutexWake(&m_header->data_seq);
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+ssize_t AzRPC_ShmRing::Read(std::string* out, int timeout_ms) {
+    if (!Readable()) {
+        if (m_closed->load()) {
+            return -1;
+        }
+        if (!WaitChange(&m_header->data_seq, &m_header->reader_waiting, timeout_ms, &AzRPC_ShmRing::Readable)) {
+            return m_closed->load() ? -1 : 0;
+        }
+    }
+
+    const uint64_t capacity = m_capacity;
+    uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+    uint64_t head = m_header->head.load(std::memory_order_acquire);
+    if (Corrupted(head, tail)) {
+        return -1;
+    }
+    size_t n = head - tail;
+    size_t offset = tail & (capacity - 1);
+    size_t first = std::min<uint64_t>(n, capacity - offset);
+    out->append(m_data + offset, first);
+    out->append(m_data, n - first);
+
+    m_header->tail.store(head);
+    m_header->space_seq.fetch_add(1);
+    if (m_header->writer_waiting.load()) {
+        FutexWake(&m_header->space_seq);
+    }
+    return n;
+}
+
+void AzRPC_ShmRing::WakeAll() {
+    if (m_header != nullptr) {
+        m_header->data_seq.fetch_add(1);
+        m_header->space_seq.fetch_add(1);
+        FutexWake(&m_header->data_seq);
+        FutexWake(&m_header->space_seq);
+    }
+}
+
+AzRPC_ShmSegment::~AzRPC_ShmSegment() {
+    if (m_addr != nullptr) {
+        munmap(m_addr, m_size);
+    }
+    Unlink();
+}
+
+// 映射段并建立两个环的视图
+bool AzRPC_ShmSegment::Map(int fd, size_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        AZRPC_LOG_ERROR("shm mmap error: %s", strerror(errno));
+        return false;
+    }
+    m_addr = addr;
+    m_size = size;
+    return true;
+}
+
+std::unique_ptr<AzRPC_ShmSegment> AzRPC_ShmSegment::Create(size_t ring_size) {
+    size_t rounded = kMinRingSize;
+    while (rounded < ring_size && rounded < kMaxRingSize) {
+        rounded <<= 1;
+    }
+
+    static std::atomic<uint32_t> counter(0);
+    std::unique_ptr<AzRPC_ShmSegment> segment(new AzRPC_ShmSegment());
+    segment->m_name = "/azrpc-" + std::to_string(getpid()) + "-" + std::to_string(counter.fetch_add(1));
+    int fd = shm_open(segment->m_name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        AZRPC_LOG_ERROR("shm_open %s error: %s", segment->m_name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    segment->m_linked = true;
+    size_t size = SegmentSize(rounded);
+    bool mapped = ftruncate(fd, size) == 0 && segment->Map(fd, size);
+    close(fd);
+    if (!mapped) {
+        return nullptr;
+    }
+
+    // ftruncate得到的页全为0, 只需要填写容量, 最后写魔数表示初始化完成
+    char* base = static_cast<char*>(segment->m_addr);
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(base);
+    AzRPC_ShmRingHeader* request = reinterpret_cast<AzRPC_ShmRingHeader*>(base + kSegmentHeaderSize);
+    AzRPC_ShmRingHeader* response = request + 1;
+    request->capacity = rounded;
+    response->capacity = rounded;
+    header->version = kShmVersion;
+    header->ring_size = rounded;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kShmMagic;
+
+    char* data = reinterpret_cast<char*>(response + 1);
+    segment->m_request = AzRPC_ShmRing(request, data, &header->closed);
+    segment->m_response = AzRPC_ShmRing(response, data + rounded, &header->closed);
+    return segment;
+}
+
+std::unique_ptr<AzRPC_ShmSegment> AzRPC_ShmSegment::Open(const std::string& name) {
+    // 段名由对端提供, 只接受本框架生成的名字
+    if (name.compare(0, 7, "/azrpc-") != 0 || name.find('/', 1) != std::string::npos) {
+        return nullptr;
+    }
+    int fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd == -1) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "shm_open %s error: %s", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    std::unique_ptr<AzRPC_ShmSegment> segment(new AzRPC_ShmSegment());
+    segment->m_name = name;
+    bool mapped = fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(SegmentSize(kMinRingSize)) && segment->Map(fd, st.st_size);
+    close(fd);
+    if (!mapped) {
+        return nullptr;
+    }
+
+    char* base = static_cast<char*>(segment->m_addr);
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(base);
+    uint64_t ring_size = header->ring_size;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != kShmMagic || header->version != kShmVersion || (ring_size & (ring_size - 1)) != 0 || SegmentSize(ring_size) != segment->m_size) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "shm segment %s is not valid", name.c_str());
+        return nullptr;
+    }
+    AzRPC_ShmRingHeader* request = reinterpret_cast<AzRPC_ShmRingHeader*>(base + kSegmentHeaderSize);
+    AzRPC_ShmRingHeader* response = request + 1;
+    if (request->capacity != ring_size || response->capacity != ring_size) {
+        return nullptr;
+    }
+    char* data = reinterpret_cast<char*>(response + 1);
+    segment->m_request = AzRPC_ShmRing(request, data, &header->closed);
+    segment->m_response = AzRPC_ShmRing(response, data + ring_size, &header->closed);
+    return segment;
+}
+
+void AzRPC_ShmSegment::Unlink() {
+    if (m_linked) {
+        shm_unlink(m_name.c_str());
+        m_linked = false;
+    }
+}
+
+void AzRPC_ShmSegment::Close() {
+    if (m_addr == nullptr) {
+        return;
+    }
+    static_cast<SegmentHeader*>(m_addr)->closed.store(1);
+    m_request.WakeAll();
+    m_response.WakeAll();
+}
+
+bool AzRPC_ShmSegment::Closed() const {
+    return m_addr == nullptr || static_cast<SegmentHeader*>(m_addr)->closed.load() != 0;
+}
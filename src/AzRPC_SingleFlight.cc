@@ -0,0 +1,86 @@
+#include "AzRPC_SingleFlight.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Controller.h"
+
+AzRPC_SingleFlight& AzRPC_SingleFlight::Instance() {
+    static AzRPC_SingleFlight instance;
+    return instance;
+}
+
+bool AzRPC_SingleFlight::Enabled(const std::string& service_name, const std::string& method_name) {
+    // 没有任何合并配置时(默认情况)不做逐次查找
+    static const bool configured = AzRPC_Application::GetConfig().HasPrefix("rpc_singleflight");
+    if (!configured) {
+        return false;
+    }
+    return AzRPC_Application::GetConfig().LoadForMethod("rpc_singleflight", service_name, method_name) == "true";
+}
+
+bool AzRPC_SingleFlight::MakeKey(const std::string& service_name, const std::string& method_name, const google::protobuf::Message& request, std::string* key) {
+    key->reserve(service_name.size() + method_name.size() + 2 + request.ByteSizeLong());
+    key->append(service_name);
+    key->push_back('\0');
+    key->append(method_name);
+    key->push_back('\0');
+    return request.AppendToString(key);
+}
+
+bool AzRPC_SingleFlight::Join(const std::string& key, Waiter waiter) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto it = m_calls.find(key);
+    if (it == m_calls.end()) {
+        m_calls.emplace(key, std::vector<Waiter>());
+        return true;
+    }
+    it->second.push_back(std::move(waiter));
+    return false;
+}
+
+void AzRPC_SingleFlight::Finish(const std::string& key, google::protobuf::RpcController* controller, const google::protobuf::Message* response) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto it = m_calls.find(key);
+        if (it == m_calls.end()) {
+            return;
+        }
+        waiters.swap(it->second);
+        m_calls.erase(it);
+    }
+    if (waiters.empty()) {
+        return;
+    }
+
+    Result result;
+    result.failed = controller->Failed();
+    if (result.failed) {
+        result.error = controller->ErrorText();
+    }
+    else if (!response->SerializeToString(&result.response)) {
+        result.failed = true;
+        result.error = "serialize coalesced response error";
+    }
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    if (az_controller != nullptr) {
+        result.attachment.Append(az_controller->ResponseAttachment());
+    }
+    for (auto& waiter: waiters) {
+        waiter(result);
+    }
+}
+
+void AzRPC_SingleFlight::Apply(const Result& result, google::protobuf::RpcController* controller, google::protobuf::Message* response) {
+    if (result.failed) {
+        controller->SetFailed(result.error);
+        return;
+    }
+    if (!response->ParseFromString(result.response)) {
+        controller->SetFailed("parse response error");
+        return;
+    }
+    AzRPC_Controller* az_controller = dynamic_cast<AzRPC_Controller*>(controller);
+    if (az_controller != nullptr) {
+        az_controller->ResponseAttachment().Clear();
+        az_controller->ResponseAttachment().Append(result.attachment);
+    }
+}
@@ -0,0 +1,289 @@
+#include "AzRPC_Stream.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// 本端的接收窗口, 配置项rpc_stream_window, 默认64条消息
+uint32_t StreamWindow() {
+    static const uint32_t window = [] {
+        std::string value = AzRPC_Application::GetConfig().Load("rpc_stream_window");
+        long n = value.empty() ? 64 : atol(value.c_str());
+        return static_cast<uint32_t>(std::max(1L, n));
+    }();
+    return window;
+}
+
+// 消费了半个窗口后归还信用, 发送方在窗口用完之前就能收到新的信用
+uint32_t CreditThreshold(uint32_t window) {
+    return std::max<uint32_t>(1, window / 2);
+}
+
+}  // namespace
+
+AzRPC_ClientStream::AzRPC_ClientStream(int fd, uint64_t call_id, bool checksum)
+    : m_fd(fd), m_call_id(call_id), m_checksum(checksum), m_window(StreamWindow()), m_send_credits(0), m_consumed(0),
+      m_send_closed(false), m_finished(false), m_failed(false) {}
+
+AzRPC_ClientStream::~AzRPC_ClientStream() {
+    if (m_fd != -1) {
+        close(m_fd);
+    }
+}
+
+bool AzRPC_ClientStream::Open(const std::string& service_name, const std::string& method_name) {
+    return SendFrame(AzRPC::STREAM_OPEN, std::string(), m_window, service_name, method_name);
+}
+
+bool AzRPC_ClientStream::Write(const google::protobuf::Message& message) {
+    if (m_send_closed) {
+        return false;
+    }
+    // 服务端的窗口用完, 读取后续的帧直到收到信用; 期间收到的消息先放进m_inbox
+    while (m_send_credits == 0) {
+        if (m_finished || !ReceiveOne()) {
+            return false;
+        }
+    }
+    if (m_finished) {
+        return false;
+    }
+    std::string body;
+    if (!message.SerializeToString(&body)) {
+        return Fail("serialize stream message error");
+    }
+    --m_send_credits;
+    return SendFrame(AzRPC::STREAM_DATA, body, 0, std::string(), std::string());
+}
+
+bool AzRPC_ClientStream::CloseSend() {
+    if (m_send_closed || m_finished) {
+        return !m_failed;
+    }
+    m_send_closed = true;
+    return SendFrame(AzRPC::STREAM_END, std::string(), 0, std::string(), std::string());
+}
+
+bool AzRPC_ClientStream::Read(google::protobuf::Message* message) {
+    while (m_inbox.empty()) {
+        if (m_finished || !ReceiveOne()) {
+            return false;
+        }
+    }
+    std::string body;
+    body.swap(m_inbox.front());
+    m_inbox.pop_front();
+    if (++m_consumed >= CreditThreshold(m_window) && !m_finished) {
+        uint32_t credits = m_consumed;
+        m_consumed = 0;
+        if (!SendFrame(AzRPC::STREAM_CREDIT, std::string(), credits, std::string(), std::string())) {
+            return false;
+        }
+    }
+    if (!message->ParseFromString(body)) {
+        return Fail("parse stream message error");
+    }
+    return true;
+}
+
+bool AzRPC_ClientStream::SendFrame(AzRPC::StreamFrameType type, const std::string& body, uint32_t credits, const std::string& service_name, const std::string& method_name) {
+    if (m_fd == -1) {
+        return false;
+    }
+    AzRPC::RpcHeader header;
+    header.set_service_name(service_name);
+    header.set_method_name(method_name);
+    header.set_call_id(m_call_id);
+    header.set_checksum(m_checksum);
+    header.set_stream_type(type);
+    header.set_stream_credits(credits);
+    std::string frame;
+    if (!AzRPC_Codec::EncodeRequest(&header, body, &frame)) {
+        return Fail("serialize rpc header error!");
+    }
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = send(m_fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            char errtxt[512] = {};
+            return Fail(strerror_r(errno, errtxt, sizeof(errtxt)));
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// 阻塞接收并处理一个帧
+bool AzRPC_ClientStream::ReceiveOne() {
+    while (true) {
+        AzRPC::RpcResponseHeader header;
+        size_t body_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeResponse(m_recv_buf.data(), m_recv_buf.size(), &header, &body_offset);
+        if (frame_size == AzRPC_Codec::kInvalid) {
+            return Fail("parse response header error");
+        }
+        if (frame_size == AzRPC_Codec::kChecksumError) {
+            return Fail("response checksum mismatch");
+        }
+        if (frame_size > 0) {
+            if (header.error_code() != AzRPC::OK) {
+                // 打开失败(服务或方法不存在)或处理函数以错误结束
+                return Fail(header.error_text());
+            }
+            switch (header.stream_type()) {
+            case AzRPC::STREAM_DATA:
+                m_inbox.emplace_back(m_recv_buf.data() + body_offset, header.body_size());
+                break;
+            case AzRPC::STREAM_END:
+                m_finished = true;
+                break;
+            case AzRPC::STREAM_CREDIT:
+                m_send_credits += header.stream_credits();
+                break;
+            default:
+                break;
+            }
+            m_recv_buf.erase(0, frame_size);
+            return true;
+        }
+
+        char buf[16384];
+        ssize_t n = recv(m_fd, buf, sizeof(buf), 0);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            char errtxt[512] = {};
+            return Fail(n == 0 ? "connection closed by server" : strerror_r(errno, errtxt, sizeof(errtxt)));
+        }
+        m_recv_buf.append(buf, n);
+    }
+}
+
+bool AzRPC_ClientStream::Fail(const std::string& reason) {
+    if (!m_failed) {
+        AZRPC_LOG_ERROR_RATELIMIT(10, "stream error: %s", reason.c_str());
+        m_failed = true;
+        m_error = reason;
+    }
+    m_finished = true;
+    return false;
+}
+
+AzRPC_ServerStream::AzRPC_ServerStream(uint64_t call_id, bool checksum, uint32_t send_credits, SendFunction send)
+    : m_call_id(call_id), m_checksum(checksum), m_window(StreamWindow()), m_send_credits(send_credits), m_consumed(0),
+      m_remote_end(false), m_closed(false), m_finished(false), m_send(std::move(send)) {}
+
+void AzRPC_ServerStream::Open() {
+    SendFrame(AzRPC::STREAM_CREDIT, std::string(), m_window, std::string());
+}
+
+bool AzRPC_ServerStream::Read(google::protobuf::Message* message) {
+    std::string body;
+    uint32_t credits = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait(lock, [this] { return !m_inbox.empty() || m_remote_end || m_closed; });
+        if (m_inbox.empty()) {
+            return false;
+        }
+        body.swap(m_inbox.front());
+        m_inbox.pop_front();
+        if (++m_consumed >= CreditThreshold(m_window) && !m_remote_end && !m_closed) {
+            credits = m_consumed;
+            m_consumed = 0;
+        }
+    }
+    if (credits > 0) {
+        SendFrame(AzRPC::STREAM_CREDIT, std::string(), credits, std::string());
+    }
+    return message->ParseFromString(body);
+}
+
+bool AzRPC_ServerStream::Write(const google::protobuf::Message& message) {
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait(lock, [this] { return m_send_credits > 0 || m_closed || m_finished; });
+        if (m_closed || m_finished) {
+            return false;
+        }
+        --m_send_credits;
+    }
+    std::string body;
+    if (!message.SerializeToString(&body)) {
+        return false;
+    }
+    SendFrame(AzRPC::STREAM_DATA, body, 0, std::string());
+    return true;
+}
+
+void AzRPC_ServerStream::Finish(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+        if (m_closed) {
+            return;
+        }
+    }
+    m_cv.notify_all();
+    SendFrame(AzRPC::STREAM_END, std::string(), 0, error);
+}
+
+bool AzRPC_ServerStream::Closed() const {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_closed;
+}
+
+void AzRPC_ServerStream::OnFrame(const AzRPC::RpcHeader& header, const char* body) {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        switch (header.stream_type()) {
+        case AzRPC::STREAM_DATA:
+            m_inbox.emplace_back(body, header.args_size());
+            break;
+        case AzRPC::STREAM_END:
+            m_remote_end = true;
+            break;
+        case AzRPC::STREAM_CREDIT:
+            m_send_credits += header.stream_credits();
+            break;
+        default:
+            return;
+        }
+    }
+    m_cv.notify_all();
+}
+
+void AzRPC_ServerStream::Close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_closed = true;
+    }
+    m_cv.notify_all();
+}
+
+void AzRPC_ServerStream::SendFrame(AzRPC::StreamFrameType type, const std::string& body, uint32_t credits, const std::string& error) {
+    AzRPC::RpcResponseHeader header;
+    header.set_call_id(m_call_id);
+    header.set_checksum(m_checksum);
+    header.set_stream_type(type);
+    header.set_stream_credits(credits);
+    if (!error.empty()) {
+        header.set_error_code(AzRPC::HANDLER_FAILED);
+        header.set_error_text(error);
+    }
+    std::string frame;
+    if (AzRPC_Codec::EncodeResponse(&header, body, &frame)) {
+        m_send(frame);
+    }
+}
@@ -0,0 +1,80 @@
+#include "AzRPC_Timer.h"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct TimerQueue {
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::map<std::pair<Clock::time_point, uint64_t>, std::function<void()>> tasks;  // 按到期时间排序, id区分同一时刻的任务
+    std::unordered_map<uint64_t, Clock::time_point> deadlines;                       // id到到期时间, 用于取消
+    uint64_t next_id = 1;
+
+    void Loop() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            if (tasks.empty()) {
+                cv.wait(lock);
+                continue;
+            }
+            auto it = tasks.begin();
+            if (it->first.first > Clock::now()) {
+                cv.wait_until(lock, it->first.first);
+                continue;
+            }
+            std::function<void()> task = std::move(it->second);
+            deadlines.erase(it->first.second);
+            tasks.erase(it);
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+};
+
+// 定时线程随进程一直存在, 队列不析构
+TimerQueue& Queue() {
+    static TimerQueue* queue = [] {
+        TimerQueue* queue = new TimerQueue();
+        std::thread(&TimerQueue::Loop, queue).detach();
+        return queue;
+    }();
+    return *queue;
+}
+
+}  // namespace
+
+uint64_t AzRPC_Timer::RunAfter(int64_t delay_ms, std::function<void()> task) {
+    TimerQueue& queue = Queue();
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(delay_ms > 0 ? delay_ms : 0);
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    uint64_t id = queue.next_id++;
+    bool earliest = queue.tasks.empty() || deadline < queue.tasks.begin()->first.first;
+    queue.tasks.emplace(std::make_pair(deadline, id), std::move(task));
+    queue.deadlines[id] = deadline;
+    // 只有新任务比当前最早的任务更早到期时才需要唤醒定时线程
+    if (earliest) {
+        queue.cv.notify_one();
+    }
+    return id;
+}
+
+bool AzRPC_Timer::Cancel(uint64_t id) {
+    TimerQueue& queue = Queue();
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    auto it = queue.deadlines.find(id);
+    if (it == queue.deadlines.end()) {
+        return false;
+    }
+    queue.tasks.erase(std::make_pair(it->second, id));
+    queue.deadlines.erase(it);
+    return true;
+}
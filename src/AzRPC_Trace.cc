@@ -0,0 +1,192 @@
+#include "AzRPC_Trace.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace {
+
+// 追踪文件头, 之后紧跟若干条定长的AzRPC_SpanRecord
+struct TraceFileHeader {
+    char magic[4];              // "AZTR"
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+// 环形缓冲区的槽位, seq为奇数表示正在写入, 读者据此丢弃被并发覆盖的记录
+struct SpanSlot {
+    std::atomic<uint64_t> seq{0};
+    AzRPC_SpanRecord record;
+};
+
+// 追踪器的全局状态, 第一次使用时根据配置文件初始化
+struct TracerState {
+    double sample_rate = 0.0;               // trace_sample_rate, 默认不采样
+    size_t mask = 0;
+    std::unique_ptr<SpanSlot[]> slots;
+    std::atomic<uint64_t> head{0};          // 下一条span的写入序号
+    std::string file_path;                  // trace_file, 为空时只保留在内存中
+
+    TracerState() {
+        AzRPC_Config& config = AzRPC_Application::GetConfig();
+        std::string rate = config.Load("trace_sample_rate");
+        if (!rate.empty()) {
+            sample_rate = atof(rate.c_str());
+        }
+
+        // 容量取不小于trace_ring_size的2的幂, 下标用掩码计算
+        size_t want = 4096;
+        std::string ring_size = config.Load("trace_ring_size");
+        if (!ring_size.empty() && atol(ring_size.c_str()) > 0) {
+            want = atol(ring_size.c_str());
+        }
+        size_t capacity = 1;
+        while (capacity < want) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        slots.reset(new SpanSlot[capacity]);
+
+        file_path = config.Load("trace_file");
+        if (!file_path.empty()) {
+            std::thread(&TracerState::FlushLoop, this).detach();
+        }
+    }
+
+    bool Read(uint64_t idx, AzRPC_SpanRecord* out) const {
+        const SpanSlot& slot = slots[idx & mask];
+        uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != 2 * idx + 2) {
+            return false;   // 尚未写完或已被覆盖
+        }
+        memcpy(out, &slot.record, sizeof(AzRPC_SpanRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == before;
+    }
+
+    // 后台线程每秒把新产生的span批量追加到文件, 不阻塞业务线程
+    void FlushLoop() {
+        std::unique_ptr<FILE, int(*)(FILE*)> pf(fopen(file_path.c_str(), "ab"), &fclose);
+        if (pf == nullptr) {
+            LOG(ERROR) << "open trace file error: " << file_path;
+            return;
+        }
+        if (ftell(pf.get()) == 0) {
+            TraceFileHeader header = {{'A', 'Z', 'T', 'R'}, 1, sizeof(AzRPC_SpanRecord), 0};
+            fwrite(&header, sizeof(header), 1, pf.get());
+        }
+
+        uint64_t flushed = 0;
+        std::vector<AzRPC_SpanRecord> batch;
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            uint64_t end = head.load(std::memory_order_acquire);
+            // 落后超过一圈的记录已经被覆盖, 直接跳过
+            if (end - flushed > mask + 1) {
+                flushed = end - (mask + 1);
+            }
+            batch.clear();
+            AzRPC_SpanRecord record;
+            for (; flushed < end; ++flushed) {
+                if (Read(flushed, &record)) {
+                    batch.push_back(record);
+                }
+            }
+            if (!batch.empty()) {
+                fwrite(batch.data(), sizeof(AzRPC_SpanRecord), batch.size(), pf.get());
+                fflush(pf.get());
+            }
+        }
+    }
+};
+
+TracerState& State() {
+    static TracerState state;
+    return state;
+}
+
+// 每个线程独立的随机数发生器, 生成id时无需加锁
+uint64_t NextRandom() {
+    thread_local std::mt19937_64 rng(std::random_device{}() ^ std::hash<std::thread::id>()(std::this_thread::get_id()));
+    uint64_t value = rng();
+    return value != 0 ? value : 1;
+}
+
+}  // namespace
+
+AzRPC_TraceContext& AzRPC_Tracer::Current() {
+    thread_local AzRPC_TraceContext context;
+    return context;
+}
+
+AzRPC_TraceContext AzRPC_Tracer::NewRoot() {
+    AzRPC_TraceContext context;
+    double rate = State().sample_rate;
+    if (rate <= 0.0) {
+        return context;
+    }
+    if (rate < 1.0 && (NextRandom() >> 11) / 9007199254740992.0 >= rate) {
+        return context;
+    }
+    context.trace_id = NextRandom();
+    context.span_id = NextRandom();
+    context.flags = AzRPC_TraceContext::kSampled;
+    return context;
+}
+
+AzRPC_TraceContext AzRPC_Tracer::NewChild(const AzRPC_TraceContext& parent) {
+    AzRPC_TraceContext context;
+    context.trace_id = parent.trace_id;
+    context.parent_span_id = parent.span_id;
+    context.span_id = NextRandom();
+    context.flags = parent.flags;
+    return context;
+}
+
+void AzRPC_Tracer::Export(const AzRPC_SpanRecord& record) {
+    TracerState& state = State();
+    uint64_t idx = state.head.fetch_add(1, std::memory_order_relaxed);
+    SpanSlot& slot = state.slots[idx & state.mask];
+    slot.seq.store(2 * idx + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot.record, &record, sizeof(AzRPC_SpanRecord));
+    slot.seq.store(2 * idx + 2, std::memory_order_release);
+}
+
+size_t AzRPC_Tracer::Snapshot(std::vector<AzRPC_SpanRecord>* records) {
+    TracerState& state = State();
+    uint64_t end = state.head.load(std::memory_order_acquire);
+    uint64_t begin = end > state.mask + 1 ? end - (state.mask + 1) : 0;
+    size_t count = 0;
+    AzRPC_SpanRecord record;
+    for (uint64_t idx = begin; idx < end; ++idx) {
+        if (state.Read(idx, &record)) {
+            records->push_back(record);
+            ++count;
+        }
+    }
+    return count;
+}
+
+void AzRPC_Tracer::FillMethod(AzRPC_SpanRecord* record, const std::string& service_name, const std::string& method_name) {
+    snprintf(record->method, sizeof(record->method), "%s.%s", service_name.c_str(), method_name.c_str());
+}
+
+int64_t AzRPC_Tracer::NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+AzRPC_TraceScope::AzRPC_TraceScope(const AzRPC_TraceContext& context): m_saved(AzRPC_Tracer::Current()) {
+    AzRPC_Tracer::Current() = context;
+}
+
+AzRPC_TraceScope::~AzRPC_TraceScope() {
+    AzRPC_Tracer::Current() = m_saved;
+}
@@ -0,0 +1,69 @@
+#include "AzRPC_UnixAcceptor.h"
+#include "AzRPC_Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+AzRPC_UnixAcceptor::AzRPC_UnixAcceptor(muduo::net::EventLoop* loop, const std::string& path): m_loop(loop), m_path(path), m_listenfd(-1) {}
+
+AzRPC_UnixAcceptor::~AzRPC_UnixAcceptor() {
+    if (m_channel) {
+        m_channel->disableAll();
+        m_channel->remove();
+    }
+    if (m_listenfd != -1) {
+        close(m_listenfd);
+        unlink(m_path.c_str());
+    }
+}
+
+bool AzRPC_UnixAcceptor::Listen() {
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (m_path.size() >= sizeof(addr.sun_path)) {
+        AZRPC_LOG_ERROR("unix socket path too long: %s", m_path.c_str());
+        return false;
+    }
+    strncpy(addr.sun_path, m_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        AZRPC_LOG_ERROR("unix socket error: %s", strerror(errno));
+        return false;
+    }
+    // 上次异常退出可能留下了套接字文件
+    unlink(m_path.c_str());
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(fd, SOMAXCONN) == -1) {
+        AZRPC_LOG_ERROR("unix socket bind/listen error: %s, path: %s", strerror(errno), m_path.c_str());
+        close(fd);
+        return false;
+    }
+
+    m_listenfd = fd;
+    m_channel.reset(new muduo::net::Channel(m_loop, m_listenfd));
+    m_channel->setReadCallback(std::bind(&AzRPC_UnixAcceptor::HandleRead, this));
+    m_channel->enableReading();
+    return true;
+}
+
+// 监听套接字可读, 一次取完所有排队的连接
+void AzRPC_UnixAcceptor::HandleRead() {
+    while (true) {
+        int connfd = accept4(m_listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (connfd == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                AZRPC_LOG_ERROR_RATELIMIT(10, "unix socket accept error: %s", strerror(errno));
+            }
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (m_callback) {
+            m_callback(connfd);
+        }
+        else {
+            close(connfd);
+        }
+    }
+}
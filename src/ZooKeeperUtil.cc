@@ -80,20 +80,27 @@ ZkClient::~ZkClient() {
 }
 
 // 启动 ZooKeeper 客户端
-void ZkClient::Start() {
+bool ZkClient::Start() {
     std::string host = AzRPC_Application::GetInstance().GetConfig().Load("zookeeperip");
     std::string port = AzRPC_Application::GetInstance().GetConfig().Load("zookeeperport");
     std::string connect_str = host + ":" + port;
+    std::string timeout = AzRPC_Application::GetInstance().GetConfig().Load("zookeeper_timeout_ms");
+    int timeout_ms = timeout.empty() ? 30000 : atoi(timeout.c_str());
 
     m_zhandle = zookeeper_init(connect_str.c_str(), global_watcher, 6000, nullptr, nullptr, 0);
     if (m_zhandle == nullptr) {
         LOG(ERROR) << "zookeeper_init error";
-        exit(EXIT_FAILURE);
+        return false;
     }
 
+    // ZooKeeper不可达时不再无限等待
     std::unique_lock<std::mutex> lock(con_var_mtx);
-    con_var.wait(lock, [] { return is_connected; });
+    if (!con_var.wait_for(lock, std::chrono::milliseconds(timeout_ms), [] { return is_connected; })) {
+        LOG(ERROR) << "zookeeper_init timeout: " << connect_str;
+        return false;
+    }
     LOG(INFO) << "zookeeper_init success";
+    return true;
 }
 
 // 异步创建节点
@@ -139,5 +146,63 @@ bool ZkClient::ExistsAsync(const char* path) {
         return false;
     }
     
+    return true;
+}
+
+// 创建节点
+bool ZkClient::Create(const std::string& path, const std::string& data, bool ephemeral) {
+    return CreateAsync(path.c_str(), data.empty() ? nullptr : data.data(), data.size(), ephemeral ? ZOO_EPHEMERAL : 0);
+}
+
+// 获取节点数据
+std::string ZkClient::GetData(const std::string& path) {
+    return GetDataAsync(path.c_str());
+}
+
+// 检查节点是否存在的回调函数(不创建节点)
+void exists_result_completion(int rc, const struct Stat* stat, const void* data) {
+    auto* promise = (std::promise<bool>*)data;
+    promise->set_value(rc == ZOK);
+    delete promise;
+}
+
+// 检查节点是否存在
+bool ZkClient::Exists(const std::string& path) {
+    auto* promise = new std::promise<bool>();
+    auto future = promise->get_future();
+
+    int rc = zoo_aexists(m_zhandle, path.c_str(), 0, exists_result_completion, promise);
+    if (rc != ZOK) {
+        LOG(ERROR) << "Failed to initiate async exists, error: " << zerror(rc);
+        delete promise;
+        return false;
+    }
+    return future.get();
+}
+
+// 节点watch的回调, 只触发一次, 触发后释放回调对象
+void node_watcher(zhandle_t* zh, int type, int state, const char* path, void* watcherCtx) {
+    auto* callback = (AzRPC_Registry::WatchCallback*)watcherCtx;
+    if (type != ZOO_SESSION_EVENT) {
+        (*callback)(path != nullptr ? path : "");
+    }
+    delete callback;
+}
+
+void watch_completion(int rc, const struct Stat* stat, const void* data) {
+    if (rc != ZOK && rc != ZNONODE) {
+        LOG(ERROR) << "zoo_awexists failed, error: " << zerror(rc);
+    }
+}
+
+// 监听节点的下一次变化(创建、删除、数据变更)
+bool ZkClient::Watch(const std::string& path, const WatchCallback& callback) {
+    auto* ctx = new WatchCallback(callback);
+    int rc = zoo_awexists(m_zhandle, path.c_str(), node_watcher, ctx, watch_completion, nullptr);
+    if (rc != ZOK) {
+        LOG(ERROR) << "Failed to initiate async watch, error: " << zerror(rc);
+        delete ctx;
+        return false;
+    }
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef _AzRPC_Attachment_H_
+#define _AzRPC_Attachment_H_
+
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 附件: 跟在请求参数或响应体之后、不经过protobuf序列化的原始字节
+// 由若干块组成, 每块通过owner持有底层内存, 引用其他内存时不拷贝
+// 调用方通过AzRPC_Controller的RequestAttachment()设置请求附件, 调用完成后从ResponseAttachment()读取响应附件
+// 服务端在业务方法中从RequestAttachment()读取请求附件, 把响应附件写入ResponseAttachment()
+class AzRPC_Attachment {
+public:
+    struct Block {
+        const char* data;
+        size_t size;
+        std::shared_ptr<const void> owner;     // 保证data在块的生命周期内有效
+    };
+
+    // 拷贝data
+    void Append(const char* data, size_t len);
+    // 接管data的内存, 不拷贝
+    void Append(std::string&& data);
+    // 引用外部内存, 不拷贝; owner释放前data必须保持有效
+    void AppendRef(const char* data, size_t len, std::shared_ptr<const void> owner);
+    void Append(const AzRPC_Attachment& other);
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const std::vector<Block>& Blocks() const { return m_blocks; }
+    void Clear();
+
+    // 把所有块追加到iov, 用于writev
+    void AppendIovec(std::vector<struct iovec>* iov) const;
+    // 把所有块拷贝到out末尾
+    void AppendTo(std::string* out) const;
+    std::string ToString() const;
+    // 在crc的基础上计算所有块的CRC32C
+    uint32_t ExtendCrc32c(uint32_t crc) const;
+
+private:
+    std::vector<Block> m_blocks;
+    size_t m_size = 0;
+};
+
+#endif
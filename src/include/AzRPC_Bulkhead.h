@@ -0,0 +1,44 @@
+#ifndef _AzRPC_Bulkhead_H_
+#define _AzRPC_Bulkhead_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// 服务端一个方法的舱壁: 限制同时执行的业务方法数(从开始处理请求到发出响应), 名额用完后的请求在有界队列中等待
+// 一个慢方法最多占用自己的名额, 不会占满所有处理线程, 其他方法的请求照常执行
+// 计数器<name>_queued为进入等待队列的请求数, <name>_rejected为名额和队列都满时被拒绝的请求数
+class AzRPC_Bulkhead {
+public:
+    typedef std::function<void()> Task;
+    enum Result {
+        kAcquired,      // 名额已经空出, 调用方直接执行
+        kQueued,        // task进入等待队列, 轮到时交给resume执行
+        kRejected,      // 队列已满
+    };
+
+    // 等待的请求在其他请求归还名额时交给resume, 由它安排执行(不能在归还的调用栈中直接执行)
+    AzRPC_Bulkhead(const std::string& name, size_t max_concurrency, size_t max_queue, std::function<void(Task)> resume);
+
+    // 获取一个执行名额, 没有空闲名额时返回false
+    bool TryAcquire();
+    // TryAcquire失败后调用, 检查期间名额可能已经空出
+    Result Wait(Task task);
+    // 归还名额; 有请求在等待时名额直接转给队首的请求
+    void Release();
+
+private:
+    std::mutex m_mtx;
+    size_t m_max_concurrency;
+    size_t m_max_queue;
+    size_t m_inflight;
+    std::deque<Task> m_waiting;
+    std::function<void(Task)> m_resume;
+    std::atomic<uint64_t>& m_queued;
+    std::atomic<uint64_t>& m_rejected;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef _AzRPC_Cache_H_
+#define _AzRPC_Cache_H_
+
+#include "AzRPC_Attachment.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 响应缓存: 按键保存序列化后的响应, 每项有各自的过期时间, 总大小按字节限制
+// 键按哈希分到多个分片, 每个分片一把锁和一个LRU链表, 超过分片的容量时淘汰最久未使用的项
+// 命中、未命中和淘汰次数记在AzRPC_Metrics中: <name>_hit、<name>_miss、<name>_evict
+class AzRPC_Cache {
+public:
+    struct Value {
+        std::string data;               // 序列化后的响应
+        AzRPC_Attachment attachment;    // 响应附件, 命中时共享其中的块
+    };
+    typedef std::shared_ptr<const Value> ValuePtr;
+
+    AzRPC_Cache(const std::string& name, size_t max_bytes, size_t shard_count);
+
+    // 命中且没有过期时返回缓存的值, 否则返回nullptr
+    ValuePtr Get(const std::string& key);
+    // 保存key的值, ttl_ms毫秒后过期; 单项超过分片容量时不保存
+    void Put(const std::string& key, ValuePtr value, int64_t ttl_ms);
+    void Erase(const std::string& key);
+    // 删除键以prefix开头的所有项, 需要遍历所有分片, 返回删除的项数
+    size_t ErasePrefix(const std::string& prefix);
+    // 当前缓存的总字节数(包括键)
+    size_t Bytes() const;
+
+private:
+    struct Entry {
+        std::string key;
+        ValuePtr value;
+        int64_t expire_us;
+        size_t charge;
+    };
+    struct Shard {
+        std::mutex mtx;
+        std::list<Entry> lru;       // 表头为最近使用的项
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    size_t m_shard_capacity;
+    std::atomic<uint64_t>& m_hit;
+    std::atomic<uint64_t>& m_miss;
+    std::atomic<uint64_t>& m_evict;
+
+    Shard& ShardFor(const std::string& key);
+    static void Remove(Shard& shard, std::list<Entry>::iterator it);
+    static int64_t NowMicros();
+};
+
+#endif
@@ -2,25 +2,150 @@
 #define _AzRPC_Channel_H_
 #include <google/protobuf/service.h>
 #include "ZooKeeperUtil.h"
+#include "AzRPC_Header.pb.h"
+#include "AzRPC_ShmTransport.h"
+#include "AzRPC_ClientLoop.h"
+#include "AzRPC_Trace.h"
+#include "AzRPC_Attachment.h"
+#include "AzRPC_Stream.h"
+#include "AzRPC_Controller.h"
+#include "AzRPC_Future.h"
+#include <sys/uio.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 class AzRPC_Channel: public google::protobuf::RpcChannel {
 public:
     AzRPC_Channel(bool connectNow);
-    virtual ~AzRPC_Channel() {}
+    virtual ~AzRPC_Channel() {
+        std::lock_guard<std::mutex> lock(m_conn_mtx);
+        closeConnection();
+    }
 
     void CallMethod(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message *request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done) override;
 
+    // 通过stub的方法发起异步调用, 立即返回future, 响应到达后在客户端IO线程中完成(没有启用IO引擎时返回前已经完成)
+    // controller为nullptr时使用内部的controller, 否则调用完成前必须有效, 可以用它设置追踪上下文、压缩算法和附件
+    // 调用失败时future失败, 错误信息与controller->ErrorText()相同
+    template <typename Stub, typename Request, typename Response>
+    AzRPC_Future<Response> CallAsync(void (Stub::*method)(::google::protobuf::RpcController*, const Request*, Response*, ::google::protobuf::Closure*),
+                                     const Request& request, AzRPC_Controller* controller = nullptr);
+
+    // 批量调用中的一个调用, 结果写入各自的controller和response
+    struct BatchItem {
+        const ::google::protobuf::MethodDescriptor* method;
+        ::google::protobuf::RpcController* controller;
+        const ::google::protobuf::Message* request;
+        ::google::protobuf::Message* response;
+    };
+    // 批量调用: 所有调用编码进一个请求帧, 服务端并行处理后用一个响应帧返回全部结果, 节省每个调用的帧、系统调用和唤醒
+    // 按第一个调用的服务和方法查找服务端, 所有调用都应该发布在同一个服务端上; 不经过响应缓存和请求合并
+    // done为nullptr时同步调用, 返回时全部完成; 否则全部完成后执行done, 启用客户端IO引擎时在IO线程中执行
+    void BatchCall(const std::vector<BatchItem>& calls, ::google::protobuf::Closure* done);
+
+    // 打开一个流式调用, 流独占一条新建立的连接, 不影响channel上的普通调用; 失败时返回nullptr并设置controller
+    std::unique_ptr<AzRPC_ClientStream> OpenStream(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller);
+
 private:
+    // 同一个channel可以被多个线程同时调用: 以下连接状态由m_conn_mtx保护
+    // 阻塞模式下整个发送请求、接收响应的过程都在锁内, 同一个channel上的阻塞调用依次进行; 需要并发时每个线程使用自己的channel
+    std::mutex m_conn_mtx;
     int m_clientfd;                 // 存放客户套接字
-    std::string service_name;
     std::string m_ip;
     uint16_t m_port;
-    std::string method_name;
+    std::string m_unix_path;        // 服务端发布的Unix域套接字路径, 没有时为空
 
     int m_idx;                      // 用来区分服务器ip和port的下标
+    std::string m_recv_buf;         // 接收响应帧的缓冲区, 在多次调用间复用
+    uint64_t m_conn_id;             // 使用客户端IO引擎时, 连接在AzRPC_ClientLoop中的id, 0表示未连接
+    std::unique_ptr<AzRPC_ShmSegment> m_shm;    // 协商成功后请求和响应改走共享内存, 连接仅用于探测服务端存活
+
+    // 一次调用的请求信息, 异步调用时在响应回调中使用
+    struct CallState {
+        std::string service_name;
+        std::string method_name;
+        AzRPC_TraceContext trace;
+        int64_t call_start_us;
+    };
+    // 一次批量调用, 子请求的call_id为它在calls中的下标
+    struct BatchState {
+        std::vector<BatchItem> calls;
+        std::vector<CallState> states;
+        std::vector<bool> sent;     // 编码成功、随批发出的调用, 编码失败的调用已经设置了controller
+    };
+
+    bool CallCached(int64_t ttl_ms, const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done);
+    void CallUncached(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done);
+    void Dispatch(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done);
+    bool CallCoalesced(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done);
+    void CallBlocking(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response);
+    void CallInLoop(AzRPC_ClientLoop* loop, const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, const ::google::protobuf::Message* request, ::google::protobuf::Message* response, ::google::protobuf::Closure* done);
+    bool Connect(const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, bool allow_shm);
+    bool ConnectLoop(AzRPC_ClientLoop* loop, const ::google::protobuf::MethodDescriptor* method, ::google::protobuf::RpcController* controller, uint64_t* conn_id);
+    bool Exchange(const std::string& frame, const AzRPC_Attachment* attachment, const std::string& trailer, AzRPC::RpcResponseHeader* response_header, size_t* body_offset, ::google::protobuf::RpcController* controller);
+    bool BuildRequest(const ::google::protobuf::MethodDescriptor* method, const ::google::protobuf::Message* request, ::google::protobuf::RpcController* controller, uint64_t call_id, bool checksum, CallState* state, std::string* frame, std::string* trailer);
+    static void FinishBatch(const BatchState& batch, const AzRPC::RpcResponseHeader& response_header, const char* body);
+    static void FailBatch(const BatchState& batch, const std::string& error);
+    static void FinishCall(const CallState& state, const AzRPC::RpcResponseHeader& response_header, const char* body, std::shared_ptr<const void> owner, ::google::protobuf::RpcController* controller, ::google::protobuf::Message* response);
     bool newConnect(const char* ip, uint16_t port);
+    bool newConnectUnix(const char* path);
+    bool SendAll(const char* data, size_t len);
+    bool SendAllv(std::vector<struct iovec>* iov);
+    bool SendFrame(const std::string& frame, const AzRPC_Attachment* attachment, const std::string& trailer, std::string* err);
+    bool RecvFrame(AzRPC::RpcResponseHeader* response_header, size_t* body_offset, std::string* err);
+    void NegotiateShm();
+    void closeConnection();
+
+    static std::string ParseHostAttr(const std::string& host_data, const std::string& key);
+    static bool PreferUnix();
+    static bool ChecksumEnabled();
+    static int64_t CacheTtlMs(const std::string& service_name, const std::string& method_name);
+    static AzRPC::Priority PriorityForMethod(const std::string& service_name, const std::string& method_name);
+    static bool IsLocalHost(const std::string& ip, const std::string& host);
+    std::string QueryServiceHost(AzRPC_Registry* registry, std::string service_name, std::string method_name, int& idx);
+};
+
+namespace AzRPC_ChannelDetail {
+
+// 一次CallAsync的响应和内部controller, 由完成回调持有到调用结束
+template <typename Response>
+struct AsyncCall {
+    Response response;
+    AzRPC_Controller own_controller;
+    AzRPC_Controller* controller;
+    AzRPC_Promise<Response> promise;
 
-    std::string QueryServiceHost(ZkClient* zkclient, std::string service_name, std::string method_name, int& idx);
+    static void Done(std::shared_ptr<AsyncCall> call) {
+        if (call->controller->Failed()) {
+            call->promise.SetFailed(call->controller->ErrorText());
+        }
+        else {
+            call->promise.SetValue(std::move(call->response));
+        }
+    }
 };
 
+}  // namespace AzRPC_ChannelDetail
+
+// 与AzRPC_Channel::CallAsync相同, 用于任意RpcChannel(例如protoc-gen-azrpc生成的stub)
+template <typename Stub, typename Request, typename Response>
+AzRPC_Future<Response> AzRPC_CallAsync(::google::protobuf::RpcChannel* channel,
+                                       void (Stub::*method)(::google::protobuf::RpcController*, const Request*, Response*, ::google::protobuf::Closure*),
+                                       const Request& request, AzRPC_Controller* controller = nullptr) {
+    typedef AzRPC_ChannelDetail::AsyncCall<Response> Call;
+    std::shared_ptr<Call> call = std::make_shared<Call>();
+    call->controller = controller != nullptr ? controller : &call->own_controller;
+    AzRPC_Future<Response> future = call->promise.GetFuture();
+    Stub stub(channel);
+    (stub.*method)(call->controller, &request, &call->response, ::google::protobuf::NewCallback(&Call::Done, call));
+    return future;
+}
+
+template <typename Stub, typename Request, typename Response>
+AzRPC_Future<Response> AzRPC_Channel::CallAsync(void (Stub::*method)(::google::protobuf::RpcController*, const Request*, Response*, ::google::protobuf::Closure*),
+                                                const Request& request, AzRPC_Controller* controller) {
+    return AzRPC_CallAsync(this, method, request, controller);
+}
+
 #endif
\ No newline at end of file
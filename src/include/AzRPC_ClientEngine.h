@@ -0,0 +1,166 @@
+#ifndef _AzRPC_ClientEngine_H_
+#define _AzRPC_ClientEngine_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define AZRPC_HAVE_IO_URING 1
+#endif
+#endif
+
+// 客户端IO引擎, 由AzRPC_ClientLoop在它的线程中驱动, 负责多个连接上的收发
+// 引擎只处理字节流, 分帧和调用匹配由AzRPC_ClientLoop完成; 所有接口只能在事件循环线程中调用
+class AzRPC_ClientEngine {
+public:
+    // 引擎事件的接收方
+    class Handler {
+    public:
+        virtual ~Handler() {}
+        // 连接上收到了数据
+        virtual void OnRead(uint64_t id, const char* data, size_t len) = 0;
+        // 连接被对端关闭或出错, 引擎已经不再使用它, 之后不会再有该连接的事件
+        virtual void OnClose(uint64_t id, const std::string& reason) = 0;
+        // 唤醒fd可读, 有其他线程提交的任务
+        virtual void OnWakeup() = 0;
+    };
+
+    virtual ~AzRPC_ClientEngine() {}
+    virtual const char* Name() const = 0;
+
+    // wakeup_fd为eventfd, 其他线程写入它来唤醒事件循环, 引擎负责读取
+    virtual bool Init(Handler* handler, int wakeup_fd) = 0;
+    // 接管fd并开始接收, 失败时关闭fd
+    virtual bool Add(uint64_t id, int fd) = 0;
+    // 主动关闭连接, 不会触发OnClose
+    virtual void Remove(uint64_t id) = 0;
+    // 追加待发送的数据, 发送不完的部分由引擎缓存, 在socket可写时继续发送
+    virtual void Send(uint64_t id, std::string data) = 0;
+    // 提交所有排队的操作并等待至少一个事件, 分发完本轮的全部事件后返回
+    // timeout_us不小于0时最多等待这么久, 超时返回时没有事件
+    virtual void Poll(int64_t timeout_us) = 0;
+    // Poll的超时能否精确到微秒; 为false时超时按毫秒向上取整
+    virtual bool PreciseTimeout() const = 0;
+
+    // 根据名字创建引擎: epoll | io_uring, io_uring初始化失败时回退到epoll
+    static std::unique_ptr<AzRPC_ClientEngine> Create(const std::string& name, Handler* handler, int wakeup_fd);
+};
+
+// 基于epoll的引擎, 非阻塞socket, 可读时读到EAGAIN为止, 发送缓冲满时等待EPOLLOUT
+class AzRPC_EpollEngine: public AzRPC_ClientEngine {
+public:
+    AzRPC_EpollEngine();
+    ~AzRPC_EpollEngine() override;
+
+    const char* Name() const override { return "epoll"; }
+    bool Init(Handler* handler, int wakeup_fd) override;
+    bool Add(uint64_t id, int fd) override;
+    void Remove(uint64_t id) override;
+    void Send(uint64_t id, std::string data) override;
+    void Poll(int64_t timeout_us) override;
+    bool PreciseTimeout() const override { return m_pwait2; }
+
+private:
+    struct Connection {
+        int fd;
+        std::string output;     // 尚未写入socket的数据
+    };
+    Handler* m_handler;
+    int m_epollfd;
+    bool m_pwait2;          // 内核支持epoll_pwait2(5.11+), 超时精确到纳秒
+    int m_wakeupfd;
+    std::unordered_map<uint64_t, Connection> m_connections;
+    std::vector<char> m_read_buf;
+
+    bool FlushOutput(Connection& connection);
+    void Close(uint64_t id, const std::string& reason);
+};
+
+#ifdef AZRPC_HAVE_IO_URING
+struct io_uring_sqe;
+struct io_uring_buf_ring;
+
+// 基于io_uring的引擎, 直接使用系统调用, 不依赖liburing
+// - 一轮事件循环中所有连接的发送和重新提交的接收合并为一次io_uring_enter
+// - 接收使用multishot recv, 一次提交持续产生完成事件, 内核不支持时退化为单次recv
+// - 接收缓冲区是预先注册给内核的provided buffer ring, 内核直接选取空闲缓冲区, 用完后归还
+class AzRPC_UringEngine: public AzRPC_ClientEngine {
+public:
+    AzRPC_UringEngine();
+    ~AzRPC_UringEngine() override;
+
+    const char* Name() const override { return "io_uring"; }
+    bool Init(Handler* handler, int wakeup_fd) override;
+    bool Add(uint64_t id, int fd) override;
+    void Remove(uint64_t id) override;
+    void Send(uint64_t id, std::string data) override;
+    void Poll(int64_t timeout_us) override;
+    bool PreciseTimeout() const override { return true; }
+
+private:
+    struct Connection {
+        int fd;
+        std::string output;     // 等待下一次提交的数据
+        std::string sending;    // 已提交、尚未完成的数据, 完成前不能修改
+        size_t sent = 0;        // sending中已发送的字节数
+        bool send_inflight = false;
+        bool recv_inflight = false;
+        bool closing = false;
+    };
+
+    Handler* m_handler;
+    int m_ringfd;
+    int m_wakeupfd;
+    uint64_t m_wakeup_value;
+
+    // 提交队列和完成队列的映射
+    void* m_sq_ptr;
+    size_t m_sq_size;
+    void* m_cq_ptr;
+    size_t m_cq_size;
+    io_uring_sqe* m_sqes;
+    size_t m_sqes_size;
+    unsigned* m_sq_head;
+    unsigned* m_sq_tail;
+    unsigned* m_sq_mask;
+    unsigned* m_sq_array;
+    unsigned* m_cq_head;
+    unsigned* m_cq_tail;
+    unsigned* m_cq_mask;
+    void* m_cqes;
+    unsigned m_to_submit;
+    // Poll的超时时长, 与__kernel_timespec的布局相同, 内核在提交时读取
+    struct Timespec {
+        int64_t tv_sec;
+        int64_t tv_nsec;
+    };
+    Timespec m_timeout;
+
+    // provided buffer ring
+    io_uring_buf_ring* m_buf_ring;
+    size_t m_buf_ring_size;
+    char* m_buffers;
+    unsigned m_buf_tail;
+    bool m_multishot;
+
+    std::unordered_map<uint64_t, Connection> m_connections;
+
+    io_uring_sqe* GetSqe();
+    int Submit(unsigned wait_nr);
+    void PrepRecv(uint64_t id, Connection& connection);
+    void PrepSend(uint64_t id, Connection& connection);
+    void PrepWakeup();
+    void PrepTimeout(int64_t timeout_us);
+    void RecycleBuffer(unsigned bid);
+    void HandleCompletion(uint64_t user_data, int res, unsigned flags);
+    void Close(uint64_t id, const std::string& reason);
+    void MaybeRelease(uint64_t id);
+};
+#endif
+
+#endif
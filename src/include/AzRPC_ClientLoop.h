@@ -0,0 +1,79 @@
+#ifndef _AzRPC_ClientLoop_H_
+#define _AzRPC_ClientLoop_H_
+
+#include "AzRPC_ClientEngine.h"
+#include "AzRPC_Header.pb.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 客户端的事件循环, 进程内所有使用它的channel共享一个后台线程
+// 配置项client_io_engine为epoll或io_uring时启用, 默认blocking表示channel自己阻塞收发, 不使用它
+// channel把连接交给它, 之后请求帧的发送、响应帧的接收和按call_id匹配都在循环线程中完成
+// 同一轮循环中提交的请求按连接合并, 由引擎一次提交(io_uring下所有连接只需一次系统调用)
+// 配置了client_write_window_us时, 连接上还有其他未完成的调用时暂缓发送较小的批, 等待更多请求一起发送, 见Loop
+class AzRPC_ClientLoop: private AzRPC_ClientEngine::Handler {
+public:
+    // 响应回调, 在循环线程中调用; error非空表示调用失败(连接断开等), 此时header和body无意义
+    typedef std::function<void(const AzRPC::RpcResponseHeader& header, const char* body, const std::string& error)> ResponseCallback;
+
+    // 按配置返回全局实例, 未启用时返回nullptr
+    static AzRPC_ClientLoop* Instance();
+
+    // 接管已连接的fd, 返回连接id; 之后fd由循环负责关闭
+    uint64_t Attach(int fd);
+    // 关闭连接, 未完成的调用以错误结束
+    void Detach(uint64_t conn_id);
+    // 发送一个已编码的请求帧, call_id必须与帧中header的call_id一致
+    void Call(uint64_t conn_id, uint64_t call_id, std::string frame, const ResponseCallback& callback);
+    // 连接是否已经断开, channel据此决定是否需要重新连接
+    bool Broken(uint64_t conn_id);
+
+    // 把任务排队到循环线程的下一轮执行, 在循环线程中调用也不会立即执行
+    void QueueInLoop(std::function<void()> task);
+
+    static uint64_t NextCallId();
+    bool InLoopThread() const { return std::this_thread::get_id() == m_thread_id; }
+    const char* EngineName() const { return m_engine->Name(); }
+
+private:
+    struct Connection {
+        std::string input;                                          // 未解析完的响应数据
+        std::unordered_map<uint64_t, ResponseCallback> pending;    // 等待响应的调用
+        std::string batch;                                          // 本轮循环中待发送的请求帧
+        size_t batch_calls = 0;                                     // batch中的调用数
+        int64_t batch_start_us = 0;                                 // batch中第一个请求的提交时间
+    };
+
+    std::unique_ptr<AzRPC_ClientEngine> m_engine;
+    int m_wakeupfd;
+    std::thread m_thread;
+    std::thread::id m_thread_id;
+    std::atomic<uint64_t> m_next_conn_id;
+    int64_t m_write_window_us;                      // 暂缓发送的最长时间, 0表示每轮都立即发送
+
+    std::mutex m_mtx;
+    std::vector<std::function<void()>> m_tasks;     // 其他线程提交的任务
+    std::unordered_map<uint64_t, bool> m_broken;    // 已断开的连接, 由m_mtx保护
+
+    // 以下只在循环线程中访问
+    std::unordered_map<uint64_t, Connection> m_connections;
+    std::vector<uint64_t> m_dirty;                  // 本轮有待发送数据的连接
+
+    AzRPC_ClientLoop();
+    bool Start(const std::string& engine);
+    void Loop();
+    void RunInLoop(std::function<void()> task);
+    void Fail(uint64_t conn_id, const std::string& reason);
+
+    void OnRead(uint64_t id, const char* data, size_t len) override;
+    void OnClose(uint64_t id, const std::string& reason) override;
+    void OnWakeup() override;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef _AzRPC_Codec_H_
+#define _AzRPC_Codec_H_
+
+#include "AzRPC_Header.pb.h"
+#include "AzRPC_Attachment.h"
+#include <cstddef>
+#include <string>
+
+// 帧的编解码, 客户端和服务端共用
+// 请求帧: varint32(header_size) + RpcHeader + 请求参数(args_size字节) + 附件(attachment_size字节) [+ CRC32C]
+// 响应帧: varint32(header_size) + RpcResponseHeader + 响应体(body_size字节) + 附件(attachment_size字节) [+ CRC32C]
+// header的checksum为true时帧末尾有4字节小端的CRC32C, 覆盖它之前的整个帧(包括附件)
+class AzRPC_Codec {
+public:
+    static const size_t kMaxHeaderSize = 64 * 1024;    // header长度的上限, 超过视为数据损坏
+
+    // 解码结果: 大于0为完整帧的总长度, 0表示数据还不完整, 小于0表示数据非法
+    static const int kIncomplete = 0;
+    static const int kInvalid = -1;
+    // 帧完整但校验和不匹配, 此时header已经解析(内容可能有误), 数据流的帧边界不再可信
+    static const int kChecksumError = -2;
+    static const size_t kChecksumSize = 4;
+
+    // 编码请求帧, 会根据args设置header的args_size, 结果追加到out; header的checksum为true时附加校验和
+    static bool EncodeRequest(AzRPC::RpcHeader* header, const std::string& args, std::string* out);
+    // 编码带附件的请求帧: 附件之前的部分追加到out, 附件之后的部分(校验和)追加到trailer
+    // 发送时依次发送out、附件的各块和trailer, 附件不会被拷贝; trailer为nullptr时附件和校验和都追加到out
+    static bool EncodeRequest(AzRPC::RpcHeader* header, const std::string& args, const AzRPC_Attachment& attachment, std::string* out, std::string* trailer);
+    // 从data中解码一个请求帧, 成功时body_offset为请求参数在data中的偏移, 附件紧跟在请求参数之后
+    static int DecodeRequest(const char* data, size_t len, AzRPC::RpcHeader* header, size_t* body_offset);
+
+    // 编码响应帧, 会根据body设置header的body_size, 结果追加到out; header的checksum为true时附加校验和
+    static bool EncodeResponse(AzRPC::RpcResponseHeader* header, const std::string& body, std::string* out);
+    // 编码带附件的响应帧, out和trailer的含义与EncodeRequest相同
+    static bool EncodeResponse(AzRPC::RpcResponseHeader* header, const std::string& body, const AzRPC_Attachment& attachment, std::string* out, std::string* trailer);
+    // 先用compress压缩响应体再编码, 太小或压缩后没有变小时原样编码; 服务端发送响应时使用
+    static bool EncodeResponse(AzRPC::RpcResponseHeader* header, const std::string& body, AzRPC::CompressType compress, const AzRPC_Attachment& attachment, std::string* out, std::string* trailer);
+    // 从data中解码一个响应帧, 成功时body_offset为响应体在data中的偏移, 附件紧跟在响应体之后
+    static int DecodeResponse(const char* data, size_t len, AzRPC::RpcResponseHeader* header, size_t* body_offset);
+
+    // 读取varint32, 返回占用的字节数, 0表示数据不完整, 小于0表示非法
+    static int ReadVarint32(const char* data, size_t len, uint32_t* value);
+
+private:
+    static bool Encode(const google::protobuf::Message& header, const std::string& body, const AzRPC_Attachment* attachment, bool checksum, std::string* out, std::string* trailer);
+    static int DecodeHeader(const char* data, size_t len, google::protobuf::Message* header, size_t* header_end);
+    static int CheckFrame(const char* data, size_t len, size_t header_end, size_t body_size, bool checksum);
+    AzRPC_Codec() = delete;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef _AzRPC_Compress_H_
+#define _AzRPC_Compress_H_
+
+#include "AzRPC_Header.pb.h"
+#include <cstddef>
+#include <string>
+
+// 请求参数和响应体的压缩
+// 可用的算法取决于编译时找到的库(AZRPC_HAVE_LZ4 / AZRPC_HAVE_ZSTD / AZRPC_HAVE_SNAPPY), 不可用的算法按不压缩处理
+// 调用方按控制器或方法选择算法, 只有长度达到rpc_compress_threshold(默认1024字节)且压缩后变小时才真正压缩
+// 服务端用请求的算法压缩响应, 不需要额外配置
+class AzRPC_Compress {
+public:
+    // 解压后长度的上限, 防止损坏的header导致过大的内存分配
+    static const size_t kMaxRawSize = 256 * 1024 * 1024;
+
+    // 本进程是否支持该算法
+    static bool Supported(AzRPC::CompressType type);
+    // 算法名: none | lz4 | zstd | snappy, 无法识别时返回false
+    static bool Parse(const std::string& name, AzRPC::CompressType* type);
+    static const char* Name(AzRPC::CompressType type);
+
+    // 调用方法时默认使用的算法, 依次查找配置项rpc_compress.<服务名>.<方法名>、rpc_compress.<服务名>、rpc_compress
+    static AzRPC::CompressType ForMethod(const std::string& service_name, const std::string& method_name);
+
+    // 按阈值压缩data: 返回实际使用的算法, 压缩时结果写入out, 返回COMPRESS_NONE时out不变, 应直接发送data
+    static AzRPC::CompressType Compress(AzRPC::CompressType type, const std::string& data, std::string* out);
+    // 解压len字节的data, raw_size为压缩前的长度; 算法不支持或数据损坏时返回false
+    static bool Decompress(AzRPC::CompressType type, const char* data, size_t len, size_t raw_size, std::string* out);
+
+private:
+    AzRPC_Compress() = delete;
+};
+
+#endif
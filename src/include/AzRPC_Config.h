@@ -11,6 +11,15 @@ public:
     // 查找key对应的value
     std::string Load(const std::string& key);
 
+    // 按方法查找配置, 依次查找<prefix>.<服务名>.<方法名>、<prefix>.<服务名>、<prefix>, 都没有时返回空字符串
+    std::string LoadForMethod(const std::string& prefix, const std::string& service_name, const std::string& method_name);
+
+    // 是否配置了prefix或者以"prefix."开头的配置项, 用于在没有按方法配置时跳过逐次查找
+    bool HasPrefix(const std::string& prefix) const;
+
+    // 获取全部键值对
+    const std::unordered_map<std::string, std::string>& All() const;
+
 private:
     std::unordered_map<std::string, std::string> config_map;
     
@@ -2,26 +2,73 @@
 #define _AzRPC_Controller_H_
 
 #include <google/protobuf/service.h>
+#include <mutex>
 #include <string>
+#include <vector>
+#include "AzRPC_Trace.h"
+#include "AzRPC_Header.pb.h"
+#include "AzRPC_Attachment.h"
 
 // 描述RPC调用的控制器
 // 主要作用是跟踪RPC方法调用的状态、错误信息并提供控制功能
 class AzRPC_Controller: public google::protobuf::RpcController {
 public:
     AzRPC_Controller();
+    ~AzRPC_Controller();
     void Reset();
     bool Failed() const;
     std::string ErrorText() const;
     void SetFailed(const std::string& reason);
 
-    // TODO
+    // 调用方取消调用: 标记为已取消并执行NotifyOnCancel注册的回调, 可以在任意线程调用
+    // 已经发出的请求不会撤回, 等待该调用的协程(见AzRPC_Coro.h)立即以失败恢复, 迟到的响应被丢弃
     void StartCancel();
     bool IsCanceled() const;
+    // 注册取消时执行一次的回调; 已经取消时立即执行; 没有取消就Reset或析构时回调被删除而不执行
     void NotifyOnCancel(google::protobuf::Closure* callback);
+    // 删除一个还没有执行的取消回调, 调用完成后不再需要它时使用
+    // 返回false表示回调已经或正在执行(调用已被取消), 此时回调由执行的一方负责
+    bool RemoveCancelCallback(google::protobuf::Closure* callback);
+
+    // 调用链上下文: 客户端用它指定本次调用所属的调用链, 服务端用它把上游的上下文交给业务方法
+    void SetTraceContext(const AzRPC_TraceContext& context);
+    const AzRPC_TraceContext& GetTraceContext() const;
+
+    // 本次调用请求参数的压缩算法, 覆盖按方法配置的rpc_compress; 服务端会用同样的算法压缩响应
+    void SetCompressType(AzRPC::CompressType type);
+    // 没有调用过SetCompressType时返回false
+    bool GetCompressType(AzRPC::CompressType* type) const;
+
+    // 本次调用的优先级类别和所属租户, 覆盖配置的rpc_priority和rpc_tenant; 服务端开启了调度时按它们排队
+    void SetPriority(AzRPC::Priority priority);
+    // 没有调用过SetPriority时返回false
+    bool GetPriority(AzRPC::Priority* priority) const;
+    void SetTenant(const std::string& tenant);
+    // 没有调用过SetTenant时返回空字符串
+    const std::string& Tenant() const;
+
+    // 不经过protobuf的原始字节, 跟在请求参数或响应体之后传输, 不压缩
+    // 客户端: 调用前写入RequestAttachment(), 调用完成后从ResponseAttachment()读取
+    // 服务端: 业务方法从RequestAttachment()读取, 把要返回的字节写入ResponseAttachment()
+    AzRPC_Attachment& RequestAttachment() { return m_request_attachment; }
+    AzRPC_Attachment& ResponseAttachment() { return m_response_attachment; }
 
 private:
     bool m_failed;          // RPC方法执行过程中的状态
     std::string m_errText;  // RPC方法执行过程中的错误信息
+    AzRPC_TraceContext m_trace;
+    bool m_compress_set;
+    AzRPC::CompressType m_compress;
+    bool m_priority_set;
+    AzRPC::Priority m_priority;
+    std::string m_tenant;
+    AzRPC_Attachment m_request_attachment;
+    AzRPC_Attachment m_response_attachment;
+    mutable std::mutex m_cancel_mtx;
+    bool m_canceled;
+    std::vector<google::protobuf::Closure*> m_cancel_callbacks;
+
+    void ClearCancelCallbacks();
 };
 
 // extern AzRPC_Controller controller; // 改为 extern 声明
@@ -0,0 +1,32 @@
+#ifndef _AzRPC_Cork_H_
+#define _AzRPC_Cork_H_
+
+#include "AzRPC_Attachment.h"
+#include <muduo/net/TcpConnection.h>
+#include <cstddef>
+#include <string>
+
+// 服务端响应的写合并: IO线程中一轮事件循环内产生的响应按连接暂存, 本轮的事件处理完后(queueInLoop的任务中)每个连接只写一次
+// 一次可读事件中流水线发来的多个请求、其他线程在同一轮中完成的多个响应都合并为一次写; 低负载时一轮只有一个响应, 不增加等待
+// 所有接口都在连接所属的IO线程中调用, 每个IO线程的暂存只在该线程中访问
+class AzRPC_Cork {
+public:
+    // 一个连接暂存到这么多字节时立即写出
+    static const size_t kFlushBytes = 64 * 1024;
+
+    // 暂存data, 本轮第一次暂存时安排本轮末尾的写出; 加上data达到kFlushBytes时按顺序立即写出, 较大的data不拷贝
+    static void Send(const muduo::net::TcpConnectionPtr& connection, const char* data, size_t len);
+    // 发送带附件的响应帧(AzRPC_Codec编码的frame、附件和trailer): 合计较小时一起暂存, 否则直接写出, 附件不拷贝
+    static void Send(const muduo::net::TcpConnectionPtr& connection, const std::string& frame, const AzRPC_Attachment& attachment, const std::string& trailer);
+    // 不经过暂存直接写data, 先写出该连接已经暂存的数据, 响应仍按产生的顺序发出
+    static void SendDirect(const muduo::net::TcpConnectionPtr& connection, const char* data, size_t len);
+    // 该连接暂存中还没有写出的字节数, 与输出缓冲区一起计入高水位
+    static size_t Pending(const muduo::net::TcpConnection* connection);
+    // 写出当前线程中所有连接暂存的数据, 由Send安排在本轮事件末尾执行
+    static void Flush();
+
+private:
+    AzRPC_Cork() = delete;
+};
+
+#endif
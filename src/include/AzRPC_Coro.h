@@ -0,0 +1,375 @@
+#ifndef _AzRPC_Coro_H_
+#define _AzRPC_Coro_H_
+
+// C++20协程接口, 只有头文件, 使用方需要用C++20编译(链接CMake目标AzRPC_Coro即可), AzRPC_Core本身仍按C++11编译
+//
+//     AzRPC_Task<std::string> Login(AzRPC_Channel* channel) {
+//         AzRPC_Controller controller;
+//         AzUser::LoginResponse response = co_await AzRPC_Call(channel, &AzUser::UserServiceRpc_Stub::Login, request, &controller);
+//         co_return controller.Failed() ? controller.ErrorText() : response.result().errmsg();
+//     }
+//
+// 启用客户端IO引擎(client_io_engine=epoll|io_uring)时, 协程在响应到达后于IO线程中恢复, 不占用等待线程;
+// 否则AzRPC_Call退化为阻塞调用, 协程在原线程中继续执行
+// 协程记住启动时的追踪上下文, 每次恢复时重新设为当前线程的上下文, 挂起前后发起的下游调用属于同一条调用链
+//
+// 服务端的业务方法也可以是协程, 在生成的服务类中用AzRPC_Serve转接, 协程结束后框架发送响应:
+//
+//     void Login(google::protobuf::RpcController* controller, const LoginRequest* request, LoginResponse* response, google::protobuf::Closure* done) override {
+//         AzRPC_Serve(DoLogin(request, response), controller, done);
+//     }
+#if !defined(__cpp_impl_coroutine)
+#error "AzRPC_Coro.h requires C++20 coroutines"
+#endif
+
+#include "AzRPC_Controller.h"
+#include "AzRPC_ClientLoop.h"
+#include "AzRPC_Timer.h"
+#include "AzRPC_Trace.h"
+#include <google/protobuf/service.h>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+template <typename T = void>
+class AzRPC_Task;
+
+namespace AzRPC_CoroDetail {
+
+// 协程结束时转到等待它的协程; 分离的任务没有等待者, 结束时释放自己
+struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        Promise& promise = handle.promise();
+        if (promise.detached) {
+            handle.destroy();
+            return std::noop_coroutine();
+        }
+        return promise.continuation ? promise.continuation : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+    bool detached = false;
+    AzRPC_TraceContext trace;       // 恢复执行时设为当前线程的追踪上下文
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() {
+        // 分离的任务没有人接收异常, 与std::thread一致直接终止
+        if (detached) {
+            std::terminate();
+        }
+        exception = std::current_exception();
+    }
+};
+
+template <typename T>
+struct Promise: PromiseBase {
+    std::optional<T> value;
+
+    AzRPC_Task<T> get_return_object() noexcept;
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    T Take() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void>: PromiseBase {
+    AzRPC_Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void Take() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+// 等待方是AzRPC_Task时取它的追踪上下文, 否则取当前线程的
+template <typename P>
+AzRPC_TraceContext TraceOf(std::coroutine_handle<P> handle) {
+    if constexpr (std::is_base_of<PromiseBase, P>::value) {
+        return handle.promise().trace;
+    }
+    else {
+        return AzRPC_Tracer::Current();
+    }
+}
+
+// 恢复挂起的协程: 不在客户端IO线程中时转到IO线程恢复(没有启用IO引擎时就地恢复)
+inline void ResumeOnLoop(std::coroutine_handle<> handle, const AzRPC_TraceContext& trace, bool in_loop) {
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (loop != nullptr && !in_loop) {
+        loop->QueueInLoop([handle, trace] {
+            AzRPC_TraceScope scope(trace);
+            handle.resume();
+        });
+    }
+    else {
+        AzRPC_TraceScope scope(trace);
+        handle.resume();
+    }
+}
+
+}  // namespace AzRPC_CoroDetail
+
+// 惰性启动的协程任务: 被co_await或Detach()时才开始执行
+template <typename T>
+class [[nodiscard]] AzRPC_Task {
+public:
+    using promise_type = AzRPC_CoroDetail::Promise<T>;
+
+    AzRPC_Task(AzRPC_Task&& other) noexcept: m_handle(std::exchange(other.m_handle, nullptr)) {}
+    AzRPC_Task& operator=(AzRPC_Task&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    AzRPC_Task(const AzRPC_Task&) = delete;
+    AzRPC_Task& operator=(const AzRPC_Task&) = delete;
+    ~AzRPC_Task() { Destroy(); }
+
+    // 开始执行, 不等待结果; 任务结束后自行释放
+    void Detach() {
+        std::coroutine_handle<promise_type> handle = std::exchange(m_handle, nullptr);
+        handle.promise().detached = true;
+        handle.promise().trace = AzRPC_Tracer::Current();
+        handle.resume();
+    }
+
+    // 等待任务: 任务在当前线程中开始执行, 结束后恢复等待方
+    struct Awaiter {
+        std::coroutine_handle<promise_type> handle;
+        bool await_ready() noexcept { return false; }
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            handle.promise().trace = AzRPC_CoroDetail::TraceOf(awaiting);
+            return handle;
+        }
+        T await_resume() { return handle.promise().Take(); }
+    };
+    Awaiter operator co_await() && noexcept { return Awaiter{m_handle}; }
+
+private:
+    friend promise_type;
+    explicit AzRPC_Task(std::coroutine_handle<promise_type> handle) noexcept: m_handle(handle) {}
+
+    void Destroy() {
+        if (m_handle) {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace AzRPC_CoroDetail {
+
+template <typename T>
+AzRPC_Task<T> Promise<T>::get_return_object() noexcept {
+    return AzRPC_Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline AzRPC_Task<void> Promise<void>::get_return_object() noexcept {
+    return AzRPC_Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// 一次协程调用的共享状态, 响应回调和取消回调各持有一份
+// 通道写入内部的controller和response, 先到的一方(响应或取消)把结果交给调用方, 迟到的一方什么都不做
+template <typename Response>
+struct CallState {
+    AzRPC_Controller inner;
+    Response response;
+    AzRPC_Controller* controller = nullptr;
+    std::coroutine_handle<> handle;
+    AzRPC_TraceContext trace;
+    std::atomic<bool> completed{false};
+    std::atomic<bool> ready{false};     // await_suspend返回和调用完成, 后发生的一方负责恢复协程
+    google::protobuf::Closure* cancel_callback = nullptr;   // 注册在调用方controller上的取消回调, 响应先到时删除
+};
+
+template <typename Response>
+void Resume(const std::shared_ptr<CallState<Response>>& state, bool in_loop) {
+    if (!state->ready.exchange(true)) {
+        return;     // 在await_suspend中同步完成, 协程不挂起
+    }
+    ResumeOnLoop(state->handle, state->trace, in_loop);
+}
+
+template <typename Response>
+void OnResponse(std::shared_ptr<CallState<Response>> state) {
+    if (state->completed.exchange(true)) {
+        return;
+    }
+    AzRPC_Controller* controller = state->controller;
+    // 取消回调持有本状态, 不删除的话在controller上越积越多, 直到它被Reset或析构
+    if (state->cancel_callback != nullptr) {
+        controller->RemoveCancelCallback(state->cancel_callback);
+    }
+    if (state->inner.Failed()) {
+        controller->SetFailed(state->inner.ErrorText());
+    }
+    controller->ResponseAttachment() = std::move(state->inner.ResponseAttachment());
+    Resume(state, true);
+}
+
+// 取消可能发生在任意线程, 协程转到IO线程中恢复
+template <typename Response>
+void OnCancel(std::shared_ptr<CallState<Response>> state) {
+    if (state->completed.exchange(true)) {
+        return;
+    }
+    state->controller->SetFailed("call canceled");
+    Resume(state, false);
+}
+
+template <typename Stub, typename Request, typename Response>
+class CallAwaiter {
+public:
+    typedef void (Stub::*Method)(google::protobuf::RpcController*, const Request*, Response*, google::protobuf::Closure*);
+
+    CallAwaiter(google::protobuf::RpcChannel* channel, Method method, const Request& request, AzRPC_Controller* controller)
+        : m_channel(channel), m_method(method), m_request(&request), m_state(std::make_shared<CallState<Response>>()) {
+        m_state->controller = controller;
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P>
+    bool await_suspend(std::coroutine_handle<P> handle) {
+        AzRPC_Controller* controller = m_state->controller;
+        if (controller->IsCanceled()) {
+            controller->SetFailed("call canceled");
+            return false;
+        }
+        m_state->handle = handle;
+        m_state->trace = TraceOf(handle);
+        // 调用方设置的调用链、压缩算法、优先级、租户和请求附件转交给内部controller
+        m_state->inner.SetTraceContext(controller->GetTraceContext());
+        AzRPC::CompressType compress;
+        if (controller->GetCompressType(&compress)) {
+            m_state->inner.SetCompressType(compress);
+        }
+        AzRPC::Priority priority;
+        if (controller->GetPriority(&priority)) {
+            m_state->inner.SetPriority(priority);
+        }
+        if (!controller->Tenant().empty()) {
+            m_state->inner.SetTenant(controller->Tenant());
+        }
+        m_state->inner.RequestAttachment().Append(controller->RequestAttachment());
+        m_state->cancel_callback = google::protobuf::NewCallback(&OnCancel<Response>, m_state);
+        controller->NotifyOnCancel(m_state->cancel_callback);
+
+        Stub stub(m_channel);
+        (stub.*m_method)(&m_state->inner, m_request, &m_state->response, google::protobuf::NewCallback(&OnResponse<Response>, m_state));
+        // 调用已经同步完成(阻塞模式、连接失败或缓存命中)时不挂起
+        return !m_state->ready.exchange(true);
+    }
+
+    Response await_resume() {
+        if (m_state->controller->Failed()) {
+            return Response();
+        }
+        return std::move(m_state->response);
+    }
+
+private:
+    google::protobuf::RpcChannel* m_channel;
+    Method m_method;
+    const Request* m_request;
+    std::shared_ptr<CallState<Response>> m_state;
+};
+
+struct SleepAwaiter {
+    int64_t delay_ms;
+
+    bool await_ready() const noexcept { return delay_ms <= 0; }
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> handle) {
+        AzRPC_TraceContext trace = TraceOf(handle);
+        AzRPC_Timer::RunAfter(delay_ms, [handle, trace] { ResumeOnLoop(handle, trace, false); });
+    }
+    void await_resume() noexcept {}
+};
+
+// 业务协程结束后执行done, 由框架序列化并发送响应; 协程抛出的异常作为调用失败返回给调用方
+inline AzRPC_Task<void> ServeRunner(AzRPC_Task<void> handler, google::protobuf::RpcController* controller, google::protobuf::Closure* done) {
+    try {
+        co_await std::move(handler);
+    }
+    catch (const std::exception& e) {
+        controller->SetFailed(e.what());
+    }
+    catch (...) {
+        controller->SetFailed("handler exception");
+    }
+    done->Run();
+}
+
+template <typename T>
+AzRPC_Task<void> SyncWaitRunner(AzRPC_Task<T> task, std::promise<T>* result) {
+    try {
+        if constexpr (std::is_void<T>::value) {
+            co_await std::move(task);
+            result->set_value();
+        }
+        else {
+            result->set_value(co_await std::move(task));
+        }
+    }
+    catch (...) {
+        result->set_exception(std::current_exception());
+    }
+}
+
+}  // namespace AzRPC_CoroDetail
+
+// 通过stub的方法发起一次调用, co_await的结果为响应; 失败或被取消时controller->Failed()为true, 响应为默认值
+// request只需在co_await表达式求值期间有效; controller在co_await结束前必须有效, 调用StartCancel()取消等待
+template <typename Stub, typename Request, typename Response>
+AzRPC_CoroDetail::CallAwaiter<Stub, Request, Response> AzRPC_Call(google::protobuf::RpcChannel* channel,
+        void (Stub::*method)(google::protobuf::RpcController*, const Request*, Response*, google::protobuf::Closure*),
+        const Request& request, AzRPC_Controller* controller) {
+    return AzRPC_CoroDetail::CallAwaiter<Stub, Request, Response>(channel, method, request, controller);
+}
+
+// 挂起当前协程delay_ms毫秒, 不占用线程; 到期后在客户端IO线程(没有启用IO引擎时在定时线程)中恢复
+inline AzRPC_CoroDetail::SleepAwaiter AzRPC_Sleep(int64_t delay_ms) {
+    return AzRPC_CoroDetail::SleepAwaiter{delay_ms};
+}
+
+// 在服务端业务方法中启动协程处理函数后立即返回, 不阻塞服务端线程; 协程结束(包括抛出异常)时执行done发送响应
+// request、response和controller由框架持有到done执行, 协程中可以直接使用
+inline void AzRPC_Serve(AzRPC_Task<void> handler, google::protobuf::RpcController* controller, google::protobuf::Closure* done) {
+    AzRPC_CoroDetail::ServeRunner(std::move(handler), controller, done).Detach();
+}
+
+// 在普通线程中启动任务并阻塞等待结果, 用于main函数等协程之外的入口; 不能在客户端IO线程中调用
+template <typename T>
+T AzRPC_SyncWait(AzRPC_Task<T> task) {
+    std::promise<T> result;
+    std::future<T> future = result.get_future();
+    AzRPC_CoroDetail::SyncWaitRunner(std::move(task), &result).Detach();
+    return future.get();
+}
+
+#endif
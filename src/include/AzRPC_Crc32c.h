@@ -0,0 +1,22 @@
+#ifndef _AzRPC_Crc32c_H_
+#define _AzRPC_Crc32c_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C(Castagnoli), 用于帧校验
+// x86-64上CPU支持SSE4.2时使用crc32指令, 三路交错计算以掩盖指令延迟, 否则使用查表(slicing-by-8)
+class AzRPC_Crc32c {
+public:
+    // 计算data的CRC32C
+    static uint32_t Value(const char* data, size_t len) { return Extend(0, data, len); }
+    // 在crc的基础上继续计算, Extend(Value(a), b) == Value(a + b)
+    static uint32_t Extend(uint32_t crc, const char* data, size_t len);
+    // 当前使用的实现: "sse4.2" 或 "table"
+    static const char* Implementation();
+
+private:
+    AzRPC_Crc32c() = delete;
+};
+
+#endif
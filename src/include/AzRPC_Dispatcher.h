@@ -0,0 +1,29 @@
+#ifndef _AzRPC_Dispatcher_H_
+#define _AzRPC_Dispatcher_H_
+
+#include <google/protobuf/service.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include "AzRPC_Stream.h"
+
+// 服务端分发接口, 由protoc-gen-azrpc生成的服务基类(<服务名>_AzService)实现
+// 按方法编号(方法在proto中的声明顺序)直接new具体的请求和响应类型、直接调用具体的业务方法, 不经过prototype和反射
+// 它同时是google::protobuf::Service, 用AzRPC_Provider::NotifyService发布, 发布时proto中声明为stream的方法自动注册为流式方法
+class AzRPC_Dispatcher: public google::protobuf::Service {
+public:
+    virtual google::protobuf::Message* NewRequest(int method_index) const = 0;
+    virtual google::protobuf::Message* NewResponse(int method_index) const = 0;
+    // 调用普通方法, 完成后执行done
+    virtual void Dispatch(int method_index, google::protobuf::RpcController* controller, const google::protobuf::Message* request,
+                          google::protobuf::Message* response, google::protobuf::Closure* done) = 0;
+    // 调用流式方法, 在框架为该流创建的线程中执行
+    virtual void DispatchStream(int method_index, AzRPC_ServerStream* stream) = 0;
+
+    // 通过google::protobuf::Service接口调用时转到Dispatch
+    void CallMethod(const google::protobuf::MethodDescriptor* method, google::protobuf::RpcController* controller, const google::protobuf::Message* request,
+                    google::protobuf::Message* response, google::protobuf::Closure* done) override {
+        Dispatch(method->index(), controller, request, response, done);
+    }
+};
+
+#endif
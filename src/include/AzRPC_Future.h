@@ -0,0 +1,240 @@
+#ifndef _AzRPC_Future_H_
+#define _AzRPC_Future_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 轻量的future/promise, 用于不能使用C++20协程的异步调用(见AzRPC_Channel::CallAsync)
+// - 结果为值或者失败信息(字符串), 不使用异常传递错误
+// - Then注册的回调在完成future的线程中执行: 异步调用的结果在客户端IO线程中完成, 回调也在IO线程中执行, 不能阻塞
+// - future可以复制, 副本共享同一个结果
+
+template <typename T>
+class AzRPC_Future;
+template <typename T>
+class AzRPC_Promise;
+
+namespace AzRPC_FutureDetail {
+
+// AzRPC_Future<void>内部保存的占位值
+struct Unit {};
+
+template <typename T>
+struct Storage {
+    typedef T type;
+};
+template <>
+struct Storage<void> {
+    typedef Unit type;
+};
+
+template <typename T>
+struct State {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ready = false;
+    bool failed = false;
+    std::string error;
+    typename Storage<T>::type value;
+    std::vector<std::function<void()>> callbacks;   // 完成前注册的Then回调
+};
+
+// Then回调的返回类型R决定新future的类型: 返回AzRPC_Future<U>时展开为AzRPC_Future<U>, 否则为AzRPC_Future<R>
+template <typename R>
+struct ThenResult {
+    typedef R type;
+};
+template <typename U>
+struct ThenResult<AzRPC_Future<U>> {
+    typedef U type;
+};
+
+}  // namespace AzRPC_FutureDetail
+
+template <typename T>
+class AzRPC_Future {
+public:
+    typedef typename AzRPC_FutureDetail::Storage<T>::type value_type;
+
+    // 默认构造的future没有关联的promise, 不能使用
+    AzRPC_Future() {}
+
+    bool Valid() const { return m_state != nullptr; }
+    bool Ready() const {
+        std::lock_guard<std::mutex> lock(m_state->mtx);
+        return m_state->ready;
+    }
+    // 阻塞等待完成; 不能在客户端IO线程中等待异步调用的结果, 否则永远等不到
+    void Wait() const {
+        std::unique_lock<std::mutex> lock(m_state->mtx);
+        m_state->cv.wait(lock, [this] { return m_state->ready; });
+    }
+
+    // 以下接口在完成后使用
+    bool Failed() const { return m_state->failed; }
+    const std::string& ErrorText() const { return m_state->error; }
+    // 失败时为默认值
+    const value_type& Value() const { return m_state->value; }
+    value_type& Value() { return m_state->value; }
+
+    // 等待完成并取出结果, 之后Value()不再保存该结果
+    value_type Get() {
+        Wait();
+        return std::move(m_state->value);
+    }
+
+    // 完成后执行f(future), 已经完成时立即在当前线程中执行; 成功和失败都会执行, 回调自己检查Failed()
+    // 返回的future在f返回后完成(f返回future时在该future完成后完成), f抛出的异常使它失败
+    template <typename F>
+    AzRPC_Future<typename AzRPC_FutureDetail::ThenResult<typename std::result_of<F(AzRPC_Future<T>)>::type>::type> Then(F f) const {
+        typedef typename std::result_of<F(AzRPC_Future<T>)>::type R;
+        typedef typename AzRPC_FutureDetail::ThenResult<R>::type U;
+        AzRPC_Promise<U> promise;
+        AzRPC_Future<U> next = promise.GetFuture();
+        AzRPC_Future<T> self = *this;
+        OnReady([self, f, promise]() mutable {
+            try {
+                Fulfill(promise, f, self, static_cast<R*>(nullptr));
+            }
+            catch (const std::exception& e) {
+                promise.SetFailed(e.what());
+            }
+            catch (...) {
+                promise.SetFailed("exception in future callback");
+            }
+        });
+        return next;
+    }
+
+    // 完成后执行callback, 已经完成时立即执行
+    void OnReady(std::function<void()> callback) const {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mtx);
+            if (!m_state->ready) {
+                m_state->callbacks.push_back(std::move(callback));
+                return;
+            }
+        }
+        callback();
+    }
+
+private:
+    friend class AzRPC_Promise<T>;
+    explicit AzRPC_Future(const std::shared_ptr<AzRPC_FutureDetail::State<T>>& state): m_state(state) {}
+
+    // 按回调的返回类型把结果交给下一个promise
+    template <typename U, typename F, typename R>
+    static void Fulfill(AzRPC_Promise<U>& promise, F& f, AzRPC_Future<T>& self, R*) {
+        promise.SetValue(f(self));
+    }
+    template <typename U, typename F>
+    static void Fulfill(AzRPC_Promise<U>& promise, F& f, AzRPC_Future<T>& self, void*) {
+        f(self);
+        promise.SetValue();
+    }
+    template <typename U, typename F>
+    static void Fulfill(AzRPC_Promise<U>& promise, F& f, AzRPC_Future<T>& self, AzRPC_Future<U>*) {
+        AzRPC_Future<U> inner = f(self);
+        inner.OnReady([inner, promise]() mutable {
+            if (inner.Failed()) {
+                promise.SetFailed(inner.ErrorText());
+            }
+            else {
+                promise.SetValue(std::move(inner.Value()));
+            }
+        });
+    }
+
+    std::shared_ptr<AzRPC_FutureDetail::State<T>> m_state;
+};
+
+template <typename T>
+class AzRPC_Promise {
+public:
+    typedef typename AzRPC_FutureDetail::Storage<T>::type value_type;
+
+    AzRPC_Promise(): m_state(std::make_shared<AzRPC_FutureDetail::State<T>>()) {}
+
+    AzRPC_Future<T> GetFuture() const { return AzRPC_Future<T>(m_state); }
+
+    // 只有第一次SetValue或SetFailed生效
+    void SetValue(value_type value = value_type()) {
+        Complete(false, std::string(), &value);
+    }
+    void SetFailed(const std::string& error) {
+        Complete(true, error, nullptr);
+    }
+
+private:
+    void Complete(bool failed, const std::string& error, value_type* value) {
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mtx);
+            if (m_state->ready) {
+                return;
+            }
+            m_state->ready = true;
+            m_state->failed = failed;
+            m_state->error = error;
+            if (value != nullptr) {
+                m_state->value = std::move(*value);
+            }
+            callbacks.swap(m_state->callbacks);
+        }
+        m_state->cv.notify_all();
+        // 回调在锁外执行, 回调中可以再访问这个future
+        for (auto& callback: callbacks) {
+            callback();
+        }
+    }
+
+    std::shared_ptr<AzRPC_FutureDetail::State<T>> m_state;
+};
+
+// 所有future完成后完成, 结果为传入的future(各自可能失败), 本身不会失败
+template <typename T>
+AzRPC_Future<std::vector<AzRPC_Future<T>>> AzRPC_WhenAll(const std::vector<AzRPC_Future<T>>& futures) {
+    AzRPC_Promise<std::vector<AzRPC_Future<T>>> promise;
+    AzRPC_Future<std::vector<AzRPC_Future<T>>> all = promise.GetFuture();
+    if (futures.empty()) {
+        promise.SetValue();
+        return all;
+    }
+    std::shared_ptr<std::atomic<size_t>> remaining = std::make_shared<std::atomic<size_t>>(futures.size());
+    std::shared_ptr<std::vector<AzRPC_Future<T>>> results = std::make_shared<std::vector<AzRPC_Future<T>>>(futures);
+    for (const AzRPC_Future<T>& future: futures) {
+        future.OnReady([remaining, results, promise]() mutable {
+            if (remaining->fetch_sub(1) == 1) {
+                promise.SetValue(std::move(*results));
+            }
+        });
+    }
+    return all;
+}
+
+// 任意一个future完成后完成, 结果为它在futures中的下标; futures为空时失败
+template <typename T>
+AzRPC_Future<size_t> AzRPC_WhenAny(const std::vector<AzRPC_Future<T>>& futures) {
+    AzRPC_Promise<size_t> promise;
+    AzRPC_Future<size_t> any = promise.GetFuture();
+    if (futures.empty()) {
+        promise.SetFailed("no future to wait");
+        return any;
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+        // 只有第一个完成的生效, 之后的SetValue被忽略
+        futures[i].OnReady([promise, i]() mutable { promise.SetValue(i); });
+    }
+    return any;
+}
+
+#endif
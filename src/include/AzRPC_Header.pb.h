@@ -29,6 +29,7 @@
 #include <google/protobuf/message.h>
 #include <google/protobuf/repeated_field.h>  // IWYU pragma: export
 #include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/generated_enum_reflection.h>
 #include <google/protobuf/unknown_field_set.h>
 // @@protoc_insertion_point(includes)
 #include <google/protobuf/port_def.inc>
@@ -48,12 +49,129 @@ namespace AzRPC {
 class RpcHeader;
 struct RpcHeaderDefaultTypeInternal;
 extern RpcHeaderDefaultTypeInternal _RpcHeader_default_instance_;
+class RpcResponseHeader;
+struct RpcResponseHeaderDefaultTypeInternal;
+extern RpcResponseHeaderDefaultTypeInternal _RpcResponseHeader_default_instance_;
 }  // namespace AzRPC
 PROTOBUF_NAMESPACE_OPEN
 template<> ::AzRPC::RpcHeader* Arena::CreateMaybeMessage<::AzRPC::RpcHeader>(Arena*);
+template<> ::AzRPC::RpcResponseHeader* Arena::CreateMaybeMessage<::AzRPC::RpcResponseHeader>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace AzRPC {
 
+enum CompressType : int {
+  COMPRESS_NONE = 0,
+  COMPRESS_LZ4 = 1,
+  COMPRESS_ZSTD = 2,
+  COMPRESS_SNAPPY = 3,
+  CompressType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  CompressType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool CompressType_IsValid(int value);
+constexpr CompressType CompressType_MIN = COMPRESS_NONE;
+constexpr CompressType CompressType_MAX = COMPRESS_SNAPPY;
+constexpr int CompressType_ARRAYSIZE = CompressType_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* CompressType_descriptor();
+template<typename T>
+inline const std::string& CompressType_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, CompressType>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function CompressType_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    CompressType_descriptor(), enum_t_value);
+}
+inline bool CompressType_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, CompressType* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<CompressType>(
+    CompressType_descriptor(), name, value);
+}
+enum StreamFrameType : int {
+  STREAM_NONE = 0,
+  STREAM_OPEN = 1,
+  STREAM_DATA = 2,
+  STREAM_END = 3,
+  STREAM_CREDIT = 4,
+  StreamFrameType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  StreamFrameType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool StreamFrameType_IsValid(int value);
+constexpr StreamFrameType StreamFrameType_MIN = STREAM_NONE;
+constexpr StreamFrameType StreamFrameType_MAX = STREAM_CREDIT;
+constexpr int StreamFrameType_ARRAYSIZE = StreamFrameType_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* StreamFrameType_descriptor();
+template<typename T>
+inline const std::string& StreamFrameType_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, StreamFrameType>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function StreamFrameType_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    StreamFrameType_descriptor(), enum_t_value);
+}
+inline bool StreamFrameType_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, StreamFrameType* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<StreamFrameType>(
+    StreamFrameType_descriptor(), name, value);
+}
+enum Priority : int {
+  PRIORITY_NORMAL = 0,
+  PRIORITY_LOW = 1,
+  PRIORITY_HIGH = 2,
+  PRIORITY_CRITICAL = 3,
+  Priority_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  Priority_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool Priority_IsValid(int value);
+constexpr Priority Priority_MIN = PRIORITY_NORMAL;
+constexpr Priority Priority_MAX = PRIORITY_CRITICAL;
+constexpr int Priority_ARRAYSIZE = Priority_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* Priority_descriptor();
+template<typename T>
+inline const std::string& Priority_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, Priority>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function Priority_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    Priority_descriptor(), enum_t_value);
+}
+inline bool Priority_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, Priority* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<Priority>(
+    Priority_descriptor(), name, value);
+}
+enum ErrorCode : int {
+  OK = 0,
+  SERVICE_NOT_FOUND = 1,
+  METHOD_NOT_FOUND = 2,
+  REQUEST_PARSE_ERROR = 3,
+  RESPONSE_SERIALIZE_ERROR = 4,
+  HANDLER_FAILED = 5,
+  CHECKSUM_ERROR = 6,
+  OVERLOADED = 7,
+  ErrorCode_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
+  ErrorCode_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
+};
+bool ErrorCode_IsValid(int value);
+constexpr ErrorCode ErrorCode_MIN = OK;
+constexpr ErrorCode ErrorCode_MAX = OVERLOADED;
+constexpr int ErrorCode_ARRAYSIZE = ErrorCode_MAX + 1;
+
+const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* ErrorCode_descriptor();
+template<typename T>
+inline const std::string& ErrorCode_Name(T enum_t_value) {
+  static_assert(::std::is_same<T, ErrorCode>::value ||
+    ::std::is_integral<T>::value,
+    "Incorrect type passed to function ErrorCode_Name.");
+  return ::PROTOBUF_NAMESPACE_ID::internal::NameOfEnum(
+    ErrorCode_descriptor(), enum_t_value);
+}
+inline bool ErrorCode_Parse(
+    ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, ErrorCode* value) {
+  return ::PROTOBUF_NAMESPACE_ID::internal::ParseNamedEnum<ErrorCode>(
+    ErrorCode_descriptor(), name, value);
+}
 // ===================================================================
 
 class RpcHeader final :
@@ -179,7 +297,22 @@ class RpcHeader final :
   enum : int {
     kServiceNameFieldNumber = 1,
     kMethodNameFieldNumber = 2,
+    kTenantFieldNumber = 18,
+    kTraceIdFieldNumber = 4,
+    kSpanIdFieldNumber = 5,
     kArgsSizeFieldNumber = 3,
+    kTraceFlagsFieldNumber = 7,
+    kParentSpanIdFieldNumber = 6,
+    kCallIdFieldNumber = 8,
+    kCompressTypeFieldNumber = 9,
+    kArgsRawSizeFieldNumber = 10,
+    kResponseCompressFieldNumber = 11,
+    kChecksumFieldNumber = 12,
+    kAttachmentSizeFieldNumber = 13,
+    kStreamTypeFieldNumber = 14,
+    kStreamCreditsFieldNumber = 15,
+    kBatchCountFieldNumber = 16,
+    kPriorityFieldNumber = 17,
   };
   // bytes service_name = 1;
   void clear_service_name();
@@ -209,6 +342,38 @@ class RpcHeader final :
   std::string* _internal_mutable_method_name();
   public:
 
+  // bytes tenant = 18;
+  void clear_tenant();
+  const std::string& tenant() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_tenant(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_tenant();
+  PROTOBUF_NODISCARD std::string* release_tenant();
+  void set_allocated_tenant(std::string* tenant);
+  private:
+  const std::string& _internal_tenant() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_tenant(const std::string& value);
+  std::string* _internal_mutable_tenant();
+  public:
+
+  // fixed64 trace_id = 4;
+  void clear_trace_id();
+  uint64_t trace_id() const;
+  void set_trace_id(uint64_t value);
+  private:
+  uint64_t _internal_trace_id() const;
+  void _internal_set_trace_id(uint64_t value);
+  public:
+
+  // fixed64 span_id = 5;
+  void clear_span_id();
+  uint64_t span_id() const;
+  void set_span_id(uint64_t value);
+  private:
+  uint64_t _internal_span_id() const;
+  void _internal_set_span_id(uint64_t value);
+  public:
+
   // uint32 args_size = 3;
   void clear_args_size();
   uint32_t args_size() const;
@@ -218,6 +383,114 @@ class RpcHeader final :
   void _internal_set_args_size(uint32_t value);
   public:
 
+  // uint32 trace_flags = 7;
+  void clear_trace_flags();
+  uint32_t trace_flags() const;
+  void set_trace_flags(uint32_t value);
+  private:
+  uint32_t _internal_trace_flags() const;
+  void _internal_set_trace_flags(uint32_t value);
+  public:
+
+  // fixed64 parent_span_id = 6;
+  void clear_parent_span_id();
+  uint64_t parent_span_id() const;
+  void set_parent_span_id(uint64_t value);
+  private:
+  uint64_t _internal_parent_span_id() const;
+  void _internal_set_parent_span_id(uint64_t value);
+  public:
+
+  // uint64 call_id = 8;
+  void clear_call_id();
+  uint64_t call_id() const;
+  void set_call_id(uint64_t value);
+  private:
+  uint64_t _internal_call_id() const;
+  void _internal_set_call_id(uint64_t value);
+  public:
+
+  // .AzRPC.CompressType compress_type = 9;
+  void clear_compress_type();
+  ::AzRPC::CompressType compress_type() const;
+  void set_compress_type(::AzRPC::CompressType value);
+  private:
+  ::AzRPC::CompressType _internal_compress_type() const;
+  void _internal_set_compress_type(::AzRPC::CompressType value);
+  public:
+
+  // uint32 args_raw_size = 10;
+  void clear_args_raw_size();
+  uint32_t args_raw_size() const;
+  void set_args_raw_size(uint32_t value);
+  private:
+  uint32_t _internal_args_raw_size() const;
+  void _internal_set_args_raw_size(uint32_t value);
+  public:
+
+  // .AzRPC.CompressType response_compress = 11;
+  void clear_response_compress();
+  ::AzRPC::CompressType response_compress() const;
+  void set_response_compress(::AzRPC::CompressType value);
+  private:
+  ::AzRPC::CompressType _internal_response_compress() const;
+  void _internal_set_response_compress(::AzRPC::CompressType value);
+  public:
+
+  // bool checksum = 12;
+  void clear_checksum();
+  bool checksum() const;
+  void set_checksum(bool value);
+  private:
+  bool _internal_checksum() const;
+  void _internal_set_checksum(bool value);
+  public:
+
+  // uint32 attachment_size = 13;
+  void clear_attachment_size();
+  uint32_t attachment_size() const;
+  void set_attachment_size(uint32_t value);
+  private:
+  uint32_t _internal_attachment_size() const;
+  void _internal_set_attachment_size(uint32_t value);
+  public:
+
+  // .AzRPC.StreamFrameType stream_type = 14;
+  void clear_stream_type();
+  ::AzRPC::StreamFrameType stream_type() const;
+  void set_stream_type(::AzRPC::StreamFrameType value);
+  private:
+  ::AzRPC::StreamFrameType _internal_stream_type() const;
+  void _internal_set_stream_type(::AzRPC::StreamFrameType value);
+  public:
+
+  // uint32 stream_credits = 15;
+  void clear_stream_credits();
+  uint32_t stream_credits() const;
+  void set_stream_credits(uint32_t value);
+  private:
+  uint32_t _internal_stream_credits() const;
+  void _internal_set_stream_credits(uint32_t value);
+  public:
+
+  // uint32 batch_count = 16;
+  void clear_batch_count();
+  uint32_t batch_count() const;
+  void set_batch_count(uint32_t value);
+  private:
+  uint32_t _internal_batch_count() const;
+  void _internal_set_batch_count(uint32_t value);
+  public:
+
+  // .AzRPC.Priority priority = 17;
+  void clear_priority();
+  ::AzRPC::Priority priority() const;
+  void set_priority(::AzRPC::Priority value);
+  private:
+  ::AzRPC::Priority _internal_priority() const;
+  void _internal_set_priority(::AzRPC::Priority value);
+  public:
+
   // @@protoc_insertion_point(class_scope:AzRPC.RpcHeader)
  private:
   class _Internal;
@@ -228,7 +501,285 @@ class RpcHeader final :
   struct Impl_ {
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr service_name_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr method_name_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr tenant_;
+    uint64_t trace_id_;
+    uint64_t span_id_;
     uint32_t args_size_;
+    uint32_t trace_flags_;
+    uint64_t parent_span_id_;
+    uint64_t call_id_;
+    int compress_type_;
+    uint32_t args_raw_size_;
+    int response_compress_;
+    bool checksum_;
+    uint32_t attachment_size_;
+    int stream_type_;
+    uint32_t stream_credits_;
+    uint32_t batch_count_;
+    int priority_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_AzRPC_5fHeader_2eproto;
+};
+// -------------------------------------------------------------------
+
+class RpcResponseHeader final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:AzRPC.RpcResponseHeader) */ {
+ public:
+  inline RpcResponseHeader() : RpcResponseHeader(nullptr) {}
+  ~RpcResponseHeader() override;
+  explicit PROTOBUF_CONSTEXPR RpcResponseHeader(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  RpcResponseHeader(const RpcResponseHeader& from);
+  RpcResponseHeader(RpcResponseHeader&& from) noexcept
+    : RpcResponseHeader() {
+    *this = ::std::move(from);
+  }
+
+  inline RpcResponseHeader& operator=(const RpcResponseHeader& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline RpcResponseHeader& operator=(RpcResponseHeader&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const RpcResponseHeader& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const RpcResponseHeader* internal_default_instance() {
+    return reinterpret_cast<const RpcResponseHeader*>(
+               &_RpcResponseHeader_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(RpcResponseHeader& a, RpcResponseHeader& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(RpcResponseHeader* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(RpcResponseHeader* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  RpcResponseHeader* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<RpcResponseHeader>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const RpcResponseHeader& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const RpcResponseHeader& from) {
+    RpcResponseHeader::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(RpcResponseHeader* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "AzRPC.RpcResponseHeader";
+  }
+  protected:
+  explicit RpcResponseHeader(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kErrorTextFieldNumber = 3,
+    kBodySizeFieldNumber = 1,
+    kErrorCodeFieldNumber = 2,
+    kCallIdFieldNumber = 4,
+    kCompressTypeFieldNumber = 5,
+    kBodyRawSizeFieldNumber = 6,
+    kChecksumFieldNumber = 7,
+    kAttachmentSizeFieldNumber = 8,
+    kStreamTypeFieldNumber = 9,
+    kStreamCreditsFieldNumber = 10,
+    kBatchCountFieldNumber = 11,
+  };
+  // bytes error_text = 3;
+  void clear_error_text();
+  const std::string& error_text() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_error_text(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_error_text();
+  PROTOBUF_NODISCARD std::string* release_error_text();
+  void set_allocated_error_text(std::string* error_text);
+  private:
+  const std::string& _internal_error_text() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_error_text(const std::string& value);
+  std::string* _internal_mutable_error_text();
+  public:
+
+  // uint32 body_size = 1;
+  void clear_body_size();
+  uint32_t body_size() const;
+  void set_body_size(uint32_t value);
+  private:
+  uint32_t _internal_body_size() const;
+  void _internal_set_body_size(uint32_t value);
+  public:
+
+  // .AzRPC.ErrorCode error_code = 2;
+  void clear_error_code();
+  ::AzRPC::ErrorCode error_code() const;
+  void set_error_code(::AzRPC::ErrorCode value);
+  private:
+  ::AzRPC::ErrorCode _internal_error_code() const;
+  void _internal_set_error_code(::AzRPC::ErrorCode value);
+  public:
+
+  // uint64 call_id = 4;
+  void clear_call_id();
+  uint64_t call_id() const;
+  void set_call_id(uint64_t value);
+  private:
+  uint64_t _internal_call_id() const;
+  void _internal_set_call_id(uint64_t value);
+  public:
+
+  // .AzRPC.CompressType compress_type = 5;
+  void clear_compress_type();
+  ::AzRPC::CompressType compress_type() const;
+  void set_compress_type(::AzRPC::CompressType value);
+  private:
+  ::AzRPC::CompressType _internal_compress_type() const;
+  void _internal_set_compress_type(::AzRPC::CompressType value);
+  public:
+
+  // uint32 body_raw_size = 6;
+  void clear_body_raw_size();
+  uint32_t body_raw_size() const;
+  void set_body_raw_size(uint32_t value);
+  private:
+  uint32_t _internal_body_raw_size() const;
+  void _internal_set_body_raw_size(uint32_t value);
+  public:
+
+  // bool checksum = 7;
+  void clear_checksum();
+  bool checksum() const;
+  void set_checksum(bool value);
+  private:
+  bool _internal_checksum() const;
+  void _internal_set_checksum(bool value);
+  public:
+
+  // uint32 attachment_size = 8;
+  void clear_attachment_size();
+  uint32_t attachment_size() const;
+  void set_attachment_size(uint32_t value);
+  private:
+  uint32_t _internal_attachment_size() const;
+  void _internal_set_attachment_size(uint32_t value);
+  public:
+
+  // .AzRPC.StreamFrameType stream_type = 9;
+  void clear_stream_type();
+  ::AzRPC::StreamFrameType stream_type() const;
+  void set_stream_type(::AzRPC::StreamFrameType value);
+  private:
+  ::AzRPC::StreamFrameType _internal_stream_type() const;
+  void _internal_set_stream_type(::AzRPC::StreamFrameType value);
+  public:
+
+  // uint32 stream_credits = 10;
+  void clear_stream_credits();
+  uint32_t stream_credits() const;
+  void set_stream_credits(uint32_t value);
+  private:
+  uint32_t _internal_stream_credits() const;
+  void _internal_set_stream_credits(uint32_t value);
+  public:
+
+  // uint32 batch_count = 11;
+  void clear_batch_count();
+  uint32_t batch_count() const;
+  void set_batch_count(uint32_t value);
+  private:
+  uint32_t _internal_batch_count() const;
+  void _internal_set_batch_count(uint32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:AzRPC.RpcResponseHeader)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr error_text_;
+    uint32_t body_size_;
+    int error_code_;
+    uint64_t call_id_;
+    int compress_type_;
+    uint32_t body_raw_size_;
+    bool checksum_;
+    uint32_t attachment_size_;
+    int stream_type_;
+    uint32_t stream_credits_;
+    uint32_t batch_count_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -365,14 +916,625 @@ inline void RpcHeader::set_args_size(uint32_t value) {
   // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.args_size)
 }
 
+// fixed64 trace_id = 4;
+inline void RpcHeader::clear_trace_id() {
+  _impl_.trace_id_ = uint64_t{0u};
+}
+inline uint64_t RpcHeader::_internal_trace_id() const {
+  return _impl_.trace_id_;
+}
+inline uint64_t RpcHeader::trace_id() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.trace_id)
+  return _internal_trace_id();
+}
+inline void RpcHeader::_internal_set_trace_id(uint64_t value) {
+  
+  _impl_.trace_id_ = value;
+}
+inline void RpcHeader::set_trace_id(uint64_t value) {
+  _internal_set_trace_id(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.trace_id)
+}
+
+// fixed64 span_id = 5;
+inline void RpcHeader::clear_span_id() {
+  _impl_.span_id_ = uint64_t{0u};
+}
+inline uint64_t RpcHeader::_internal_span_id() const {
+  return _impl_.span_id_;
+}
+inline uint64_t RpcHeader::span_id() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.span_id)
+  return _internal_span_id();
+}
+inline void RpcHeader::_internal_set_span_id(uint64_t value) {
+  
+  _impl_.span_id_ = value;
+}
+inline void RpcHeader::set_span_id(uint64_t value) {
+  _internal_set_span_id(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.span_id)
+}
+
+// fixed64 parent_span_id = 6;
+inline void RpcHeader::clear_parent_span_id() {
+  _impl_.parent_span_id_ = uint64_t{0u};
+}
+inline uint64_t RpcHeader::_internal_parent_span_id() const {
+  return _impl_.parent_span_id_;
+}
+inline uint64_t RpcHeader::parent_span_id() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.parent_span_id)
+  return _internal_parent_span_id();
+}
+inline void RpcHeader::_internal_set_parent_span_id(uint64_t value) {
+  
+  _impl_.parent_span_id_ = value;
+}
+inline void RpcHeader::set_parent_span_id(uint64_t value) {
+  _internal_set_parent_span_id(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.parent_span_id)
+}
+
+// uint32 trace_flags = 7;
+inline void RpcHeader::clear_trace_flags() {
+  _impl_.trace_flags_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_trace_flags() const {
+  return _impl_.trace_flags_;
+}
+inline uint32_t RpcHeader::trace_flags() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.trace_flags)
+  return _internal_trace_flags();
+}
+inline void RpcHeader::_internal_set_trace_flags(uint32_t value) {
+  
+  _impl_.trace_flags_ = value;
+}
+inline void RpcHeader::set_trace_flags(uint32_t value) {
+  _internal_set_trace_flags(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.trace_flags)
+}
+
+// uint64 call_id = 8;
+inline void RpcHeader::clear_call_id() {
+  _impl_.call_id_ = uint64_t{0u};
+}
+inline uint64_t RpcHeader::_internal_call_id() const {
+  return _impl_.call_id_;
+}
+inline uint64_t RpcHeader::call_id() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.call_id)
+  return _internal_call_id();
+}
+inline void RpcHeader::_internal_set_call_id(uint64_t value) {
+  
+  _impl_.call_id_ = value;
+}
+inline void RpcHeader::set_call_id(uint64_t value) {
+  _internal_set_call_id(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.call_id)
+}
+
+// .AzRPC.CompressType compress_type = 9;
+inline void RpcHeader::clear_compress_type() {
+  _impl_.compress_type_ = 0;
+}
+inline ::AzRPC::CompressType RpcHeader::_internal_compress_type() const {
+  return static_cast< ::AzRPC::CompressType >(_impl_.compress_type_);
+}
+inline ::AzRPC::CompressType RpcHeader::compress_type() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.compress_type)
+  return _internal_compress_type();
+}
+inline void RpcHeader::_internal_set_compress_type(::AzRPC::CompressType value) {
+  
+  _impl_.compress_type_ = value;
+}
+inline void RpcHeader::set_compress_type(::AzRPC::CompressType value) {
+  _internal_set_compress_type(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.compress_type)
+}
+
+// uint32 args_raw_size = 10;
+inline void RpcHeader::clear_args_raw_size() {
+  _impl_.args_raw_size_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_args_raw_size() const {
+  return _impl_.args_raw_size_;
+}
+inline uint32_t RpcHeader::args_raw_size() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.args_raw_size)
+  return _internal_args_raw_size();
+}
+inline void RpcHeader::_internal_set_args_raw_size(uint32_t value) {
+  
+  _impl_.args_raw_size_ = value;
+}
+inline void RpcHeader::set_args_raw_size(uint32_t value) {
+  _internal_set_args_raw_size(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.args_raw_size)
+}
+
+// .AzRPC.CompressType response_compress = 11;
+inline void RpcHeader::clear_response_compress() {
+  _impl_.response_compress_ = 0;
+}
+inline ::AzRPC::CompressType RpcHeader::_internal_response_compress() const {
+  return static_cast< ::AzRPC::CompressType >(_impl_.response_compress_);
+}
+inline ::AzRPC::CompressType RpcHeader::response_compress() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.response_compress)
+  return _internal_response_compress();
+}
+inline void RpcHeader::_internal_set_response_compress(::AzRPC::CompressType value) {
+  
+  _impl_.response_compress_ = value;
+}
+inline void RpcHeader::set_response_compress(::AzRPC::CompressType value) {
+  _internal_set_response_compress(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.response_compress)
+}
+
+// bool checksum = 12;
+inline void RpcHeader::clear_checksum() {
+  _impl_.checksum_ = false;
+}
+inline bool RpcHeader::_internal_checksum() const {
+  return _impl_.checksum_;
+}
+inline bool RpcHeader::checksum() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.checksum)
+  return _internal_checksum();
+}
+inline void RpcHeader::_internal_set_checksum(bool value) {
+  
+  _impl_.checksum_ = value;
+}
+inline void RpcHeader::set_checksum(bool value) {
+  _internal_set_checksum(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.checksum)
+}
+
+// uint32 attachment_size = 13;
+inline void RpcHeader::clear_attachment_size() {
+  _impl_.attachment_size_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_attachment_size() const {
+  return _impl_.attachment_size_;
+}
+inline uint32_t RpcHeader::attachment_size() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.attachment_size)
+  return _internal_attachment_size();
+}
+inline void RpcHeader::_internal_set_attachment_size(uint32_t value) {
+  
+  _impl_.attachment_size_ = value;
+}
+inline void RpcHeader::set_attachment_size(uint32_t value) {
+  _internal_set_attachment_size(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.attachment_size)
+}
+
+// .AzRPC.StreamFrameType stream_type = 14;
+inline void RpcHeader::clear_stream_type() {
+  _impl_.stream_type_ = 0;
+}
+inline ::AzRPC::StreamFrameType RpcHeader::_internal_stream_type() const {
+  return static_cast< ::AzRPC::StreamFrameType >(_impl_.stream_type_);
+}
+inline ::AzRPC::StreamFrameType RpcHeader::stream_type() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.stream_type)
+  return _internal_stream_type();
+}
+inline void RpcHeader::_internal_set_stream_type(::AzRPC::StreamFrameType value) {
+  
+  _impl_.stream_type_ = value;
+}
+inline void RpcHeader::set_stream_type(::AzRPC::StreamFrameType value) {
+  _internal_set_stream_type(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.stream_type)
+}
+
+// uint32 stream_credits = 15;
+inline void RpcHeader::clear_stream_credits() {
+  _impl_.stream_credits_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_stream_credits() const {
+  return _impl_.stream_credits_;
+}
+inline uint32_t RpcHeader::stream_credits() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.stream_credits)
+  return _internal_stream_credits();
+}
+inline void RpcHeader::_internal_set_stream_credits(uint32_t value) {
+  
+  _impl_.stream_credits_ = value;
+}
+inline void RpcHeader::set_stream_credits(uint32_t value) {
+  _internal_set_stream_credits(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.stream_credits)
+}
+
+// uint32 batch_count = 16;
+inline void RpcHeader::clear_batch_count() {
+  _impl_.batch_count_ = 0u;
+}
+inline uint32_t RpcHeader::_internal_batch_count() const {
+  return _impl_.batch_count_;
+}
+inline uint32_t RpcHeader::batch_count() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.batch_count)
+  return _internal_batch_count();
+}
+inline void RpcHeader::_internal_set_batch_count(uint32_t value) {
+  
+  _impl_.batch_count_ = value;
+}
+inline void RpcHeader::set_batch_count(uint32_t value) {
+  _internal_set_batch_count(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.batch_count)
+}
+
+// .AzRPC.Priority priority = 17;
+inline void RpcHeader::clear_priority() {
+  _impl_.priority_ = 0;
+}
+inline ::AzRPC::Priority RpcHeader::_internal_priority() const {
+  return static_cast< ::AzRPC::Priority >(_impl_.priority_);
+}
+inline ::AzRPC::Priority RpcHeader::priority() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.priority)
+  return _internal_priority();
+}
+inline void RpcHeader::_internal_set_priority(::AzRPC::Priority value) {
+  
+  _impl_.priority_ = value;
+}
+inline void RpcHeader::set_priority(::AzRPC::Priority value) {
+  _internal_set_priority(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.priority)
+}
+
+// bytes tenant = 18;
+inline void RpcHeader::clear_tenant() {
+  _impl_.tenant_.ClearToEmpty();
+}
+inline const std::string& RpcHeader::tenant() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcHeader.tenant)
+  return _internal_tenant();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcHeader::set_tenant(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.tenant_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:AzRPC.RpcHeader.tenant)
+}
+inline std::string* RpcHeader::mutable_tenant() {
+  std::string* _s = _internal_mutable_tenant();
+  // @@protoc_insertion_point(field_mutable:AzRPC.RpcHeader.tenant)
+  return _s;
+}
+inline const std::string& RpcHeader::_internal_tenant() const {
+  return _impl_.tenant_.Get();
+}
+inline void RpcHeader::_internal_set_tenant(const std::string& value) {
+  
+  _impl_.tenant_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcHeader::_internal_mutable_tenant() {
+  
+  return _impl_.tenant_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcHeader::release_tenant() {
+  // @@protoc_insertion_point(field_release:AzRPC.RpcHeader.tenant)
+  return _impl_.tenant_.Release();
+}
+inline void RpcHeader::set_allocated_tenant(std::string* tenant) {
+  if (tenant != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.tenant_.SetAllocated(tenant, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.tenant_.IsDefault()) {
+    _impl_.tenant_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:AzRPC.RpcHeader.tenant)
+}
+
+// -------------------------------------------------------------------
+
+// RpcResponseHeader
+
+// uint32 body_size = 1;
+inline void RpcResponseHeader::clear_body_size() {
+  _impl_.body_size_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_body_size() const {
+  return _impl_.body_size_;
+}
+inline uint32_t RpcResponseHeader::body_size() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.body_size)
+  return _internal_body_size();
+}
+inline void RpcResponseHeader::_internal_set_body_size(uint32_t value) {
+  
+  _impl_.body_size_ = value;
+}
+inline void RpcResponseHeader::set_body_size(uint32_t value) {
+  _internal_set_body_size(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.body_size)
+}
+
+// .AzRPC.ErrorCode error_code = 2;
+inline void RpcResponseHeader::clear_error_code() {
+  _impl_.error_code_ = 0;
+}
+inline ::AzRPC::ErrorCode RpcResponseHeader::_internal_error_code() const {
+  return static_cast< ::AzRPC::ErrorCode >(_impl_.error_code_);
+}
+inline ::AzRPC::ErrorCode RpcResponseHeader::error_code() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.error_code)
+  return _internal_error_code();
+}
+inline void RpcResponseHeader::_internal_set_error_code(::AzRPC::ErrorCode value) {
+  
+  _impl_.error_code_ = value;
+}
+inline void RpcResponseHeader::set_error_code(::AzRPC::ErrorCode value) {
+  _internal_set_error_code(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.error_code)
+}
+
+// bytes error_text = 3;
+inline void RpcResponseHeader::clear_error_text() {
+  _impl_.error_text_.ClearToEmpty();
+}
+inline const std::string& RpcResponseHeader::error_text() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.error_text)
+  return _internal_error_text();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void RpcResponseHeader::set_error_text(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.error_text_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.error_text)
+}
+inline std::string* RpcResponseHeader::mutable_error_text() {
+  std::string* _s = _internal_mutable_error_text();
+  // @@protoc_insertion_point(field_mutable:AzRPC.RpcResponseHeader.error_text)
+  return _s;
+}
+inline const std::string& RpcResponseHeader::_internal_error_text() const {
+  return _impl_.error_text_.Get();
+}
+inline void RpcResponseHeader::_internal_set_error_text(const std::string& value) {
+  
+  _impl_.error_text_.Set(value, GetArenaForAllocation());
+}
+inline std::string* RpcResponseHeader::_internal_mutable_error_text() {
+  
+  return _impl_.error_text_.Mutable(GetArenaForAllocation());
+}
+inline std::string* RpcResponseHeader::release_error_text() {
+  // @@protoc_insertion_point(field_release:AzRPC.RpcResponseHeader.error_text)
+  return _impl_.error_text_.Release();
+}
+inline void RpcResponseHeader::set_allocated_error_text(std::string* error_text) {
+  if (error_text != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.error_text_.SetAllocated(error_text, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.error_text_.IsDefault()) {
+    _impl_.error_text_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:AzRPC.RpcResponseHeader.error_text)
+}
+
+// uint64 call_id = 4;
+inline void RpcResponseHeader::clear_call_id() {
+  _impl_.call_id_ = uint64_t{0u};
+}
+inline uint64_t RpcResponseHeader::_internal_call_id() const {
+  return _impl_.call_id_;
+}
+inline uint64_t RpcResponseHeader::call_id() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.call_id)
+  return _internal_call_id();
+}
+inline void RpcResponseHeader::_internal_set_call_id(uint64_t value) {
+  
+  _impl_.call_id_ = value;
+}
+inline void RpcResponseHeader::set_call_id(uint64_t value) {
+  _internal_set_call_id(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.call_id)
+}
+
+// .AzRPC.CompressType compress_type = 5;
+inline void RpcResponseHeader::clear_compress_type() {
+  _impl_.compress_type_ = 0;
+}
+inline ::AzRPC::CompressType RpcResponseHeader::_internal_compress_type() const {
+  return static_cast< ::AzRPC::CompressType >(_impl_.compress_type_);
+}
+inline ::AzRPC::CompressType RpcResponseHeader::compress_type() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.compress_type)
+  return _internal_compress_type();
+}
+inline void RpcResponseHeader::_internal_set_compress_type(::AzRPC::CompressType value) {
+  
+  _impl_.compress_type_ = value;
+}
+inline void RpcResponseHeader::set_compress_type(::AzRPC::CompressType value) {
+  _internal_set_compress_type(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.compress_type)
+}
+
+// uint32 body_raw_size = 6;
+inline void RpcResponseHeader::clear_body_raw_size() {
+  _impl_.body_raw_size_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_body_raw_size() const {
+  return _impl_.body_raw_size_;
+}
+inline uint32_t RpcResponseHeader::body_raw_size() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.body_raw_size)
+  return _internal_body_raw_size();
+}
+inline void RpcResponseHeader::_internal_set_body_raw_size(uint32_t value) {
+  
+  _impl_.body_raw_size_ = value;
+}
+inline void RpcResponseHeader::set_body_raw_size(uint32_t value) {
+  _internal_set_body_raw_size(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.body_raw_size)
+}
+
+// bool checksum = 7;
+inline void RpcResponseHeader::clear_checksum() {
+  _impl_.checksum_ = false;
+}
+inline bool RpcResponseHeader::_internal_checksum() const {
+  return _impl_.checksum_;
+}
+inline bool RpcResponseHeader::checksum() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.checksum)
+  return _internal_checksum();
+}
+inline void RpcResponseHeader::_internal_set_checksum(bool value) {
+  
+  _impl_.checksum_ = value;
+}
+inline void RpcResponseHeader::set_checksum(bool value) {
+  _internal_set_checksum(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.checksum)
+}
+
+// uint32 attachment_size = 8;
+inline void RpcResponseHeader::clear_attachment_size() {
+  _impl_.attachment_size_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_attachment_size() const {
+  return _impl_.attachment_size_;
+}
+inline uint32_t RpcResponseHeader::attachment_size() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.attachment_size)
+  return _internal_attachment_size();
+}
+inline void RpcResponseHeader::_internal_set_attachment_size(uint32_t value) {
+  
+  _impl_.attachment_size_ = value;
+}
+inline void RpcResponseHeader::set_attachment_size(uint32_t value) {
+  _internal_set_attachment_size(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.attachment_size)
+}
+
+// .AzRPC.StreamFrameType stream_type = 9;
+inline void RpcResponseHeader::clear_stream_type() {
+  _impl_.stream_type_ = 0;
+}
+inline ::AzRPC::StreamFrameType RpcResponseHeader::_internal_stream_type() const {
+  return static_cast< ::AzRPC::StreamFrameType >(_impl_.stream_type_);
+}
+inline ::AzRPC::StreamFrameType RpcResponseHeader::stream_type() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.stream_type)
+  return _internal_stream_type();
+}
+inline void RpcResponseHeader::_internal_set_stream_type(::AzRPC::StreamFrameType value) {
+  
+  _impl_.stream_type_ = value;
+}
+inline void RpcResponseHeader::set_stream_type(::AzRPC::StreamFrameType value) {
+  _internal_set_stream_type(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.stream_type)
+}
+
+// uint32 stream_credits = 10;
+inline void RpcResponseHeader::clear_stream_credits() {
+  _impl_.stream_credits_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_stream_credits() const {
+  return _impl_.stream_credits_;
+}
+inline uint32_t RpcResponseHeader::stream_credits() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.stream_credits)
+  return _internal_stream_credits();
+}
+inline void RpcResponseHeader::_internal_set_stream_credits(uint32_t value) {
+  
+  _impl_.stream_credits_ = value;
+}
+inline void RpcResponseHeader::set_stream_credits(uint32_t value) {
+  _internal_set_stream_credits(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.stream_credits)
+}
+
+// uint32 batch_count = 11;
+inline void RpcResponseHeader::clear_batch_count() {
+  _impl_.batch_count_ = 0u;
+}
+inline uint32_t RpcResponseHeader::_internal_batch_count() const {
+  return _impl_.batch_count_;
+}
+inline uint32_t RpcResponseHeader::batch_count() const {
+  // @@protoc_insertion_point(field_get:AzRPC.RpcResponseHeader.batch_count)
+  return _internal_batch_count();
+}
+inline void RpcResponseHeader::_internal_set_batch_count(uint32_t value) {
+  
+  _impl_.batch_count_ = value;
+}
+inline void RpcResponseHeader::set_batch_count(uint32_t value) {
+  _internal_set_batch_count(value);
+  // @@protoc_insertion_point(field_set:AzRPC.RpcResponseHeader.batch_count)
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
 }  // namespace AzRPC
 
+PROTOBUF_NAMESPACE_OPEN
+
+template <> struct is_proto_enum< ::AzRPC::CompressType> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::AzRPC::CompressType>() {
+  return ::AzRPC::CompressType_descriptor();
+}
+template <> struct is_proto_enum< ::AzRPC::StreamFrameType> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::AzRPC::StreamFrameType>() {
+  return ::AzRPC::StreamFrameType_descriptor();
+}
+template <> struct is_proto_enum< ::AzRPC::Priority> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::AzRPC::Priority>() {
+  return ::AzRPC::Priority_descriptor();
+}
+template <> struct is_proto_enum< ::AzRPC::ErrorCode> : ::std::true_type {};
+template <>
+inline const EnumDescriptor* GetEnumDescriptor< ::AzRPC::ErrorCode>() {
+  return ::AzRPC::ErrorCode_descriptor();
+}
+
+PROTOBUF_NAMESPACE_CLOSE
+
 // @@protoc_insertion_point(global_scope)
 
 #include <google/protobuf/port_undef.inc>
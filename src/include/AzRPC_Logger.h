@@ -1,14 +1,92 @@
 #ifndef AzRPC_LOG_H
 #define AzRPC_LOG_H
 #include <glog/logging.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 
+// 日志级别
+enum AzRPC_LogLevel {
+    AzRPC_LOG_DEBUG = 0,
+    AzRPC_LOG_INFO = 1,
+    AzRPC_LOG_WARNING = 2,
+    AzRPC_LOG_ERROR = 3,
+};
+
+// 编译期的最低日志级别, 低于该级别的AZRPC_LOG_*调用会被编译器整体删除
+// 可以通过 -DAZRPC_LOG_MIN_LEVEL=0 打开DEBUG日志
+#ifndef AZRPC_LOG_MIN_LEVEL
+#define AZRPC_LOG_MIN_LEVEL 1
+#endif
+
+// 异步日志后端
+// 每个线程写自己的无锁环形缓冲区(单生产者单消费者), 后台线程定期把所有缓冲区的日志批量写入文件或标准错误
+// 业务线程只做一次格式化和内存拷贝, 不会因为IO阻塞; 缓冲区写满时丢弃日志并计数, 而不是等待
+class AzRPC_AsyncLogging {
+public:
+    // 格式化一条日志并放入当前线程的缓冲区
+    static void Append(int level, const char* file, int line, const char* fmt, ...) __attribute__((format(printf, 4, 5)));
+    // 阻塞直到调用前写入的日志全部落盘
+    static void Flush();
+
+    // 运行期的最低日志级别(默认取配置项log_level, 否则为INFO)
+    static bool Enabled(int level) { return level >= s_level.load(std::memory_order_relaxed); }
+    static void SetLevel(int level) { s_level.store(level, std::memory_order_relaxed); }
+
+    // 因缓冲区满而被丢弃的日志条数
+    static uint64_t Dropped();
+
+private:
+    static std::atomic<int> s_level;
+    AzRPC_AsyncLogging() = delete;
+};
+
+// 日志限流器: 每秒最多放行rate条, 多出的计数并在下一次放行时一并报告
+class AzRPC_LogRateLimiter {
+public:
+    explicit AzRPC_LogRateLimiter(uint32_t rate): m_rate(rate), m_second(0), m_count(0), m_suppressed(0) {}
+    // 返回true表示可以输出, suppressed返回自上次放行以来被压制的条数
+    bool Allow(uint64_t* suppressed);
+private:
+    uint32_t m_rate;
+    std::atomic<int64_t> m_second;
+    std::atomic<uint32_t> m_count;
+    std::atomic<uint64_t> m_suppressed;
+};
+
+#define AZRPC_LOG(level, fmt, ...) \
+    do { \
+        if ((level) >= AZRPC_LOG_MIN_LEVEL && AzRPC_AsyncLogging::Enabled(level)) { \
+            AzRPC_AsyncLogging::Append((level), __FILE__, __LINE__, fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define AZRPC_LOG_DEBUG(fmt, ...) AZRPC_LOG(AzRPC_LOG_DEBUG, fmt, ##__VA_ARGS__)
+#define AZRPC_LOG_INFO(fmt, ...) AZRPC_LOG(AzRPC_LOG_INFO, fmt, ##__VA_ARGS__)
+#define AZRPC_LOG_WARNING(fmt, ...) AZRPC_LOG(AzRPC_LOG_WARNING, fmt, ##__VA_ARGS__)
+#define AZRPC_LOG_ERROR(fmt, ...) AZRPC_LOG(AzRPC_LOG_ERROR, fmt, ##__VA_ARGS__)
+
+// 限流的错误日志, 每个调用点每秒最多输出rate条, 避免故障时日志本身拖垮服务
+#define AZRPC_LOG_ERROR_RATELIMIT(rate, fmt, ...) \
+    do { \
+        static AzRPC_LogRateLimiter azrpc_limiter_(rate); \
+        uint64_t azrpc_suppressed_ = 0; \
+        if (azrpc_limiter_.Allow(&azrpc_suppressed_)) { \
+            if (azrpc_suppressed_ > 0) { \
+                AZRPC_LOG_ERROR("(%llu similar messages suppressed) " fmt, (unsigned long long)azrpc_suppressed_, ##__VA_ARGS__); \
+            } \
+            else { \
+                AZRPC_LOG_ERROR(fmt, ##__VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
 class AzRPC_Logger {
 private:
     // 禁用拷贝构造函数和重载赋值函数
     AzRPC_Logger(const AzRPC_Logger&) = delete;
     AzRPC_Logger& operator=(const AzRPC_Logger&) = delete;
-    
+
 public:
     // 构造函数自动初始化glog
     explicit AzRPC_Logger(const char* argv) {
@@ -18,29 +96,31 @@ public:
     }
 
     ~AzRPC_Logger() {
-        // 关闭logger
+        // 关闭logger前把异步日志写完
+        AzRPC_AsyncLogging::Flush();
         google::ShutdownGoogleLogging();
     }
 
     // 提供静态日志
     static void Info(const std::string& message) {
-        LOG(INFO) << message;
+        AZRPC_LOG_INFO("%s", message.c_str());
     }
 
     // 提供静态警告
     static void Warning(const std::string& message) {
-        LOG(WARNING) << message;
+        AZRPC_LOG_WARNING("%s", message.c_str());
     }
 
     // 提供静态错误
     static void ERROR(const std::string& message) {
-        LOG(ERROR) << message;
+        AZRPC_LOG_ERROR("%s", message.c_str());
     }
 
-    // 提供静态重要错误
+    // 提供静态重要错误, 进程即将退出, 先把异步日志写完再同步输出
     static void Fatal(const std::string& message) {
+        AzRPC_AsyncLogging::Flush();
         LOG(FATAL) << message;
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,24 @@
+#ifndef _AzRPC_Metrics_H_
+#define _AzRPC_Metrics_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// 进程内的计数器, 按名字注册, 用于观察缓存命中、请求被拒绝等事件
+// 计数器创建后不会删除, 调用方应保存Counter()返回的引用, 热路径上不再按名字查找
+class AzRPC_Metrics {
+public:
+    // 返回名字对应的计数器, 第一次使用时创建
+    static std::atomic<uint64_t>& Counter(const std::string& name);
+    // 所有计数器的当前值, 按名字排序
+    static std::map<std::string, uint64_t> Snapshot();
+    // 每行一个"名字 值", 便于写日志或者由监控抓取
+    static std::string Dump();
+
+private:
+    AzRPC_Metrics() = delete;
+};
+
+#endif
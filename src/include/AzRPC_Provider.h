@@ -3,37 +3,218 @@
 
 #include <google/protobuf/service.h>
 #include "ZooKeeperUtil.h"
+#include "AzRPC_Controller.h"
+#include "AzRPC_Trace.h"
+#include "AzRPC_Header.pb.h"
+#include "AzRPC_UnixAcceptor.h"
+#include "AzRPC_ShmTransport.h"
+#include "AzRPC_Stream.h"
+#include "AzRPC_Dispatcher.h"
+#include "AzRPC_Scheduler.h"
+#include "AzRPC_Bulkhead.h"
 #include <muduo/net/TcpServer.h>
 #include <muduo/net/EventLoop.h>
+#include <muduo/net/EventLoopThread.h>
 #include <muduo/net/InetAddress.h> 
 #include <muduo/net/TcpConnection.h>
 #include <google/protobuf/descriptor.h> 
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 class AzRPC_Provider {
 public:
+    // 发布服务; service为protoc-gen-azrpc生成的AzRPC_Dispatcher时, 请求按方法编号直接分发, 流式方法自动注册
     void NotifyService(google::protobuf::Service* service);
 
+    // 流式方法的处理函数, 在独立的线程中执行, 返回时流自动结束
+    typedef std::function<void(AzRPC_ServerStream* stream)> StreamHandler;
+    // 把已发布服务中的一个方法注册为流式方法, 调用方通过AzRPC_Channel::OpenStream调用它
+    // 方法在proto中通常声明为stream, protobuf生成的普通接口不会被调用; 需要先调用NotifyService
+    void NotifyStreamMethod(const std::string& service_name, const std::string& method_name, StreamHandler handler);
+
     // 启动RPC服务结点, 提供RPC远程调用服务
     void Run();
+    // 停止服务, 可以在其他线程调用
+    void Stop();
+
+    // 服务端响应缓存的失效接口, 业务方法在数据变化后调用, 作用于进程内所有AzRPC_Provider
+    // 删除一个请求的缓存响应
+    static void InvalidateCache(const std::string& service_name, const std::string& method_name, const google::protobuf::Message& request);
+    // 按前缀删除: method_name为空时删除整个服务, 否则删除该方法中序列化后的请求参数以request_prefix开头的项
+    static void InvalidateCachePrefix(const std::string& service_name, const std::string& method_name = "", const std::string& request_prefix = "");
+
+    // 根据服务名和方法名查找已注册的服务对象和方法描述, 返回OK、SERVICE_NOT_FOUND或METHOD_NOT_FOUND
+    AzRPC::ErrorCode FindMethod(const std::string& service_name, const std::string& method_name, google::protobuf::Service** service, const google::protobuf::MethodDescriptor** method) const;
 
     ~AzRPC_Provider();
 
 private:
     muduo::net::EventLoop event_loop;
+    std::shared_ptr<muduo::net::TcpServer> server;
+
+    // 配置rpcserver_reuseport=true时不使用server, 每个IO线程各有一个TcpServer, 用SO_REUSEPORT监听同一端口
+    // 由内核把新连接分散到各线程, 大量客户端同时重连时accept不再集中在event_loop一个线程中
+    // 每个TcpServer不再创建自己的IO线程, 接受连接的线程同时负责该连接的收发
+    struct ReusePortAcceptor {
+        std::unique_ptr<muduo::net::EventLoopThread> thread;
+        std::shared_ptr<muduo::net::TcpServer> server;     // 只能在thread的事件循环中创建和销毁
+    };
+    std::vector<ReusePortAcceptor> reuseport_acceptors;
+    size_t next_reuseport_acceptor = 0;
+
+    // 连接输出缓冲区的高水位, 超过时暂停读取该连接的请求, 缓冲区发送完后恢复
+    // 读得慢的调用方不会让服务端为它无限缓存响应
+    size_t output_high_water = 4 * 1024 * 1024;
+
+    // 配置了rpcserver_unix_path时, 同时在Unix域套接字上监听
+    // 接受的连接由基础事件循环持有, 分配到TcpServer的IO线程上收发
+    std::unique_ptr<AzRPC_UnixAcceptor> unix_acceptor;
+    std::map<std::string, muduo::net::TcpConnectionPtr> unix_connections;
+    int next_unix_conn_id = 1;
 
     struct ServiceInfo {
         google::protobuf::Service* service;
+        AzRPC_Dispatcher* dispatcher = nullptr;    // service由protoc-gen-azrpc生成时不为空
         std::unordered_map<std::string, const google::protobuf::MethodDescriptor*> method_map;
+        std::unordered_map<std::string, StreamHandler> stream_handlers;
+        std::unordered_map<std::string, std::shared_ptr<AzRPC_Bulkhead>> bulkheads;   // 配置了并发上限的方法, Run时创建
     };
     //保存服务对象和rpc方法
     std::unordered_map<std::string, ServiceInfo> service_map;
+    AzRPC::ErrorCode FindMethod(const std::string& service_name, const std::string& method_name, const ServiceInfo** service_info, const google::protobuf::MethodDescriptor** method) const;
+
+    // 通过共享内存段接入的调用方, 由协商时使用的连接决定生命周期, 连接断开时停止
+    // 段的请求环由专门的线程读取和分发, 响应可能来自多个线程, 写响应环时需要加锁
+    // 服务线程不在断开连接的IO线程中等待, 关闭段后自行退出; 析构时等待所有服务线程退出
+    struct ShmSession {
+        std::unique_ptr<AzRPC_ShmSegment> segment;
+        std::mutex write_mtx;
+    };
+    typedef std::shared_ptr<ShmSession> ShmSessionPtr;
+    std::mutex shm_mtx;
+    std::condition_variable shm_cv;
+    std::map<std::string, ShmSessionPtr> shm_sessions;      // 连接名 -> 会话
+    size_t shm_threads = 0;                                 // 还在运行的服务线程数
+
+    struct BatchContext;
+    typedef std::shared_ptr<BatchContext> BatchContextPtr;
+
+    // 响应的发送目标: 连接, 或者共享内存会话的响应环; call_id为请求中的调用编号, 随响应带回
+    // checksum与请求一致, 请求带有校验和时响应也带上
+    // 批量调用中的子请求发往batch, 响应帧暂存在批中的batch_index位置, 全部完成后合成一帧发出
+    struct ReplyTarget {
+        muduo::net::TcpConnectionPtr connection;
+        ShmSessionPtr shm;
+        uint64_t call_id;
+        bool checksum;
+        BatchContextPtr batch;
+        uint32_t batch_index;
+        void Send(const std::string& frame) const;
+        // 依次发送frame、附件的各块和trailer, 在连接所属的IO线程中调用时附件不拷贝
+        void Send(const std::string& frame, const AzRPC_Attachment& attachment, const std::string& trailer) const;
+    };
+
+    // 一次RPC调用在服务端的上下文, 从解析完请求一直存活到响应发送完毕
+    struct CallContext {
+        ReplyTarget target;
+        google::protobuf::Message* request;
+        google::protobuf::Message* response;
+        AzRPC_Controller controller;
+        AzRPC::CompressType response_compress;     // 调用方选择的压缩算法, 用于压缩响应
+        std::string flight_key;     // 开启了请求合并时为合并的键, 响应同时发给期间合并进来的请求
+        std::string cache_key;      // 开启了响应缓存时为缓存的键, 成功的响应放入缓存
+        int64_t cache_ttl_ms;
+        uint64_t cache_generation;  // 开始处理时的失效代数, 处理期间有过失效时响应不放入缓存
+        AzRPC_SpanRecord span;      // 仅在请求被采样时填充
+        int64_t stage_us;           // 上一个阶段结束的时间点, 用于计算各阶段耗时
+        AzRPC_Bulkhead* bulkhead = nullptr;     // 方法配置了并发上限时占用的名额, 发出响应后归还
+    };
+
+    // 一次批量调用, 子请求分到多个IO线程并行处理, 由最后完成的子请求发送合并后的响应
+    struct BatchContext {
+        ReplyTarget target;
+        AzRPC::CompressType response_compress;
+        std::string body;                   // 批量请求的请求参数, 子请求的参数指向其中, 处理完之前一直有效
+        std::vector<std::pair<AzRPC::RpcHeader, size_t>> requests;     // 子请求的header和请求参数在body中的偏移
+        std::mutex mtx;
+        std::vector<std::string> frames;    // 子响应帧, 按子请求的顺序
+        size_t remaining;
+        void Complete(uint32_t index, std::string frame);
+    };
+    // 子请求的分片在这些IO线程中执行, Run时确定; 不在事件循环中等待并发名额的请求也轮流分给它们
+    std::vector<muduo::net::EventLoop*> io_loops;
+    std::atomic<size_t> next_batch_loop{0};
+
+    // 配置了rpcserver_workers时, 请求不在IO线程中处理, 按优先级类别和租户排队, 由调度器的处理线程执行
+    // 排队的请求拷贝出请求参数, IO线程不被业务方法阻塞, 可以继续读取和排队高优先级的请求
+    struct QueuedRequest {
+        ReplyTarget target;
+        AzRPC::RpcHeader header;
+        std::string args;
+        AzRPC_Attachment attachment;
+        muduo::Timestamp receive_time;
+        int64_t decode_start_us;
+        int64_t submit_us;
+    };
+    std::unique_ptr<AzRPC_Scheduler> scheduler;
+
+    // 配置了rpcserver_singleflight的方法, 相同的请求正在处理时不再执行业务方法, 等待它的响应
+    struct FlightWaiter {
+        ReplyTarget target;
+        AzRPC::CompressType response_compress;
+    };
+    std::mutex flight_mtx;
+    std::unordered_map<std::string, std::vector<FlightWaiter>> flights;   // 合并的键 -> 等待者
+
+    std::vector<FlightWaiter> LeaveFlight(const std::string& key);
+    static bool EncodeRpcResponse(const ReplyTarget& target, AzRPC::CompressType response_compress, const std::string& body, const AzRPC_Attachment& attachment, std::string* frame, std::string* trailer, uint32_t batch_count = 0);
+
+    void StartReusePort(const muduo::net::InetAddress& address, int thread_num);
+    void StopReusePort();
+    muduo::net::EventLoop* NextIoLoop();
 
     void OnConnection(const muduo::net::TcpConnectionPtr& connection);
+    void OnHighWaterMark(const muduo::net::TcpConnectionPtr& connection, size_t output_size);
+    void OnWriteComplete(const muduo::net::TcpConnectionPtr& connection);
+    void OnUnixConnection(int sockfd);
+    void RemoveUnixConnection(const muduo::net::TcpConnectionPtr& connection);
+    void RemoveUnixConnectionInLoop(const muduo::net::TcpConnectionPtr& connection);
     void OnMessage(const muduo::net::TcpConnectionPtr& connection, muduo::net::Buffer* buffer, muduo::Timestamp receive_time);
-    void SendRpcResponse(const muduo::net::TcpConnectionPtr& conn, google::protobuf::Message* response);
+    void HandleRequest(const ReplyTarget& target, const AzRPC::RpcHeader& header, const char* args_data, AzRPC_Attachment&& attachment, muduo::Timestamp receive_time, int64_t decode_start_us);
+    // admitted为true时请求已经在方法的舱壁中等到了名额
+    void ProcessRequest(const ReplyTarget& target, const AzRPC::RpcHeader& header, const char* args_data, AzRPC_Attachment&& attachment, muduo::Timestamp receive_time, int64_t decode_start_us, bool admitted = false);
+    static std::shared_ptr<QueuedRequest> MakeQueued(const ReplyTarget& target, const AzRPC::RpcHeader& header, const char* args_data, AzRPC_Attachment&& attachment, muduo::Timestamp receive_time, int64_t decode_start_us);
+    void RunQueued(const std::shared_ptr<QueuedRequest>& queued, bool admitted);
+    void HandleBatch(const ReplyTarget& target, const AzRPC::RpcHeader& header, const char* args_data, muduo::Timestamp receive_time, int64_t decode_start_us);
+    void RunBatch(const BatchContextPtr& batch, size_t begin, size_t end, muduo::Timestamp receive_time, int64_t decode_start_us);
+    void SendRpcResponse(CallContext* context);
+    void SendRpcError(const ReplyTarget& target, AzRPC::ErrorCode error_code, const std::string& error_text);
+
+    // 进行中的流式调用, 处理函数的线程结束时删除; 连接断开时关闭其上的所有流
+    typedef std::shared_ptr<AzRPC_ServerStream> ServerStreamPtr;
+    std::mutex stream_mtx;
+    std::condition_variable stream_cv;
+    std::map<std::pair<std::string, uint64_t>, ServerStreamPtr> streams;     // (连接名, call_id) -> 流
+    // 每个流的处理函数占用一个线程, 同时进行的流数按rpcserver_max_streams和rpcserver_max_streams_per_connection限制, 超过时回复OVERLOADED
+    size_t max_streams = 1024;
+    size_t max_streams_per_connection = 64;
+
+    void HandleStreamFrame(const muduo::net::TcpConnectionPtr& connection, const AzRPC::RpcHeader& header, const char* body);
+    void OpenStream(const muduo::net::TcpConnectionPtr& connection, const AzRPC::RpcHeader& header);
+    void CloseStreams(const muduo::net::TcpConnectionPtr& connection);
+
+    static bool IsLocalConnection(const muduo::net::TcpConnectionPtr& connection);
+    void AttachShm(const muduo::net::TcpConnectionPtr& connection, const std::string& name);
+    void DetachShm(const muduo::net::TcpConnectionPtr& connection);
+    void ServeShm(ShmSessionPtr session);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef _AzRPC_Registry_H_
+#define _AzRPC_Registry_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// 服务注册中心接口, 路径格式与ZooKeeper一致: /service_name/method_name, 节点数据为"ip:port"
+// 实现: ZkClient(ZooKeeper), AzRPC_MemoryRegistry(进程内), AzRPC_FileRegistry(静态文件)
+class AzRPC_Registry {
+public:
+    // 节点被创建、删除或数据变化时触发, 与ZooKeeper的watch一样只触发一次
+    typedef std::function<void(const std::string& path)> WatchCallback;
+
+    virtual ~AzRPC_Registry() {}
+
+    // 连接注册中心, 失败返回false
+    virtual bool Start() = 0;
+    // 创建节点, ephemeral为true时节点随当前会话(注册中心对象)的结束而删除
+    virtual bool Create(const std::string& path, const std::string& data, bool ephemeral) = 0;
+    // 获取节点数据, 节点不存在时返回空字符串
+    virtual std::string GetData(const std::string& path) = 0;
+    virtual bool Exists(const std::string& path) = 0;
+    // 监听节点的下一次变化
+    virtual bool Watch(const std::string& path, const WatchCallback& callback) = 0;
+
+    // 根据配置项registry创建注册中心: zookeeper(默认) | memory | file
+    static std::unique_ptr<AzRPC_Registry> NewFromConfig();
+};
+
+// 进程内的注册中心, 同一进程内的所有实例共享一棵节点树
+// 每个实例是一个会话, 析构时删除它创建的临时节点; 用于测试、压测以及不依赖ZooKeeper的单机部署
+class AzRPC_MemoryRegistry: public AzRPC_Registry {
+public:
+    AzRPC_MemoryRegistry();
+    ~AzRPC_MemoryRegistry() override;
+
+    bool Start() override;
+    bool Create(const std::string& path, const std::string& data, bool ephemeral) override;
+    std::string GetData(const std::string& path) override;
+    bool Exists(const std::string& path) override;
+    bool Watch(const std::string& path, const WatchCallback& callback) override;
+
+    // 修改节点数据并触发watch
+    bool SetData(const std::string& path, const std::string& data);
+    bool Delete(const std::string& path);
+
+private:
+    uint64_t m_session;     // 会话id, 用于标记临时节点的所有者
+};
+
+// 从静态文件读取服务地址, 每行一个节点: /UserServiceRpc/Login=127.0.0.1:8000
+// 也可以只写服务: /UserServiceRpc=127.0.0.1:8000, 对该服务下的所有方法生效
+// 注册操作不会修改文件, 直接返回成功; 不支持watch
+class AzRPC_FileRegistry: public AzRPC_Registry {
+public:
+    explicit AzRPC_FileRegistry(const std::string& file);
+
+    bool Start() override;
+    bool Create(const std::string& path, const std::string& data, bool ephemeral) override;
+    std::string GetData(const std::string& path) override;
+    bool Exists(const std::string& path) override;
+    bool Watch(const std::string& path, const WatchCallback& callback) override;
+
+private:
+    std::string m_file;
+    std::unordered_map<std::string, std::string> m_nodes;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef _AzRPC_Scheduler_H_
+#define _AzRPC_Scheduler_H_
+
+#include "AzRPC_Header.pb.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 服务端的请求调度器: 请求按优先级类别排队, 由固定数量的处理线程执行
+// 类别之间严格优先, CRITICAL > HIGH > NORMAL > LOW, 低类别只在高类别的队列都为空时执行
+// 同一类别中按流(租户或方法)加权轮转: 每个有请求排队的流轮到时最多连续执行权重个请求, 一个流涌入大量请求只会让它自己排队变长
+// 排队总数达到上限时, 丢弃比新请求类别低的最低类别中排队最多的流的最新请求; 没有更低类别的请求时拒绝新请求
+class AzRPC_Scheduler {
+public:
+    typedef std::function<void()> Task;
+
+    AzRPC_Scheduler(size_t worker_num, size_t queue_limit);
+    ~AzRPC_Scheduler();
+
+    // 停止处理线程, 等待正在执行的任务返回, 还在排队的任务不再执行; 之后的Submit返回false, Resume的任务被丢弃
+    // 可以重复调用, 不能在处理线程中调用
+    void Stop();
+
+    // 提交一个请求, run在处理线程中执行; 请求之后因过载被丢弃时, 在挤掉它的Submit调用中执行shed
+    // 返回false表示新请求被拒绝, run和shed都不会执行
+    bool Submit(AzRPC::Priority priority, const std::string& flow, uint32_t weight, Task run, Task shed);
+    // 排在所有类别之前执行, 用于已经排过队、又在方法的舱壁(AzRPC_Bulkhead)中等到名额的请求; 不计入排队上限, 也不会被丢弃
+    void Resume(Task run);
+
+    // 解析配置中的优先级名: low、normal、high、critical
+    static bool ParsePriority(const std::string& name, AzRPC::Priority* priority);
+
+private:
+    // 按执行顺序排列的类别, 下标0最先执行
+    static const int kLevels = 4;
+    static int Level(AzRPC::Priority priority);
+
+    struct Item {
+        Task run;
+        Task shed;
+    };
+    struct Flow {
+        std::string key;
+        uint32_t weight;
+        uint32_t deficit;       // 本轮还可以连续执行的请求数, 为0时轮到下一个流
+        std::deque<Item> items;
+    };
+    struct Queue {
+        std::unordered_map<std::string, Flow> flows;    // 只保存有请求排队的流
+        std::deque<Flow*> active;                       // 轮转顺序, 队首为当前执行的流
+    };
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    Queue m_queues[kLevels];
+    std::deque<Task> m_resumed;
+    size_t m_queued;
+    size_t m_queue_limit;
+    bool m_stop;
+    std::vector<std::thread> m_workers;
+    std::atomic<uint64_t>* m_shed[kLevels];     // 各类别被丢弃或拒绝的请求数
+
+    void Work();
+    bool Pop(Item* item);
+    bool ShedLowest(int level, Item* victim);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef _AzRPC_ShmTransport_H_
+#define _AzRPC_ShmTransport_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+// 同主机调用的共享内存传输
+// 调用方在/dev/shm中创建一个段, 里面有两个单生产者单消费者的字节环: 请求环(调用方->服务端)和响应环(服务端->调用方)
+// 环里传输的仍然是AzRPC_Codec编码的帧, 和TCP字节流一样可以拆分和拼接, 帧比环大时分段写入
+// 数据到达用futex通知, 等待方先自旋一段时间再睡眠, 自旋次数根据最近的等待结果自适应调整
+
+// 协商控制请求使用的服务名和方法名, 请求参数为段的名字
+#define AZRPC_TRANSPORT_SERVICE "AzRPC.Transport"
+#define AZRPC_SHM_ATTACH_METHOD "ShmAttach"
+
+// 共享内存中环的控制块, 生产者和消费者各自写的字段分在不同的缓存行
+struct AzRPC_ShmRingHeader {
+    uint64_t capacity;                          // 数据区大小, 2的幂
+    alignas(64) std::atomic<uint64_t> head;     // 生产者已写入的总字节数
+    std::atomic<uint32_t> data_seq;             // 每次写入后加1, 消费者在它上面futex等待
+    std::atomic<uint32_t> reader_waiting;
+    alignas(64) std::atomic<uint64_t> tail;     // 消费者已读取的总字节数
+    std::atomic<uint32_t> space_seq;            // 每次读取后加1, 环满时生产者在它上面futex等待
+    std::atomic<uint32_t> writer_waiting;
+};
+
+// 环的一端, 不拥有内存, 由AzRPC_ShmSegment创建
+class AzRPC_ShmRing {
+public:
+    AzRPC_ShmRing(): m_header(nullptr), m_data(nullptr), m_capacity(0), m_closed(nullptr), m_spin(0) {}
+    AzRPC_ShmRing(AzRPC_ShmRingHeader* header, char* data, std::atomic<uint32_t>* closed);
+
+    // 写入全部数据, 环满时等待消费者; 段被关闭或控制块已损坏时返回false
+    bool Write(const char* data, size_t len);
+    // 把可读的数据追加到out, 没有数据时最多等待timeout_ms毫秒
+    // 返回读取的字节数, 超时返回0, 段已关闭且没有剩余数据时返回-1
+    // 对端写入的head超出容量时视为段已损坏, 关闭段并返回-1
+    ssize_t Read(std::string* out, int timeout_ms);
+
+    // 唤醒在本环上等待的双方, 关闭段时使用
+    void WakeAll();
+
+private:
+    AzRPC_ShmRingHeader* m_header;
+    char* m_data;
+    uint64_t m_capacity;    // 建立视图时检查过的容量, 不再读取共享内存中可被对端改写的值
+    std::atomic<uint32_t>* m_closed;
+    int m_spin;         // 进入睡眠前的自旋次数, 本进程私有
+
+    bool WaitChange(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiting, int timeout_ms, bool (AzRPC_ShmRing::*ready)() const);
+    bool Readable() const;
+    bool Writable() const;
+    bool Corrupted(uint64_t head, uint64_t tail);
+    void AdjustSpin(bool spun);
+};
+
+// 一个共享内存段, 调用方Create, 服务端Open, 双方都解除映射后内核回收
+class AzRPC_ShmSegment {
+public:
+    ~AzRPC_ShmSegment();
+
+    // 创建段, ring_size为每个环的大小(向上取整为2的幂)
+    static std::unique_ptr<AzRPC_ShmSegment> Create(size_t ring_size);
+    // 打开调用方创建的段, 会检查魔数和版本
+    static std::unique_ptr<AzRPC_ShmSegment> Open(const std::string& name);
+
+    const std::string& Name() const { return m_name; }
+    // 删除/dev/shm中的文件名, 已建立的映射不受影响; 协商结束后调用, 进程异常退出也不会残留
+    void Unlink();
+    // 标记段已关闭并唤醒对端
+    void Close();
+    bool Closed() const;
+
+    AzRPC_ShmRing& Request() { return m_request; }
+    AzRPC_ShmRing& Response() { return m_response; }
+
+private:
+    std::string m_name;
+    void* m_addr;
+    size_t m_size;
+    bool m_linked;
+    AzRPC_ShmRing m_request;
+    AzRPC_ShmRing m_response;
+
+    AzRPC_ShmSegment(): m_addr(nullptr), m_size(0), m_linked(false) {}
+    bool Map(int fd, size_t size);
+    AzRPC_ShmSegment(const AzRPC_ShmSegment&) = delete;
+    AzRPC_ShmSegment& operator=(const AzRPC_ShmSegment&) = delete;
+};
+
+#endif
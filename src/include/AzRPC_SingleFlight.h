@@ -0,0 +1,45 @@
+#ifndef _AzRPC_SingleFlight_H_
+#define _AzRPC_SingleFlight_H_
+
+#include "AzRPC_Attachment.h"
+#include <google/protobuf/message.h>
+#include <google/protobuf/service.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 调用方的请求合并: 同一时刻方法和序列化后的请求参数都相同的调用只发出一次, 其余调用等待它的结果
+// 按方法开启, 依次查找配置项rpc_singleflight.<服务名>.<方法名>、rpc_singleflight.<服务名>、rpc_singleflight, 值为true时开启
+// 只适用于幂等的读方法: 等待者拿到的是发出调用的那一次的结果(包括失败)
+class AzRPC_SingleFlight {
+public:
+    // 一次调用的结果, 交给等待者
+    struct Result {
+        bool failed;
+        std::string error;
+        std::string response;           // 序列化后的响应
+        AzRPC_Attachment attachment;    // 响应附件, 等待者共享其中的块
+    };
+    typedef std::function<void(const Result& result)> Waiter;
+
+    static AzRPC_SingleFlight& Instance();
+    static bool Enabled(const std::string& service_name, const std::string& method_name);
+    // 合并的键: 服务名、方法名和序列化后的请求参数, 请求无法序列化时返回false
+    static bool MakeKey(const std::string& service_name, const std::string& method_name, const google::protobuf::Message& request, std::string* key);
+
+    // 加入key对应的调用: 没有进行中的调用时返回true, 调用方负责发出调用, 结束后必须调用Finish
+    // 否则登记waiter并返回false, waiter在发出调用的线程执行Finish时执行
+    bool Join(const std::string& key, Waiter waiter);
+    // 调用结束, 把结果交给所有等待者; 没有等待者时不序列化响应
+    void Finish(const std::string& key, google::protobuf::RpcController* controller, const google::protobuf::Message* response);
+    // 把结果写入等待者自己的controller和response
+    static void Apply(const Result& result, google::protobuf::RpcController* controller, google::protobuf::Message* response);
+
+private:
+    std::mutex m_mtx;
+    std::unordered_map<std::string, std::vector<Waiter>> m_calls;    // 进行中的调用 -> 等待者
+};
+
+#endif
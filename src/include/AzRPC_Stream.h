@@ -0,0 +1,100 @@
+#ifndef _AzRPC_Stream_H_
+#define _AzRPC_Stream_H_
+
+#include "AzRPC_Header.pb.h"
+#include <google/protobuf/message.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// 流式调用: 一个call_id上双方各自发送任意条消息, 可用于服务端流(分批返回大结果集)、客户端流(上传)以及双向流
+// 流控以消息条数为单位: 接收方告诉发送方自己的窗口, 每消费半个窗口就通过STREAM_CREDIT归还信用, 发送方信用用完时阻塞
+// 窗口由配置项rpc_stream_window决定, 默认64条
+
+// 调用方的流, 由AzRPC_Channel::OpenStream创建, 独占一条连接, 析构时关闭连接(服务端随之结束流)
+// 不是线程安全的, 同一时刻只能在一个线程中使用
+class AzRPC_ClientStream {
+public:
+    AzRPC_ClientStream(int fd, uint64_t call_id, bool checksum);
+    ~AzRPC_ClientStream();
+
+    // 发送STREAM_OPEN, 由AzRPC_Channel调用
+    bool Open(const std::string& service_name, const std::string& method_name);
+
+    // 发送一条消息, 服务端的接收窗口用完时阻塞等待信用; 流已结束或出错时返回false
+    bool Write(const google::protobuf::Message& message);
+    // 告诉服务端不再发送消息
+    bool CloseSend();
+    // 读取服务端的下一条消息, 流正常结束或出错时返回false, 用Failed()区分
+    bool Read(google::protobuf::Message* message);
+
+    bool Failed() const { return m_failed; }
+    const std::string& ErrorText() const { return m_error; }
+
+private:
+    int m_fd;
+    uint64_t m_call_id;
+    bool m_checksum;
+    uint32_t m_window;              // 本端的接收窗口
+    uint32_t m_send_credits;        // 还可以发送的消息条数, 由服务端授予
+    uint32_t m_consumed;            // 上次归还信用后读取的消息条数
+    bool m_send_closed;
+    bool m_finished;                // 服务端已经结束流或者出错
+    bool m_failed;
+    std::string m_error;
+    std::string m_recv_buf;
+    std::deque<std::string> m_inbox;    // 已收到尚未读取的消息
+
+    bool SendFrame(AzRPC::StreamFrameType type, const std::string& body, uint32_t credits, const std::string& service_name, const std::string& method_name);
+    bool ReceiveOne();
+    bool Fail(const std::string& reason);
+};
+
+// 服务端的流, 交给通过AzRPC_Provider::NotifyStreamMethod注册的处理函数
+// 处理函数在独立的线程中执行, 可以阻塞; Read和Write可以分别在两个线程中调用
+class AzRPC_ServerStream {
+public:
+    // 把编码好的帧发给调用方, 可以在任意线程调用
+    typedef std::function<void(const std::string& frame)> SendFunction;
+
+    // send_credits为调用方在STREAM_OPEN中告知的接收窗口
+    AzRPC_ServerStream(uint64_t call_id, bool checksum, uint32_t send_credits, SendFunction send);
+
+    // 读取调用方的下一条消息, 调用方结束发送或连接断开时返回false
+    bool Read(google::protobuf::Message* message);
+    // 发送一条消息, 调用方的接收窗口用完时阻塞; 流已结束或连接断开时返回false
+    bool Write(const google::protobuf::Message& message);
+    // 结束流, error非空时调用方以该错误失败; 处理函数返回时还没有结束的流自动以成功结束
+    void Finish(const std::string& error = "");
+    // 连接已经断开
+    bool Closed() const;
+
+    // 以下由框架调用
+    // 告知调用方本端的接收窗口
+    void Open();
+    // 收到调用方的帧, 在IO线程中调用
+    void OnFrame(const AzRPC::RpcHeader& header, const char* body);
+    // 连接断开, 唤醒阻塞中的Read和Write
+    void Close();
+
+private:
+    mutable std::mutex m_mtx;
+    std::condition_variable m_cv;
+    uint64_t m_call_id;
+    bool m_checksum;
+    uint32_t m_window;
+    uint32_t m_send_credits;
+    uint32_t m_consumed;
+    bool m_remote_end;              // 调用方不再发送消息
+    bool m_closed;
+    bool m_finished;
+    std::deque<std::string> m_inbox;
+    SendFunction m_send;
+
+    void SendFrame(AzRPC::StreamFrameType type, const std::string& body, uint32_t credits, const std::string& error);
+};
+
+#endif
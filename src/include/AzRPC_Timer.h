@@ -0,0 +1,20 @@
+#ifndef _AzRPC_Timer_H_
+#define _AzRPC_Timer_H_
+
+#include <cstdint>
+#include <functional>
+
+// 进程内共享的定时器, 所有定时任务在一个后台线程中按到期时间执行
+// 任务应当很快返回(例如把协程转交给其他线程恢复), 否则会推迟后面到期的任务
+class AzRPC_Timer {
+public:
+    // delay_ms毫秒后执行task, 返回可用于取消的id
+    static uint64_t RunAfter(int64_t delay_ms, std::function<void()> task);
+    // 取消还没有执行的任务, 任务已经执行或正在执行时返回false
+    static bool Cancel(uint64_t id);
+
+private:
+    AzRPC_Timer() = delete;
+};
+
+#endif
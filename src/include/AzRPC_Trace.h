@@ -0,0 +1,73 @@
+#ifndef _AzRPC_Trace_H_
+#define _AzRPC_Trace_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 调用链上下文, 随RpcHeader在多跳调用之间传播
+struct AzRPC_TraceContext {
+    static const uint32_t kSampled = 0x1;   // trace_flags中的采样标记
+
+    uint64_t trace_id = 0;          // 整条调用链的唯一标识
+    uint64_t span_id = 0;           // 当前这一跳的唯一标识
+    uint64_t parent_span_id = 0;    // 上一跳的span_id, 根span为0
+    uint32_t flags = 0;
+
+    bool Valid() const { return trace_id != 0; }
+    bool Sampled() const { return (flags & kSampled) != 0; }
+};
+
+// span记录, 定长POD结构, 直接以二进制形式写入环形缓冲区和文件
+struct AzRPC_SpanRecord {
+    enum Kind : uint32_t { kClient = 1, kServer = 2 };
+
+    uint64_t trace_id;
+    uint64_t span_id;
+    uint64_t parent_span_id;
+    int64_t start_us;           // span开始时间(墙上时钟, 微秒), 用于跨主机对齐
+    uint32_t kind;
+    uint32_t queue_us;          // 数据到达到开始处理的等待时间
+    uint32_t decode_us;         // 解析header和请求参数
+    uint32_t handler_us;        // 业务方法执行时间(客户端span中为整个调用耗时)
+    uint32_t encode_us;         // 序列化响应
+    uint32_t send_us;           // 发送响应
+    char method[40];            // "service.method", 超长时截断
+};
+
+// 追踪器, 负责采样决策、span id生成以及span的导出(单例, 静态接口)
+class AzRPC_Tracer {
+public:
+    // 当前线程的追踪上下文, 服务端在执行业务方法期间会设置它, 以便下游调用自动继承
+    static AzRPC_TraceContext& Current();
+
+    // 按配置的采样率开启一条新的调用链, 未采样时返回空上下文
+    static AzRPC_TraceContext NewRoot();
+    // 在parent所在的调用链上派生一个子span
+    static AzRPC_TraceContext NewChild(const AzRPC_TraceContext& parent);
+
+    // 将span写入环形缓冲区, 配置了trace_file时由后台线程批量落盘
+    static void Export(const AzRPC_SpanRecord& record);
+    // 读取环形缓冲区中当前保留的span, 返回读取到的条数
+    static size_t Snapshot(std::vector<AzRPC_SpanRecord>* records);
+
+    static void FillMethod(AzRPC_SpanRecord* record, const std::string& service_name, const std::string& method_name);
+    static int64_t NowMicros();
+
+private:
+    AzRPC_Tracer() = delete;
+};
+
+// 在作用域内替换当前线程的追踪上下文, 退出作用域时恢复
+class AzRPC_TraceScope {
+public:
+    explicit AzRPC_TraceScope(const AzRPC_TraceContext& context);
+    ~AzRPC_TraceScope();
+private:
+    AzRPC_TraceContext m_saved;
+    AzRPC_TraceScope(const AzRPC_TraceScope&) = delete;
+    AzRPC_TraceScope& operator=(const AzRPC_TraceScope&) = delete;
+};
+
+#endif
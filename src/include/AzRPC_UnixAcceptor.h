@@ -0,0 +1,38 @@
+#ifndef _AzRPC_UnixAcceptor_H_
+#define _AzRPC_UnixAcceptor_H_
+
+#include <muduo/net/EventLoop.h>
+#include <muduo/net/Channel.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Unix域流式套接字的监听器, 挂在muduo的事件循环上
+// muduo的TcpServer只支持IP地址, 同主机的调用方通过它绕过回环TCP协议栈
+// 接受的连接交给回调, 由上层包装成muduo::net::TcpConnection, 后续收发与TCP连接完全相同
+class AzRPC_UnixAcceptor {
+public:
+    typedef std::function<void(int sockfd)> NewConnectionCallback;
+
+    AzRPC_UnixAcceptor(muduo::net::EventLoop* loop, const std::string& path);
+    ~AzRPC_UnixAcceptor();
+
+    // 创建套接字文件并开始监听, 已存在的同名文件会被删除
+    bool Listen();
+    void SetNewConnectionCallback(const NewConnectionCallback& callback) { m_callback = callback; }
+    const std::string& Path() const { return m_path; }
+
+private:
+    muduo::net::EventLoop* m_loop;
+    std::string m_path;
+    int m_listenfd;
+    std::unique_ptr<muduo::net::Channel> m_channel;
+    NewConnectionCallback m_callback;
+
+    void HandleRead();
+
+    AzRPC_UnixAcceptor(const AzRPC_UnixAcceptor&) = delete;
+    AzRPC_UnixAcceptor& operator=(const AzRPC_UnixAcceptor&) = delete;
+};
+
+#endif
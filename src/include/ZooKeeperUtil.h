@@ -6,17 +6,25 @@
 #include <mutex>
 #include <future>
 #include <condition_variable>
+#include "AzRPC_Registry.h"
 
-// 封装zk客户端
-class ZkClient {
+// 封装zk客户端, 作为注册中心的ZooKeeper实现
+class ZkClient: public AzRPC_Registry {
 public:
     ZkClient();
-    ~ZkClient();
+    ~ZkClient() override;
 
-    void Start();  // 启动 ZooKeeper 客户端
+    // 启动 ZooKeeper 客户端, 在zookeeper_timeout_ms(默认30000)内未连上时返回false
+    bool Start() override;
     bool CreateAsync(const char* path, const char* data, int datalen, int state);  // 异步创建节点
     std::string GetDataAsync(const char* path);  // 异步获取节点数据
-    bool ExistsAsync(const char* path);  // 异步检查节点是否存在
+    bool ExistsAsync(const char* path);  // 异步检查节点是否存在, 不存在时创建
+
+    // 注册中心接口
+    bool Create(const std::string& path, const std::string& data, bool ephemeral) override;
+    std::string GetData(const std::string& path) override;
+    bool Exists(const std::string& path) override;
+    bool Watch(const std::string& path, const WatchCallback& callback) override;
 
 private:
     zhandle_t* m_zhandle;  // ZooKeeper 客户端句柄
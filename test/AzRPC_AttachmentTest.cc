@@ -0,0 +1,74 @@
+#include "AzRPC_Attachment.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Crc32c.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+// AppendRef引用外部内存不拷贝, 附件持有owner, 附件释放后owner才释放
+TEST(AttachmentTest, AppendRefSharesMemory) {
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>("referenced bytes");
+    std::weak_ptr<std::string> weak = buffer;
+    {
+        AzRPC_Attachment attachment;
+        attachment.AppendRef(buffer->data(), buffer->size(), buffer);
+        buffer.reset();
+        ASSERT_FALSE(weak.expired());
+        ASSERT_EQ(attachment.Blocks().size(), 1u);
+        EXPECT_EQ(attachment.Blocks()[0].data, weak.lock()->data());
+
+        AzRPC_Attachment copy;
+        copy.Append(attachment);
+        EXPECT_EQ(copy.Blocks()[0].data, attachment.Blocks()[0].data);
+        attachment.Clear();
+        EXPECT_TRUE(attachment.empty());
+        EXPECT_FALSE(weak.expired());
+        EXPECT_EQ(copy.ToString(), "referenced bytes");
+    }
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(AttachmentTest, BlocksKeepOrder) {
+    AzRPC_Attachment attachment;
+    attachment.Append("head-", 5);
+    attachment.Append(std::string("middle-"));
+    attachment.Append("", 0);
+    static const char kTail[] = "tail";
+    attachment.AppendRef(kTail, 4, nullptr);
+    EXPECT_EQ(attachment.Blocks().size(), 3u);
+    EXPECT_EQ(attachment.size(), 16u);
+    EXPECT_EQ(attachment.ToString(), "head-middle-tail");
+
+    std::vector<struct iovec> iov;
+    attachment.AppendIovec(&iov);
+    ASSERT_EQ(iov.size(), 3u);
+    EXPECT_EQ(iov[2].iov_base, kTail);
+    EXPECT_EQ(attachment.ExtendCrc32c(0), AzRPC_Crc32c::Value("head-middle-tail", 16));
+}
+
+// 分成out、附件和trailer三段编码的结果与整帧编码相同, 解码后附件紧跟在请求参数之后
+TEST(AttachmentTest, CodecCarriesAttachment) {
+    AzRPC_Attachment attachment;
+    attachment.Append(std::string(3000, 'x'));
+    attachment.Append("-end", 4);
+    for (bool checksum: {false, true}) {
+        AzRPC::RpcHeader header;
+        header.set_service_name("EchoService");
+        header.set_method_name("Echo");
+        header.set_checksum(checksum);
+        std::string out, trailer;
+        ASSERT_TRUE(AzRPC_Codec::EncodeRequest(&header, "args", attachment, &out, &trailer));
+        EXPECT_EQ(trailer.size(), checksum ? AzRPC_Codec::kChecksumSize : 0u);
+        std::string whole;
+        ASSERT_TRUE(AzRPC_Codec::EncodeRequest(&header, "args", attachment, &whole, nullptr));
+        std::string frame = out + attachment.ToString() + trailer;
+        EXPECT_EQ(frame, whole);
+
+        AzRPC::RpcHeader decoded;
+        size_t body_offset = 0;
+        ASSERT_EQ(AzRPC_Codec::DecodeRequest(frame.data(), frame.size(), &decoded, &body_offset), static_cast<int>(frame.size()));
+        EXPECT_EQ(decoded.attachment_size(), attachment.size());
+        EXPECT_EQ(frame.substr(body_offset, decoded.args_size()), "args");
+        EXPECT_EQ(frame.substr(body_offset + decoded.args_size(), decoded.attachment_size()), attachment.ToString());
+    }
+}
@@ -0,0 +1,100 @@
+#include "AzRPC_Bulkhead.h"
+#include "AzRPC_Metrics.h"
+#include "AzRPC_Scheduler.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 名额用完后请求进入等待队列, 队列也满时拒绝; 归还名额时直接转给队首的请求
+TEST(BulkheadTest, QueuesThenRejects) {
+    std::atomic<uint64_t>& queued = AzRPC_Metrics::Counter("bulkhead_test_queued");
+    std::atomic<uint64_t>& rejected = AzRPC_Metrics::Counter("bulkhead_test_rejected");
+    uint64_t queued_before = queued.load();
+    uint64_t rejected_before = rejected.load();
+    std::vector<AzRPC_Bulkhead::Task> resumed;
+    AzRPC_Bulkhead bulkhead("bulkhead_test", 2, 2, [&resumed](AzRPC_Bulkhead::Task task) { resumed.push_back(std::move(task)); });
+
+    EXPECT_TRUE(bulkhead.TryAcquire());
+    EXPECT_TRUE(bulkhead.TryAcquire());
+    EXPECT_FALSE(bulkhead.TryAcquire());
+    std::vector<std::string> order;
+    EXPECT_EQ(bulkhead.Wait([&order] { order.push_back("first"); }), AzRPC_Bulkhead::kQueued);
+    EXPECT_EQ(bulkhead.Wait([&order] { order.push_back("second"); }), AzRPC_Bulkhead::kQueued);
+    EXPECT_EQ(bulkhead.Wait([&order] { order.push_back("third"); }), AzRPC_Bulkhead::kRejected);
+    EXPECT_EQ(queued.load() - queued_before, 2u);
+    EXPECT_EQ(rejected.load() - rejected_before, 1u);
+
+    // 名额转给等待的请求, 执行中的数量不变
+    bulkhead.Release();
+    bulkhead.Release();
+    ASSERT_EQ(resumed.size(), 2u);
+    EXPECT_FALSE(bulkhead.TryAcquire());
+    for (AzRPC_Bulkhead::Task& task: resumed) {
+        task();
+    }
+    std::vector<std::string> expected = {"first", "second"};
+    EXPECT_EQ(order, expected);
+
+    // 没有等待的请求时名额空出
+    bulkhead.Release();
+    EXPECT_EQ(bulkhead.Wait(nullptr), AzRPC_Bulkhead::kAcquired);
+}
+
+// 与调度器一起使用: 慢方法最多同时占用自己的名额, 其余请求在舱壁中等待而不占用处理线程, 其他方法的请求照常执行
+TEST(BulkheadTest, SlowMethodDoesNotBlockOthers) {
+    const int kSlow = 5;
+    const int kFast = 100;
+    AzRPC_Scheduler scheduler(2, 1000);
+    AzRPC_Bulkhead bulkhead("bulkhead_slow_test", 1, kSlow, [&scheduler](AzRPC_Bulkhead::Task task) { scheduler.Resume(std::move(task)); });
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool open = false;
+    int slow_done = 0;
+    std::atomic<int> running(0);
+    std::atomic<int> max_running(0);
+    std::atomic<int> fast_done(0);
+    // 慢方法等到测试放开后才返回, 返回时归还名额
+    std::function<void()> slow = [&] {
+        int now = ++running;
+        int seen = max_running.load();
+        while (now > seen && !max_running.compare_exchange_weak(seen, now)) {
+        }
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&open] { return open; });
+        --running;
+        ++slow_done;
+        cv.notify_all();
+        lock.unlock();
+        bulkhead.Release();
+    };
+    for (int i = 0; i < kSlow; ++i) {
+        ASSERT_TRUE(scheduler.Submit(AzRPC::PRIORITY_NORMAL, "EchoService.Slow", 1, [&bulkhead, &slow] {
+            if (bulkhead.TryAcquire() || bulkhead.Wait(slow) == AzRPC_Bulkhead::kAcquired) {
+                slow();
+            }
+        }, nullptr));
+    }
+    for (int i = 0; i < kFast; ++i) {
+        ASSERT_TRUE(scheduler.Submit(AzRPC::PRIORITY_NORMAL, "EchoService.Echo", 1, [&fast_done] { ++fast_done; }, nullptr));
+    }
+    for (int i = 0; i < 500 && fast_done.load() < kFast; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(fast_done.load(), kFast);
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        open = true;
+        cv.notify_all();
+        EXPECT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&slow_done] { return slow_done == kSlow; }));
+    }
+    EXPECT_EQ(max_running.load(), 1);
+    scheduler.Stop();
+}
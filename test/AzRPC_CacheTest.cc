@@ -0,0 +1,108 @@
+#include "AzRPC_Cache.h"
+#include "AzRPC_Metrics.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+AzRPC_Cache::ValuePtr MakeValue(const std::string& data) {
+    std::shared_ptr<AzRPC_Cache::Value> value = std::make_shared<AzRPC_Cache::Value>();
+    value->data = data;
+    return value;
+}
+
+}  // namespace
+
+// 命中返回同一个值, 命中和未命中分别计数
+TEST(CacheTest, GetReturnsStoredValue) {
+    AzRPC_Cache cache("cache_test_get", 1 << 20, 4);
+    std::atomic<uint64_t>& hit = AzRPC_Metrics::Counter("cache_test_get_hit");
+    std::atomic<uint64_t>& miss = AzRPC_Metrics::Counter("cache_test_get_miss");
+    EXPECT_EQ(cache.Get("k"), nullptr);
+    AzRPC_Cache::ValuePtr value = MakeValue("response");
+    cache.Put("k", value, 60000);
+    EXPECT_EQ(cache.Get("k"), value);
+    EXPECT_EQ(hit.load(), 1u);
+    EXPECT_EQ(miss.load(), 1u);
+
+    cache.Erase("k");
+    EXPECT_EQ(cache.Get("k"), nullptr);
+    EXPECT_EQ(cache.Bytes(), 0u);
+}
+
+// 每项按各自的过期时间失效, ttl不大于0时不保存
+TEST(CacheTest, EntriesExpire) {
+    AzRPC_Cache cache("cache_test_ttl", 1 << 20, 1);
+    cache.Put("short", MakeValue("a"), 30);
+    cache.Put("long", MakeValue("b"), 60000);
+    cache.Put("never", MakeValue("c"), 0);
+    EXPECT_NE(cache.Get("short"), nullptr);
+    EXPECT_EQ(cache.Get("never"), nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(cache.Get("short"), nullptr);
+    EXPECT_NE(cache.Get("long"), nullptr);
+}
+
+// 超过容量时淘汰最久未使用的项, 最近读过的项保留
+TEST(CacheTest, EvictsLeastRecentlyUsed) {
+    const std::string data(1000, 'x');
+    // 单个分片, 容量刚好放下三项(每项还有键和固定开销)
+    AzRPC_Cache cache("cache_test_lru", 3 * 1300, 1);
+    std::atomic<uint64_t>& evict = AzRPC_Metrics::Counter("cache_test_lru_evict");
+    cache.Put("a", MakeValue(data), 60000);
+    cache.Put("b", MakeValue(data), 60000);
+    cache.Put("c", MakeValue(data), 60000);
+    ASSERT_NE(cache.Get("a"), nullptr);
+    cache.Put("d", MakeValue(data), 60000);
+    EXPECT_EQ(evict.load(), 1u);
+    EXPECT_EQ(cache.Get("b"), nullptr);
+    EXPECT_NE(cache.Get("a"), nullptr);
+    EXPECT_NE(cache.Get("c"), nullptr);
+    EXPECT_NE(cache.Get("d"), nullptr);
+    EXPECT_LE(cache.Bytes(), 3u * 1300);
+
+    // 单项超过分片容量时不保存, 也不淘汰已有的项
+    cache.Put("huge", MakeValue(std::string(5000, 'y')), 60000);
+    EXPECT_EQ(cache.Get("huge"), nullptr);
+    EXPECT_EQ(evict.load(), 1u);
+}
+
+// 多个线程并发读写不同分片
+TEST(CacheTest, ConcurrentAccess) {
+    AzRPC_Cache cache("cache_test_concurrent", 1 << 20, 8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 2000; ++i) {
+                std::string key = std::to_string(t) + ":" + std::to_string(i % 100);
+                cache.Put(key, MakeValue(key), 60000);
+                AzRPC_Cache::ValuePtr value = cache.Get(key);
+                ASSERT_NE(value, nullptr);
+                EXPECT_EQ(value->data, key);
+            }
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+}
+
+// 按前缀删除遍历所有分片, 只删除键以前缀开头的项
+TEST(CacheTest, ErasePrefix) {
+    AzRPC_Cache cache("cache_test_prefix", 1 << 20, 8);
+    for (int i = 0; i < 50; ++i) {
+        cache.Put(std::string("UserService\0Get\0", 16) + std::to_string(i), MakeValue("user"), 60000);
+        cache.Put(std::string("UserService\0List\0", 17) + std::to_string(i), MakeValue("list"), 60000);
+        cache.Put(std::string("OrderService\0Get\0", 17) + std::to_string(i), MakeValue("order"), 60000);
+    }
+    EXPECT_EQ(cache.ErasePrefix(std::string("UserService\0Get\0", 16) + "1"), 11u);    // 1和10~19
+    EXPECT_EQ(cache.Get(std::string("UserService\0Get\0", 16) + "1"), nullptr);
+    EXPECT_NE(cache.Get(std::string("UserService\0Get\0", 16) + "2"), nullptr);
+    EXPECT_EQ(cache.ErasePrefix(std::string("UserService\0", 12)), 89u);
+    EXPECT_EQ(cache.Get(std::string("UserService\0List\0", 17) + "0"), nullptr);
+    EXPECT_NE(cache.Get(std::string("OrderService\0Get\0", 17) + "0"), nullptr);
+    EXPECT_EQ(cache.ErasePrefix("Missing"), 0u);
+}
@@ -0,0 +1,360 @@
+#include "AzRPC_ClientLoop.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Channel.h"
+#include "AzRPC_Codec.h"
+#include "echo.pb.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+std::string ConfiguredEngine() {
+    return AzRPC_Application::GetConfig().Load("client_io_engine");
+}
+
+// socketpair另一端的简易服务端: 每次读到的完整请求帧按相反的顺序回复, 响应体为请求参数
+// 客户端必须按call_id而不是顺序匹配响应
+void ReverseEchoServer(int fd) {
+    std::string input;
+    char buf[65536];
+    while (true) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+        input.append(buf, n);
+        std::vector<std::string> replies;
+        size_t offset = 0;
+        while (true) {
+            AzRPC::RpcHeader header;
+            size_t body_offset = 0;
+            int frame_size = AzRPC_Codec::DecodeRequest(input.data() + offset, input.size() - offset, &header, &body_offset);
+            if (frame_size <= 0) {
+                break;
+            }
+            AzRPC::RpcResponseHeader response_header;
+            response_header.set_call_id(header.call_id());
+            std::string reply;
+            AzRPC_Codec::EncodeResponse(&response_header, std::string(input.data() + offset + body_offset, header.args_size()), &reply);
+            replies.push_back(reply);
+            offset += frame_size;
+        }
+        input.erase(0, offset);
+        std::string out;
+        for (auto it = replies.rbegin(); it != replies.rend(); ++it) {
+            out += *it;
+        }
+        if (!out.empty() && write(fd, out.data(), out.size()) != static_cast<ssize_t>(out.size())) {
+            break;
+        }
+    }
+    close(fd);
+}
+
+std::string RequestFrame(uint64_t call_id, const std::string& args) {
+    AzRPC::RpcHeader header;
+    header.set_service_name("EchoService");
+    header.set_method_name("Echo");
+    header.set_call_id(call_id);
+    std::string frame;
+    AzRPC_Codec::EncodeRequest(&header, args, &frame);
+    return frame;
+}
+
+void RunAndDelete(std::function<void()>* function) {
+    (*function)();
+    delete function;
+}
+
+// 连接到ReverseEchoServer的客户端循环连接, 析构时关闭
+class ClientLoopConnection {
+public:
+    ClientLoopConnection(): loop(AzRPC_ClientLoop::Instance()), conn_id(0) {
+        int sv[2];
+        if (loop == nullptr || socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+            return;
+        }
+        server = std::thread(ReverseEchoServer, sv[1]);
+        conn_id = loop->Attach(sv[0]);
+    }
+    ~ClientLoopConnection() {
+        if (conn_id != 0) {
+            loop->Detach(conn_id);
+            server.join();
+        }
+    }
+
+    AzRPC_ClientLoop* loop;
+    uint64_t conn_id;
+    std::thread server;
+};
+
+}  // namespace
+
+// client_io_engine为epoll或io_uring时启用对应的引擎, 不配置或为blocking时不使用客户端循环
+TEST(ClientLoopTest, EngineFromConfig) {
+    std::string engine = ConfiguredEngine();
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (engine.empty() || engine == "blocking") {
+        EXPECT_EQ(loop, nullptr);
+        return;
+    }
+    ASSERT_NE(loop, nullptr) << engine << " failed to start";
+    EXPECT_EQ(engine, loop->EngineName());
+}
+
+// 多个线程同时在一条连接上调用, 同一轮的请求合并发送, 响应按call_id交给各自的回调
+TEST(ClientLoopTest, MatchesResponsesByCallId) {
+    ClientLoopConnection connection;
+    if (connection.loop == nullptr) {
+        GTEST_SKIP() << "client io engine not enabled";
+    }
+    const int kThreads = 4;
+    const int kCalls = 500;
+    std::atomic<int> completed(0);
+    std::atomic<int> mismatched(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&connection, &completed, &mismatched, t] {
+            for (int i = 0; i < kCalls; ++i) {
+                std::string args = std::to_string(t) + ":" + std::to_string(i);
+                uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+                connection.loop->Call(connection.conn_id, call_id, RequestFrame(call_id, args),
+                    [&completed, &mismatched, args](const AzRPC::RpcResponseHeader& header, const char* body, const std::string& error) {
+                        if (!error.empty() || std::string(body, header.body_size()) != args) {
+                            ++mismatched;
+                        }
+                        ++completed;
+                    });
+            }
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    for (int i = 0; i < 500 && completed.load() < kThreads * kCalls; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(completed.load(), kThreads * kCalls);
+    EXPECT_EQ(mismatched.load(), 0);
+}
+
+// 在响应回调(循环线程)中发起的下一次调用不会等到下一个事件才发送
+TEST(ClientLoopTest, CallFromCallback) {
+    ClientLoopConnection connection;
+    if (connection.loop == nullptr) {
+        GTEST_SKIP() << "client io engine not enabled";
+    }
+    std::promise<int> finished;
+    std::function<void(int)> next = [&](int remaining) {
+        if (remaining == 0) {
+            finished.set_value(0);
+            return;
+        }
+        uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+        connection.loop->Call(connection.conn_id, call_id, RequestFrame(call_id, "chain"),
+            [&next, &finished, remaining](const AzRPC::RpcResponseHeader&, const char*, const std::string& error) {
+                if (!error.empty()) {
+                    finished.set_value(remaining);
+                    return;
+                }
+                next(remaining - 1);
+            });
+    };
+    next(200);
+    std::future<int> result = finished.get_future();
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(result.get(), 0);
+}
+
+// 关闭连接时还在等待的调用以错误结束, 之后的调用立即失败
+TEST(ClientLoopTest, DetachFailsPendingCalls) {
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (loop == nullptr) {
+        GTEST_SKIP() << "client io engine not enabled";
+    }
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    uint64_t conn_id = loop->Attach(sv[0]);
+
+    // 对端不回复
+    std::promise<std::string> pending;
+    uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+    loop->Call(conn_id, call_id, RequestFrame(call_id, "never"), [&pending](const AzRPC::RpcResponseHeader&, const char*, const std::string& error) {
+        pending.set_value(error);
+    });
+    loop->Detach(conn_id);
+    std::future<std::string> error = pending.get_future();
+    ASSERT_EQ(error.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(error.get().empty());
+
+    std::promise<std::string> after;
+    call_id = AzRPC_ClientLoop::NextCallId();
+    loop->Call(conn_id, call_id, RequestFrame(call_id, "closed"), [&after](const AzRPC::RpcResponseHeader&, const char*, const std::string& error) {
+        after.set_value(error);
+    });
+    std::future<std::string> after_error = after.get_future();
+    ASSERT_EQ(after_error.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(after_error.get(), "connection closed");
+    close(sv[1]);
+}
+
+// 对端关闭连接时等待中的调用失败, 连接被标记为断开, channel据此重新连接
+TEST(ClientLoopTest, PeerCloseMarksBroken) {
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (loop == nullptr) {
+        GTEST_SKIP() << "client io engine not enabled";
+    }
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    uint64_t conn_id = loop->Attach(sv[0]);
+    std::promise<std::string> pending;
+    uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+    loop->Call(conn_id, call_id, RequestFrame(call_id, "never"), [&pending](const AzRPC::RpcResponseHeader&, const char*, const std::string& error) {
+        pending.set_value(error);
+    });
+    close(sv[1]);
+    std::future<std::string> error = pending.get_future();
+    ASSERT_EQ(error.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_FALSE(error.get().empty());
+    EXPECT_TRUE(loop->Broken(conn_id));
+    loop->Detach(conn_id);
+}
+
+// 通过channel对本进程中的服务端异步调用: 启用引擎时完成回调在IO线程中执行, 否则返回前已经完成
+TEST(ClientLoopTest, ChannelAsyncCalls) {
+    const int kThreads = 4;
+    const int kCalls = 200;
+    std::mutex mtx;
+    std::condition_variable cv;
+    int completed = 0;
+    std::atomic<int> failed(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            AzRPC_Channel channel(false);
+            AzTest::EchoService_Stub stub(&channel);
+            std::vector<std::unique_ptr<AzRPC_Controller>> controllers;
+            std::vector<std::unique_ptr<AzTest::EchoRequest>> requests;
+            std::vector<std::unique_ptr<AzTest::EchoResponse>> responses;
+            int done_here = 0;
+            for (int i = 0; i < kCalls; ++i) {
+                controllers.emplace_back(new AzRPC_Controller());
+                requests.emplace_back(new AzTest::EchoRequest());
+                responses.emplace_back(new AzTest::EchoResponse());
+                requests.back()->set_payload(std::to_string(t * kCalls + i));
+                AzRPC_Controller* controller = controllers.back().get();
+                AzTest::EchoRequest* request = requests.back().get();
+                AzTest::EchoResponse* response = responses.back().get();
+                std::function<void()>* finish = new std::function<void()>([&, controller, request, response]() {
+                    if (controller->Failed() || response->payload() != request->payload()) {
+                        ++failed;
+                    }
+                    std::lock_guard<std::mutex> lock(mtx);
+                    ++completed;
+                    ++done_here;
+                    cv.notify_all();
+                });
+                stub.Echo(controller, request, response, google::protobuf::NewCallback(&RunAndDelete, finish));
+            }
+            // channel和它的调用状态要活到本线程的调用全部完成
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return done_here == kCalls; });
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(completed, kThreads * kCalls);
+    EXPECT_EQ(failed.load(), 0);
+}
+
+// 配置了client_write_window_us时, 连接上还有未完成的调用, 之后陆续提交的请求在窗口内合并为少数几次写
+// 对端先不回复, 记录收到请求用了几次读, 收齐后再一起回复
+TEST(ClientLoopTest, WriteWindowCoalescesRequests) {
+    AzRPC_ClientLoop* loop = AzRPC_ClientLoop::Instance();
+    if (loop == nullptr || atol(AzRPC_Application::GetConfig().Load("client_write_window_us").c_str()) <= 0) {
+        GTEST_SKIP() << "client write window not enabled";
+    }
+    const int kCalls = 50;
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    int fd = sv[1];
+    std::promise<int> reads;
+    std::thread server([fd, &reads] {
+        std::string input;
+        std::string out;
+        char buf[65536];
+        int frames = 0;
+        int read_count = 0;
+        while (frames < kCalls + 1) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) {
+                break;
+            }
+            ++read_count;
+            input.append(buf, n);
+            size_t offset = 0;
+            while (true) {
+                AzRPC::RpcHeader header;
+                size_t body_offset = 0;
+                int frame_size = AzRPC_Codec::DecodeRequest(input.data() + offset, input.size() - offset, &header, &body_offset);
+                if (frame_size <= 0) {
+                    break;
+                }
+                AzRPC::RpcResponseHeader response_header;
+                response_header.set_call_id(header.call_id());
+                AzRPC_Codec::EncodeResponse(&response_header, "", &out);
+                offset += frame_size;
+                ++frames;
+            }
+            input.erase(0, offset);
+        }
+        // 第一次读只带着先发出的那个调用
+        reads.set_value(read_count - 1);
+        if (write(fd, out.data(), out.size()) != static_cast<ssize_t>(out.size())) {
+            return;
+        }
+        while (read(fd, buf, sizeof(buf)) > 0) {
+        }
+        close(fd);
+    });
+    uint64_t conn_id = loop->Attach(sv[0]);
+
+    std::atomic<int> completed(0);
+    auto count = [&completed](const AzRPC::RpcResponseHeader&, const char*, const std::string& error) {
+        if (error.empty()) {
+            ++completed;
+        }
+    };
+    uint64_t call_id = AzRPC_ClientLoop::NextCallId();
+    loop->Call(conn_id, call_id, RequestFrame(call_id, "first"), count);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // 每个请求单独唤醒一轮循环, 没有窗口时几乎每个请求都是一次写
+    for (int i = 0; i < kCalls; ++i) {
+        call_id = AzRPC_ClientLoop::NextCallId();
+        loop->Call(conn_id, call_id, RequestFrame(call_id, std::to_string(i)), count);
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    std::future<int> read_count = reads.get_future();
+    ASSERT_EQ(read_count.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_LE(read_count.get(), kCalls / 2);
+    for (int i = 0; i < 500 && completed.load() < kCalls + 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(completed.load(), kCalls + 1);
+    loop->Detach(conn_id);
+    server.join();
+}
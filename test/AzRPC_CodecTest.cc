@@ -0,0 +1,132 @@
+#include "AzRPC_Codec.h"
+#include "AzRPC_Compress.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+// 类内初始化的静态常量没有定义, 不能按引用传给EXPECT_EQ
+const int kIncomplete = AzRPC_Codec::kIncomplete;
+const int kInvalid = AzRPC_Codec::kInvalid;
+
+}  // namespace
+
+TEST(CodecTest, RequestRoundTrip) {
+    AzRPC::RpcHeader header;
+    header.set_service_name("EchoService");
+    header.set_method_name("Echo");
+    header.set_call_id(7);
+    std::string frame;
+    ASSERT_TRUE(AzRPC_Codec::EncodeRequest(&header, "args", &frame));
+    EXPECT_EQ(header.args_size(), 4u);
+
+    AzRPC::RpcHeader decoded;
+    size_t body_offset = 0;
+    ASSERT_EQ(AzRPC_Codec::DecodeRequest(frame.data(), frame.size(), &decoded, &body_offset), static_cast<int>(frame.size()));
+    EXPECT_EQ(decoded.service_name(), "EchoService");
+    EXPECT_EQ(decoded.method_name(), "Echo");
+    EXPECT_EQ(decoded.call_id(), 7u);
+    EXPECT_EQ(frame.substr(body_offset, decoded.args_size()), "args");
+}
+
+// 响应帧带长度, 一次读到的多个响应可以逐个切分, 同一连接可以连续复用
+TEST(CodecTest, BackToBackResponses) {
+    std::string stream;
+    for (uint64_t call_id = 1; call_id <= 3; ++call_id) {
+        AzRPC::RpcResponseHeader header;
+        header.set_call_id(call_id);
+        ASSERT_TRUE(AzRPC_Codec::EncodeResponse(&header, "body" + std::to_string(call_id), &stream));
+    }
+
+    size_t offset = 0;
+    for (uint64_t call_id = 1; call_id <= 3; ++call_id) {
+        AzRPC::RpcResponseHeader header;
+        size_t body_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeResponse(stream.data() + offset, stream.size() - offset, &header, &body_offset);
+        ASSERT_GT(frame_size, 0);
+        EXPECT_EQ(header.call_id(), call_id);
+        EXPECT_EQ(std::string(stream.data() + offset + body_offset, header.body_size()), "body" + std::to_string(call_id));
+        offset += frame_size;
+    }
+    EXPECT_EQ(offset, stream.size());
+}
+
+TEST(CodecTest, EveryPrefixIsIncomplete) {
+    AzRPC::RpcResponseHeader header;
+    header.set_call_id(1);
+    std::string frame;
+    ASSERT_TRUE(AzRPC_Codec::EncodeResponse(&header, std::string(300, 'x'), &frame));
+    for (size_t len = 0; len < frame.size(); ++len) {
+        AzRPC::RpcResponseHeader decoded;
+        size_t body_offset = 0;
+        EXPECT_EQ(AzRPC_Codec::DecodeResponse(frame.data(), len, &decoded, &body_offset), kIncomplete) << len;
+    }
+}
+
+TEST(CodecTest, Varint32) {
+    uint32_t value = 0;
+    EXPECT_EQ(AzRPC_Codec::ReadVarint32("\x05", 1, &value), 1);
+    EXPECT_EQ(value, 5u);
+    EXPECT_EQ(AzRPC_Codec::ReadVarint32("\xAC\x02", 2, &value), 2);
+    EXPECT_EQ(value, 300u);
+    EXPECT_EQ(AzRPC_Codec::ReadVarint32("\xFF\xFF\xFF\xFF\x0F", 5, &value), 5);
+    EXPECT_EQ(value, 0xFFFFFFFFu);
+    EXPECT_EQ(AzRPC_Codec::ReadVarint32("\xAC", 1, &value), kIncomplete);
+}
+
+// 第5字节超出32位或者超过5个字节的长度是非法数据, 不能截断成另一个长度继续解析
+TEST(CodecTest, Varint32OverflowIsInvalid) {
+    uint32_t value = 0;
+    EXPECT_EQ(AzRPC_Codec::ReadVarint32("\xFF\xFF\xFF\xFF\x1F", 5, &value), kInvalid);
+    EXPECT_EQ(AzRPC_Codec::ReadVarint32("\x80\x80\x80\x80\x80\x01", 6, &value), kInvalid);
+
+    AzRPC::RpcHeader header;
+    size_t body_offset = 0;
+    EXPECT_EQ(AzRPC_Codec::DecodeRequest("\x85\x80\x80\x80\x10", 5, &header, &body_offset), kInvalid);
+}
+
+TEST(CodecTest, OversizedHeaderIsInvalid) {
+    std::string data = "\x81\x80\x04";     // 65537
+    data.append(16, '\0');
+    AzRPC::RpcHeader header;
+    size_t body_offset = 0;
+    EXPECT_EQ(AzRPC_Codec::DecodeRequest(data.data(), data.size(), &header, &body_offset), kInvalid);
+}
+
+// 服务端发送响应的编码路径: 响应体按调用方的算法压缩, 进程不支持该算法或者太小时原样编码
+TEST(CodecTest, EncodeResponseCompressesBody) {
+    const AzRPC::CompressType kTypes[] = {AzRPC::COMPRESS_NONE, AzRPC::COMPRESS_LZ4, AzRPC::COMPRESS_ZSTD, AzRPC::COMPRESS_SNAPPY};
+    std::string body;
+    for (int i = 0; i < 512; ++i) {
+        body += "response body " + std::to_string(i % 8) + ";";
+    }
+    for (AzRPC::CompressType type: kTypes) {
+        AzRPC::RpcResponseHeader header;
+        std::string frame;
+        std::string trailer;
+        ASSERT_TRUE(AzRPC_Codec::EncodeResponse(&header, body, type, AzRPC_Attachment(), &frame, &trailer));
+        frame += trailer;
+
+        AzRPC::RpcResponseHeader decoded;
+        size_t body_offset = 0;
+        ASSERT_EQ(AzRPC_Codec::DecodeResponse(frame.data(), frame.size(), &decoded, &body_offset), static_cast<int>(frame.size()));
+        if (type == AzRPC::COMPRESS_NONE || !AzRPC_Compress::Supported(type)) {
+            EXPECT_EQ(decoded.compress_type(), AzRPC::COMPRESS_NONE) << AzRPC_Compress::Name(type);
+            EXPECT_EQ(std::string(frame.data() + body_offset, decoded.body_size()), body);
+            continue;
+        }
+        EXPECT_EQ(decoded.compress_type(), type) << AzRPC_Compress::Name(type);
+        EXPECT_LT(decoded.body_size(), body.size());
+        std::string raw;
+        ASSERT_TRUE(AzRPC_Compress::Decompress(type, frame.data() + body_offset, decoded.body_size(), decoded.body_raw_size(), &raw));
+        EXPECT_EQ(raw, body);
+    }
+}
+
+TEST(CodecTest, EncodeResponseKeepsSmallBody) {
+    AzRPC::RpcResponseHeader header;
+    std::string frame;
+    ASSERT_TRUE(AzRPC_Codec::EncodeResponse(&header, "small", AzRPC::COMPRESS_ZSTD, AzRPC_Attachment(), &frame, nullptr));
+    EXPECT_EQ(header.compress_type(), AzRPC::COMPRESS_NONE);
+    EXPECT_EQ(header.body_size(), 5u);
+}
@@ -0,0 +1,78 @@
+#include "AzRPC_Compress.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+const AzRPC::CompressType kCompressTypes[] = {AzRPC::COMPRESS_LZ4, AzRPC::COMPRESS_ZSTD, AzRPC::COMPRESS_SNAPPY};
+
+std::string Compressible(size_t size) {
+    std::string data;
+    while (data.size() < size) {
+        data += "compressible payload " + std::to_string(data.size() % 7) + " ";
+    }
+    data.resize(size);
+    return data;
+}
+
+}  // namespace
+
+// unit.conf中为CompressTestService配置了服务级和方法级的算法, 没有配置全局的rpc_compress
+TEST(CompressTest, ForMethodPrefersMethodOverService) {
+    EXPECT_EQ(AzRPC_Compress::ForMethod("CompressTestService", "Fast"), AzRPC::COMPRESS_LZ4);
+    EXPECT_EQ(AzRPC_Compress::ForMethod("CompressTestService", "Other"), AzRPC::COMPRESS_ZSTD);
+    EXPECT_EQ(AzRPC_Compress::ForMethod("OtherService", "Fast"), AzRPC::COMPRESS_NONE);
+}
+
+TEST(CompressTest, ParseAndName) {
+    for (AzRPC::CompressType type: {AzRPC::COMPRESS_NONE, AzRPC::COMPRESS_LZ4, AzRPC::COMPRESS_ZSTD, AzRPC::COMPRESS_SNAPPY}) {
+        AzRPC::CompressType parsed;
+        ASSERT_TRUE(AzRPC_Compress::Parse(AzRPC_Compress::Name(type), &parsed));
+        EXPECT_EQ(parsed, type);
+    }
+    AzRPC::CompressType parsed;
+    EXPECT_FALSE(AzRPC_Compress::Parse("gzip", &parsed));
+    EXPECT_TRUE(AzRPC_Compress::Supported(AzRPC::COMPRESS_NONE));
+}
+
+// 小于rpc_compress_threshold(默认1024字节)的数据不压缩; 没有编译进来的算法按不压缩处理
+TEST(CompressTest, SkipsSmallOrUnsupported) {
+    std::string out = "unchanged";
+    EXPECT_EQ(AzRPC_Compress::Compress(AzRPC::COMPRESS_ZSTD, Compressible(1000), &out), AzRPC::COMPRESS_NONE);
+    EXPECT_EQ(out, "unchanged");
+    EXPECT_EQ(AzRPC_Compress::Compress(AzRPC::COMPRESS_NONE, Compressible(4096), &out), AzRPC::COMPRESS_NONE);
+    for (AzRPC::CompressType type: kCompressTypes) {
+        if (!AzRPC_Compress::Supported(type)) {
+            EXPECT_EQ(AzRPC_Compress::Compress(type, Compressible(4096), &out), AzRPC::COMPRESS_NONE) << AzRPC_Compress::Name(type);
+            EXPECT_EQ(out, "unchanged");
+        }
+    }
+}
+
+TEST(CompressTest, RoundTrip) {
+    std::string data = Compressible(64 * 1024);
+    for (AzRPC::CompressType type: kCompressTypes) {
+        if (!AzRPC_Compress::Supported(type)) {
+            continue;
+        }
+        std::string compressed;
+        ASSERT_EQ(AzRPC_Compress::Compress(type, data, &compressed), type) << AzRPC_Compress::Name(type);
+        EXPECT_LT(compressed.size(), data.size());
+        std::string raw;
+        ASSERT_TRUE(AzRPC_Compress::Decompress(type, compressed.data(), compressed.size(), data.size(), &raw));
+        EXPECT_EQ(raw, data);
+
+        // 压缩前的长度与header中的不一致或者数据损坏时解压失败
+        EXPECT_FALSE(AzRPC_Compress::Decompress(type, compressed.data(), compressed.size(), data.size() + 1, &raw));
+        EXPECT_FALSE(AzRPC_Compress::Decompress(type, compressed.data(), compressed.size() / 2, data.size(), &raw));
+    }
+}
+
+// 损坏的header声明的解压后长度过大时不分配内存
+TEST(CompressTest, RejectsHugeRawSize) {
+    std::string raw;
+    for (AzRPC::CompressType type: kCompressTypes) {
+        EXPECT_FALSE(AzRPC_Compress::Decompress(type, "x", 1, AzRPC_Compress::kMaxRawSize + 1, &raw));
+    }
+    EXPECT_TRUE(raw.empty());
+}
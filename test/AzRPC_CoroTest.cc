@@ -0,0 +1,199 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Channel.h"
+#include "AzRPC_Coro.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+AzRPC_Task<AzTest::EchoResponse> Echo(AzRPC_Channel* channel, AzRPC_Controller* controller, const std::string& payload, uint32_t sleep_ms) {
+    AzTest::EchoRequest request;
+    request.set_payload(payload);
+    request.set_sleep_ms(sleep_ms);
+    co_return co_await AzRPC_Call(channel, &AzTest::EchoService_Stub::Echo, request, controller);
+}
+
+}  // namespace
+
+TEST(CoroTest, CallReturnsResponse) {
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    AzTest::EchoResponse response = AzRPC_SyncWait(Echo(&channel, &controller, "coroutine", 0));
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.payload(), "coroutine");
+}
+
+// 同一个协程中连续调用; 启用IO引擎时协程在IO线程中恢复, 不占用发起的线程
+TEST(CoroTest, SequentialCallsResumeOnLoop) {
+    AzRPC_Channel channel(false);
+    std::thread::id caller = std::this_thread::get_id();
+    auto task = [&]() -> AzRPC_Task<int> {
+        int succeeded = 0;
+        for (int i = 0; i < 20; ++i) {
+            AzRPC_Controller controller;
+            AzTest::EchoResponse response = co_await Echo(&channel, &controller, std::to_string(i), 0);
+            if (!controller.Failed() && response.payload() == std::to_string(i)) {
+                ++succeeded;
+            }
+        }
+        if (AzRPC_ClientLoop::Instance() != nullptr) {
+            EXPECT_NE(std::this_thread::get_id(), caller);
+        }
+        co_return succeeded;
+    };
+    EXPECT_EQ(AzRPC_SyncWait(task()), 20);
+}
+
+// 挂起和恢复前后当前线程的追踪上下文不变, 下游调用都属于同一条调用链
+TEST(CoroTest, TraceSurvivesSuspension) {
+    AzRPC_TraceContext root = AzRPC_Tracer::NewRoot();
+    AzRPC_TraceScope scope(root);
+    AzRPC_Channel channel(false);
+    auto task = [&]() -> AzRPC_Task<void> {
+        for (int i = 0; i < 2; ++i) {
+            AzRPC_Controller controller;
+            AzTest::EchoResponse response = co_await Echo(&channel, &controller, "traced", 0);
+            EXPECT_FALSE(controller.Failed()) << controller.ErrorText();
+            EXPECT_EQ(response.trace_id(), root.trace_id);
+            EXPECT_EQ(AzRPC_Tracer::Current().trace_id, root.trace_id);
+        }
+        co_await AzRPC_Sleep(1);
+        EXPECT_EQ(AzRPC_Tracer::Current().trace_id, root.trace_id);
+    };
+    AzRPC_SyncWait(task());
+}
+
+// 调用前已经取消的controller不发出调用
+TEST(CoroTest, CanceledBeforeCall) {
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    controller.StartCancel();
+    uint64_t calls = AzRPC_EchoService::EchoCalls();
+    AzTest::EchoResponse response = AzRPC_SyncWait(Echo(&channel, &controller, "never sent", 0));
+    EXPECT_TRUE(controller.Failed());
+    EXPECT_EQ(controller.ErrorText(), "call canceled");
+    EXPECT_EQ(response.payload(), "");
+    EXPECT_EQ(AzRPC_EchoService::EchoCalls(), calls);
+}
+
+// 等待响应期间取消, 协程立即以"call canceled"恢复, 之后到达的响应被丢弃
+TEST(CoroTest, CancelWhileWaiting) {
+    if (AzRPC_ClientLoop::Instance() == nullptr) {
+        GTEST_SKIP() << "client_io_engine not configured, calls are blocking";
+    }
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    std::thread canceler([&controller] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        controller.StartCancel();
+    });
+    Clock::time_point start = Clock::now();
+    AzRPC_SyncWait(Echo(&channel, &controller, "slow", 500));
+    int64_t elapsed = ElapsedMs(start);
+    canceler.join();
+    EXPECT_TRUE(controller.Failed());
+    EXPECT_EQ(controller.ErrorText(), "call canceled");
+    EXPECT_LT(elapsed, 400);
+    // 等迟到的响应到达, 它不能再恢复已经结束的协程
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+}
+
+// 调用完成后取消回调已经删除, 之后再取消同一个controller不改变调用结果
+TEST(CoroTest, CancelAfterCompletionIsIgnored) {
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    AzTest::EchoResponse response = AzRPC_SyncWait(Echo(&channel, &controller, "done", 0));
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    controller.StartCancel();
+    EXPECT_FALSE(controller.Failed());
+    EXPECT_EQ(response.payload(), "done");
+}
+
+TEST(CoroTest, SleepSuspends) {
+    Clock::time_point start = Clock::now();
+    auto task = []() -> AzRPC_Task<void> {
+        co_await AzRPC_Sleep(50);
+    };
+    AzRPC_SyncWait(task());
+    EXPECT_GE(ElapsedMs(start), 50);
+}
+
+namespace {
+
+// 模拟服务端框架: done执行时记录调用结束, 由测试线程等待
+class DoneWaiter {
+public:
+    google::protobuf::Closure* NewDone() {
+        return google::protobuf::NewCallback(this, &DoneWaiter::Run);
+    }
+    bool Wait() {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        return m_cv.wait_for(lock, std::chrono::seconds(2), [this] { return m_done; });
+    }
+
+private:
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_done = false;
+
+    void Run() {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_done = true;
+        m_cv.notify_all();
+    }
+};
+
+// 服务端的协程处理函数: 挂起等待后调用下游服务, 把结果写入响应
+AzRPC_Task<void> ForwardEcho(AzRPC_Channel* channel, const AzTest::EchoRequest* request, AzTest::EchoResponse* response) {
+    co_await AzRPC_Sleep(10);
+    AzRPC_Controller controller;
+    AzTest::EchoResponse downstream = co_await AzRPC_Call(channel, &AzTest::EchoService_Stub::Echo, *request, &controller);
+    if (controller.Failed()) {
+        throw std::runtime_error(controller.ErrorText());
+    }
+    response->set_payload("forwarded:" + downstream.payload());
+}
+
+AzRPC_Task<void> Reject(const AzTest::EchoRequest* request) {
+    co_await AzRPC_Sleep(1);
+    throw std::invalid_argument("bad payload " + request->payload());
+}
+
+}  // namespace
+
+// AzRPC_Serve立即返回, 协程结束后才执行done
+TEST(CoroTest, ServeRunsDoneAfterHandler) {
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    AzTest::EchoRequest request;
+    request.set_payload("serve");
+    AzTest::EchoResponse response;
+    DoneWaiter done;
+    AzRPC_Serve(ForwardEcho(&channel, &request, &response), &controller, done.NewDone());
+    ASSERT_TRUE(done.Wait());
+    EXPECT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.payload(), "forwarded:serve");
+}
+
+// 处理函数抛出的异常作为调用失败交给框架
+TEST(CoroTest, ServeReportsException) {
+    AzRPC_Controller controller;
+    AzTest::EchoRequest request;
+    request.set_payload("x");
+    DoneWaiter done;
+    AzRPC_Serve(Reject(&request), &controller, done.NewDone());
+    ASSERT_TRUE(done.Wait());
+    EXPECT_TRUE(controller.Failed());
+    EXPECT_EQ(controller.ErrorText(), "bad payload x");
+}
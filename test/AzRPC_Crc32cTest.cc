@@ -0,0 +1,84 @@
+#include "AzRPC_Crc32c.h"
+#include "AzRPC_Codec.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+
+namespace {
+
+// 逐位计算的参考实现(反射多项式0x82F63B78)
+uint32_t ReferenceCrc32c(const char* data, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= static_cast<uint8_t>(data[i]);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+std::string Pattern(size_t len) {
+    std::string data(len, '\0');
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < len; ++i) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = static_cast<char>(seed >> 16);
+    }
+    return data;
+}
+
+}  // namespace
+
+// RFC 3720 B.4中的测试向量
+TEST(Crc32cTest, KnownVectors) {
+    EXPECT_EQ(AzRPC_Crc32c::Value("123456789", 9), 0xE3069283u);
+    std::string zeros(32, '\0');
+    EXPECT_EQ(AzRPC_Crc32c::Value(zeros.data(), zeros.size()), 0x8A9136AAu);
+    std::string ones(32, '\xFF');
+    EXPECT_EQ(AzRPC_Crc32c::Value(ones.data(), ones.size()), 0x62A8AB43u);
+    EXPECT_EQ(AzRPC_Crc32c::Value("", 0), 0u);
+}
+
+// 覆盖未对齐的开头、三路交错的分块以及剩余的尾部
+TEST(Crc32cTest, MatchesReferenceForAllShapes) {
+    std::string data = Pattern(10000);
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t len: {1, 7, 8, 15, 64, 255, 256, 257, 1000, 3 * 1024 + 5, 9000}) {
+            ASSERT_EQ(AzRPC_Crc32c::Value(data.data() + offset, len), ReferenceCrc32c(data.data() + offset, len))
+                << AzRPC_Crc32c::Implementation() << " offset " << offset << " len " << len;
+        }
+    }
+}
+
+TEST(Crc32cTest, ExtendEqualsWhole) {
+    std::string data = Pattern(5000);
+    uint32_t whole = AzRPC_Crc32c::Value(data.data(), data.size());
+    for (size_t split: {0, 1, 3, 100, 2500, 4999, 5000}) {
+        uint32_t crc = AzRPC_Crc32c::Value(data.data(), split);
+        EXPECT_EQ(AzRPC_Crc32c::Extend(crc, data.data() + split, data.size() - split), whole) << split;
+    }
+}
+
+// 帧中任何一个字节被改动都会被校验发现, 帧完整之前不计算校验
+TEST(Crc32cTest, CodecDetectsCorruption) {
+    AzRPC::RpcHeader header;
+    header.set_service_name("EchoService");
+    header.set_method_name("Echo");
+    header.set_checksum(true);
+    std::string frame;
+    ASSERT_TRUE(AzRPC_Codec::EncodeRequest(&header, "checked args", &frame));
+
+    AzRPC::RpcHeader decoded;
+    size_t body_offset = 0;
+    ASSERT_EQ(AzRPC_Codec::DecodeRequest(frame.data(), frame.size(), &decoded, &body_offset), static_cast<int>(frame.size()));
+    EXPECT_TRUE(decoded.checksum());
+    EXPECT_EQ(AzRPC_Codec::DecodeRequest(frame.data(), frame.size() - 1, &decoded, &body_offset), static_cast<int>(AzRPC_Codec::kIncomplete));
+
+    // 改动请求参数和校验和本身
+    for (size_t pos: {frame.size() - AzRPC_Codec::kChecksumSize - 1, frame.size() - 1}) {
+        std::string corrupted = frame;
+        corrupted[pos] ^= 0x01;
+        EXPECT_EQ(AzRPC_Codec::DecodeRequest(corrupted.data(), corrupted.size(), &decoded, &body_offset), static_cast<int>(AzRPC_Codec::kChecksumError)) << pos;
+    }
+}
@@ -0,0 +1,94 @@
+#include "AzRPC_Future.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(FutureTest, ValueAndFailure) {
+    AzRPC_Promise<std::string> promise;
+    AzRPC_Future<std::string> future = promise.GetFuture();
+    EXPECT_FALSE(future.Ready());
+    promise.SetValue("first");
+    promise.SetFailed("ignored");   // 只有第一次生效
+    ASSERT_TRUE(future.Ready());
+    EXPECT_FALSE(future.Failed());
+    EXPECT_EQ(future.Get(), "first");
+
+    AzRPC_Promise<int> failing;
+    failing.SetFailed("boom");
+    EXPECT_TRUE(failing.GetFuture().Failed());
+    EXPECT_EQ(failing.GetFuture().ErrorText(), "boom");
+    EXPECT_EQ(failing.GetFuture().Value(), 0);
+}
+
+// 完成前注册的回调在完成future的线程中执行, 完成后注册的回调立即执行
+TEST(FutureTest, ThenRunsOnCompletingThread) {
+    AzRPC_Promise<int> promise;
+    std::thread::id callback_thread;
+    AzRPC_Future<int> doubled = promise.GetFuture().Then([&callback_thread](AzRPC_Future<int> f) {
+        callback_thread = std::this_thread::get_id();
+        return f.Value() * 2;
+    });
+    std::thread completer([&promise] { promise.SetValue(21); });
+    std::thread::id completer_id = completer.get_id();
+    completer.join();
+    EXPECT_EQ(callback_thread, completer_id);
+    EXPECT_EQ(doubled.Get(), 42);
+
+    bool ran = false;
+    doubled.Then([&ran](AzRPC_Future<int>) { ran = true; });
+    EXPECT_TRUE(ran);
+}
+
+// 回调返回future时展开, 链上的失败和异常都传到最后
+TEST(FutureTest, ThenChainsAndFlattens) {
+    AzRPC_Promise<int> first;
+    AzRPC_Promise<std::string> second;
+    AzRPC_Future<std::string> chained = first.GetFuture().Then([&second](AzRPC_Future<int> f) {
+        return second.GetFuture().Then([f](AzRPC_Future<std::string> s) {
+            return s.Value() + std::to_string(f.Value());
+        });
+    });
+    first.SetValue(7);
+    EXPECT_FALSE(chained.Ready());
+    second.SetValue("answer ");
+    ASSERT_TRUE(chained.Ready());
+    EXPECT_EQ(chained.Value(), "answer 7");
+
+    AzRPC_Promise<int> throwing;
+    AzRPC_Future<void> failed = throwing.GetFuture().Then([](AzRPC_Future<int> f) {
+        if (f.Failed()) {
+            throw std::runtime_error("upstream: " + f.ErrorText());
+        }
+    });
+    throwing.SetFailed("timeout");
+    ASSERT_TRUE(failed.Ready());
+    EXPECT_TRUE(failed.Failed());
+    EXPECT_EQ(failed.ErrorText(), "upstream: timeout");
+}
+
+TEST(FutureTest, WhenAllAndWhenAny) {
+    std::vector<AzRPC_Promise<int>> promises(3);
+    std::vector<AzRPC_Future<int>> futures;
+    for (AzRPC_Promise<int>& promise: promises) {
+        futures.push_back(promise.GetFuture());
+    }
+    AzRPC_Future<std::vector<AzRPC_Future<int>>> all = AzRPC_WhenAll(futures);
+    AzRPC_Future<size_t> any = AzRPC_WhenAny(futures);
+    promises[2].SetValue(2);
+    EXPECT_TRUE(any.Ready());
+    EXPECT_EQ(any.Value(), 2u);
+    EXPECT_FALSE(all.Ready());
+    promises[0].SetFailed("lost");
+    promises[1].SetValue(1);
+    ASSERT_TRUE(all.Ready());
+    EXPECT_FALSE(all.Failed());
+    ASSERT_EQ(all.Value().size(), 3u);
+    EXPECT_TRUE(all.Value()[0].Failed());
+    EXPECT_EQ(all.Value()[1].Value(), 1);
+    EXPECT_EQ(all.Value()[2].Value(), 2);
+
+    EXPECT_TRUE(AzRPC_WhenAll(std::vector<AzRPC_Future<int>>()).Ready());
+    EXPECT_TRUE(AzRPC_WhenAny(std::vector<AzRPC_Future<int>>()).Failed());
+}
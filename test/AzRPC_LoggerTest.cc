@@ -0,0 +1,73 @@
+#include "AzRPC_Logger.h"
+#include "AzRPC_Application.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <time.h>
+
+namespace {
+
+// 读取unit.conf中log_file指定的日志文件
+std::string ReadLog() {
+    std::ifstream in(AzRPC_Application::GetConfig().Load("log_file"));
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+}  // namespace
+
+TEST(LoggerTest, FlushWritesGlogStyleLine) {
+    AZRPC_LOG_INFO("logger test %d", 42);
+    int line = __LINE__ - 1;
+    AzRPC_AsyncLogging::Flush();
+    std::string log = ReadLog();
+    size_t pos = log.find("AzRPC_LoggerTest.cc:" + std::to_string(line) + "] logger test 42\n");
+    ASSERT_NE(pos, std::string::npos);
+    // 行首为级别字符, 与glog一致
+    size_t begin = log.rfind('\n', pos);
+    EXPECT_EQ(log[begin == std::string::npos ? 0 : begin + 1], 'I');
+}
+
+TEST(LoggerTest, LevelFiltersMessages) {
+    AzRPC_AsyncLogging::SetLevel(AzRPC_LOG_WARNING);
+    AZRPC_LOG_INFO("filtered info message");
+    AZRPC_LOG_WARNING("kept warning message");
+    AzRPC_AsyncLogging::SetLevel(AzRPC_LOG_INFO);
+    AzRPC_AsyncLogging::Flush();
+    std::string log = ReadLog();
+    EXPECT_EQ(log.find("filtered info message"), std::string::npos);
+    EXPECT_NE(log.find("kept warning message"), std::string::npos);
+}
+
+// 线程退出后缓冲区中剩余的日志仍然会写出
+TEST(LoggerTest, ExitedThreadIsDrained) {
+    std::thread([] {
+        AZRPC_LOG_ERROR("from exited thread");
+    }).join();
+    AzRPC_AsyncLogging::Flush();
+    EXPECT_NE(ReadLog().find("from exited thread"), std::string::npos);
+}
+
+TEST(LoggerTest, RateLimiterReportsSuppressed) {
+    AzRPC_LogRateLimiter limiter(3);
+    uint64_t suppressed = 0;
+    // 在同一秒内完成, 避开秒的边界
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    std::this_thread::sleep_for(std::chrono::nanoseconds(1000000000 - ts.tv_nsec));
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(limiter.Allow(&suppressed));
+        EXPECT_EQ(suppressed, 0u);
+    }
+    EXPECT_FALSE(limiter.Allow(&suppressed));
+    EXPECT_FALSE(limiter.Allow(&suppressed));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    EXPECT_TRUE(limiter.Allow(&suppressed));
+    EXPECT_EQ(suppressed, 2u);
+}
@@ -0,0 +1,560 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Channel.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Controller.h"
+#include "AzRPC_Metrics.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// 在环形缓冲区中查找一条span, 服务端在发出响应之后才导出span, 因此最多等待1秒
+bool FindSpan(uint64_t trace_id, uint32_t kind, AzRPC_SpanRecord* found) {
+    for (int i = 0; i < 100; ++i) {
+        std::vector<AzRPC_SpanRecord> records;
+        AzRPC_Tracer::Snapshot(&records);
+        for (const AzRPC_SpanRecord& record: records) {
+            if (record.trace_id == trace_id && record.kind == kind) {
+                *found = record;
+                return true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(LoopbackTest, Echo) {
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    AzRPC_Controller controller;
+    AzTest::EchoRequest request;
+    request.set_payload("hello");
+    AzTest::EchoResponse response;
+    stub.Echo(&controller, &request, &response, nullptr);
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.payload(), "hello");
+}
+
+// 调用方指定的调用链经过RpcHeader传到服务端, 业务方法看到的上下文是调用方span的子span, 两端的span都被导出
+TEST(LoopbackTest, TracePropagatesToProvider) {
+    AzRPC_TraceContext root = AzRPC_Tracer::NewRoot();
+    ASSERT_TRUE(root.Sampled());
+
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    AzRPC_Controller controller;
+    controller.SetTraceContext(root);
+    AzTest::EchoRequest request;
+    AzTest::EchoResponse response;
+    stub.Echo(&controller, &request, &response, nullptr);
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.trace_id(), root.trace_id);
+    EXPECT_EQ(response.parent_span_id(), root.span_id);
+
+    AzRPC_SpanRecord client_span;
+    AzRPC_SpanRecord server_span;
+    ASSERT_TRUE(FindSpan(root.trace_id, AzRPC_SpanRecord::kClient, &client_span));
+    ASSERT_TRUE(FindSpan(root.trace_id, AzRPC_SpanRecord::kServer, &server_span));
+    EXPECT_EQ(client_span.parent_span_id, root.span_id);
+    EXPECT_EQ(server_span.span_id, client_span.span_id);
+    EXPECT_STREQ(server_span.method, "EchoService.Echo");
+}
+
+// 同一个channel连续调用, 复用的连接上每个响应都与它的请求对应
+TEST(LoopbackTest, ReusedConnection) {
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    for (int i = 0; i < 50; ++i) {
+        AzRPC_Controller controller;
+        AzTest::EchoRequest request;
+        request.set_payload(std::string(i * 100, 'a' + i % 26));
+        AzTest::EchoResponse response;
+        stub.Echo(&controller, &request, &response, nullptr);
+        ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+        EXPECT_EQ(response.payload(), request.payload());
+    }
+}
+
+// 调用方选择的算法压缩请求参数, 服务端用同样的算法压缩响应; 算法没有编译进来时按不压缩发送
+TEST(LoopbackTest, CompressedCall) {
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    std::string payload;
+    for (int i = 0; i < 2000; ++i) {
+        payload += "compress me " + std::to_string(i % 10);
+    }
+    for (AzRPC::CompressType type: {AzRPC::COMPRESS_LZ4, AzRPC::COMPRESS_ZSTD, AzRPC::COMPRESS_SNAPPY}) {
+        AzRPC_Controller controller;
+        controller.SetCompressType(type);
+        AzTest::EchoRequest request;
+        request.set_payload(payload);
+        AzTest::EchoResponse response;
+        stub.Echo(&controller, &request, &response, nullptr);
+        ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+        EXPECT_EQ(response.payload(), payload);
+    }
+}
+
+// 请求帧在传输中损坏时, 服务端回复CHECKSUM_ERROR后断开连接, 不执行业务方法
+TEST(LoopbackTest, ChecksumMismatchIsReported) {
+    int fd = AzRPC_TestConnect();
+    ASSERT_GE(fd, 0);
+    AzTest::EchoRequest request;
+    request.set_payload("corrupted in flight");
+    AzRPC::RpcHeader header;
+    header.set_service_name("EchoService");
+    header.set_method_name("Echo");
+    header.set_call_id(7);
+    header.set_checksum(true);
+    std::string frame;
+    ASSERT_TRUE(AzRPC_Codec::EncodeRequest(&header, request.SerializeAsString(), &frame));
+    frame[frame.size() - AzRPC_Codec::kChecksumSize - 1] ^= 0x20;
+
+    uint64_t calls = AzRPC_EchoService::EchoCalls();
+    AzRPC::RpcResponseHeader response_header;
+    std::string body;
+    ASSERT_TRUE(AzRPC_TestExchange(fd, frame, &response_header, &body));
+    EXPECT_EQ(response_header.error_code(), AzRPC::CHECKSUM_ERROR);
+    EXPECT_EQ(response_header.call_id(), 7u);
+    EXPECT_EQ(AzRPC_EchoService::EchoCalls(), calls);
+    char byte;
+    EXPECT_EQ(read(fd, &byte, 1), 0);
+    close(fd);
+}
+
+// 配置rpc_checksum=true时(loopback_io_uring.conf)请求和响应都带校验和, 调用结果不变
+TEST(LoopbackTest, ChecksummedCall) {
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    AzRPC_Controller controller;
+    AzTest::EchoRequest request;
+    request.set_payload(std::string(10000, 'c'));
+    AzTest::EchoResponse response;
+    stub.Echo(&controller, &request, &response, nullptr);
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.payload(), request.payload());
+}
+
+// 请求附件不经过序列化原样到达服务端, 服务端写入的响应附件同样原样返回
+TEST(LoopbackTest, AttachmentRoundTrip) {
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    std::shared_ptr<std::string> blob = std::make_shared<std::string>(256 * 1024, '\0');
+    for (size_t i = 0; i < blob->size(); ++i) {
+        (*blob)[i] = static_cast<char>(i * 31);
+    }
+    AzRPC_Controller controller;
+    controller.RequestAttachment().Append("prefix:", 7);
+    controller.RequestAttachment().AppendRef(blob->data(), blob->size(), blob);
+    AzTest::EchoRequest request;
+    request.set_payload("with attachment");
+    AzTest::EchoResponse response;
+    stub.Echo(&controller, &request, &response, nullptr);
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.payload(), "with attachment");
+    EXPECT_EQ(controller.ResponseAttachment().ToString(), "prefix:" + *blob);
+}
+
+// 双向流: 每写一条读一条回显, 条数超过窗口时靠双方归还的信用继续; 结束发送后收到汇总
+TEST(LoopbackTest, BidiStream) {
+    const int kMessages = 500;
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    std::unique_ptr<AzRPC_ClientStream> stream = channel.OpenStream(AzTest::EchoService::descriptor()->FindMethodByName("Stream"), &controller);
+    ASSERT_TRUE(stream != nullptr) << controller.ErrorText();
+    AzTest::EchoRequest request;
+    AzTest::EchoResponse response;
+    for (int i = 0; i < kMessages; ++i) {
+        request.set_payload("stream" + std::to_string(i));
+        ASSERT_TRUE(stream->Write(request)) << stream->ErrorText();
+        ASSERT_TRUE(stream->Read(&response)) << stream->ErrorText();
+        EXPECT_EQ(response.payload(), request.payload());
+        EXPECT_EQ(response.calls(), static_cast<uint64_t>(i + 1));
+    }
+    ASSERT_TRUE(stream->CloseSend());
+    ASSERT_TRUE(stream->Read(&response)) << stream->ErrorText();
+    EXPECT_EQ(response.payload(), std::to_string(kMessages));
+    EXPECT_FALSE(stream->Read(&response));
+    EXPECT_FALSE(stream->Failed()) << stream->ErrorText();
+}
+
+// 没有注册为流式方法的方法不能以流的方式调用
+TEST(LoopbackTest, StreamRejectsUnaryMethod) {
+    AzRPC_Channel channel(false);
+    AzRPC_Controller controller;
+    std::unique_ptr<AzRPC_ClientStream> stream = channel.OpenStream(AzTest::EchoService::descriptor()->FindMethodByName("Echo"), &controller);
+    ASSERT_TRUE(stream != nullptr) << controller.ErrorText();
+    AzTest::EchoResponse response;
+    EXPECT_FALSE(stream->Read(&response));
+    EXPECT_TRUE(stream->Failed());
+    EXPECT_NE(stream->ErrorText().find("is not a stream method"), std::string::npos) << stream->ErrorText();
+}
+
+// 同时进行的流达到rpcserver_max_streams时, 新的流收到OVERLOADED; 结束一个流后可以再打开
+TEST(LoopbackTest, StreamLimitRejectsExtraStreams) {
+    size_t max_streams = atol(AzRPC_Application::GetConfig().Load("rpcserver_max_streams").c_str());
+    if (max_streams == 0) {
+        GTEST_SKIP() << "rpcserver_max_streams not configured";
+    }
+    const google::protobuf::MethodDescriptor* method = AzTest::EchoService::descriptor()->FindMethodByName("Stream");
+    AzRPC_Channel channel(false);
+    AzTest::EchoRequest request;
+    request.set_payload("held");
+    AzTest::EchoResponse response;
+    // 每个流收到一条回复, 确认服务端已经为它启动了处理函数
+    std::vector<std::unique_ptr<AzRPC_ClientStream>> held;
+    for (size_t i = 0; i < max_streams; ++i) {
+        AzRPC_Controller controller;
+        held.push_back(channel.OpenStream(method, &controller));
+        ASSERT_TRUE(held.back() != nullptr) << controller.ErrorText();
+        ASSERT_TRUE(held.back()->Write(request)) << held.back()->ErrorText();
+        ASSERT_TRUE(held.back()->Read(&response)) << held.back()->ErrorText();
+    }
+
+    AzRPC_Controller controller;
+    std::unique_ptr<AzRPC_ClientStream> extra = channel.OpenStream(method, &controller);
+    ASSERT_TRUE(extra != nullptr) << controller.ErrorText();
+    EXPECT_FALSE(extra->Read(&response));
+    EXPECT_NE(extra->ErrorText().find("too many streams"), std::string::npos) << extra->ErrorText();
+
+    // 结束一个流, 服务端的处理函数返回后空出名额
+    ASSERT_TRUE(held.back()->CloseSend());
+    while (held.back()->Read(&response)) {
+    }
+    held.pop_back();
+    bool reopened = false;
+    for (int i = 0; i < 100 && !reopened; ++i) {
+        AzRPC_Controller retry_controller;
+        std::unique_ptr<AzRPC_ClientStream> stream = channel.OpenStream(method, &retry_controller);
+        ASSERT_TRUE(stream != nullptr) << retry_controller.ErrorText();
+        reopened = stream->Write(request) && stream->Read(&response);
+        if (!reopened) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    EXPECT_TRUE(reopened);
+}
+
+// 调用方只发不读时, 服务端的输出缓冲区超过rpcserver_output_high_water后暂停读取该连接, 不再执行新请求
+// 调用方开始读取后服务端恢复, 全部请求按顺序得到响应
+TEST(LoopbackTest, SlowReaderPausesServer) {
+    const int kRequests = 200;
+    const std::string payload(256 * 1024, 'w');
+    int fd = AzRPC_TestConnect();
+    ASSERT_GE(fd, 0);
+    uint64_t calls = AzRPC_EchoService::EchoCalls();
+    std::thread writer([fd, &payload] {
+        for (int i = 1; i <= kRequests; ++i) {
+            std::string frame = AzRPC_TestEchoFrame(i, payload);
+            size_t sent = 0;
+            while (sent < frame.size()) {
+                ssize_t n = write(fd, frame.data() + sent, frame.size() - sent);
+                if (n <= 0) {
+                    return;
+                }
+                sent += n;
+            }
+        }
+    });
+
+    // 等服务端不再执行新请求
+    uint64_t executed = AzRPC_EchoService::EchoCalls();
+    for (int i = 0; i < 100; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        uint64_t now = AzRPC_EchoService::EchoCalls();
+        if (now == executed && now > calls) {
+            break;
+        }
+        executed = now;
+    }
+    EXPECT_LT(executed - calls, static_cast<uint64_t>(kRequests));
+
+    std::string input;
+    char buf[65536];
+    for (uint64_t call_id = 1; call_id <= kRequests;) {
+        AzRPC::RpcResponseHeader header;
+        size_t body_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeResponse(input.data(), input.size(), &header, &body_offset);
+        ASSERT_GE(frame_size, 0);
+        if (frame_size == 0) {
+            ssize_t n = read(fd, buf, sizeof(buf));
+            ASSERT_GT(n, 0);
+            input.append(buf, n);
+            continue;
+        }
+        EXPECT_EQ(header.call_id(), call_id);
+        AzTest::EchoResponse response;
+        ASSERT_TRUE(response.ParseFromArray(input.data() + body_offset, header.body_size()));
+        EXPECT_EQ(response.payload().size(), payload.size());
+        input.erase(0, frame_size);
+        ++call_id;
+    }
+    writer.join();
+    close(fd);
+}
+
+// 多个线程同时发出相同的Coalesced调用, 只有一次到达业务方法, 所有调用拿到同一个结果
+// 调用方的合并在进程内生效; 从多个进程来的相同请求由服务端的合并处理
+TEST(LoopbackTest, IdenticalCallsAreCoalesced) {
+    if (AzRPC_Application::GetConfig().LoadForMethod("rpc_singleflight", "EchoService", "Coalesced") != "true") {
+        GTEST_SKIP() << "rpc_singleflight not enabled for EchoService.Coalesced";
+    }
+    const int kThreads = 8;
+    uint64_t calls = AzRPC_EchoService::CoalescedCalls();
+    std::vector<AzTest::EchoResponse> responses(kThreads);
+    std::vector<std::string> errors(kThreads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([i, &responses, &errors] {
+            AzRPC_Channel channel(false);
+            AzTest::EchoService_Stub stub(&channel);
+            AzRPC_Controller controller;
+            AzTest::EchoRequest request;
+            request.set_payload("same request");
+            request.set_sleep_ms(300);
+            stub.Coalesced(&controller, &request, &responses[i], nullptr);
+            errors[i] = controller.ErrorText();
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    EXPECT_LT(AzRPC_EchoService::CoalescedCalls() - calls, static_cast<uint64_t>(kThreads));
+    for (int i = 0; i < kThreads; ++i) {
+        EXPECT_EQ(errors[i], "");
+        EXPECT_EQ(responses[i].payload(), "same request");
+    }
+}
+
+// 调用方缓存的方法: 相同的请求第二次直接从本地缓存返回, 不同的请求照常调用
+TEST(LoopbackTest, CachedCallSkipsNetwork) {
+    if (AzRPC_Application::GetConfig().LoadForMethod("rpc_cache_ttl_ms", "EchoService", "Cached").empty()) {
+        GTEST_SKIP() << "rpc_cache_ttl_ms not configured for EchoService.Cached";
+    }
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    std::atomic<uint64_t>& hit = AzRPC_Metrics::Counter("client_cache_hit");
+    uint64_t hits = hit.load();
+    uint64_t calls = AzRPC_EchoService::CachedCalls();
+    for (const char* payload: {"cached", "cached", "other"}) {
+        AzRPC_Controller controller;
+        AzTest::EchoRequest request;
+        request.set_payload(payload);
+        AzTest::EchoResponse response;
+        stub.Cached(&controller, &request, &response, nullptr);
+        ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+        EXPECT_EQ(response.payload(), payload);
+    }
+    EXPECT_EQ(AzRPC_EchoService::CachedCalls() - calls, 2u);
+    EXPECT_EQ(hit.load() - hits, 1u);
+}
+
+// 服务端缓存的方法: 相同的请求第二次不再执行业务方法; InvalidateCache和InvalidateCachePrefix之后重新执行
+TEST(LoopbackTest, ServerCacheInvalidation) {
+    if (AzRPC_Application::GetConfig().LoadForMethod("rpcserver_cache_ttl_ms", "EchoService", "ServerCached").empty()) {
+        GTEST_SKIP() << "rpcserver_cache_ttl_ms not configured for EchoService.ServerCached";
+    }
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    AzTest::EchoRequest request;
+    request.set_payload("server cached");
+    auto call = [&]() {
+        AzRPC_Controller controller;
+        AzTest::EchoResponse response;
+        stub.ServerCached(&controller, &request, &response, nullptr);
+        EXPECT_FALSE(controller.Failed()) << controller.ErrorText();
+        EXPECT_EQ(response.payload(), request.payload());
+    };
+    uint64_t calls = AzRPC_EchoService::ServerCachedCalls();
+    call();
+    call();
+    EXPECT_EQ(AzRPC_EchoService::ServerCachedCalls() - calls, 1u);
+
+    AzRPC_Provider::InvalidateCache("EchoService", "ServerCached", request);
+    call();
+    call();
+    EXPECT_EQ(AzRPC_EchoService::ServerCachedCalls() - calls, 2u);
+
+    AzRPC_Provider::InvalidateCachePrefix("EchoService");
+    call();
+    EXPECT_EQ(AzRPC_EchoService::ServerCachedCalls() - calls, 3u);
+}
+
+// 并发上限为1的方法: 多个连接同时调用时, 超出名额的请求在等待队列中排队, 名额归还后恢复执行, 全部成功且不会同时执行
+TEST(LoopbackTest, LimitedMethodQueuesRequests) {
+    if (AzRPC_Application::GetConfig().LoadForMethod("rpcserver_max_concurrency", "EchoService", "Limited").empty()) {
+        GTEST_SKIP() << "rpcserver_max_concurrency not configured for EchoService.Limited";
+    }
+    const int kThreads = 4;
+    std::atomic<uint64_t>& queued = AzRPC_Metrics::Counter("provider_EchoService.Limited_queued");
+    uint64_t queued_before = queued.load();
+    uint64_t calls = AzRPC_EchoService::LimitedCalls();
+    std::atomic<int> failed(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        // 每个线程一个通道, 请求从不同的连接同时到达
+        threads.emplace_back([&failed, t] {
+            AzRPC_Channel channel(false);
+            AzTest::EchoService_Stub stub(&channel);
+            AzRPC_Controller controller;
+            AzTest::EchoRequest request;
+            request.set_payload("limited" + std::to_string(t));
+            request.set_sleep_ms(50);
+            AzTest::EchoResponse response;
+            stub.Limited(&controller, &request, &response, nullptr);
+            if (controller.Failed() || response.payload() != request.payload()) {
+                ++failed;
+            }
+        });
+    }
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_EQ(AzRPC_EchoService::LimitedCalls() - calls, static_cast<uint64_t>(kThreads));
+    EXPECT_EQ(AzRPC_EchoService::LimitedMaxRunning(), 1);
+    EXPECT_GE(queued.load() - queued_before, 1u);
+}
+
+// CallAsync同时发出多个调用, 用Then串联依赖前一个结果的调用, 失败的调用使future失败
+TEST(LoopbackTest, FutureCalls) {
+    AzRPC_Channel channel(false);
+    std::vector<AzRPC_Future<AzTest::EchoResponse>> futures;
+    for (int i = 0; i < 3; ++i) {
+        AzTest::EchoRequest request;
+        request.set_payload("async" + std::to_string(i));
+        futures.push_back(channel.CallAsync(&AzTest::EchoService_Stub::Echo, request));
+    }
+    AzRPC_Future<std::vector<AzRPC_Future<AzTest::EchoResponse>>> all = AzRPC_WhenAll(futures);
+    all.Wait();
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_FALSE(all.Value()[i].Failed()) << all.Value()[i].ErrorText();
+        EXPECT_EQ(all.Value()[i].Value().payload(), "async" + std::to_string(i));
+    }
+
+    AzTest::EchoRequest first;
+    first.set_payload("first");
+    AzRPC_Future<AzTest::EchoResponse> chained = channel.CallAsync(&AzTest::EchoService_Stub::Echo, first).Then([&channel](AzRPC_Future<AzTest::EchoResponse> f) {
+        AzTest::EchoRequest second;
+        second.set_payload(f.Value().payload() + "+second");
+        return channel.CallAsync(&AzTest::EchoService_Stub::Echo, second);
+    });
+    chained.Wait();
+    ASSERT_FALSE(chained.Failed()) << chained.ErrorText();
+    EXPECT_EQ(chained.Value().payload(), "first+second");
+
+    // Stream只注册为流式方法, 普通调用失败
+    AzTest::EchoRequest request;
+    AzRPC_Future<AzTest::EchoResponse> failed = channel.CallAsync(&AzTest::EchoService_Stub::Stream, request);
+    failed.Wait();
+    EXPECT_TRUE(failed.Failed());
+    EXPECT_FALSE(failed.ErrorText().empty());
+}
+
+// 批量调用: 一个帧中的子调用各自成功或失败, 结果写入各自的controller和response
+TEST(LoopbackTest, BatchCall) {
+    const int kCalls = 100;
+    const google::protobuf::ServiceDescriptor* service = AzTest::EchoService::descriptor();
+    AzRPC_Channel channel(false);
+    std::vector<AzRPC_Controller> controllers(kCalls);
+    std::vector<AzTest::EchoRequest> requests(kCalls);
+    std::vector<AzTest::EchoResponse> responses(kCalls);
+    std::vector<AzRPC_Channel::BatchItem> items;
+    for (int i = 0; i < kCalls; ++i) {
+        requests[i].set_payload("batch" + std::to_string(i));
+        // 每10个中有一个调用只注册为流式方法的Stream, 以普通方式调用会失败
+        const char* method = i % 10 == 9 ? "Stream" : (i % 2 == 0 ? "Echo" : "Coalesced");
+        items.push_back(AzRPC_Channel::BatchItem{service->FindMethodByName(method), &controllers[i], &requests[i], &responses[i]});
+    }
+    channel.BatchCall(items, nullptr);
+    for (int i = 0; i < kCalls; ++i) {
+        if (i % 10 == 9) {
+            EXPECT_TRUE(controllers[i].Failed()) << i;
+        }
+        else {
+            ASSERT_FALSE(controllers[i].Failed()) << i << ": " << controllers[i].ErrorText();
+            EXPECT_EQ(responses[i].payload(), requests[i].payload());
+        }
+    }
+
+    // 带done时全部完成后执行一次
+    std::vector<AzRPC_Controller> async_controllers(3);
+    std::vector<AzTest::EchoResponse> async_responses(3);
+    std::vector<AzRPC_Channel::BatchItem> async_items;
+    for (int i = 0; i < 3; ++i) {
+        async_items.push_back(AzRPC_Channel::BatchItem{service->FindMethodByName("Echo"), &async_controllers[i], &requests[i], &async_responses[i]});
+    }
+    struct Finished {
+        std::mutex mtx;
+        std::condition_variable cv;
+        int count = 0;
+        void Run() {
+            std::lock_guard<std::mutex> lock(mtx);
+            ++count;
+            cv.notify_all();
+        }
+    } finished;
+    channel.BatchCall(async_items, google::protobuf::NewCallback(&finished, &Finished::Run));
+    {
+        std::unique_lock<std::mutex> lock(finished.mtx);
+        ASSERT_TRUE(finished.cv.wait_for(lock, std::chrono::seconds(5), [&] { return finished.count > 0; }));
+        EXPECT_EQ(finished.count, 1);
+    }
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_FALSE(async_controllers[i].Failed()) << async_controllers[i].ErrorText();
+        EXPECT_EQ(async_responses[i].payload(), requests[i].payload());
+    }
+}
+
+// 多个线程同时使用同一个channel: 第一次调用只建立一条连接, 每个调用拿到自己的响应, 期间打开的流不影响普通调用
+TEST(LoopbackTest, SharedChannelConcurrentCalls) {
+    const int kThreads = 8;
+    const int kCalls = 100;
+    AzRPC_Channel channel(false);
+    std::atomic<int> mismatched(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&channel, &mismatched, t] {
+            AzTest::EchoService_Stub stub(&channel);
+            for (int i = 0; i < kCalls; ++i) {
+                AzRPC_Controller controller;
+                AzTest::EchoRequest request;
+                request.set_payload(std::to_string(t) + ":" + std::to_string(i));
+                AzTest::EchoResponse response;
+                stub.Echo(&controller, &request, &response, nullptr);
+                if (controller.Failed() || response.payload() != request.payload()) {
+                    ++mismatched;
+                }
+            }
+        });
+    }
+    threads.emplace_back([&channel, &mismatched] {
+        for (int i = 0; i < 10; ++i) {
+            AzRPC_Controller controller;
+            std::unique_ptr<AzRPC_ClientStream> stream = channel.OpenStream(AzTest::EchoService::descriptor()->FindMethodByName("Stream"), &controller);
+            AzTest::EchoRequest request;
+            request.set_payload("stream" + std::to_string(i));
+            AzTest::EchoResponse response;
+            if (stream == nullptr || !stream->Write(request) || !stream->Read(&response) || response.payload() != request.payload() || !stream->CloseSend()) {
+                ++mismatched;
+            }
+        }
+    });
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatched.load(), 0);
+}
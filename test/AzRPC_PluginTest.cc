@@ -0,0 +1,98 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Channel.h"
+#include "typed_echo.azrpc.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace {
+
+// 由生成的服务基类分发: 业务方法直接以具体的消息类型声明, Stream方法在发布时自动注册为流式方法
+class TypedEchoService: public AzTest::TypedEchoService_AzService {
+public:
+    void Echo(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) override {
+        response->set_payload("typed:" + request->payload());
+        response->set_calls(++m_calls);
+        done->Run();
+    }
+
+    void Stream(AzRPC_ServerStream* stream) override {
+        AzRPC_EchoService::StreamEcho(stream);
+    }
+
+private:
+    std::atomic<uint64_t> m_calls{0};
+};
+
+const bool kRegistered = [] {
+    AzRPC_TestServer::AddService(new TypedEchoService());
+    return true;
+}();
+
+}  // namespace
+
+// 方法编号与proto中的声明顺序一致, 按编号构造具体的消息类型
+TEST(PluginTest, DispatcherBuildsTypedMessages) {
+    TypedEchoService service;
+    EXPECT_EQ(service.GetDescriptor()->full_name(), "AzTest.TypedEchoService");
+    EXPECT_EQ(service.GetDescriptor()->method(AzTest::TypedEchoService_AzService::kStream)->name(), "Stream");
+    std::unique_ptr<google::protobuf::Message> request(service.NewRequest(AzTest::TypedEchoService_AzService::kEcho));
+    ASSERT_TRUE(request != nullptr);
+    EXPECT_EQ(request->GetDescriptor(), AzTest::EchoRequest::descriptor());
+    std::unique_ptr<google::protobuf::Message> response(service.NewResponse(AzTest::TypedEchoService_AzService::kEcho));
+    EXPECT_EQ(response->GetDescriptor(), AzTest::EchoResponse::descriptor());
+    EXPECT_EQ(service.NewRequest(100), nullptr);
+}
+
+// 生成的stub同步调用和返回future的异步调用
+TEST(PluginTest, StubCallsTypedService) {
+    AzRPC_Channel channel(false);
+    AzTest::TypedEchoService_AzStub stub(&channel);
+    AzRPC_Controller controller;
+    AzTest::EchoRequest request;
+    request.set_payload("sync");
+    AzTest::EchoResponse response;
+    stub.Echo(&controller, &request, &response, nullptr);
+    ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+    EXPECT_EQ(response.payload(), "typed:sync");
+
+    request.set_payload("async");
+    AzRPC_Future<AzTest::EchoResponse> future = stub.EchoAsync(request);
+    future.Wait();
+    ASSERT_FALSE(future.Failed()) << future.ErrorText();
+    EXPECT_EQ(future.Value().payload(), "typed:async");
+    EXPECT_GT(future.Value().calls(), response.calls());
+}
+
+// 没有重写的方法使用生成的默认实现
+TEST(PluginTest, UnimplementedMethodFails) {
+    AzRPC_Channel channel(false);
+    AzTest::TypedEchoService_AzStub stub(&channel);
+    AzRPC_Controller controller;
+    AzTest::EchoRequest request;
+    AzTest::EchoResponse response;
+    stub.Unimplemented(&controller, &request, &response, nullptr);
+    EXPECT_TRUE(controller.Failed());
+    EXPECT_EQ(controller.ErrorText(), "Method Unimplemented() not implemented.");
+}
+
+// 声明为stream的方法不需要NotifyStreamMethod, stub直接打开流
+TEST(PluginTest, StreamMethodIsRegistered) {
+    AzRPC_Channel channel(false);
+    AzTest::TypedEchoService_AzStub stub(&channel);
+    AzRPC_Controller controller;
+    std::unique_ptr<AzRPC_ClientStream> stream = stub.Stream(&controller);
+    ASSERT_TRUE(stream != nullptr) << controller.ErrorText();
+    AzTest::EchoRequest request;
+    AzTest::EchoResponse response;
+    for (int i = 0; i < 3; ++i) {
+        request.set_payload("typed stream " + std::to_string(i));
+        ASSERT_TRUE(stream->Write(request)) << stream->ErrorText();
+        ASSERT_TRUE(stream->Read(&response)) << stream->ErrorText();
+        EXPECT_EQ(response.payload(), request.payload());
+    }
+    ASSERT_TRUE(stream->CloseSend());
+    ASSERT_TRUE(stream->Read(&response)) << stream->ErrorText();
+    EXPECT_EQ(response.payload(), "3");
+}
@@ -0,0 +1,67 @@
+#include "AzRPC_Registry.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+TEST(RegistryTest, MemoryCreateNeedsParent) {
+    AzRPC_MemoryRegistry registry;
+    ASSERT_TRUE(registry.Start());
+    EXPECT_FALSE(registry.Create("/RegistryTestA/Login", "127.0.0.1:8000", true));
+    EXPECT_TRUE(registry.Create("/RegistryTestA", "", false));
+    EXPECT_TRUE(registry.Create("/RegistryTestA/Login", "127.0.0.1:8000", true));
+    EXPECT_FALSE(registry.Create("/RegistryTestA/Login", "127.0.0.1:8001", true));
+    EXPECT_EQ(registry.GetData("/RegistryTestA/Login"), "127.0.0.1:8000");
+}
+
+// 进程内的所有实例共享节点树, 临时节点随创建它的实例析构而删除, 并触发watch
+TEST(RegistryTest, MemoryEphemeralNodeEndsWithSession) {
+    AzRPC_MemoryRegistry observer;
+    std::vector<std::string> fired;
+    {
+        AzRPC_MemoryRegistry provider;
+        ASSERT_TRUE(provider.Create("/RegistryTestB", "", false));
+        ASSERT_TRUE(provider.Create("/RegistryTestB/Login", "127.0.0.1:8000", true));
+        EXPECT_TRUE(observer.Exists("/RegistryTestB/Login"));
+        observer.Watch("/RegistryTestB/Login", [&fired](const std::string& path) { fired.push_back(path); });
+    }
+    EXPECT_FALSE(observer.Exists("/RegistryTestB/Login"));
+    EXPECT_TRUE(observer.Exists("/RegistryTestB"));
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0], "/RegistryTestB/Login");
+}
+
+TEST(RegistryTest, MemoryWatchFiresOnce) {
+    AzRPC_MemoryRegistry registry;
+    ASSERT_TRUE(registry.Create("/RegistryTestC", "a", false));
+    int fired = 0;
+    registry.Watch("/RegistryTestC", [&fired](const std::string&) { ++fired; });
+    EXPECT_TRUE(registry.SetData("/RegistryTestC", "b"));
+    EXPECT_TRUE(registry.SetData("/RegistryTestC", "c"));
+    EXPECT_EQ(fired, 1);
+    EXPECT_EQ(registry.GetData("/RegistryTestC"), "c");
+    EXPECT_TRUE(registry.Delete("/RegistryTestC"));
+    EXPECT_FALSE(registry.Delete("/RegistryTestC"));
+}
+
+// 静态文件中方法没有单独配置时使用服务的地址
+TEST(RegistryTest, FileFallsBackToService) {
+    char path[] = "/tmp/azrpc_registry_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    std::string content = "# 测试\n/UserServiceRpc=127.0.0.1:8000\n/UserServiceRpc/Login=127.0.0.1:9000\n";
+    ASSERT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    close(fd);
+
+    AzRPC_FileRegistry registry(path);
+    ASSERT_TRUE(registry.Start());
+    EXPECT_EQ(registry.GetData("/UserServiceRpc/Login"), "127.0.0.1:9000");
+    EXPECT_EQ(registry.GetData("/UserServiceRpc/Register"), "127.0.0.1:8000");
+    EXPECT_TRUE(registry.Exists("/UserServiceRpc/Register"));
+    EXPECT_EQ(registry.GetData("/OtherService/Login"), "");
+    unlink(path);
+
+    AzRPC_FileRegistry missing(path);
+    EXPECT_FALSE(missing.Start());
+}
@@ -0,0 +1,62 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Channel.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// rpcserver_reuseport=true时服务端的监听socket都带有SO_REUSEPORT, 同一用户的其他SO_REUSEPORT socket可以绑定同一端口
+// 否则端口被独占, 绑定失败; 只绑定不监听, 不会分走服务端的连接
+TEST(ReusePortTest, ListenersMatchConfig) {
+    AzRPC_Config& config = AzRPC_Application::GetConfig();
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    int on = 1;
+    ASSERT_EQ(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)), 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(atoi(config.Load("rpcserverport").c_str())));
+    inet_pton(AF_INET, config.Load("rpcserverip").c_str(), &addr.sin_addr);
+    int rt = bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    close(fd);
+    if (config.Load("rpcserver_reuseport") == "true") {
+        EXPECT_EQ(rt, 0);
+    }
+    else {
+        EXPECT_NE(rt, 0);
+    }
+}
+
+// 大量调用方同时建立连接并调用, 连接分散到各IO线程后都能正常收发
+TEST(ReusePortTest, ConcurrentConnections) {
+    const int kClients = 16;
+    const int kCalls = 20;
+    std::atomic<int> succeeded(0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < kClients; ++c) {
+        clients.emplace_back([&succeeded, c] {
+            AzRPC_Channel channel(false);
+            AzTest::EchoService_Stub stub(&channel);
+            for (int i = 0; i < kCalls; ++i) {
+                AzRPC_Controller controller;
+                AzTest::EchoRequest request;
+                request.set_payload(std::to_string(c) + "/" + std::to_string(i));
+                AzTest::EchoResponse response;
+                stub.Echo(&controller, &request, &response, nullptr);
+                if (!controller.Failed() && response.payload() == request.payload()) {
+                    ++succeeded;
+                }
+            }
+        });
+    }
+    for (std::thread& client: clients) {
+        client.join();
+    }
+    EXPECT_EQ(succeeded.load(), kClients * kCalls);
+}
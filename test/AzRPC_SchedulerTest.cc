@@ -0,0 +1,149 @@
+#include "AzRPC_Scheduler.h"
+#include "AzRPC_Metrics.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 只有一个处理线程的调度器, 构造时用一个任务占住处理线程, 之后提交的请求都在排队, Release后按调度顺序执行
+class BlockedScheduler {
+public:
+    explicit BlockedScheduler(size_t queue_limit): m_released(false), m_scheduler(1, queue_limit) {
+        std::promise<void> started;
+        m_scheduler.Submit(AzRPC::PRIORITY_CRITICAL, "blocker", 1, [this, &started] {
+            started.set_value();
+            std::unique_lock<std::mutex> lock(m_mtx);
+            m_cv.wait(lock, [this] { return m_released; });
+        }, nullptr);
+        started.get_future().wait();
+    }
+    // 断言失败提前返回时也要放开处理线程; m_scheduler最后声明, 先于任务使用的成员析构
+    ~BlockedScheduler() {
+        Release(0);
+    }
+
+    AzRPC_Scheduler::Task Record(const std::string& name) {
+        return [this, name] {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_order.push_back(name);
+            m_cv.notify_all();
+        };
+    }
+    bool Submit(AzRPC::Priority priority, const std::string& flow, uint32_t weight, const std::string& name) {
+        return m_scheduler.Submit(priority, flow, weight, Record(name), [this, name] { m_shed.push_back(name); });
+    }
+    void Resume(const std::string& name) {
+        m_scheduler.Resume(Record(name));
+    }
+
+    // 放开处理线程, 等待count个请求执行完, 返回执行顺序
+    std::vector<std::string> Release(size_t count) {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_released = true;
+        m_cv.notify_all();
+        m_cv.wait_for(lock, std::chrono::seconds(5), [this, count] { return m_order.size() >= count; });
+        return m_order;
+    }
+    const std::vector<std::string>& Shed() const { return m_shed; }
+
+private:
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    bool m_released;
+    std::vector<std::string> m_order;
+    std::vector<std::string> m_shed;      // shed在提交线程中执行
+    AzRPC_Scheduler m_scheduler;
+};
+
+}  // namespace
+
+// 类别之间严格优先, 与提交顺序无关
+TEST(SchedulerTest, PriorityClassesRunInOrder) {
+    BlockedScheduler blocked(16);
+    blocked.Submit(AzRPC::PRIORITY_LOW, "f", 1, "low");
+    blocked.Submit(AzRPC::PRIORITY_NORMAL, "f", 1, "normal");
+    blocked.Submit(AzRPC::PRIORITY_HIGH, "f", 1, "high");
+    blocked.Submit(AzRPC::PRIORITY_CRITICAL, "f", 1, "critical");
+    std::vector<std::string> expected = {"critical", "high", "normal", "low"};
+    EXPECT_EQ(blocked.Release(4), expected);
+}
+
+// 同一类别中的流按权重轮转: A每轮连续执行2个, B执行1个, 一个流排得多不会饿死其他流
+TEST(SchedulerTest, FlowsShareByWeight) {
+    BlockedScheduler blocked(16);
+    for (int i = 0; i < 4; ++i) {
+        blocked.Submit(AzRPC::PRIORITY_NORMAL, "A", 2, "A" + std::to_string(i));
+    }
+    for (int i = 0; i < 2; ++i) {
+        blocked.Submit(AzRPC::PRIORITY_NORMAL, "B", 1, "B" + std::to_string(i));
+    }
+    std::vector<std::string> expected = {"A0", "A1", "B0", "A2", "A3", "B1"};
+    EXPECT_EQ(blocked.Release(6), expected);
+}
+
+// 队列满时丢弃更低类别中排队最多的流的最新请求(一样多时取先排队的流), 在提交线程中执行它的shed; 没有更低类别的请求时拒绝新请求
+TEST(SchedulerTest, FullQueueShedsLowerClass) {
+    std::atomic<uint64_t>& low_shed = AzRPC_Metrics::Counter("provider_shed_low");
+    std::atomic<uint64_t>& normal_shed = AzRPC_Metrics::Counter("provider_shed_normal");
+    uint64_t low_before = low_shed.load();
+    uint64_t normal_before = normal_shed.load();
+
+    BlockedScheduler blocked(3);
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_LOW, "small", 1, "S0"));
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_LOW, "large", 1, "L0"));
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_LOW, "large", 1, "L1"));
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_NORMAL, "f", 1, "N0"));
+    std::vector<std::string> shed = {"L1"};
+    EXPECT_EQ(blocked.Shed(), shed);
+    // 同类别的请求不能互相挤掉
+    EXPECT_FALSE(blocked.Submit(AzRPC::PRIORITY_LOW, "small", 1, "S1"));
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_HIGH, "f", 1, "H0"));
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_HIGH, "f", 1, "H1"));
+    EXPECT_FALSE(blocked.Submit(AzRPC::PRIORITY_NORMAL, "f", 1, "N1"));
+    shed = {"L1", "S0", "L0"};
+    EXPECT_EQ(blocked.Shed(), shed);
+
+    std::vector<std::string> expected = {"H0", "H1", "N0"};
+    EXPECT_EQ(blocked.Release(3), expected);
+    EXPECT_EQ(low_shed.load() - low_before, 4u);
+    EXPECT_EQ(normal_shed.load() - normal_before, 1u);
+}
+
+// Resume的请求排在所有类别之前, 也不计入排队上限
+TEST(SchedulerTest, ResumedRunsFirst) {
+    BlockedScheduler blocked(1);
+    EXPECT_TRUE(blocked.Submit(AzRPC::PRIORITY_CRITICAL, "f", 1, "critical"));
+    blocked.Resume("resumed");
+    std::vector<std::string> expected = {"resumed", "critical"};
+    EXPECT_EQ(blocked.Release(2), expected);
+}
+
+// Stop之后不再接受请求
+TEST(SchedulerTest, StopRejectsSubmit) {
+    AzRPC_Scheduler scheduler(2, 16);
+    std::promise<void> ran;
+    EXPECT_TRUE(scheduler.Submit(AzRPC::PRIORITY_NORMAL, "f", 1, [&ran] { ran.set_value(); }, nullptr));
+    ran.get_future().wait();
+    scheduler.Stop();
+    bool called = false;
+    EXPECT_FALSE(scheduler.Submit(AzRPC::PRIORITY_CRITICAL, "f", 1, [&called] { called = true; }, [&called] { called = true; }));
+    scheduler.Resume([&called] { called = true; });
+    scheduler.Stop();
+    EXPECT_FALSE(called);
+}
+
+TEST(SchedulerTest, ParsePriority) {
+    AzRPC::Priority priority = AzRPC::PRIORITY_NORMAL;
+    EXPECT_TRUE(AzRPC_Scheduler::ParsePriority("critical", &priority));
+    EXPECT_EQ(priority, AzRPC::PRIORITY_CRITICAL);
+    EXPECT_TRUE(AzRPC_Scheduler::ParsePriority("low", &priority));
+    EXPECT_EQ(priority, AzRPC::PRIORITY_LOW);
+    EXPECT_FALSE(AzRPC_Scheduler::ParsePriority("urgent", &priority));
+    EXPECT_EQ(priority, AzRPC::PRIORITY_LOW);
+}
@@ -0,0 +1,42 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Channel.h"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+
+namespace {
+
+// 本进程映射了框架创建的共享内存段(服务端和调用方在同一进程中, 两端都映射)
+bool ShmMapped() {
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line)) {
+        if (line.find("/dev/shm/azrpc-") != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// 两端都配置rpc_shm=true时, 同主机的调用协商后改走共享内存, 对调用方透明
+TEST(ShmLoopbackTest, CallsUseSharedMemory) {
+    if (AzRPC_Application::GetConfig().Load("rpc_shm") != "true") {
+        GTEST_SKIP() << "rpc_shm not enabled";
+    }
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    for (int i = 0; i < 20; ++i) {
+        AzRPC_Controller controller;
+        AzTest::EchoRequest request;
+        // 超过环的大小(rpc_shm_ring_size)的请求分段写入
+        request.set_payload(std::string(i == 0 ? 100000 : 100, 's'));
+        AzTest::EchoResponse response;
+        stub.Echo(&controller, &request, &response, nullptr);
+        ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+        EXPECT_EQ(response.payload(), request.payload());
+    }
+    EXPECT_TRUE(ShmMapped());
+}
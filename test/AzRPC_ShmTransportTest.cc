@@ -0,0 +1,109 @@
+#include "AzRPC_ShmTransport.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TEST(ShmTransportTest, RoundTrip) {
+    std::unique_ptr<AzRPC_ShmSegment> caller = AzRPC_ShmSegment::Create(4096);
+    ASSERT_NE(caller, nullptr);
+    std::unique_ptr<AzRPC_ShmSegment> provider = AzRPC_ShmSegment::Open(caller->Name());
+    ASSERT_NE(provider, nullptr);
+    caller->Unlink();
+
+    ASSERT_TRUE(caller->Request().Write("request", 7));
+    std::string in;
+    EXPECT_EQ(provider->Request().Read(&in, 100), 7);
+    EXPECT_EQ(in, "request");
+
+    ASSERT_TRUE(provider->Response().Write("response", 8));
+    std::string out;
+    EXPECT_EQ(caller->Response().Read(&out, 100), 8);
+    EXPECT_EQ(out, "response");
+
+    // 没有数据时等待超时返回0
+    EXPECT_EQ(caller->Response().Read(&out, 10), 0);
+}
+
+// 比环大的数据分段写入, 写满时等待读取方腾出空间
+TEST(ShmTransportTest, WriteLargerThanRing) {
+    std::unique_ptr<AzRPC_ShmSegment> caller = AzRPC_ShmSegment::Create(4096);
+    ASSERT_NE(caller, nullptr);
+    std::unique_ptr<AzRPC_ShmSegment> provider = AzRPC_ShmSegment::Open(caller->Name());
+    ASSERT_NE(provider, nullptr);
+    caller->Unlink();
+
+    std::string data;
+    for (int i = 0; i < 50000; ++i) {
+        data.push_back(static_cast<char>(i * 31));
+    }
+    std::thread writer([&caller, &data] {
+        EXPECT_TRUE(caller->Request().Write(data.data(), data.size()));
+    });
+    std::string received;
+    while (received.size() < data.size()) {
+        ASSERT_GE(provider->Request().Read(&received, 1000), 0);
+    }
+    writer.join();
+    EXPECT_EQ(received, data);
+}
+
+TEST(ShmTransportTest, CloseEndsBothSides) {
+    std::unique_ptr<AzRPC_ShmSegment> caller = AzRPC_ShmSegment::Create(4096);
+    ASSERT_NE(caller, nullptr);
+    std::unique_ptr<AzRPC_ShmSegment> provider = AzRPC_ShmSegment::Open(caller->Name());
+    ASSERT_NE(provider, nullptr);
+    caller->Unlink();
+
+    ASSERT_TRUE(caller->Request().Write("last", 4));
+    std::thread closer([&caller] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        caller->Close();
+    });
+    // 关闭前写入的数据仍然可以读到, 之后返回-1; 等待中的读取方被唤醒
+    std::string in;
+    EXPECT_EQ(provider->Request().Read(&in, 1000), 4);
+    EXPECT_EQ(provider->Request().Read(&in, 1000), -1);
+    closer.join();
+    EXPECT_TRUE(provider->Closed());
+    EXPECT_FALSE(provider->Response().Write("x", 1));
+}
+
+// 段名由对端提供, 只打开本框架生成的名字
+TEST(ShmTransportTest, OpenRejectsForeignNames) {
+    EXPECT_EQ(AzRPC_ShmSegment::Open("/etc"), nullptr);
+    EXPECT_EQ(AzRPC_ShmSegment::Open("/azrpc-1/../x"), nullptr);
+    EXPECT_EQ(AzRPC_ShmSegment::Open("/azrpc-does-not-exist"), nullptr);
+}
+
+// 对端改写了共享内存中的读写位置时, 关闭段而不是越界读取
+TEST(ShmTransportTest, CorruptedOffsetsCloseSegment) {
+    std::unique_ptr<AzRPC_ShmSegment> caller = AzRPC_ShmSegment::Create(4096);
+    ASSERT_NE(caller, nullptr);
+    std::unique_ptr<AzRPC_ShmSegment> provider = AzRPC_ShmSegment::Open(caller->Name());
+    ASSERT_NE(provider, nullptr);
+
+    // 模拟恶意的调用方: 直接映射段, 段头(64字节)之后是请求环的控制块
+    int fd = shm_open(caller->Name().c_str(), O_RDWR, 0);
+    ASSERT_GE(fd, 0);
+    struct stat st;
+    ASSERT_EQ(fstat(fd, &st), 0);
+    void* addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    caller->Unlink();
+    ASSERT_NE(addr, MAP_FAILED);
+    AzRPC_ShmRingHeader* request = reinterpret_cast<AzRPC_ShmRingHeader*>(static_cast<char*>(addr) + 64);
+    request->capacity = 1UL << 30;
+    request->head.store(request->tail.load() + (1UL << 20));
+
+    std::string in;
+    EXPECT_EQ(provider->Request().Read(&in, 100), -1);
+    EXPECT_TRUE(in.empty());
+    EXPECT_TRUE(provider->Closed());
+    EXPECT_FALSE(caller->Request().Write("x", 1));
+    munmap(addr, st.st_size);
+}
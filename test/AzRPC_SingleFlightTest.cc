@@ -0,0 +1,85 @@
+#include "AzRPC_SingleFlight.h"
+#include "AzRPC_Controller.h"
+#include "echo.pb.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string Key(const std::string& method, const std::string& payload) {
+    AzTest::EchoRequest request;
+    request.set_payload(payload);
+    std::string key;
+    EXPECT_TRUE(AzRPC_SingleFlight::MakeKey("EchoService", method, request, &key));
+    return key;
+}
+
+}  // namespace
+
+// 按unit.conf中的rpc_singleflight.SingleFlightTestService.Read开启, 同一服务的其他方法不合并
+TEST(SingleFlightTest, EnabledPerMethod) {
+    EXPECT_TRUE(AzRPC_SingleFlight::Enabled("SingleFlightTestService", "Read"));
+    EXPECT_FALSE(AzRPC_SingleFlight::Enabled("SingleFlightTestService", "Write"));
+    EXPECT_FALSE(AzRPC_SingleFlight::Enabled("EchoService", "Echo"));
+}
+
+// 键包含方法名和完整的请求参数, 不同的调用不会被合并
+TEST(SingleFlightTest, KeyDistinguishesCalls) {
+    EXPECT_EQ(Key("Echo", "a"), Key("Echo", "a"));
+    EXPECT_NE(Key("Echo", "a"), Key("Echo", "b"));
+    EXPECT_NE(Key("Echo", "a"), Key("Other", "a"));
+}
+
+// 第一个调用负责发出, 之后加入的调用在Finish时拿到同一个结果, 结束后同样的键重新开始
+TEST(SingleFlightTest, WaitersShareResult) {
+    AzRPC_SingleFlight& flight = AzRPC_SingleFlight::Instance();
+    std::string key = Key("Echo", "shared");
+    std::vector<std::unique_ptr<AzTest::EchoResponse>> responses;
+    std::vector<std::unique_ptr<AzRPC_Controller>> controllers;
+    ASSERT_TRUE(flight.Join(key, nullptr));
+    for (int i = 0; i < 3; ++i) {
+        responses.emplace_back(new AzTest::EchoResponse());
+        controllers.emplace_back(new AzRPC_Controller());
+        AzTest::EchoResponse* response = responses.back().get();
+        AzRPC_Controller* controller = controllers.back().get();
+        EXPECT_FALSE(flight.Join(key, [response, controller](const AzRPC_SingleFlight::Result& result) {
+            AzRPC_SingleFlight::Apply(result, controller, response);
+        }));
+    }
+
+    AzRPC_Controller controller;
+    controller.ResponseAttachment().Append("attached", 8);
+    AzTest::EchoResponse response;
+    response.set_payload("shared");
+    response.set_calls(1);
+    flight.Finish(key, &controller, &response);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_FALSE(controllers[i]->Failed());
+        EXPECT_EQ(responses[i]->payload(), "shared");
+        EXPECT_EQ(responses[i]->calls(), 1u);
+        // 等待者共享附件的块, 不拷贝
+        ASSERT_EQ(controllers[i]->ResponseAttachment().Blocks().size(), 1u);
+        EXPECT_EQ(controllers[i]->ResponseAttachment().Blocks()[0].data, controller.ResponseAttachment().Blocks()[0].data);
+    }
+    EXPECT_TRUE(flight.Join(key, nullptr));
+    flight.Finish(key, &controller, &response);
+}
+
+// 发出的调用失败时等待者以同样的错误失败
+TEST(SingleFlightTest, FailureIsShared) {
+    AzRPC_SingleFlight& flight = AzRPC_SingleFlight::Instance();
+    std::string key = Key("Echo", "failing");
+    ASSERT_TRUE(flight.Join(key, nullptr));
+    AzRPC_Controller waiter_controller;
+    AzTest::EchoResponse waiter_response;
+    EXPECT_FALSE(flight.Join(key, [&](const AzRPC_SingleFlight::Result& result) {
+        AzRPC_SingleFlight::Apply(result, &waiter_controller, &waiter_response);
+    }));
+    AzRPC_Controller controller;
+    controller.SetFailed("upstream timeout");
+    flight.Finish(key, &controller, nullptr);
+    EXPECT_TRUE(waiter_controller.Failed());
+    EXPECT_EQ(waiter_controller.ErrorText(), "upstream timeout");
+}
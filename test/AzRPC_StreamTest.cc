@@ -0,0 +1,193 @@
+#include "AzRPC_Stream.h"
+#include "AzRPC_Codec.h"
+#include "echo.pb.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// 流的窗口为默认的64条消息(unit.conf没有配置rpc_stream_window)
+const uint32_t kWindow = 64;
+
+// 用socketpair把AzRPC_ClientStream接到一个AzRPC_ServerStream上, 代替AzRPC_Provider转发帧
+// 收到STREAM_OPEN时创建服务端的流并在独立线程中运行handler, 与Provider相同
+class StreamPair {
+public:
+    explicit StreamPair(std::function<void(AzRPC_ServerStream*)> handler): m_handler(std::move(handler)) {
+        int fds[2];
+        EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        m_server_fd = fds[1];
+        m_client.reset(new AzRPC_ClientStream(fds[0], 1, true));
+        m_pump = std::thread(&StreamPair::Pump, this);
+    }
+
+    ~StreamPair() {
+        m_client.reset();   // 关闭调用方的连接, 服务端的流随之结束
+        m_pump.join();
+        if (m_handler_thread.joinable()) {
+            m_handler_thread.join();
+        }
+        close(m_server_fd);
+    }
+
+    AzRPC_ClientStream* Client() { return m_client.get(); }
+
+private:
+    std::function<void(AzRPC_ServerStream*)> m_handler;
+    int m_server_fd;
+    std::mutex m_send_mtx;
+    std::unique_ptr<AzRPC_ClientStream> m_client;
+    std::shared_ptr<AzRPC_ServerStream> m_stream;
+    std::thread m_pump;
+    std::thread m_handler_thread;
+
+    void Send(const std::string& frame) {
+        std::lock_guard<std::mutex> lock(m_send_mtx);
+        size_t sent = 0;
+        while (sent < frame.size()) {
+            ssize_t n = send(m_server_fd, frame.data() + sent, frame.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                return;
+            }
+            sent += n;
+        }
+    }
+
+    void Pump() {
+        std::string input;
+        char buf[16384];
+        while (true) {
+            ssize_t n = read(m_server_fd, buf, sizeof(buf));
+            if (n <= 0) {
+                break;
+            }
+            input.append(buf, n);
+            while (true) {
+                AzRPC::RpcHeader header;
+                size_t body_offset = 0;
+                int frame_size = AzRPC_Codec::DecodeRequest(input.data(), input.size(), &header, &body_offset);
+                if (frame_size <= 0) {
+                    break;
+                }
+                if (header.stream_type() == AzRPC::STREAM_OPEN) {
+                    m_stream = std::make_shared<AzRPC_ServerStream>(header.call_id(), header.checksum(), header.stream_credits(), [this](const std::string& frame) {
+                        Send(frame);
+                    });
+                    m_stream->Open();
+                    std::shared_ptr<AzRPC_ServerStream> stream = m_stream;
+                    m_handler_thread = std::thread([this, stream] {
+                        m_handler(stream.get());
+                        stream->Finish();
+                    });
+                }
+                else if (m_stream) {
+                    m_stream->OnFrame(header, input.data() + body_offset);
+                }
+                input.erase(0, frame_size);
+            }
+        }
+        if (m_stream) {
+            m_stream->Close();
+        }
+    }
+};
+
+AzTest::EchoRequest Request(const std::string& payload) {
+    AzTest::EchoRequest request;
+    request.set_payload(payload);
+    return request;
+}
+
+AzTest::EchoResponse Response(const std::string& payload) {
+    AzTest::EchoResponse response;
+    response.set_payload(payload);
+    return response;
+}
+
+}  // namespace
+
+// 服务端流: 消息条数远超窗口, 调用方边读边归还信用, 全部按顺序收到
+TEST(StreamTest, ServerStreaming) {
+    const int kMessages = 1000;
+    StreamPair pair([](AzRPC_ServerStream* stream) {
+        for (int i = 0; i < kMessages; ++i) {
+            ASSERT_TRUE(stream->Write(Response(std::to_string(i))));
+        }
+    });
+    ASSERT_TRUE(pair.Client()->Open("EchoService", "Stream"));
+    AzTest::EchoResponse response;
+    for (int i = 0; i < kMessages; ++i) {
+        ASSERT_TRUE(pair.Client()->Read(&response)) << pair.Client()->ErrorText();
+        EXPECT_EQ(response.payload(), std::to_string(i));
+    }
+    EXPECT_FALSE(pair.Client()->Read(&response));
+    EXPECT_FALSE(pair.Client()->Failed()) << pair.Client()->ErrorText();
+}
+
+// 客户端流: 调用方的写入受服务端窗口限制, CloseSend之后服务端读完全部消息并返回汇总
+TEST(StreamTest, ClientStreaming) {
+    const int kMessages = 1000;
+    StreamPair pair([](AzRPC_ServerStream* stream) {
+        AzTest::EchoRequest request;
+        int count = 0;
+        std::string last;
+        while (stream->Read(&request)) {
+            ++count;
+            last = request.payload();
+        }
+        stream->Write(Response(std::to_string(count) + ":" + last));
+    });
+    ASSERT_TRUE(pair.Client()->Open("EchoService", "Stream"));
+    for (int i = 0; i < kMessages; ++i) {
+        ASSERT_TRUE(pair.Client()->Write(Request(std::to_string(i)))) << pair.Client()->ErrorText();
+    }
+    ASSERT_TRUE(pair.Client()->CloseSend());
+    AzTest::EchoResponse response;
+    ASSERT_TRUE(pair.Client()->Read(&response)) << pair.Client()->ErrorText();
+    EXPECT_EQ(response.payload(), "1000:999");
+}
+
+// 调用方不读取时服务端写满调用方的窗口后阻塞, 不会无限发送
+TEST(StreamTest, WriterBlocksWithoutCredits) {
+    std::atomic<uint32_t> written(0);
+    StreamPair pair([&written](AzRPC_ServerStream* stream) {
+        while (stream->Write(Response("x"))) {
+            ++written;
+        }
+    });
+    ASSERT_TRUE(pair.Client()->Open("EchoService", "Stream"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(written.load(), kWindow);
+
+    // 读取半个窗口后归还信用, 服务端可以继续写
+    AzTest::EchoResponse response;
+    for (uint32_t i = 0; i < kWindow / 2; ++i) {
+        ASSERT_TRUE(pair.Client()->Read(&response));
+    }
+    for (int i = 0; i < 100 && written.load() < kWindow + kWindow / 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(written.load(), kWindow + kWindow / 2);
+}
+
+// 处理函数以错误结束流时调用方读到错误
+TEST(StreamTest, FinishWithError) {
+    StreamPair pair([](AzRPC_ServerStream* stream) {
+        stream->Write(Response("partial"));
+        stream->Finish("handler gave up");
+    });
+    ASSERT_TRUE(pair.Client()->Open("EchoService", "Stream"));
+    AzTest::EchoResponse response;
+    ASSERT_TRUE(pair.Client()->Read(&response));
+    EXPECT_EQ(response.payload(), "partial");
+    EXPECT_FALSE(pair.Client()->Read(&response));
+    EXPECT_TRUE(pair.Client()->Failed());
+    EXPECT_EQ(pair.Client()->ErrorText(), "handler gave up");
+}
@@ -0,0 +1,10 @@
+#include "AzRPC_Application.h"
+#include <gtest/gtest.h>
+
+// 所有测试程序共用的入口, 用法: <测试程序> [GoogleTest参数] -i <配置文件>
+int main(int argc, char** argv) {
+    // InitGoogleTest会从argv中移除它识别的参数, 剩下的交给框架解析
+    testing::InitGoogleTest(&argc, argv);
+    AzRPC_Application::Init(argc, const_cast<char const**>(argv));
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,237 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Registry.h"
+#include "AzRPC_Codec.h"
+#include "AzRPC_Controller.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+std::atomic<uint64_t> AzRPC_EchoService::s_echo_calls(0);
+std::atomic<uint64_t> AzRPC_EchoService::s_coalesced_calls(0);
+std::atomic<uint64_t> AzRPC_EchoService::s_cached_calls(0);
+std::atomic<uint64_t> AzRPC_EchoService::s_server_cached_calls(0);
+std::atomic<uint64_t> AzRPC_EchoService::s_limited_calls(0);
+std::atomic<int> AzRPC_EchoService::s_limited_running(0);
+std::atomic<int> AzRPC_EchoService::s_limited_max_running(0);
+
+void AzRPC_EchoService::Echo(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) {
+    Reply(&s_echo_calls, controller, request, response, done);
+}
+
+void AzRPC_EchoService::Coalesced(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) {
+    Reply(&s_coalesced_calls, controller, request, response, done);
+}
+
+void AzRPC_EchoService::Cached(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) {
+    Reply(&s_cached_calls, controller, request, response, done);
+}
+
+void AzRPC_EchoService::ServerCached(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) {
+    Reply(&s_server_cached_calls, controller, request, response, done);
+}
+
+// 记录同时执行的个数, 同步方法返回时已经发出响应
+void AzRPC_EchoService::Limited(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) {
+    int running = ++s_limited_running;
+    int seen = s_limited_max_running.load();
+    while (running > seen && !s_limited_max_running.compare_exchange_weak(seen, running)) {
+    }
+    if (request->sleep_ms() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(request->sleep_ms()));
+    }
+    --s_limited_running;
+    AzTest::EchoRequest reply_request(*request);
+    reply_request.set_sleep_ms(0);
+    Reply(&s_limited_calls, controller, &reply_request, response, done);
+}
+
+uint64_t AzRPC_EchoService::EchoCalls() {
+    return s_echo_calls.load();
+}
+
+uint64_t AzRPC_EchoService::CoalescedCalls() {
+    return s_coalesced_calls.load();
+}
+
+uint64_t AzRPC_EchoService::CachedCalls() {
+    return s_cached_calls.load();
+}
+
+uint64_t AzRPC_EchoService::ServerCachedCalls() {
+    return s_server_cached_calls.load();
+}
+
+uint64_t AzRPC_EchoService::LimitedCalls() {
+    return s_limited_calls.load();
+}
+
+int AzRPC_EchoService::LimitedMaxRunning() {
+    return s_limited_max_running.load();
+}
+
+void AzRPC_EchoService::StreamEcho(AzRPC_ServerStream* stream) {
+    AzTest::EchoRequest request;
+    AzTest::EchoResponse response;
+    uint64_t received = 0;
+    while (stream->Read(&request)) {
+        response.set_payload(request.payload());
+        response.set_calls(++received);
+        if (!stream->Write(response)) {
+            return;
+        }
+    }
+    response.set_payload(std::to_string(received));
+    response.set_calls(received);
+    stream->Write(response);
+}
+
+void AzRPC_EchoService::Reply(std::atomic<uint64_t>* calls, google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) {
+    if (request->sleep_ms() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(request->sleep_ms()));
+    }
+    response->set_payload(request->payload());
+    AzRPC_Controller* azrpc_controller = static_cast<AzRPC_Controller*>(controller);
+    azrpc_controller->ResponseAttachment().Append(azrpc_controller->RequestAttachment());
+    response->set_calls(calls->fetch_add(1) + 1);
+    const AzRPC_TraceContext& trace = AzRPC_Tracer::Current();
+    response->set_trace_id(trace.trace_id);
+    response->set_parent_span_id(trace.parent_span_id);
+    done->Run();
+}
+
+namespace {
+
+std::vector<google::protobuf::Service*>& ExtraServices() {
+    static std::vector<google::protobuf::Service*> services;
+    return services;
+}
+
+}  // namespace
+
+void AzRPC_TestServer::AddService(google::protobuf::Service* service) {
+    ExtraServices().push_back(service);
+}
+
+void AzRPC_TestServer::SetUp() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_running = true;
+    }
+    m_thread = std::thread([this]() {
+        // EventLoop必须在运行它的线程中创建
+        AzRPC_Provider provider;
+        provider.NotifyService(&m_service);
+        provider.NotifyStreamMethod("EchoService", "Stream", &AzRPC_EchoService::StreamEcho);
+        for (google::protobuf::Service* service: ExtraServices()) {
+            provider.NotifyService(service);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_provider = &provider;
+        }
+        provider.Run();
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_provider = nullptr;
+        m_running = false;
+    });
+
+    // 等所有服务的第一个方法都出现在注册中心
+    std::vector<std::string> paths(1, "/EchoService/Echo");
+    for (google::protobuf::Service* service: ExtraServices()) {
+        const google::protobuf::ServiceDescriptor* descriptor = service->GetDescriptor();
+        paths.push_back("/" + descriptor->name() + "/" + descriptor->method(0)->name());
+    }
+    std::unique_ptr<AzRPC_Registry> registry = AzRPC_Registry::NewFromConfig();
+    ASSERT_TRUE(registry->Start());
+    for (const std::string& path: paths) {
+        int waited_ms = 0;
+        while (registry->GetData(path).empty()) {
+            ASSERT_LT(waited_ms, 10000) << "provider did not register " << path;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            waited_ms += 10;
+        }
+    }
+}
+
+void AzRPC_TestServer::TearDown() {
+    // 方法注册完成时事件循环可能还没有开始, 此前的quit会被loop忽略, 因此重复Stop直到Run返回
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (!m_running) {
+                break;
+            }
+            if (m_provider != nullptr) {
+                m_provider->Stop();
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    m_thread.join();
+}
+
+int AzRPC_TestConnect() {
+    AzRPC_Config& config = AzRPC_Application::GetConfig();
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(atoi(config.Load("rpcserverport").c_str())));
+    inet_pton(AF_INET, config.Load("rpcserverip").c_str(), &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool AzRPC_TestExchange(int fd, const std::string& frame, AzRPC::RpcResponseHeader* header, std::string* body) {
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        ssize_t n = write(fd, frame.data() + sent, frame.size() - sent);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    std::string input;
+    char buf[4096];
+    while (true) {
+        size_t body_offset = 0;
+        int frame_size = AzRPC_Codec::DecodeResponse(input.data(), input.size(), header, &body_offset);
+        if (frame_size < 0) {
+            return false;
+        }
+        if (frame_size > 0) {
+            body->assign(input.data() + body_offset, header->body_size());
+            return true;
+        }
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+            return false;
+        }
+        input.append(buf, n);
+    }
+}
+
+std::string AzRPC_TestEchoFrame(uint64_t call_id, const std::string& payload) {
+    AzTest::EchoRequest request;
+    request.set_payload(payload);
+    AzRPC::RpcHeader header;
+    header.set_service_name("EchoService");
+    header.set_method_name("Echo");
+    header.set_call_id(call_id);
+    std::string frame;
+    AzRPC_Codec::EncodeRequest(&header, request.SerializeAsString(), &frame);
+    return frame;
+}
+
+// 链接了本文件的测试程序都在这个服务端上运行
+static testing::Environment* const kTestServer = testing::AddGlobalTestEnvironment(new AzRPC_TestServer());
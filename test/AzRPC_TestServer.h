@@ -0,0 +1,68 @@
+#ifndef _AzRPC_TestServer_H_
+#define _AzRPC_TestServer_H_
+
+#include "echo.pb.h"
+#include "AzRPC_Provider.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 回环测试的服务: 等待sleep_ms后原样返回payload和请求附件, 并带回执行次数和业务方法看到的调用链上下文
+class AzRPC_EchoService: public AzTest::EchoService {
+public:
+    void Echo(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) override;
+    void Coalesced(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) override;
+    void Cached(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) override;
+    void ServerCached(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) override;
+    void Limited(google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done) override;
+
+    // 服务端执行Echo的累计次数
+    static uint64_t EchoCalls();
+    static uint64_t CoalescedCalls();
+    static uint64_t CachedCalls();
+    static uint64_t ServerCachedCalls();
+    static uint64_t LimitedCalls();
+    // 同时执行Limited的最大个数
+    static int LimitedMaxRunning();
+    // Stream方法的处理函数, 通过NotifyStreamMethod注册
+    static void StreamEcho(AzRPC_ServerStream* stream);
+
+private:
+    static std::atomic<uint64_t> s_echo_calls;
+    static std::atomic<uint64_t> s_coalesced_calls;
+    static std::atomic<uint64_t> s_cached_calls;
+    static std::atomic<uint64_t> s_server_cached_calls;
+    static std::atomic<uint64_t> s_limited_calls;
+    static std::atomic<int> s_limited_running;
+    static std::atomic<int> s_limited_max_running;
+    static void Reply(std::atomic<uint64_t>* calls, google::protobuf::RpcController* controller, const AzTest::EchoRequest* request, AzTest::EchoResponse* response, google::protobuf::Closure* done);
+};
+
+// 回环测试的服务端, 作为GoogleTest的全局环境在所有测试之前启动, 全部结束后停止
+// AzRPC_Provider在后台线程中运行, 等到方法出现在注册中心后测试才开始
+class AzRPC_TestServer: public testing::Environment {
+public:
+    void SetUp() override;
+    void TearDown() override;
+
+    // 与EchoService一起发布的服务, 在服务端启动(全局环境SetUp)之前调用, 例如在测试文件的静态初始化中
+    static void AddService(google::protobuf::Service* service);
+
+private:
+    AzRPC_EchoService m_service;
+    std::thread m_thread;
+    std::mutex m_mtx;
+    AzRPC_Provider* m_provider = nullptr;   // Run返回后为空
+    bool m_running = false;
+};
+
+// 连接配置中的rpcserverip:rpcserverport, 失败返回-1
+int AzRPC_TestConnect();
+// 不经过AzRPC_Channel直接收发帧: 在已连接的fd上发送一个请求帧, 读取一个完整的响应帧, 失败返回false
+bool AzRPC_TestExchange(int fd, const std::string& frame, AzRPC::RpcResponseHeader* header, std::string* body);
+// 编码一个EchoService.Echo的请求帧
+std::string AzRPC_TestEchoFrame(uint64_t call_id, const std::string& payload);
+
+#endif
@@ -0,0 +1,59 @@
+#include "AzRPC_Timer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// 等待count个任务执行完, 最多等待1秒
+class Recorder {
+public:
+    void Add(int value) {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_values.push_back(value);
+        m_cv.notify_all();
+    }
+    std::vector<int> Wait(size_t count) {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cv.wait_for(lock, std::chrono::seconds(1), [&] { return m_values.size() >= count; });
+        return m_values;
+    }
+
+private:
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::vector<int> m_values;
+};
+
+}  // namespace
+
+// 任务按到期时间执行, 与加入的顺序无关
+TEST(TimerTest, RunsInDeadlineOrder) {
+    Recorder recorder;
+    AzRPC_Timer::RunAfter(60, [&recorder] { recorder.Add(3); });
+    AzRPC_Timer::RunAfter(20, [&recorder] { recorder.Add(1); });
+    AzRPC_Timer::RunAfter(40, [&recorder] { recorder.Add(2); });
+    AzRPC_Timer::RunAfter(0, [&recorder] { recorder.Add(0); });
+    EXPECT_EQ(recorder.Wait(4), (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(TimerTest, DelayIsRespected) {
+    Recorder recorder;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    AzRPC_Timer::RunAfter(30, [&recorder] { recorder.Add(1); });
+    ASSERT_EQ(recorder.Wait(1).size(), 1u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(30));
+}
+
+// 取消还没有到期的任务, 已经执行过的任务不能再取消
+TEST(TimerTest, CancelPendingTask) {
+    Recorder recorder;
+    uint64_t canceled = AzRPC_Timer::RunAfter(20, [&recorder] { recorder.Add(1); });
+    uint64_t kept = AzRPC_Timer::RunAfter(40, [&recorder] { recorder.Add(2); });
+    EXPECT_TRUE(AzRPC_Timer::Cancel(canceled));
+    EXPECT_FALSE(AzRPC_Timer::Cancel(canceled));
+    EXPECT_EQ(recorder.Wait(1), (std::vector<int>{2}));
+    EXPECT_FALSE(AzRPC_Timer::Cancel(kept));
+}
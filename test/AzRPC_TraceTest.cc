@@ -0,0 +1,61 @@
+#include "AzRPC_Trace.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+// unit.conf中trace_sample_rate=1, 每条新的调用链都被采样
+TEST(TraceTest, RootIsSampled) {
+    AzRPC_TraceContext root = AzRPC_Tracer::NewRoot();
+    EXPECT_TRUE(root.Valid());
+    EXPECT_TRUE(root.Sampled());
+    EXPECT_NE(root.span_id, 0u);
+    EXPECT_EQ(root.parent_span_id, 0u);
+}
+
+TEST(TraceTest, ChildKeepsTraceAndLinksParent) {
+    AzRPC_TraceContext root = AzRPC_Tracer::NewRoot();
+    AzRPC_TraceContext child = AzRPC_Tracer::NewChild(root);
+    EXPECT_EQ(child.trace_id, root.trace_id);
+    EXPECT_EQ(child.parent_span_id, root.span_id);
+    EXPECT_NE(child.span_id, root.span_id);
+    EXPECT_EQ(child.flags, root.flags);
+}
+
+TEST(TraceTest, ScopeRestoresPreviousContext) {
+    AzRPC_TraceContext outer = AzRPC_Tracer::NewRoot();
+    AzRPC_TraceScope outer_scope(outer);
+    {
+        AzRPC_TraceContext inner = AzRPC_Tracer::NewChild(outer);
+        AzRPC_TraceScope inner_scope(inner);
+        EXPECT_EQ(AzRPC_Tracer::Current().span_id, inner.span_id);
+    }
+    EXPECT_EQ(AzRPC_Tracer::Current().span_id, outer.span_id);
+}
+
+TEST(TraceTest, SnapshotReturnsExportedSpans) {
+    AzRPC_SpanRecord record;
+    memset(&record, 0, sizeof(record));
+    record.trace_id = AzRPC_Tracer::NewRoot().trace_id;
+    record.kind = AzRPC_SpanRecord::kServer;
+    AzRPC_Tracer::FillMethod(&record, "EchoService", "Echo");
+    AzRPC_Tracer::Export(record);
+
+    std::vector<AzRPC_SpanRecord> records;
+    ASSERT_GT(AzRPC_Tracer::Snapshot(&records), 0u);
+    EXPECT_EQ(records.back().trace_id, record.trace_id);
+    EXPECT_STREQ(records.back().method, "EchoService.Echo");
+}
+
+// 超过环形缓冲区容量(trace_ring_size=64)时只保留最新的span
+TEST(TraceTest, RingKeepsNewestSpans) {
+    AzRPC_SpanRecord record;
+    memset(&record, 0, sizeof(record));
+    for (uint64_t i = 1; i <= 200; ++i) {
+        record.span_id = i;
+        AzRPC_Tracer::Export(record);
+    }
+    std::vector<AzRPC_SpanRecord> records;
+    EXPECT_EQ(AzRPC_Tracer::Snapshot(&records), 64u);
+    EXPECT_EQ(records.back().span_id, 200u);
+    EXPECT_EQ(records.front().span_id, 137u);
+}
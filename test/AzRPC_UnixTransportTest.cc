@@ -0,0 +1,76 @@
+#include "AzRPC_TestServer.h"
+#include "AzRPC_Application.h"
+#include "AzRPC_Channel.h"
+#include "AzRPC_Registry.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::string UnixPath() {
+    return AzRPC_Application::GetConfig().Load("rpcserver_unix_path");
+}
+
+}  // namespace
+
+// 服务端在注册的节点数据中附带Unix域套接字的路径和主机名
+TEST(UnixTransportTest, NodeAdvertisesPath) {
+    if (UnixPath().empty()) {
+        GTEST_SKIP() << "rpcserver_unix_path not configured";
+    }
+    std::unique_ptr<AzRPC_Registry> registry = AzRPC_Registry::NewFromConfig();
+    ASSERT_TRUE(registry->Start());
+    std::string node = registry->GetData("/EchoService/Echo");
+    EXPECT_NE(node.find(";unix=" + UnixPath() + ";host="), std::string::npos) << node;
+
+    struct stat st;
+    ASSERT_EQ(stat(UnixPath().c_str(), &st), 0);
+    EXPECT_TRUE(S_ISSOCK(st.st_mode));
+}
+
+// Unix域连接与TCP连接使用同样的帧格式, 同一连接上可以连续调用
+TEST(UnixTransportTest, ServesFramesOverUnixSocket) {
+    if (UnixPath().empty()) {
+        GTEST_SKIP() << "rpcserver_unix_path not configured";
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", UnixPath().c_str());
+    ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+
+    for (uint64_t call_id = 1; call_id <= 3; ++call_id) {
+        AzRPC::RpcResponseHeader header;
+        std::string body;
+        ASSERT_TRUE(AzRPC_TestExchange(fd, AzRPC_TestEchoFrame(call_id, "unix" + std::to_string(call_id)), &header, &body));
+        EXPECT_EQ(header.call_id(), call_id);
+        AzTest::EchoResponse response;
+        ASSERT_TRUE(response.ParseFromString(body));
+        EXPECT_EQ(response.payload(), "unix" + std::to_string(call_id));
+    }
+    close(fd);
+}
+
+// 调用方发现服务端在本机时优先走Unix域套接字, 对调用方透明
+TEST(UnixTransportTest, ChannelCallsSucceed) {
+    if (UnixPath().empty()) {
+        GTEST_SKIP() << "rpcserver_unix_path not configured";
+    }
+    AzRPC_Channel channel(false);
+    AzTest::EchoService_Stub stub(&channel);
+    for (int i = 0; i < 10; ++i) {
+        AzRPC_Controller controller;
+        AzTest::EchoRequest request;
+        request.set_payload("via unix");
+        AzTest::EchoResponse response;
+        stub.Echo(&controller, &request, &response, nullptr);
+        ASSERT_FALSE(controller.Failed()) << controller.ErrorText();
+        EXPECT_EQ(response.payload(), "via unix");
+    }
+}
@@ -0,0 +1,864 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: echo.proto
+
+#include "echo.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+namespace AzTest {
+PROTOBUF_CONSTEXPR EchoRequest::EchoRequest(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.payload_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.sleep_ms_)*/0u
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct EchoRequestDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR EchoRequestDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~EchoRequestDefaultTypeInternal() {}
+  union {
+    EchoRequest _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 EchoRequestDefaultTypeInternal _EchoRequest_default_instance_;
+PROTOBUF_CONSTEXPR EchoResponse::EchoResponse(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.payload_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.calls_)*/uint64_t{0u}
+  , /*decltype(_impl_.trace_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.parent_span_id_)*/uint64_t{0u}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct EchoResponseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR EchoResponseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~EchoResponseDefaultTypeInternal() {}
+  union {
+    EchoResponse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 EchoResponseDefaultTypeInternal _EchoResponse_default_instance_;
+}  // namespace AzTest
+static ::_pb::Metadata file_level_metadata_echo_2eproto[2];
+static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_echo_2eproto = nullptr;
+static const ::_pb::ServiceDescriptor* file_level_service_descriptors_echo_2eproto[1];
+
+const uint32_t TableStruct_echo_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoRequest, _impl_.payload_),
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoRequest, _impl_.sleep_ms_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoResponse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoResponse, _impl_.payload_),
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoResponse, _impl_.calls_),
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoResponse, _impl_.trace_id_),
+  PROTOBUF_FIELD_OFFSET(::AzTest::EchoResponse, _impl_.parent_span_id_),
+};
+static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
+  { 0, -1, -1, sizeof(::AzTest::EchoRequest)},
+  { 8, -1, -1, sizeof(::AzTest::EchoResponse)},
+};
+
+static const ::_pb::Message* const file_default_instances[] = {
+  &::AzTest::_EchoRequest_default_instance_._instance,
+  &::AzTest::_EchoResponse_default_instance_._instance,
+};
+
+const char descriptor_table_protodef_echo_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\necho.proto\022\006AzTest\"0\n\013EchoRequest\022\017\n\007p"
+  "ayload\030\001 \001(\014\022\020\n\010sleep_ms\030\002 \001(\r\"X\n\014EchoRe"
+  "sponse\022\017\n\007payload\030\001 \001(\014\022\r\n\005calls\030\002 \001(\004\022\020"
+  "\n\010trace_id\030\003 \001(\006\022\026\n\016parent_span_id\030\004 \001(\006"
+  "2\327\002\n\013EchoService\0221\n\004Echo\022\023.AzTest.EchoRe"
+  "quest\032\024.AzTest.EchoResponse\0226\n\tCoalesced"
+  "\022\023.AzTest.EchoRequest\032\024.AzTest.EchoRespo"
+  "nse\0223\n\006Cached\022\023.AzTest.EchoRequest\032\024.AzT"
+  "est.EchoResponse\0229\n\014ServerCached\022\023.AzTes"
+  "t.EchoRequest\032\024.AzTest.EchoResponse\0227\n\006S"
+  "tream\022\023.AzTest.EchoRequest\032\024.AzTest.Echo"
+  "Response(\0010\001\0224\n\007Limited\022\023.AzTest.EchoReq"
+  "uest\032\024.AzTest.EchoResponseB\003\200\001\001b\006proto3"
+  ;
+static ::_pbi::once_flag descriptor_table_echo_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_echo_2eproto = {
+    false, false, 519, descriptor_table_protodef_echo_2eproto,
+    "echo.proto",
+    &descriptor_table_echo_2eproto_once, nullptr, 0, 2,
+    schemas, file_default_instances, TableStruct_echo_2eproto::offsets,
+    file_level_metadata_echo_2eproto, file_level_enum_descriptors_echo_2eproto,
+    file_level_service_descriptors_echo_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_echo_2eproto_getter() {
+  return &descriptor_table_echo_2eproto;
+}
+
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_echo_2eproto(&descriptor_table_echo_2eproto);
+namespace AzTest {
+
+// ===================================================================
+
+class EchoRequest::_Internal {
+ public:
+};
+
+EchoRequest::EchoRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:AzTest.EchoRequest)
+}
+EchoRequest::EchoRequest(const EchoRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  EchoRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.payload_){}
+    , decltype(_impl_.sleep_ms_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.payload_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.payload_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_payload().empty()) {
+    _this->_impl_.payload_.Set(from._internal_payload(), 
+      _this->GetArenaForAllocation());
+  }
+  _this->_impl_.sleep_ms_ = from._impl_.sleep_ms_;
+  // @@protoc_insertion_point(copy_constructor:AzTest.EchoRequest)
+}
+
+inline void EchoRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.payload_){}
+    , decltype(_impl_.sleep_ms_){0u}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.payload_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.payload_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+EchoRequest::~EchoRequest() {
+  // @@protoc_insertion_point(destructor:AzTest.EchoRequest)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void EchoRequest::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.payload_.Destroy();
+}
+
+void EchoRequest::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void EchoRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:AzTest.EchoRequest)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.payload_.ClearToEmpty();
+  _impl_.sleep_ms_ = 0u;
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* EchoRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // bytes payload = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_payload();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint32 sleep_ms = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.sleep_ms_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* EchoRequest::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:AzTest.EchoRequest)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // bytes payload = 1;
+  if (!this->_internal_payload().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_payload(), target);
+  }
+
+  // uint32 sleep_ms = 2;
+  if (this->_internal_sleep_ms() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(2, this->_internal_sleep_ms(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:AzTest.EchoRequest)
+  return target;
+}
+
+size_t EchoRequest::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:AzTest.EchoRequest)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes payload = 1;
+  if (!this->_internal_payload().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_payload());
+  }
+
+  // uint32 sleep_ms = 2;
+  if (this->_internal_sleep_ms() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_sleep_ms());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData EchoRequest::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    EchoRequest::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*EchoRequest::GetClassData() const { return &_class_data_; }
+
+
+void EchoRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<EchoRequest*>(&to_msg);
+  auto& from = static_cast<const EchoRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:AzTest.EchoRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_payload().empty()) {
+    _this->_internal_set_payload(from._internal_payload());
+  }
+  if (from._internal_sleep_ms() != 0) {
+    _this->_internal_set_sleep_ms(from._internal_sleep_ms());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void EchoRequest::CopyFrom(const EchoRequest& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:AzTest.EchoRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool EchoRequest::IsInitialized() const {
+  return true;
+}
+
+void EchoRequest::InternalSwap(EchoRequest* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.payload_, lhs_arena,
+      &other->_impl_.payload_, rhs_arena
+  );
+  swap(_impl_.sleep_ms_, other->_impl_.sleep_ms_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata EchoRequest::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_echo_2eproto_getter, &descriptor_table_echo_2eproto_once,
+      file_level_metadata_echo_2eproto[0]);
+}
+
+// ===================================================================
+
+class EchoResponse::_Internal {
+ public:
+};
+
+EchoResponse::EchoResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:AzTest.EchoResponse)
+}
+EchoResponse::EchoResponse(const EchoResponse& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  EchoResponse* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.payload_){}
+    , decltype(_impl_.calls_){}
+    , decltype(_impl_.trace_id_){}
+    , decltype(_impl_.parent_span_id_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.payload_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.payload_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_payload().empty()) {
+    _this->_impl_.payload_.Set(from._internal_payload(), 
+      _this->GetArenaForAllocation());
+  }
+  ::memcpy(&_impl_.calls_, &from._impl_.calls_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.parent_span_id_) -
+    reinterpret_cast<char*>(&_impl_.calls_)) + sizeof(_impl_.parent_span_id_));
+  // @@protoc_insertion_point(copy_constructor:AzTest.EchoResponse)
+}
+
+inline void EchoResponse::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.payload_){}
+    , decltype(_impl_.calls_){uint64_t{0u}}
+    , decltype(_impl_.trace_id_){uint64_t{0u}}
+    , decltype(_impl_.parent_span_id_){uint64_t{0u}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.payload_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.payload_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+EchoResponse::~EchoResponse() {
+  // @@protoc_insertion_point(destructor:AzTest.EchoResponse)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void EchoResponse::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.payload_.Destroy();
+}
+
+void EchoResponse::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void EchoResponse::Clear() {
+// @@protoc_insertion_point(message_clear_start:AzTest.EchoResponse)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.payload_.ClearToEmpty();
+  ::memset(&_impl_.calls_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.parent_span_id_) -
+      reinterpret_cast<char*>(&_impl_.calls_)) + sizeof(_impl_.parent_span_id_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* EchoResponse::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // bytes payload = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_payload();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 calls = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.calls_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // fixed64 trace_id = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 25)) {
+          _impl_.trace_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      // fixed64 parent_span_id = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 33)) {
+          _impl_.parent_span_id_ = ::PROTOBUF_NAMESPACE_ID::internal::UnalignedLoad<uint64_t>(ptr);
+          ptr += sizeof(uint64_t);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* EchoResponse::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:AzTest.EchoResponse)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // bytes payload = 1;
+  if (!this->_internal_payload().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_payload(), target);
+  }
+
+  // uint64 calls = 2;
+  if (this->_internal_calls() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(2, this->_internal_calls(), target);
+  }
+
+  // fixed64 trace_id = 3;
+  if (this->_internal_trace_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(3, this->_internal_trace_id(), target);
+  }
+
+  // fixed64 parent_span_id = 4;
+  if (this->_internal_parent_span_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteFixed64ToArray(4, this->_internal_parent_span_id(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:AzTest.EchoResponse)
+  return target;
+}
+
+size_t EchoResponse::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:AzTest.EchoResponse)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // bytes payload = 1;
+  if (!this->_internal_payload().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_payload());
+  }
+
+  // uint64 calls = 2;
+  if (this->_internal_calls() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_calls());
+  }
+
+  // fixed64 trace_id = 3;
+  if (this->_internal_trace_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  // fixed64 parent_span_id = 4;
+  if (this->_internal_parent_span_id() != 0) {
+    total_size += 1 + 8;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData EchoResponse::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    EchoResponse::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*EchoResponse::GetClassData() const { return &_class_data_; }
+
+
+void EchoResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<EchoResponse*>(&to_msg);
+  auto& from = static_cast<const EchoResponse&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:AzTest.EchoResponse)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (!from._internal_payload().empty()) {
+    _this->_internal_set_payload(from._internal_payload());
+  }
+  if (from._internal_calls() != 0) {
+    _this->_internal_set_calls(from._internal_calls());
+  }
+  if (from._internal_trace_id() != 0) {
+    _this->_internal_set_trace_id(from._internal_trace_id());
+  }
+  if (from._internal_parent_span_id() != 0) {
+    _this->_internal_set_parent_span_id(from._internal_parent_span_id());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void EchoResponse::CopyFrom(const EchoResponse& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:AzTest.EchoResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool EchoResponse::IsInitialized() const {
+  return true;
+}
+
+void EchoResponse::InternalSwap(EchoResponse* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.payload_, lhs_arena,
+      &other->_impl_.payload_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(EchoResponse, _impl_.parent_span_id_)
+      + sizeof(EchoResponse::_impl_.parent_span_id_)
+      - PROTOBUF_FIELD_OFFSET(EchoResponse, _impl_.calls_)>(
+          reinterpret_cast<char*>(&_impl_.calls_),
+          reinterpret_cast<char*>(&other->_impl_.calls_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata EchoResponse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_echo_2eproto_getter, &descriptor_table_echo_2eproto_once,
+      file_level_metadata_echo_2eproto[1]);
+}
+
+// ===================================================================
+
+EchoService::~EchoService() {}
+
+const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* EchoService::descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_echo_2eproto);
+  return file_level_service_descriptors_echo_2eproto[0];
+}
+
+const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* EchoService::GetDescriptor() {
+  return descriptor();
+}
+
+void EchoService::Echo(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::AzTest::EchoRequest*,
+                         ::AzTest::EchoResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method Echo() not implemented.");
+  done->Run();
+}
+
+void EchoService::Coalesced(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::AzTest::EchoRequest*,
+                         ::AzTest::EchoResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method Coalesced() not implemented.");
+  done->Run();
+}
+
+void EchoService::Cached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::AzTest::EchoRequest*,
+                         ::AzTest::EchoResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method Cached() not implemented.");
+  done->Run();
+}
+
+void EchoService::ServerCached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::AzTest::EchoRequest*,
+                         ::AzTest::EchoResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method ServerCached() not implemented.");
+  done->Run();
+}
+
+void EchoService::Stream(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::AzTest::EchoRequest*,
+                         ::AzTest::EchoResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method Stream() not implemented.");
+  done->Run();
+}
+
+void EchoService::Limited(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::AzTest::EchoRequest*,
+                         ::AzTest::EchoResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method Limited() not implemented.");
+  done->Run();
+}
+
+void EchoService::CallMethod(const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method,
+                             ::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                             const ::PROTOBUF_NAMESPACE_ID::Message* request,
+                             ::PROTOBUF_NAMESPACE_ID::Message* response,
+                             ::google::protobuf::Closure* done) {
+  GOOGLE_DCHECK_EQ(method->service(), file_level_service_descriptors_echo_2eproto[0]);
+  switch(method->index()) {
+    case 0:
+      Echo(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::AzTest::EchoRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::AzTest::EchoResponse*>(
+                 response),
+             done);
+      break;
+    case 1:
+      Coalesced(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::AzTest::EchoRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::AzTest::EchoResponse*>(
+                 response),
+             done);
+      break;
+    case 2:
+      Cached(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::AzTest::EchoRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::AzTest::EchoResponse*>(
+                 response),
+             done);
+      break;
+    case 3:
+      ServerCached(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::AzTest::EchoRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::AzTest::EchoResponse*>(
+                 response),
+             done);
+      break;
+    case 4:
+      Stream(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::AzTest::EchoRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::AzTest::EchoResponse*>(
+                 response),
+             done);
+      break;
+    case 5:
+      Limited(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::AzTest::EchoRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::AzTest::EchoResponse*>(
+                 response),
+             done);
+      break;
+    default:
+      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
+      break;
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message& EchoService::GetRequestPrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const {
+  GOOGLE_DCHECK_EQ(method->service(), descriptor());
+  switch(method->index()) {
+    case 0:
+      return ::AzTest::EchoRequest::default_instance();
+    case 1:
+      return ::AzTest::EchoRequest::default_instance();
+    case 2:
+      return ::AzTest::EchoRequest::default_instance();
+    case 3:
+      return ::AzTest::EchoRequest::default_instance();
+    case 4:
+      return ::AzTest::EchoRequest::default_instance();
+    case 5:
+      return ::AzTest::EchoRequest::default_instance();
+    default:
+      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
+      return *::PROTOBUF_NAMESPACE_ID::MessageFactory::generated_factory()
+          ->GetPrototype(method->input_type());
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message& EchoService::GetResponsePrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const {
+  GOOGLE_DCHECK_EQ(method->service(), descriptor());
+  switch(method->index()) {
+    case 0:
+      return ::AzTest::EchoResponse::default_instance();
+    case 1:
+      return ::AzTest::EchoResponse::default_instance();
+    case 2:
+      return ::AzTest::EchoResponse::default_instance();
+    case 3:
+      return ::AzTest::EchoResponse::default_instance();
+    case 4:
+      return ::AzTest::EchoResponse::default_instance();
+    case 5:
+      return ::AzTest::EchoResponse::default_instance();
+    default:
+      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
+      return *::PROTOBUF_NAMESPACE_ID::MessageFactory::generated_factory()
+          ->GetPrototype(method->output_type());
+  }
+}
+
+EchoService_Stub::EchoService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel)
+  : channel_(channel), owns_channel_(false) {}
+EchoService_Stub::EchoService_Stub(
+    ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel,
+    ::PROTOBUF_NAMESPACE_ID::Service::ChannelOwnership ownership)
+  : channel_(channel),
+    owns_channel_(ownership == ::PROTOBUF_NAMESPACE_ID::Service::STUB_OWNS_CHANNEL) {}
+EchoService_Stub::~EchoService_Stub() {
+  if (owns_channel_) delete channel_;
+}
+
+void EchoService_Stub::Echo(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::AzTest::EchoRequest* request,
+                              ::AzTest::EchoResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(0),
+                       controller, request, response, done);
+}
+void EchoService_Stub::Coalesced(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::AzTest::EchoRequest* request,
+                              ::AzTest::EchoResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(1),
+                       controller, request, response, done);
+}
+void EchoService_Stub::Cached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::AzTest::EchoRequest* request,
+                              ::AzTest::EchoResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(2),
+                       controller, request, response, done);
+}
+void EchoService_Stub::ServerCached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::AzTest::EchoRequest* request,
+                              ::AzTest::EchoResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(3),
+                       controller, request, response, done);
+}
+void EchoService_Stub::Stream(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::AzTest::EchoRequest* request,
+                              ::AzTest::EchoResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(4),
+                       controller, request, response, done);
+}
+void EchoService_Stub::Limited(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::AzTest::EchoRequest* request,
+                              ::AzTest::EchoResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(5),
+                       controller, request, response, done);
+}
+
+// @@protoc_insertion_point(namespace_scope)
+}  // namespace AzTest
+PROTOBUF_NAMESPACE_OPEN
+template<> PROTOBUF_NOINLINE ::AzTest::EchoRequest*
+Arena::CreateMaybeMessage< ::AzTest::EchoRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::AzTest::EchoRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::AzTest::EchoResponse*
+Arena::CreateMaybeMessage< ::AzTest::EchoResponse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::AzTest::EchoResponse >(arena);
+}
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>
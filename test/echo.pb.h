@@ -0,0 +1,719 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: echo.proto
+
+#ifndef GOOGLE_PROTOBUF_INCLUDED_echo_2eproto
+#define GOOGLE_PROTOBUF_INCLUDED_echo_2eproto
+
+#include <limits>
+#include <string>
+
+#include <google/protobuf/port_def.inc>
+#if PROTOBUF_VERSION < 3021000
+#error This file was generated by a newer version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please update
+#error your headers.
+#endif
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
+#error This file was generated by an older version of protoc which is
+#error incompatible with your Protocol Buffer headers. Please
+#error regenerate this file with a newer version of protoc.
+#endif
+
+#include <google/protobuf/port_undef.inc>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/arenastring.h>
+#include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/metadata_lite.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>  // IWYU pragma: export
+#include <google/protobuf/extension_set.h>  // IWYU pragma: export
+#include <google/protobuf/service.h>
+#include <google/protobuf/unknown_field_set.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+#define PROTOBUF_INTERNAL_EXPORT_echo_2eproto
+PROTOBUF_NAMESPACE_OPEN
+namespace internal {
+class AnyMetadata;
+}  // namespace internal
+PROTOBUF_NAMESPACE_CLOSE
+
+// Internal implementation detail -- do not use these members.
+struct TableStruct_echo_2eproto {
+  static const uint32_t offsets[];
+};
+extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_echo_2eproto;
+namespace AzTest {
+class EchoRequest;
+struct EchoRequestDefaultTypeInternal;
+extern EchoRequestDefaultTypeInternal _EchoRequest_default_instance_;
+class EchoResponse;
+struct EchoResponseDefaultTypeInternal;
+extern EchoResponseDefaultTypeInternal _EchoResponse_default_instance_;
+}  // namespace AzTest
+PROTOBUF_NAMESPACE_OPEN
+template<> ::AzTest::EchoRequest* Arena::CreateMaybeMessage<::AzTest::EchoRequest>(Arena*);
+template<> ::AzTest::EchoResponse* Arena::CreateMaybeMessage<::AzTest::EchoResponse>(Arena*);
+PROTOBUF_NAMESPACE_CLOSE
+namespace AzTest {
+
+// ===================================================================
+
+class EchoRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:AzTest.EchoRequest) */ {
+ public:
+  inline EchoRequest() : EchoRequest(nullptr) {}
+  ~EchoRequest() override;
+  explicit PROTOBUF_CONSTEXPR EchoRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  EchoRequest(const EchoRequest& from);
+  EchoRequest(EchoRequest&& from) noexcept
+    : EchoRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline EchoRequest& operator=(const EchoRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline EchoRequest& operator=(EchoRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const EchoRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const EchoRequest* internal_default_instance() {
+    return reinterpret_cast<const EchoRequest*>(
+               &_EchoRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    0;
+
+  friend void swap(EchoRequest& a, EchoRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(EchoRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(EchoRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  EchoRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<EchoRequest>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const EchoRequest& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const EchoRequest& from) {
+    EchoRequest::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(EchoRequest* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "AzTest.EchoRequest";
+  }
+  protected:
+  explicit EchoRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kPayloadFieldNumber = 1,
+    kSleepMsFieldNumber = 2,
+  };
+  // bytes payload = 1;
+  void clear_payload();
+  const std::string& payload() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_payload(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_payload();
+  PROTOBUF_NODISCARD std::string* release_payload();
+  void set_allocated_payload(std::string* payload);
+  private:
+  const std::string& _internal_payload() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_payload(const std::string& value);
+  std::string* _internal_mutable_payload();
+  public:
+
+  // uint32 sleep_ms = 2;
+  void clear_sleep_ms();
+  uint32_t sleep_ms() const;
+  void set_sleep_ms(uint32_t value);
+  private:
+  uint32_t _internal_sleep_ms() const;
+  void _internal_set_sleep_ms(uint32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:AzTest.EchoRequest)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr payload_;
+    uint32_t sleep_ms_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_echo_2eproto;
+};
+// -------------------------------------------------------------------
+
+class EchoResponse final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:AzTest.EchoResponse) */ {
+ public:
+  inline EchoResponse() : EchoResponse(nullptr) {}
+  ~EchoResponse() override;
+  explicit PROTOBUF_CONSTEXPR EchoResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  EchoResponse(const EchoResponse& from);
+  EchoResponse(EchoResponse&& from) noexcept
+    : EchoResponse() {
+    *this = ::std::move(from);
+  }
+
+  inline EchoResponse& operator=(const EchoResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline EchoResponse& operator=(EchoResponse&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const EchoResponse& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const EchoResponse* internal_default_instance() {
+    return reinterpret_cast<const EchoResponse*>(
+               &_EchoResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(EchoResponse& a, EchoResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(EchoResponse* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(EchoResponse* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  EchoResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<EchoResponse>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const EchoResponse& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const EchoResponse& from) {
+    EchoResponse::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(EchoResponse* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "AzTest.EchoResponse";
+  }
+  protected:
+  explicit EchoResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kPayloadFieldNumber = 1,
+    kCallsFieldNumber = 2,
+    kTraceIdFieldNumber = 3,
+    kParentSpanIdFieldNumber = 4,
+  };
+  // bytes payload = 1;
+  void clear_payload();
+  const std::string& payload() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_payload(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_payload();
+  PROTOBUF_NODISCARD std::string* release_payload();
+  void set_allocated_payload(std::string* payload);
+  private:
+  const std::string& _internal_payload() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_payload(const std::string& value);
+  std::string* _internal_mutable_payload();
+  public:
+
+  // uint64 calls = 2;
+  void clear_calls();
+  uint64_t calls() const;
+  void set_calls(uint64_t value);
+  private:
+  uint64_t _internal_calls() const;
+  void _internal_set_calls(uint64_t value);
+  public:
+
+  // fixed64 trace_id = 3;
+  void clear_trace_id();
+  uint64_t trace_id() const;
+  void set_trace_id(uint64_t value);
+  private:
+  uint64_t _internal_trace_id() const;
+  void _internal_set_trace_id(uint64_t value);
+  public:
+
+  // fixed64 parent_span_id = 4;
+  void clear_parent_span_id();
+  uint64_t parent_span_id() const;
+  void set_parent_span_id(uint64_t value);
+  private:
+  uint64_t _internal_parent_span_id() const;
+  void _internal_set_parent_span_id(uint64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:AzTest.EchoResponse)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr payload_;
+    uint64_t calls_;
+    uint64_t trace_id_;
+    uint64_t parent_span_id_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_echo_2eproto;
+};
+// ===================================================================
+
+class EchoService_Stub;
+
+class EchoService : public ::PROTOBUF_NAMESPACE_ID::Service {
+ protected:
+  // This class should be treated as an abstract interface.
+  inline EchoService() {};
+ public:
+  virtual ~EchoService();
+
+  typedef EchoService_Stub Stub;
+
+  static const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* descriptor();
+
+  virtual void Echo(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void Coalesced(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void Cached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void ServerCached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void Stream(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void Limited(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+
+  // implements Service ----------------------------------------------
+
+  const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* GetDescriptor();
+  void CallMethod(const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method,
+                  ::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                  const ::PROTOBUF_NAMESPACE_ID::Message* request,
+                  ::PROTOBUF_NAMESPACE_ID::Message* response,
+                  ::google::protobuf::Closure* done);
+  const ::PROTOBUF_NAMESPACE_ID::Message& GetRequestPrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const;
+  const ::PROTOBUF_NAMESPACE_ID::Message& GetResponsePrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(EchoService);
+};
+
+class EchoService_Stub : public EchoService {
+ public:
+  EchoService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel);
+  EchoService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel,
+                   ::PROTOBUF_NAMESPACE_ID::Service::ChannelOwnership ownership);
+  ~EchoService_Stub();
+
+  inline ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel() { return channel_; }
+
+  // implements EchoService ------------------------------------------
+
+  void Echo(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  void Coalesced(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  void Cached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  void ServerCached(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  void Stream(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+  void Limited(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::AzTest::EchoRequest* request,
+                       ::AzTest::EchoResponse* response,
+                       ::google::protobuf::Closure* done);
+ private:
+  ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel_;
+  bool owns_channel_;
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(EchoService_Stub);
+};
+
+
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// EchoRequest
+
+// bytes payload = 1;
+inline void EchoRequest::clear_payload() {
+  _impl_.payload_.ClearToEmpty();
+}
+inline const std::string& EchoRequest::payload() const {
+  // @@protoc_insertion_point(field_get:AzTest.EchoRequest.payload)
+  return _internal_payload();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void EchoRequest::set_payload(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.payload_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:AzTest.EchoRequest.payload)
+}
+inline std::string* EchoRequest::mutable_payload() {
+  std::string* _s = _internal_mutable_payload();
+  // @@protoc_insertion_point(field_mutable:AzTest.EchoRequest.payload)
+  return _s;
+}
+inline const std::string& EchoRequest::_internal_payload() const {
+  return _impl_.payload_.Get();
+}
+inline void EchoRequest::_internal_set_payload(const std::string& value) {
+  
+  _impl_.payload_.Set(value, GetArenaForAllocation());
+}
+inline std::string* EchoRequest::_internal_mutable_payload() {
+  
+  return _impl_.payload_.Mutable(GetArenaForAllocation());
+}
+inline std::string* EchoRequest::release_payload() {
+  // @@protoc_insertion_point(field_release:AzTest.EchoRequest.payload)
+  return _impl_.payload_.Release();
+}
+inline void EchoRequest::set_allocated_payload(std::string* payload) {
+  if (payload != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.payload_.SetAllocated(payload, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.payload_.IsDefault()) {
+    _impl_.payload_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:AzTest.EchoRequest.payload)
+}
+
+// uint32 sleep_ms = 2;
+inline void EchoRequest::clear_sleep_ms() {
+  _impl_.sleep_ms_ = 0u;
+}
+inline uint32_t EchoRequest::_internal_sleep_ms() const {
+  return _impl_.sleep_ms_;
+}
+inline uint32_t EchoRequest::sleep_ms() const {
+  // @@protoc_insertion_point(field_get:AzTest.EchoRequest.sleep_ms)
+  return _internal_sleep_ms();
+}
+inline void EchoRequest::_internal_set_sleep_ms(uint32_t value) {
+  
+  _impl_.sleep_ms_ = value;
+}
+inline void EchoRequest::set_sleep_ms(uint32_t value) {
+  _internal_set_sleep_ms(value);
+  // @@protoc_insertion_point(field_set:AzTest.EchoRequest.sleep_ms)
+}
+
+// -------------------------------------------------------------------
+
+// EchoResponse
+
+// bytes payload = 1;
+inline void EchoResponse::clear_payload() {
+  _impl_.payload_.ClearToEmpty();
+}
+inline const std::string& EchoResponse::payload() const {
+  // @@protoc_insertion_point(field_get:AzTest.EchoResponse.payload)
+  return _internal_payload();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void EchoResponse::set_payload(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.payload_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:AzTest.EchoResponse.payload)
+}
+inline std::string* EchoResponse::mutable_payload() {
+  std::string* _s = _internal_mutable_payload();
+  // @@protoc_insertion_point(field_mutable:AzTest.EchoResponse.payload)
+  return _s;
+}
+inline const std::string& EchoResponse::_internal_payload() const {
+  return _impl_.payload_.Get();
+}
+inline void EchoResponse::_internal_set_payload(const std::string& value) {
+  
+  _impl_.payload_.Set(value, GetArenaForAllocation());
+}
+inline std::string* EchoResponse::_internal_mutable_payload() {
+  
+  return _impl_.payload_.Mutable(GetArenaForAllocation());
+}
+inline std::string* EchoResponse::release_payload() {
+  // @@protoc_insertion_point(field_release:AzTest.EchoResponse.payload)
+  return _impl_.payload_.Release();
+}
+inline void EchoResponse::set_allocated_payload(std::string* payload) {
+  if (payload != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.payload_.SetAllocated(payload, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.payload_.IsDefault()) {
+    _impl_.payload_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:AzTest.EchoResponse.payload)
+}
+
+// uint64 calls = 2;
+inline void EchoResponse::clear_calls() {
+  _impl_.calls_ = uint64_t{0u};
+}
+inline uint64_t EchoResponse::_internal_calls() const {
+  return _impl_.calls_;
+}
+inline uint64_t EchoResponse::calls() const {
+  // @@protoc_insertion_point(field_get:AzTest.EchoResponse.calls)
+  return _internal_calls();
+}
+inline void EchoResponse::_internal_set_calls(uint64_t value) {
+  
+  _impl_.calls_ = value;
+}
+inline void EchoResponse::set_calls(uint64_t value) {
+  _internal_set_calls(value);
+  // @@protoc_insertion_point(field_set:AzTest.EchoResponse.calls)
+}
+
+// fixed64 trace_id = 3;
+inline void EchoResponse::clear_trace_id() {
+  _impl_.trace_id_ = uint64_t{0u};
+}
+inline uint64_t EchoResponse::_internal_trace_id() const {
+  return _impl_.trace_id_;
+}
+inline uint64_t EchoResponse::trace_id() const {
+  // @@protoc_insertion_point(field_get:AzTest.EchoResponse.trace_id)
+  return _internal_trace_id();
+}
+inline void EchoResponse::_internal_set_trace_id(uint64_t value) {
+  
+  _impl_.trace_id_ = value;
+}
+inline void EchoResponse::set_trace_id(uint64_t value) {
+  _internal_set_trace_id(value);
+  // @@protoc_insertion_point(field_set:AzTest.EchoResponse.trace_id)
+}
+
+// fixed64 parent_span_id = 4;
+inline void EchoResponse::clear_parent_span_id() {
+  _impl_.parent_span_id_ = uint64_t{0u};
+}
+inline uint64_t EchoResponse::_internal_parent_span_id() const {
+  return _impl_.parent_span_id_;
+}
+inline uint64_t EchoResponse::parent_span_id() const {
+  // @@protoc_insertion_point(field_get:AzTest.EchoResponse.parent_span_id)
+  return _internal_parent_span_id();
+}
+inline void EchoResponse::_internal_set_parent_span_id(uint64_t value) {
+  
+  _impl_.parent_span_id_ = value;
+}
+inline void EchoResponse::set_parent_span_id(uint64_t value) {
+  _internal_set_parent_span_id(value);
+  // @@protoc_insertion_point(field_set:AzTest.EchoResponse.parent_span_id)
+}
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic pop
+#endif  // __GNUC__
+// -------------------------------------------------------------------
+
+
+// @@protoc_insertion_point(namespace_scope)
+
+}  // namespace AzTest
+
+// @@protoc_insertion_point(global_scope)
+
+#include <google/protobuf/port_undef.inc>
+#endif  // GOOGLE_PROTOBUF_INCLUDED_GOOGLE_PROTOBUF_INCLUDED_echo_2eproto
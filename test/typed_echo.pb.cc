@@ -0,0 +1,65 @@
+// Generated by the protocol buffer compiler.  DO NOT EDIT!
+// source: typed_echo.proto
+
+#include "typed_echo.pb.h"
+
+#include <algorithm>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/extension_set.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/reflection_ops.h>
+#include <google/protobuf/wire_format.h>
+// @@protoc_insertion_point(includes)
+#include <google/protobuf/port_def.inc>
+
+PROTOBUF_PRAGMA_INIT_SEG
+
+namespace _pb = ::PROTOBUF_NAMESPACE_ID;
+namespace _pbi = _pb::internal;
+
+namespace AzTest {
+}  // namespace AzTest
+static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_typed_5fecho_2eproto = nullptr;
+static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_typed_5fecho_2eproto = nullptr;
+const uint32_t TableStruct_typed_5fecho_2eproto::offsets[1] = {};
+static constexpr ::_pbi::MigrationSchema* schemas = nullptr;
+static constexpr ::_pb::Message* const* file_default_instances = nullptr;
+
+const char descriptor_table_protodef_typed_5fecho_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
+  "\n\020typed_echo.proto\022\006AzTest\032\necho.proto2\272"
+  "\001\n\020TypedEchoService\0221\n\004Echo\022\023.AzTest.Ech"
+  "oRequest\032\024.AzTest.EchoResponse\022:\n\rUnimpl"
+  "emented\022\023.AzTest.EchoRequest\032\024.AzTest.Ec"
+  "hoResponse\0227\n\006Stream\022\023.AzTest.EchoReques"
+  "t\032\024.AzTest.EchoResponse(\0010\001b\006proto3"
+  ;
+static const ::_pbi::DescriptorTable* const descriptor_table_typed_5fecho_2eproto_deps[1] = {
+  &::descriptor_table_echo_2eproto,
+};
+static ::_pbi::once_flag descriptor_table_typed_5fecho_2eproto_once;
+const ::_pbi::DescriptorTable descriptor_table_typed_5fecho_2eproto = {
+    false, false, 235, descriptor_table_protodef_typed_5fecho_2eproto,
+    "typed_echo.proto",
+    &descriptor_table_typed_5fecho_2eproto_once, descriptor_table_typed_5fecho_2eproto_deps, 1, 0,
+    schemas, file_default_instances, TableStruct_typed_5fecho_2eproto::offsets,
+    nullptr, file_level_enum_descriptors_typed_5fecho_2eproto,
+    file_level_service_descriptors_typed_5fecho_2eproto,
+};
+PROTOBUF_ATTRIBUTE_WEAK const ::_pbi::DescriptorTable* descriptor_table_typed_5fecho_2eproto_getter() {
+  return &descriptor_table_typed_5fecho_2eproto;
+}
+
+// Force running AddDescriptors() at dynamic initialization time.
+PROTOBUF_ATTRIBUTE_INIT_PRIORITY2 static ::_pbi::AddDescriptorsRunner dynamic_init_dummy_typed_5fecho_2eproto(&descriptor_table_typed_5fecho_2eproto);
+namespace AzTest {
+
+// @@protoc_insertion_point(namespace_scope)
+}  // namespace AzTest
+PROTOBUF_NAMESPACE_OPEN
+PROTOBUF_NAMESPACE_CLOSE
+
+// @@protoc_insertion_point(global_scope)
+#include <google/protobuf/port_undef.inc>